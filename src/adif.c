@@ -0,0 +1,89 @@
+// adif.c - ADIF formatting helpers
+#include "adif.h"
+
+#include <string.h>
+
+#include "artemis.h"
+#include "utils.h"
+
+void
+adif_append_field(GString *out, const char *name, const char *value)
+{
+  if (!value || !*value) return;
+  g_string_append_printf(out, "<%s:%zu>%s ", name, strlen(value), value);
+}
+
+void
+adif_append_header(GString *out)
+{
+  g_autofree gchar *version = g_strdup_printf("%d.%d.%d",
+                                              VERSION_MAJOR(APP_VERSION),
+                                              VERSION_MINOR(APP_VERSION),
+                                              VERSION_PATCH(APP_VERSION));
+  g_string_append(out, "Artemis POTA hunter log export\n");
+  adif_append_field(out, "ADIF_VER", "3.1.4");
+  adif_append_field(out, "PROGRAMID", "Artemis");
+  adif_append_field(out, "PROGRAMVERSION", version);
+  g_string_append(out, "<EOH>\n");
+}
+
+void
+adif_append_iso8601_datetime(GString *out, const char *iso_utc)
+{
+  // Expect "YYYY-MM-DDTHH:MM:SS..." - slice rather than parse
+  if (!iso_utc || strlen(iso_utc) < 19) return;
+
+  char date[9] = {
+    iso_utc[0], iso_utc[1], iso_utc[2], iso_utc[3],
+    iso_utc[5], iso_utc[6], iso_utc[8], iso_utc[9], '\0'
+  };
+  char time[7] = {
+    iso_utc[11], iso_utc[12], iso_utc[14], iso_utc[15],
+    iso_utc[17], iso_utc[18], '\0'
+  };
+
+  adif_append_field(out, "QSO_DATE", date);
+  adif_append_field(out, "TIME_ON", time);
+}
+
+void
+adif_append_frequency_khz(GString *out, int frequency_khz)
+{
+  if (frequency_khz <= 0) return;
+
+  char freq[G_ASCII_DTOSTR_BUF_SIZE];
+  g_ascii_formatd(freq, sizeof freq, "%.4f", frequency_khz / 1000.0);
+  adif_append_field(out, "FREQ", freq);
+
+  const char *band = band_from_hz(frequency_khz);
+  if (g_strcmp0(band, "Other") != 0) {
+    adif_append_field(out, "BAND", band);
+  }
+}
+
+void
+adif_append_eor(GString *out)
+{
+  g_string_append(out, "<EOR>\n");
+}
+
+void
+adif_append_logbook_qso(GString *out, const LogbookQso *qso)
+{
+  g_autoptr(GDateTime) now = qso->qso_datetime ? NULL : g_date_time_new_now_utc();
+  g_autofree gchar *iso = g_date_time_format(qso->qso_datetime ? qso->qso_datetime : now, "%Y-%m-%dT%H:%M:%SZ");
+
+  adif_append_field(out, "CALL", qso->callsign);
+  adif_append_iso8601_datetime(out, iso);
+  adif_append_frequency_khz(out, qso->frequency_hz);
+  adif_append_field(out, "MODE", qso->mode);
+  adif_append_field(out, "RST_SENT", qso->rst_sent);
+  adif_append_field(out, "RST_RCVD", qso->rst_received);
+  if (qso->park_ref && *qso->park_ref) {
+    adif_append_field(out, "SIG", "POTA");
+    adif_append_field(out, "SIG_INFO", qso->park_ref);
+  }
+  adif_append_field(out, "COMMENT", qso->comment);
+  adif_append_field(out, ADIF_UID_FIELD, qso->uid);
+  adif_append_eor(out);
+}
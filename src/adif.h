@@ -0,0 +1,36 @@
+// adif.h - ADIF (Amateur Data Interchange Format) formatting helpers
+#pragma once
+
+#include <glib.h>
+
+#include "logbook.h"
+
+G_BEGIN_DECLS
+
+// App-defined field adif_append_logbook_qso() puts LogbookQso.uid in
+#define ADIF_UID_FIELD "APP_ARTEMIS_UID"
+
+// Append "<name:len>value" to out. NULL or empty values are skipped.
+void
+adif_append_field(GString *out, const char *name, const char *value);
+
+// Append the file header (comment line, ADIF_VER, PROGRAMID, PROGRAMVERSION, <eoh>)
+void
+adif_append_header(GString *out);
+
+// Append QSO_DATE/TIME_ON from an ISO 8601 UTC timestamp ("YYYY-MM-DDTHH:MM:SSZ")
+void
+adif_append_iso8601_datetime(GString *out, const char *iso_utc);
+
+// Append FREQ (MHz) and BAND for a frequency given in kHz
+void
+adif_append_frequency_khz(GString *out, int frequency_khz);
+
+void
+adif_append_eor(GString *out);
+
+// Append a whole record for qso, <EOR> included. qso->uid goes into ADIF_UID_FIELD.
+void
+adif_append_logbook_qso(GString *out, const LogbookQso *qso);
+
+G_END_DECLS
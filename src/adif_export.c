@@ -0,0 +1,182 @@
+// adif_export.c - Streaming ADIF export of the local QSO database
+#include "adif_export.h"
+#include "adif.h"
+
+#define EXPORT_BUFFER_SIZE (64 * 1024)
+
+typedef struct {
+  GOutputStream *stream;
+  GCancellable  *cancellable;
+  GString       *record;  // reused for every row
+  guint          count;
+} ExportState;
+
+typedef struct {
+  GFile *file;
+  gchar *from_utc;
+  gchar *to_utc;
+  gchar *park_prefix;
+  gchar *mode;
+} ExportTaskData;
+
+static void
+export_task_data_free(ExportTaskData *data)
+{
+  if (!data) return;
+  g_clear_object(&data->file);
+  g_free(data->from_utc);
+  g_free(data->to_utc);
+  g_free(data->park_prefix);
+  g_free(data->mode);
+  g_free(data);
+}
+
+static void
+append_qso_record(GString *out, const QsoRow *row)
+{
+  adif_append_field(out, "CALL", row->callsign);
+  adif_append_iso8601_datetime(out, row->created_utc);
+  adif_append_frequency_khz(out, row->frequency_hz);
+  adif_append_field(out, "MODE", row->mode);
+  adif_append_field(out, "SIG", "POTA");
+  adif_append_field(out, "SIG_INFO", row->park_ref);
+  adif_append_field(out, "COMMENT", row->spotter_comment);
+  adif_append_eor(out);
+}
+
+static gboolean
+write_qso_row(const QsoRow *row, gpointer user_data, GError **error)
+{
+  ExportState *state = user_data;
+
+  g_string_truncate(state->record, 0);
+  append_qso_record(state->record, row);
+
+  if (!g_output_stream_write_all(state->stream, state->record->str, state->record->len,
+                                 NULL, state->cancellable, error)) {
+    return FALSE;
+  }
+
+  state->count++;
+  return TRUE;
+}
+
+gboolean
+adif_export_to_stream(SpotDb *db,
+                      GOutputStream *stream,
+                      const QsoFilter *filter,
+                      GCancellable *cancellable,
+                      guint *out_count,
+                      GError **error)
+{
+  g_return_val_if_fail(db != NULL, FALSE);
+  g_return_val_if_fail(G_IS_OUTPUT_STREAM(stream), FALSE);
+
+  ExportState state = {
+    .stream = stream,
+    .cancellable = cancellable,
+    .record = g_string_sized_new(512),
+    .count = 0,
+  };
+
+  adif_append_header(state.record);
+  gboolean ok = g_output_stream_write_all(stream, state.record->str, state.record->len,
+                                          NULL, cancellable, error);
+  if (ok) {
+    ok = spot_db_foreach_qso(db, filter, cancellable, write_qso_row, &state, error);
+  }
+
+  if (out_count) *out_count = state.count;
+  g_string_free(state.record, TRUE);
+  return ok;
+}
+
+static void
+export_thread_func(GTask *task, gpointer source_object,
+                   gpointer task_data, GCancellable *cancellable)
+{
+  ExportTaskData *data = task_data;
+  GError *error = NULL;
+
+  SpotDb *db = spot_db_get_instance();
+  if (!db) {
+    g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_FAILED, "Database is not available");
+    return;
+  }
+
+  GFileOutputStream *file_stream = g_file_replace(data->file, NULL, FALSE,
+                                                  G_FILE_CREATE_REPLACE_DESTINATION,
+                                                  cancellable, &error);
+  if (!file_stream) {
+    g_task_return_error(task, error);
+    return;
+  }
+
+  GOutputStream *out = g_buffered_output_stream_new_sized(G_OUTPUT_STREAM(file_stream),
+                                                          EXPORT_BUFFER_SIZE);
+  g_object_unref(file_stream);
+
+  QsoFilter filter = {
+    .from_utc = data->from_utc,
+    .to_utc = data->to_utc,
+    .park_prefix = data->park_prefix,
+    .mode = data->mode,
+  };
+
+  guint count = 0;
+  gboolean ok = adif_export_to_stream(db, out, &filter, cancellable, &count, &error);
+
+  if (ok) {
+    ok = g_output_stream_close(out, cancellable, &error);
+  } else {
+    // Closing with a cancelled cancellable aborts the replace and keeps the old file
+    g_autoptr(GCancellable) abort = g_cancellable_new();
+    g_cancellable_cancel(abort);
+    g_output_stream_close(out, abort, NULL);
+  }
+  g_object_unref(out);
+
+  if (!ok) {
+    g_task_return_error(task, error);
+    return;
+  }
+
+  g_task_return_int(task, count);
+}
+
+void
+adif_export_to_file_async(GFile *file,
+                          const QsoFilter *filter,
+                          GCancellable *cancellable,
+                          GAsyncReadyCallback callback,
+                          gpointer user_data)
+{
+  g_return_if_fail(G_IS_FILE(file));
+
+  ExportTaskData *data = g_new0(ExportTaskData, 1);
+  data->file = g_object_ref(file);
+  if (filter) {
+    data->from_utc = g_strdup(filter->from_utc);
+    data->to_utc = g_strdup(filter->to_utc);
+    data->park_prefix = g_strdup(filter->park_prefix);
+    data->mode = g_strdup(filter->mode);
+  }
+
+  GTask *task = g_task_new(NULL, cancellable, callback, user_data);
+  g_task_set_source_tag(task, adif_export_to_file_async);
+  g_task_set_task_data(task, data, (GDestroyNotify)export_task_data_free);
+  g_task_run_in_thread(task, export_thread_func);
+  g_object_unref(task);
+}
+
+gboolean
+adif_export_to_file_finish(GAsyncResult *result, guint *out_count, GError **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, NULL), FALSE);
+
+  gssize count = g_task_propagate_int(G_TASK(result), error);
+  if (count < 0) return FALSE;
+
+  if (out_count) *out_count = (guint)count;
+  return TRUE;
+}
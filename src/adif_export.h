@@ -0,0 +1,31 @@
+// adif_export.h - Streaming ADIF export of the local QSO database
+#pragma once
+
+#include <glib.h>
+#include <gio/gio.h>
+#include "database.h"
+
+G_BEGIN_DECLS
+
+// Write every QSO matching filter (may be NULL) to stream as ADIF.
+// Rows are formatted one at a time, so memory use is independent of log size.
+gboolean adif_export_to_stream(SpotDb *db,
+                               GOutputStream *stream,
+                               const QsoFilter *filter,
+                               GCancellable *cancellable,
+                               guint *out_count,
+                               GError **error);
+
+// Export to file in a worker thread. The file is only replaced once the
+// export completes; cancelling leaves any existing file untouched.
+void adif_export_to_file_async(GFile *file,
+                               const QsoFilter *filter,
+                               GCancellable *cancellable,
+                               GAsyncReadyCallback callback,
+                               gpointer user_data);
+
+gboolean adif_export_to_file_finish(GAsyncResult *result,
+                                    guint *out_count,
+                                    GError **error);
+
+G_END_DECLS
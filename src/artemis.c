@@ -13,7 +13,6 @@
 
 #include <gtk/gtk.h>
 #include <libintl.h>
-#include <hamlib/rig.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -24,6 +23,23 @@
 #include "pota_user_cache.h"
 #include "status_page.h"
 #include "spot_page.h"
+#include "stats_dialog.h"
+#include "rig_worker.h"
+#include "rig_profile.h"
+#include "refresh_scheduler.h"
+#include "spot_index.h"
+#include "history_query.h"
+#include "http_session.h"
+#include "spot_history_dialog.h"
+#include "spot_outbox.h"
+#include "logbook_queue.h"
+#include "logbook_qrz.h"
+#include "logbook_adif_file.h"
+#include "logbook_udp.h"
+
+#define SEARCH_CATALOG_MIN_CHARS 3
+#define SEARCH_CATALOG_LIMIT     2000
+#define SEARCH_HISTORY_LIMIT     500
 
 GtkWindow *artemis_app_build_ui(ArtemisApp *self, GtkApplication *app);
 static void artemis_app_activate(GApplication *app);
@@ -32,6 +48,7 @@ static void artemis_app_init(ArtemisApp* self);
 static void artemis_app_dispose(GObject *object);
 static void artemis_app_start_connection_monitoring(ArtemisApp *self);
 static void artemis_app_stop_connection_monitoring(ArtemisApp *self);
+static void on_vfo_changed(ArtemisRigWorker *worker, gdouble freq_hz, gpointer user_data);
 
 static guint app_signals[N_SIGNALS];
 
@@ -44,12 +61,13 @@ struct _ArtemisApp {
 
   GtkFlowBox      *spots_container;
   GtkBox          *loading_spinner;
+  GtkWidget       *band_stack;      // dimmed while the spots are last run's snapshot
 
   ArtemisSpotRepo *repo;
   
-  // Radio connection management
-  RIG             *rig;
-  gboolean        radio_connected;
+  // Radio connection management; all hamlib I/O happens on the worker's thread
+  ArtemisRigWorker *rig_worker;
+  GPtrArray       *extra_rigs;    // RigSlot*, one per rig-profiles entry
   guint           radio_check_source_id; // For periodic connection checks
   gulong          settings_changed_handler; // For settings change monitoring
   GPtrArray       *pages;
@@ -57,17 +75,31 @@ struct _ArtemisApp {
   AdwToastOverlay *toast_overlay;
 
   guint time_source_id;
-  unsigned int    seconds_elapsed;
-  unsigned int    seconds_to_update;
+  ArtemisRefreshScheduler *refresh_scheduler; // decides when the spot list is fetched
+
+  // Spots are posted through the outbox so none are lost offline
+  ArtemisSpotOutbox *outbox;
+  GtkWidget       *outbox_button;
+  GtkListBox      *outbox_list;
+
+  LogbookQueue    *logbook_queue;  // uploads logged QSOs to the configured logbooks
   
   // Search functionality
   gchar           *search_text;
+  GHashTable      *search_park_refs; // catalog parks matching search_text
+  GtkSearchEntry  *search_entry;
+  gboolean         history_mode;     // search the spot archive instead of filtering
   
   // Mode filtering
   gchar           *current_mode_filter;
   
   // Pinned spot tracking
   guint           pinned_spot_hash;
+
+  // VFO tracking: spots by frequency, and the pin that followed the dial
+  SpotIndex       *spot_index;
+  gdouble          vfo_khz;       // last VFO reading, 0 = unknown
+  gboolean         vfo_pinned;    // pinned_spot_hash was set from the VFO
 };
 
 typedef struct {
@@ -106,190 +138,167 @@ band_view_free(BandView *view) {
   }
 }
 
-// Radio connection task data
+// An additional radio and the worker thread that owns its connection
 typedef struct {
-  ArtemisApp *app;
-  gint model_id;
-  gchar *connection_type;
-  gchar *device_path;
-  gchar *network_host;
-  gint network_port;
-  gint baud_rate;
-} RadioConnectionData;
+  RigProfile       *profile;
+  ArtemisRigWorker *worker;
+} RigSlot;
 
 static void
-radio_connection_data_free(RadioConnectionData *data) {
-  if (data) {
-    g_object_unref(data->app);
-    g_free(data->connection_type);
-    g_free(data->device_path);
-    g_free(data->network_host);
-    g_free(data);
-  }
+rig_slot_free(RigSlot *slot)
+{
+  g_object_run_dispose(G_OBJECT(slot->worker));
+  g_object_unref(slot->worker);
+  rig_profile_free(slot->profile);
+  g_free(slot);
 }
 
-// Background thread radio connection function
-static void radio_connection_thread_func(GTask *task, gpointer source_object, 
-                                        gpointer task_data, GCancellable *cancellable)
+static guint artemis_app_get_poll_interval_ms(void)
 {
-  RadioConnectionData *data = (RadioConnectionData *)task_data;
-  RIG *rig = NULL;
-  GError *error = NULL;
-  
-  // Initialize rig
-  rig = rig_init(data->model_id);
-  if (!rig) {
-    g_set_error(&error, G_IO_ERROR, G_IO_ERROR_FAILED, 
-                "Failed to initialize radio model %d", data->model_id);
-    g_task_return_error(task, error);
-    return;
-  }
-  
-  // Configure connection based on type
-  if (g_strcmp0(data->connection_type, "serial") == 0 || g_strcmp0(data->connection_type, "usb") == 0) {
-    strncpy(rig->state.rigport.pathname, data->device_path, HAMLIB_FILPATHLEN - 1);
-    rig->state.rigport.parm.serial.rate = data->baud_rate;
-  } else if (g_strcmp0(data->connection_type, "network") == 0) {
-    g_snprintf(rig->state.rigport.pathname, HAMLIB_FILPATHLEN, "%s:%d", 
-               data->network_host, data->network_port);
-  }
-  
-  // Attempt connection
-  int result = rig_open(rig);
-  if (result != RIG_OK) {
-    g_set_error(&error, G_IO_ERROR, G_IO_ERROR_CONNECTION_REFUSED,
-                "Failed to connect to radio: %s", rigerror(result));
-    rig_cleanup(rig);
-    g_task_return_error(task, error);
-    return;
-  }
-  
-  // Success - return the rig
-  g_task_return_pointer(task, rig, (GDestroyNotify)rig_cleanup);
+  int rate = g_settings_get_int(artemis_app_get_settings(), "vfo-poll-rate");
+  return rate > 0 ? 1000 / rate : 0;
 }
 
 // Async callback when radio connection completes
 static void on_radio_connection_complete(GObject *source, GAsyncResult *result, gpointer user_data)
 {
   ArtemisApp *self = ARTEMIS_APP(user_data);
-  GError *error = NULL;
-  
-  RIG *rig = g_task_propagate_pointer(G_TASK(result), &error);
-  
-  if (rig) {
-    // Success - store the rig and mark as connected
-    self->rig = rig;
-    self->radio_connected = TRUE;
-    g_debug("Radio connected successfully");
-    
+  g_autoptr(GError) error = NULL;
+
+  if (artemis_rig_worker_open_finish(ARTEMIS_RIG_WORKER(source), result, &error)) {
     // Start monitoring now that we're connected
     artemis_app_start_connection_monitoring(self);
-  } else {
-    // Failed - log the error but don't block the app
-    g_warning("Radio connection failed: %s", error ? error->message : "Unknown error");
-    g_clear_error(&error);
-    self->rig = NULL;
-    self->radio_connected = FALSE;
+  } else if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+    // Failed - log the error but don't block the app. The monitor is shared, so
+    // the other radios' health checks and the settings watch must carry on.
+    g_warning("Radio connection failed: %s", error->message);
+    artemis_app_start_connection_monitoring(self);
   }
 }
 
 // Radio connection management functions
 static void artemis_app_init_radio_connection_async(ArtemisApp *self)
 {
-  GSettings *settings = artemis_app_get_settings();
-  
-  // Check if radio is configured
-  g_autofree gchar *connection_type = g_settings_get_string(settings, "radio-connection-type");
-  if (g_strcmp0(connection_type, "none") == 0) {
+  g_autoptr(RigConfig) config = rig_config_new_from_settings(artemis_app_get_settings());
+  if (!config) {
     return; // No radio configured
   }
-  
-  // Prepare connection data
-  RadioConnectionData *data = g_new0(RadioConnectionData, 1);
-  data->app = g_object_ref(self);
-  data->model_id = g_settings_get_int(settings, "radio-model");
-  data->connection_type = g_strdup(connection_type);
-  data->device_path = g_settings_get_string(settings, "radio-device");
-  data->network_host = g_settings_get_string(settings, "radio-network-host");
-  data->network_port = g_settings_get_int(settings, "radio-network-port");
-  data->baud_rate = g_settings_get_int(settings, "radio-baud-rate");
-  
-  // Create and run async task
-  GTask *task = g_task_new(self, NULL, on_radio_connection_complete, self);
-  g_task_set_task_data(task, data, (GDestroyNotify)radio_connection_data_free);
-  g_task_run_in_thread(task, radio_connection_thread_func);
-  g_object_unref(task);
-  
-  g_debug("Radio connection started in background thread");
-}
 
-static void artemis_app_disconnect_radio(ArtemisApp *self)
-{
-  if (self->rig && self->radio_connected) {
-    // Safely close the rig connection
-    int close_result = rig_close(self->rig);
-    if (close_result != RIG_OK) {
-      g_warning("Error closing radio connection: %s", rigerror(close_result));
-    }
-    self->radio_connected = FALSE;
-    g_debug("Radio disconnected");
-  }
+  artemis_rig_worker_open_async(self->rig_worker, config, NULL, on_radio_connection_complete, self);
+  g_debug("Radio connection queued on the rig worker");
 }
 
 static void artemis_app_reconnect_radio_async(ArtemisApp *self)
 {
   // Stop monitoring during reconnection
   artemis_app_stop_connection_monitoring(self);
-  
-  // Disconnect existing connection
-  artemis_app_disconnect_radio(self);
-  
-  // Clean up existing rig
-  if (self->rig) {
-    rig_cleanup(self->rig);
-    self->rig = NULL;
+
+  // Opening closes any existing rig first; with no radio configured just close
+  g_autoptr(RigConfig) config = rig_config_new_from_settings(artemis_app_get_settings());
+  if (!config) {
+    artemis_rig_worker_close(self->rig_worker);
+    // The additional radios still need their health checks
+    artemis_app_start_connection_monitoring(self);
+    return;
   }
-  
-  // Re-initialize connection asynchronously
-  artemis_app_init_radio_connection_async(self);
+  artemis_rig_worker_open_async(self->rig_worker, config, NULL, on_radio_connection_complete, self);
 }
 
-// Periodic radio connection check
-static gboolean radio_connection_check(gpointer user_data)
+static RigSlot *artemis_app_find_rig_slot(ArtemisApp *self, ArtemisRigWorker *worker)
 {
-  ArtemisApp *self = ARTEMIS_APP(user_data);
-  
-  if (!self->rig || !self->radio_connected) {
-    return G_SOURCE_CONTINUE; // Keep checking
+  for (guint i = 0; i < self->extra_rigs->len; i++) {
+    RigSlot *slot = g_ptr_array_index(self->extra_rigs, i);
+    if (slot->worker == worker) return slot;
   }
-  
-  // Test connection with a simple command - with crash protection
-  if (!self->rig) {
-    g_debug("Rig is NULL, skipping connection check");
-    self->radio_connected = FALSE;
-    return G_SOURCE_CONTINUE;
+  return NULL;
+}
+
+// Bring rig-profiles in line with the running workers. Radios whose connection
+// settings did not change keep their worker, so editing one never drops the others.
+static void artemis_app_load_rig_profiles(ArtemisApp *self)
+{
+  g_autoptr(GPtrArray) profiles = rig_profiles_load(artemis_app_get_settings());
+  g_ptr_array_set_free_func(profiles, NULL); // ownership moves into the slots
+  GPtrArray *slots = g_ptr_array_new_with_free_func((GDestroyNotify)rig_slot_free);
+  guint poll_interval_ms = artemis_app_get_poll_interval_ms();
+
+  for (guint i = 0; i < profiles->len; i++) {
+    RigProfile *profile = g_ptr_array_index(profiles, i);
+    RigSlot *slot = NULL;
+
+    for (guint j = 0; self->extra_rigs && j < self->extra_rigs->len; j++) {
+      RigSlot *old = g_ptr_array_index(self->extra_rigs, j);
+      if (rig_config_equal(old->profile->config, profile->config)) {
+        slot = g_ptr_array_steal_index_fast(self->extra_rigs, j);
+        rig_profile_free(slot->profile);
+        slot->profile = profile;
+        break;
+      }
+    }
+
+    if (!slot) {
+      slot = g_new0(RigSlot, 1);
+      slot->profile = profile;
+      slot->worker = artemis_rig_worker_new();
+      g_signal_connect(slot->worker, "vfo-changed", G_CALLBACK(on_vfo_changed), self);
+      artemis_rig_worker_set_poll_interval(slot->worker, poll_interval_ms);
+      if (rig_profile_is_enabled(profile)) {
+        artemis_rig_worker_open_async(slot->worker, profile->config, NULL, on_radio_connection_complete, self);
+      }
+    }
+    g_ptr_array_add(slots, slot);
   }
-  
-  freq_t freq;
-  int result = -1;
-  
-  // Additional validation before calling hamlib
-  if (self->rig->caps == NULL || self->rig->state.comm_state != RIG_OK) {
-    g_warning("Rig is in invalid state, marking as disconnected");
-    self->radio_connected = FALSE;
-    return G_SOURCE_CONTINUE;
+
+  // Whatever is left was removed or reconfigured; disposing closes the radio
+  g_clear_pointer(&self->extra_rigs, g_ptr_array_unref);
+  self->extra_rigs = slots;
+}
+
+static void on_rig_profiles_changed(GSettings *settings, const char *key, gpointer user_data)
+{
+  artemis_app_load_rig_profiles(ARTEMIS_APP(user_data));
+}
+
+// Reopen whichever radio failed its health check
+static void artemis_app_reconnect_rig(ArtemisApp *self, ArtemisRigWorker *worker)
+{
+  if (worker == self->rig_worker) {
+    artemis_app_reconnect_radio_async(self);
+    return;
   }
-  
-  result = rig_get_freq(self->rig, RIG_VFO_CURR, &freq);
-  
-  if (result != RIG_OK) {
-    g_warning("Radio connection check failed: %s", rigerror(result));
-    self->radio_connected = FALSE;
-    
+
+  RigSlot *slot = artemis_app_find_rig_slot(self, worker);
+  if (slot && rig_profile_is_enabled(slot->profile)) {
+    artemis_rig_worker_open_async(worker, slot->profile->config, NULL, on_radio_connection_complete, self);
+  }
+}
+
+static void on_radio_check_complete(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  g_autoptr(GError) error = NULL;
+
+  if (!artemis_rig_worker_get_freq_finish(ARTEMIS_RIG_WORKER(source), result, NULL, &error)) {
+    g_warning("Radio connection check failed: %s", error->message);
     // Try to reconnect automatically
-    artemis_app_reconnect_radio_async(self);
+    artemis_app_reconnect_rig(self, ARTEMIS_RIG_WORKER(source));
+  }
+}
+
+// Periodic radio connection check; each rig answers on its own thread
+static gboolean radio_connection_check(gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+
+  if (artemis_rig_worker_is_connected(self->rig_worker)) {
+    artemis_rig_worker_get_freq_async(self->rig_worker, NULL, on_radio_check_complete, self);
+  }
+  for (guint i = 0; i < self->extra_rigs->len; i++) {
+    RigSlot *slot = g_ptr_array_index(self->extra_rigs, i);
+    if (artemis_rig_worker_is_connected(slot->worker)) {
+      artemis_rig_worker_get_freq_async(slot->worker, NULL, on_radio_check_complete, self);
+    }
   }
-  
   return G_SOURCE_CONTINUE;
 }
 
@@ -433,6 +442,12 @@ artemis_app_update_all_spot_cards_hunted_state(ArtemisApp *self) {
   return G_SOURCE_REMOVE; // Remove this idle callback after running once
 }
 
+void
+artemis_app_refresh_hunted_state(ArtemisApp *self) {
+  g_return_if_fail(ARTEMIS_IS_APP(self));
+  g_idle_add((GSourceFunc)artemis_app_update_all_spot_cards_hunted_state, self);
+}
+
 static void
 on_items_changed(GListModel *m, guint pos, guint removed, guint added, gpointer user_data) {
   band_view_update_empty((BandView*)user_data);
@@ -494,6 +509,13 @@ static gboolean combined_filter_func(gpointer item, gpointer user_data)
     if (contains_text_case_insensitive(artemis_spot_get_park_name(spot), search_text)) {
       return TRUE;
     }
+
+    // Search in the park catalog (location, names not carried by the spot)
+    ArtemisApp *app = ARTEMIS_APP(g_application_get_default());
+    const char *park_ref = artemis_spot_get_park_ref(spot);
+    if (app->search_park_refs && park_ref && g_hash_table_contains(app->search_park_refs, park_ref)) {
+      return TRUE;
+    }
     
     // No match found in any search field
     return FALSE;
@@ -625,6 +647,72 @@ static void on_repo_busy(ArtemisSpotRepo *repo, gboolean busy, gpointer user_dat
   gtk_widget_set_visible(GTK_WIDGET(self->loading_spinner), busy);
 }
 
+static void on_repo_stale_changed(ArtemisSpotRepo *repo, gboolean stale, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  if (!self->band_stack) return;
+
+  if (stale)
+    gtk_widget_add_css_class(self->band_stack, "stale");
+  else
+    gtk_widget_remove_css_class(self->band_stack, "stale");
+}
+
+// Pin the spot the dial is sitting on; drop a VFO-set pin once the dial moves off.
+// Pins made by clicking a card are left alone until the VFO lands on another spot.
+static void artemis_app_track_vfo(ArtemisApp *self)
+{
+  if (self->vfo_khz <= 0) return;
+
+  gdouble tolerance_khz = g_settings_get_int(artemis_app_get_settings(), "vfo-match-tolerance") / 1000.0;
+  ArtemisSpot *spot = spot_index_find_nearest(self->spot_index, self->vfo_khz, tolerance_khz);
+  guint hash = spot ? hash_spot(spot) : G_MAXUINT;
+
+  if (spot && hash != self->pinned_spot_hash) {
+    self->pinned_spot_hash = hash;
+    self->vfo_pinned = TRUE;
+  } else if (!spot && self->vfo_pinned && self->pinned_spot_hash != G_MAXUINT) {
+    self->pinned_spot_hash = G_MAXUINT;
+    self->vfo_pinned = FALSE;
+  } else {
+    return;
+  }
+
+  g_idle_add((GSourceFunc)artemis_app_update_all_spot_cards_pinned_state, self);
+}
+
+// Every rig polls on its own thread; with several radios the pin follows
+// whichever dial moved last
+static void on_vfo_changed(ArtemisRigWorker *worker, gdouble freq_hz, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  self->vfo_khz = freq_hz / 1000.0;
+  artemis_app_track_vfo(self);
+}
+
+static void on_vfo_poll_rate_changed(GSettings *s, const char *key, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  guint interval_ms = artemis_app_get_poll_interval_ms();
+
+  artemis_rig_worker_set_poll_interval(self->rig_worker, interval_ms);
+  for (guint i = 0; self->extra_rigs && i < self->extra_rigs->len; i++) {
+    RigSlot *slot = g_ptr_array_index(self->extra_rigs, i);
+    artemis_rig_worker_set_poll_interval(slot->worker, interval_ms);
+  }
+  if (interval_ms == 0) self->vfo_khz = 0;
+}
+
+// The repo's list was replaced, by a fetch or otherwise
+static void artemis_app_spots_replaced(ArtemisApp *self, ArtemisSpotRepo *repo)
+{
+  spot_index_rebuild(self->spot_index, artemis_spot_repo_get_model(repo));
+  artemis_app_track_vfo(self);
+
+  // Reapply pinned styles after refresh since we have new spot objects
+  artemis_app_update_all_spot_cards_pinned_state(self); // Call directly, not as idle callback
+}
+
 static void on_repo_refreshed(ArtemisSpotRepo *repo, guint n, gpointer user_data)
 {
   ArtemisApp *self = ARTEMIS_APP(user_data);
@@ -636,14 +724,47 @@ static void on_repo_refreshed(ArtemisSpotRepo *repo, guint n, gpointer user_data
   adw_toast_set_title(toast, title);
   adw_toast_set_timeout(toast, 5);
   adw_toast_overlay_add_toast(self->toast_overlay, toast);
-  
-  // Reapply pinned styles after refresh since we have new spot objects
-  artemis_app_update_all_spot_cards_pinned_state(self); // Call directly, not as idle callback
+
+  artemis_app_spots_replaced(self, repo);
+
+  artemis_refresh_scheduler_complete(self->refresh_scheduler, TRUE,
+                                     artemis_spot_repo_get_refresh_hint(repo));
+}
+
+// No fetch finished, so the scheduler is left alone
+static void on_repo_applied(ArtemisSpotRepo *repo, guint n, gpointer user_data)
+{
+  artemis_app_spots_replaced(ARTEMIS_APP(user_data), repo);
+}
+
+static void on_repo_unchanged(ArtemisSpotRepo *repo, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  artemis_refresh_scheduler_complete(self->refresh_scheduler, TRUE,
+                                     artemis_spot_repo_get_refresh_hint(repo));
+}
+
+static void on_repo_error_response(AdwAlertDialog *dialog, const char *response, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  if (g_strcmp0(response, "retry") == 0) {
+    artemis_refresh_scheduler_refresh_now(self->refresh_scheduler);
+  }
 }
 
 static void on_repo_error(ArtemisSpotRepo *repo, GError *error, gpointer user_data)
 {
   ArtemisApp *self = ARTEMIS_APP(user_data);
+
+  artemis_refresh_scheduler_complete(self->refresh_scheduler, FALSE,
+                                     artemis_spot_repo_get_refresh_hint(repo));
+
+  // Only the first failure in a row gets a dialog; the banner shows the retry countdown after that
+  if (artemis_refresh_scheduler_get_failures(self->refresh_scheduler) > 1) {
+    g_debug("Spot refresh failed again: %s", error->message);
+    return;
+  }
+
   AdwDialog *dialog = adw_alert_dialog_new(_("Unable to refresh spots"), NULL);
 
   adw_alert_dialog_format_body (ADW_ALERT_DIALOG (dialog),
@@ -655,7 +776,7 @@ static void on_repo_error(ArtemisSpotRepo *repo, GError *error, gpointer user_da
   adw_alert_dialog_set_default_response(ADW_ALERT_DIALOG(dialog), "cancel");
   adw_alert_dialog_set_close_response(ADW_ALERT_DIALOG(dialog), "cancel");
 
-  //g_signal_connect (dialog, "response", G_CALLBACK (response_cb), self);
+  g_signal_connect(dialog, "response", G_CALLBACK(on_repo_error_response), self);
 
   adw_dialog_present(dialog, GTK_WIDGET(self->window));
 }
@@ -670,16 +791,110 @@ static void artemis_app_activate(GApplication *app)
 static void
 on_search_entry_changed(GtkSearchEntry *entry, gpointer user_data) {
   ArtemisApp *app = ARTEMIS_APP(user_data);
-  const char *text = gtk_editable_get_text(GTK_EDITABLE(entry));
+  const char *text = app->history_mode ? "" : gtk_editable_get_text(GTK_EDITABLE(entry));
   
   // Update app's search text
   g_clear_pointer(&app->search_text, g_free);
   app->search_text = g_strdup(text);
+
+  // Resolve matching parks once per change instead of once per spot
+  g_clear_pointer(&app->search_park_refs, g_hash_table_unref);
+  if (text && strlen(text) >= SEARCH_CATALOG_MIN_CHARS) {
+    g_autoptr(GPtrArray) parks = spot_db_search_parks(spot_db_get_instance(), text, SEARCH_CATALOG_LIMIT, NULL);
+    if (parks && parks->len > 0) {
+      app->search_park_refs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+      for (guint i = 0; i < parks->len; i++) {
+        ParkCatalogRow *park = g_ptr_array_index(parks, i);
+        g_hash_table_add(app->search_park_refs, g_steal_pointer(&park->reference));
+      }
+    }
+  }
   
   // Emit signal to notify all band views
   artemis_app_emit_search_changed(app, text);
 }
 
+typedef struct {
+  SpotHistoryQuery  *query;
+  SpotHistoryDialog *dialog;
+} HistorySearchData;
+
+static void
+history_search_data_free(HistorySearchData *data) {
+  spot_history_query_free(data->query);
+  g_object_unref(data->dialog);
+  g_free(data);
+}
+
+static void
+history_search_thread(GTask *task, gpointer source_object, gpointer task_data, GCancellable *cancellable) {
+  HistorySearchData *data = task_data;
+  SpotDb *db = spot_db_get_instance();
+  if (!db) {
+    g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_INITIALIZED,
+                            _("The spot database could not be opened"));
+    return;
+  }
+
+  GError *error = NULL;
+  GPtrArray *spots = spot_db_search_spot_history(db, data->query, SEARCH_HISTORY_LIMIT, &error);
+  if (!spots) {
+    if (!error) {
+      error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_FAILED, _("Spot history search failed"));
+    }
+    g_task_return_error(task, error);
+    return;
+  }
+  g_task_return_pointer(task, spots, (GDestroyNotify)g_ptr_array_unref);
+}
+
+static void
+on_history_search_done(GObject *source, GAsyncResult *result, gpointer user_data) {
+  HistorySearchData *data = g_task_get_task_data(G_TASK(result));
+  g_autoptr(GError) error = NULL;
+  g_autoptr(GPtrArray) spots = g_task_propagate_pointer(G_TASK(result), &error);
+
+  if (!spots) {
+    spot_history_dialog_show_error(data->dialog, error ? error->message : _("Spot history search failed"));
+    return;
+  }
+  spot_history_dialog_show_spots(data->dialog, spots);
+}
+
+// Enter in history mode: parse the phrase and query the archive off the main thread
+static void
+on_search_entry_activate(GtkSearchEntry *entry, gpointer user_data) {
+  ArtemisApp *app = ARTEMIS_APP(user_data);
+  const char *text = gtk_editable_get_text(GTK_EDITABLE(entry));
+  if (!app->history_mode || !text || !*text) return;
+
+  HistorySearchData *data = g_new0(HistorySearchData, 1);
+  data->query = history_query_parse(text, NULL);
+  data->dialog = g_object_ref_sink(spot_history_dialog_new());
+
+  spot_history_dialog_set_title(data->dialog, _("Spot History"), text);
+  spot_history_dialog_show_loading(data->dialog);
+  adw_dialog_present(ADW_DIALOG(data->dialog), GTK_WIDGET(app->window));
+
+  g_autoptr(GTask) task = g_task_new(app, NULL, on_history_search_done, NULL);
+  g_task_set_source_tag(task, on_search_entry_activate);
+  g_task_set_task_data(task, data, (GDestroyNotify)history_search_data_free);
+  g_task_run_in_thread(task, history_search_thread);
+}
+
+static void
+on_history_toggled(GtkToggleButton *button, gpointer user_data) {
+  ArtemisApp *app = ARTEMIS_APP(user_data);
+  app->history_mode = gtk_toggle_button_get_active(button);
+
+  gtk_search_entry_set_placeholder_text(app->search_entry, app->history_mode
+      ? _("Search spot history, e.g. K-1234 40m CW last week")
+      : _("Search for Park or Callsign"));
+
+  // Live filtering only applies outside history mode
+  on_search_entry_changed(app->search_entry, app);
+}
+
 static void on_mode_changed(GObject *object, GParamSpec *pspec, gpointer user_data)
 {
   ArtemisApp *app = ARTEMIS_APP(user_data);
@@ -706,94 +921,136 @@ static void on_hide_hunted_changed(GtkSwitch *hide_hunted, gpointer user_data)
   g_message("hide hunted changed");
 }
 
-static void spot_submitted_callback(GObject *src,
-                                    GAsyncResult *result,
-                                    gpointer user_data)
+static void show_spot_error(ArtemisApp *self, const gchar *message)
 {
-  PotaClient *client = ARTEMIS_POTA_CLIENT(src);
-  g_return_if_fail(client != NULL);
-  ArtemisApp *self = ARTEMIS_APP(user_data);
+  const char *fmt = _("Unable to spot due to the following error: %s");
+  g_autofree gchar *body = g_strdup_printf(fmt, message ? message : _("Unknown error"));
 
-  GError *error = NULL;
-  JsonNode *node = pota_client_post_spot_finish(client, result, &error);
-  gchar *s = json_to_string(node, TRUE);   // TRUE = pretty-print
-  g_print("%s\n", s);
-  g_free(s);
-  const gchar *message = NULL;
+  AdwAlertDialog *dlg = ADW_ALERT_DIALOG(adw_alert_dialog_new(_("Unable to Spot"), body));
+  adw_alert_dialog_add_response(dlg, "ok", _("_OK"));
+  adw_alert_dialog_set_default_response(dlg, "ok");
+  adw_alert_dialog_set_close_response(dlg, "ok");
+
+  adw_dialog_present(ADW_DIALOG(dlg), GTK_WIDGET(self->window));
+}
 
-  if (error != NULL) {
-    message = error->message ? error->message : _("Unknown error");
-    goto alert;
+static void on_spot_posted(ArtemisSpotOutbox *outbox,
+                           ArtemisSpot *queued,
+                           GPtrArray *spots,
+                           gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+
+  // The reply is the server's current list, new spot included: use it instead of
+  // fetching again. Applying it logs the user's spot as a QSO like any other refresh.
+  if (spots) {
+    artemis_spot_repo_apply_spots(self->repo, spots);
+    return;
   }
 
-  if (node == NULL) {
-    message = _("No response from server.");
-    goto alert;
+  // Found already posted on a retry; log the queued copy and pick up the list
+  sqlite3_int64 qso_id = 0;
+  g_autoptr(GError) db_err = NULL;
+  if (!spot_db_add_qso_from_spot(spot_db_get_instance(), queued, &qso_id, &db_err)) {
+    show_spot_error(self, db_err && db_err->message ? db_err->message : _("Failed to write QSO to database."));
+    return;
   }
 
-  if (JSON_NODE_HOLDS_ARRAY(node)) {
-    JsonArray *arr = json_node_get_array(node);
-    guint array_length = json_array_get_length(arr);
-    
-    if (array_length >= 1) {
-      // Get user's callsign from preferences to identify their spot
-      GSettings *settings = artemis_app_get_settings();
-      g_autofree gchar *user_callsign = g_settings_get_string(settings, "callsign");
-      
-      ArtemisSpot *user_spot = NULL;
-      
-      // Iterate through all spots to find the one submitted by the user
-      for (guint i = 0; i < array_length; i++) {
-        ArtemisSpot *spot = artemis_spot_new_from_json(json_array_get_object_element(arr, i));
-        if (spot == NULL) {
-          continue; // Skip invalid spots
-        }
-        
-        const char *spotter = artemis_spot_get_spotter(spot);
-        if (spotter && user_callsign && g_strcmp0(spotter, user_callsign) == 0) {
-          // Found the user's spot
-          user_spot = spot;
-          break;
-        }
-        
-        g_object_unref(spot);
-      }
+  artemis_refresh_scheduler_refresh_now(self->refresh_scheduler);
+}
 
-      sqlite3_int64 qso_id = 0;
-      GError *db_err = NULL;
-      if (!spot_db_add_qso_from_spot(spot_db_get_instance(), user_spot, &qso_id, &db_err)) {
-        message = db_err && db_err->message ? db_err->message : _("Failed to write QSO to database.");
-        g_clear_error(&db_err);
-        g_object_unref(user_spot);
-        goto alert;
-      }
+static gchar *outbox_row_status(ArtemisSpotOutbox *outbox, SpotOutboxRow *row)
+{
+  switch (row->state) {
+  case SPOT_OUTBOX_SENDING:
+    return g_strdup(_("Sending…"));
+  case SPOT_OUTBOX_SENT:
+    return g_strdup(_("Posted"));
+  case SPOT_OUTBOX_FAILED:
+    return g_strdup_printf(_("Failed: %s"), row->last_error ? row->last_error : _("Unknown error"));
+  case SPOT_OUTBOX_QUEUED:
+  default:
+    break;
+  }
 
-      g_object_unref(user_spot);
-      if (node) json_node_unref(node);
+  if (!artemis_spot_outbox_get_network_available(outbox))
+    return g_strdup(_("Waiting for network"));
 
-      artemis_spot_repo_update_spots(self->repo, 60);
-      return;
-    }
-  }
+  gint64 wait = row->next_attempt - g_get_real_time() / G_USEC_PER_SEC;
+  if (wait <= 0)
+    return g_strdup(_("Queued"));
+  if (wait < 60)
+    return g_strdup_printf(_("Retrying in %d s"), (int)wait);
+  return g_strdup_printf(_("Retrying in %d min"), (int)((wait + 59) / 60));
+}
 
-  // Unexpected JSON type
-  message = _("Unexpected response type from server.");
+static void on_outbox_retry_clicked(GtkButton *button, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  sqlite3_int64 id = *(sqlite3_int64 *)g_object_get_data(G_OBJECT(button), "outbox-id");
+  artemis_spot_outbox_retry(self->outbox, id);
+}
 
-alert:
-  {
-    const char *fmt = _("Unable to spot due to the following error: %s");
-    g_autofree gchar *body = g_strdup_printf(fmt, message ? message : _("Unknown error"));
+static void on_outbox_discard_clicked(GtkButton *button, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  sqlite3_int64 id = *(sqlite3_int64 *)g_object_get_data(G_OBJECT(button), "outbox-id");
+  artemis_spot_outbox_discard(self->outbox, id);
+}
 
-    AdwAlertDialog *dlg = ADW_ALERT_DIALOG(adw_alert_dialog_new(_("Unable to Spot"), body));
-    adw_alert_dialog_add_response(dlg, "ok", _("_OK"));
-    adw_alert_dialog_set_default_response(dlg, "ok");
-    adw_alert_dialog_set_close_response(dlg, "ok");
+static GtkWidget *outbox_row_button(ArtemisApp *self, SpotOutboxRow *row, const char *icon,
+                                    const char *tooltip, GCallback callback)
+{
+  GtkWidget *button = gtk_button_new_from_icon_name(icon);
+  gtk_widget_set_tooltip_text(button, tooltip);
+  gtk_widget_set_valign(button, GTK_ALIGN_CENTER);
+  gtk_widget_add_css_class(button, "flat");
+  g_object_set_data_full(G_OBJECT(button), "outbox-id",
+                         g_memdup2(&row->id, sizeof row->id), g_free);
+  g_signal_connect(button, "clicked", callback, self);
+  return button;
+}
 
-    adw_dialog_present(ADW_DIALOG(dlg), GTK_WIDGET(self->window));
+static void on_outbox_changed(ArtemisSpotOutbox *outbox, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  if (!self->outbox_list) return;
+
+  gtk_list_box_remove_all(self->outbox_list);
+
+  GPtrArray *rows = artemis_spot_outbox_get_rows(outbox);
+  for (guint i = 0; rows && i < rows->len; i++) {
+    SpotOutboxRow *row = g_ptr_array_index(rows, i);
+    g_autofree gchar *title = g_strdup_printf("%s @ %s · %d %s",
+                                              artemis_spot_get_callsign(row->spot),
+                                              artemis_spot_get_park_ref(row->spot),
+                                              artemis_spot_get_frequency_hz(row->spot),
+                                              artemis_spot_get_mode(row->spot) ? artemis_spot_get_mode(row->spot) : "");
+    g_autofree gchar *status = outbox_row_status(outbox, row);
+
+    GtkWidget *action_row = adw_action_row_new();
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(action_row), title);
+    adw_preferences_row_set_use_markup(ADW_PREFERENCES_ROW(action_row), FALSE);
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(action_row), status);
+
+    if (row->state == SPOT_OUTBOX_FAILED || row->state == SPOT_OUTBOX_QUEUED) {
+      adw_action_row_add_suffix(ADW_ACTION_ROW(action_row),
+        outbox_row_button(self, row, "view-refresh-symbolic", _("Send Now"), G_CALLBACK(on_outbox_retry_clicked)));
+      adw_action_row_add_suffix(ADW_ACTION_ROW(action_row),
+        outbox_row_button(self, row, "user-trash-symbolic", _("Discard"), G_CALLBACK(on_outbox_discard_clicked)));
+    }
+    gtk_list_box_append(self->outbox_list, action_row);
   }
 
-  if (node) json_node_unref(node);
-  if (error) g_error_free(error);
+  gtk_widget_set_visible(self->outbox_button, artemis_spot_outbox_get_n_waiting(outbox) > 0);
+}
+
+// The optimistic copy must not outlive a spot the server will never show
+static void on_spot_failed(ArtemisSpotOutbox *outbox, ArtemisSpot *queued, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  artemis_spot_repo_remove_pending(self->repo, queued);
+  spot_index_rebuild(self->spot_index, artemis_spot_repo_get_model(self->repo));
 }
 
 static void on_spot_submitted(ArtemisApp *app, ArtemisSpot *spot, gpointer user_data)
@@ -805,8 +1062,55 @@ static void on_spot_submitted(ArtemisApp *app, ArtemisSpot *spot, gpointer user_
   // Update visual state on the next idle cycle to ensure all signal handlers have run
   g_idle_add((GSourceFunc)artemis_app_update_all_spot_cards_pinned_state, self);
   
-  PotaClient *client = artemis_spot_repo_get_pota_client(app->repo);
-  pota_client_post_spot_async(client, spot, NULL, spot_submitted_callback, app);
+  g_autoptr(GError) error = NULL;
+  if (!artemis_spot_outbox_enqueue(self->outbox, spot, &error)) {
+    show_spot_error(self, error->message);
+    return;
+  }
+
+  // Show it right away; the POST reply or the next refresh replaces it
+  artemis_spot_repo_add_pending(self->repo, spot);
+  spot_index_rebuild(self->spot_index, artemis_spot_repo_get_model(self->repo));
+}
+
+static void on_tune_complete(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(g_application_get_default());
+  guint frequency_khz = GPOINTER_TO_UINT(user_data);
+  g_autoptr(GError) error = NULL;
+
+  if (artemis_rig_worker_set_freq_finish(ARTEMIS_RIG_WORKER(source), result, &error)) {
+    // Success - show toast
+    g_autofree gchar *msg = g_strdup_printf("Tuned radio to %.3f MHz", frequency_khz / 1000.0f);
+    AdwToast *toast = adw_toast_new(msg);
+    adw_toast_overlay_add_toast(self->toast_overlay, toast);
+    return;
+  }
+
+  if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+    return; // superseded by a newer tune request
+  }
+
+  // Still failed after the worker's reconnect - show error dialog
+  g_autofree gchar *error_detail = g_strdup_printf("%s\n\nPlease verify your radio is responding correctly and try again.", error->message);
+  AdwAlertDialog *alert = ADW_ALERT_DIALOG(adw_alert_dialog_new("Frequency Setting Failed", error_detail));
+  adw_alert_dialog_add_response(alert, "ok", "OK");
+  adw_alert_dialog_set_default_response(alert, "ok");
+  adw_dialog_present(ADW_DIALOG(alert), GTK_WIDGET(self->window));
+}
+
+// The rig whose profile lists the band, otherwise the main radio
+static ArtemisRigWorker *artemis_app_get_rig_for_khz(ArtemisApp *self, guint64 frequency_khz)
+{
+  const char *band = band_from_hz((int)frequency_khz);
+
+  for (guint i = 0; self->extra_rigs && i < self->extra_rigs->len; i++) {
+    RigSlot *slot = g_ptr_array_index(self->extra_rigs, i);
+    if (rig_profile_is_enabled(slot->profile) && rig_profile_covers_band(slot->profile, band)) {
+      return slot->worker;
+    }
+  }
+  return self->rig_worker;
 }
 
 static void on_tune_frequency(ArtemisApp *app, guint64 frequency_khz, ArtemisSpot *spot, gpointer user_data)
@@ -826,58 +1130,20 @@ static void on_tune_frequency(ArtemisApp *app, guint64 frequency_khz, ArtemisSpo
     self->pinned_spot_hash = spot_hash;
     g_debug("Pinned spot set");
   }
+  self->vfo_pinned = FALSE;
   
   // Update visual state on the next idle cycle to ensure all signal handlers have run
   g_idle_add((GSourceFunc)artemis_app_update_all_spot_cards_pinned_state, self);
   
-  // Check if radio is connected, if not we updated the pinned state to "track" or reset and now we bail
-  if (!self->rig || !self->radio_connected) {
+  // Check if the radio for this band is connected, if not we updated the pinned state to "track" or reset and now we bail
+  ArtemisRigWorker *worker = artemis_app_get_rig_for_khz(self, frequency_khz);
+  if (!artemis_rig_worker_is_connected(worker)) {
     return;
   }
-  
-  freq_t freq_hz = (freq_t)(frequency_khz * 1000); // Convert MHz to Hz
-  int set_result = -1;
-  
-  // Additional validation before calling hamlib
-  if (!self->rig || self->rig->caps == NULL) {
-    g_warning("Rig is NULL or has invalid caps, cannot set frequency");
-    // Show error dialog
-    AdwDialog *alert = adw_alert_dialog_new(_("Radio Error"), _("Radio is not properly initialized. Please check your radio settings."));
-    adw_alert_dialog_add_response(ADW_ALERT_DIALOG(alert), "ok", _("OK"));
-    adw_alert_dialog_set_default_response(ADW_ALERT_DIALOG(alert), "ok");
-    adw_dialog_present(alert, GTK_WIDGET(self->window));
-    return;
-  }
-  
-  set_result = rig_set_freq(self->rig, RIG_VFO_CURR, freq_hz);
-  
-  if (set_result == RIG_OK) {
-    // Success - show toast
-    g_autofree gchar *msg = g_strdup_printf("Tuned radio to %.3f MHz", frequency_khz / 1000.0f);
-    AdwToast *toast = adw_toast_new(msg);
-    adw_toast_overlay_add_toast(self->toast_overlay, toast);
-  } else {
-    // Error setting frequency - try to reconnect and retry once
-    g_warning("Radio frequency setting failed: %s, attempting reconnect", rigerror(set_result));
-    artemis_app_reconnect_radio_async(self);
-    
-    if (self->rig && self->radio_connected && self->rig->caps) {
-      set_result = rig_set_freq(self->rig, RIG_VFO_CURR, freq_hz);
-      if (set_result == RIG_OK) {
-        g_autofree gchar *msg = g_strdup_printf("Tuned radio to %.3f MHz (after reconnect)", frequency_khz / 1000.0f);
-        AdwToast *toast = adw_toast_new(msg);
-        adw_toast_overlay_add_toast(self->toast_overlay, toast);
-        return;
-      }
-    }
-    
-    // Still failed - show error dialog
-    g_autofree gchar *error_detail = g_strdup_printf("Failed to set frequency: %s\n\nPlease verify your radio is responding correctly and try again.", rigerror(set_result));
-    AdwAlertDialog *alert = ADW_ALERT_DIALOG(adw_alert_dialog_new("Frequency Setting Failed", error_detail));
-    adw_alert_dialog_add_response(alert, "ok", "OK");
-    adw_alert_dialog_set_default_response(alert, "ok");
-    adw_dialog_present(ADW_DIALOG(alert), GTK_WIDGET(self->window));
-  }
+
+  // Rapid clicks collapse on the worker; only the newest request reaches the radio
+  artemis_rig_worker_set_freq_async(worker, (gdouble)frequency_khz * 1000.0, NULL,
+                                    on_tune_complete, GUINT_TO_POINTER((guint)frequency_khz));
 }
 
 static void artemis_app_class_init(ArtemisAppClass *klass)
@@ -934,22 +1200,34 @@ static void on_banner_button_clicked(AdwBanner *banner, gpointer user_data)
 {
   ArtemisApp *self = ARTEMIS_APP(user_data);
   self->spots_update_paused = !self->spots_update_paused;
+  artemis_refresh_scheduler_set_paused(self->refresh_scheduler, self->spots_update_paused);
 
   if (self->spots_update_paused)
   {
     adw_banner_set_button_label(banner, "Resume");
-    self->seconds_elapsed = 0;
   }
   else
   {
     adw_banner_set_button_label(banner, "Pause");
-    artemis_spot_repo_update_spots(self->repo, 60);
+    artemis_refresh_scheduler_refresh_now(self->refresh_scheduler);
   }
 }
 
 static void on_add_button_clicked(GtkButton *button, gpointer user_data)
 {
-  show_add_spot_page(GTK_WIDGET(gtk_widget_get_root(GTK_WIDGET(button))));
+  ArtemisApp *self = ARTEMIS_APP(g_application_get_default());
+  GtkWidget *parent = GTK_WIDGET(gtk_widget_get_root(GTK_WIDGET(button)));
+
+  // While following the dial, start from the spot the radio is tuned to
+  if (self->vfo_pinned) {
+    g_autoptr(ArtemisSpot) spot = artemis_app_get_pinned_spot(self);
+    if (spot) {
+      show_spot_page_with_spot(parent, spot);
+      return;
+    }
+  }
+
+  show_add_spot_page(parent, (gint)(self->vfo_khz + 0.5));
 }
 
 static gboolean update_time(gpointer user_data)
@@ -973,21 +1251,31 @@ static gboolean update_time(gpointer user_data)
 
   gtk_label_set_text(label, formatted);
 
-  if (!ctx->app->spots_update_paused)
-  {
-    ctx->app->seconds_elapsed += 1;
-    if (ctx->app->seconds_elapsed >= ctx->app->seconds_to_update)
-    {
-      artemis_spot_repo_update_spots(ctx->app->repo, 60);
-    }
-    ctx->app->seconds_elapsed = ctx->app->seconds_elapsed % ctx->app->seconds_to_update;
+  // Spots left over from the last run say how old they are
+  g_autoptr(GDateTime) stale_utc = NULL;
+  g_autofree char *stale_prefix = artemis_spot_repo_get_stale(ctx->app->repo, &stale_utc) && stale_utc
+    ? g_date_time_format(stale_utc, "Showing spots from %H:%M UTC. ")
+    : g_strdup("");
 
-    gtk_progress_bar_set_fraction(prog, (gfloat)ctx->app->seconds_elapsed / (gfloat)ctx->app->seconds_to_update);
+  // The scheduler owns the timing; this only draws its countdown
+  ArtemisRefreshScheduler *scheduler = ctx->app->refresh_scheduler;
+  guint remaining = 0, total = 0;
+  if (artemis_refresh_scheduler_get_countdown(scheduler, &remaining, &total))
+  {
+    gtk_progress_bar_set_fraction(prog, total > 0 ? 1.f - (gfloat)remaining / (gfloat)total : 1.f);
 
-    char *message = g_strdup_printf("Spots will refresh in %d seconds", ctx->app->seconds_to_update - ctx->app->seconds_elapsed);
+    char *message = artemis_refresh_scheduler_get_failures(scheduler) > 0
+      ? g_strdup_printf("%sRefresh failed, retrying in %u seconds", stale_prefix, remaining)
+      : g_strdup_printf("Spots will refresh in %u seconds", remaining);
     adw_banner_set_title(banner, message);
     g_free(message);
   }
+  else if (artemis_refresh_scheduler_is_in_flight(scheduler))
+  {
+    g_autofree char *message = g_strdup_printf("%sRefreshing spots…", stale_prefix);
+    gtk_progress_bar_set_fraction(prog, 1.f);
+    adw_banner_set_title(banner, message);
+  }
   else
   {
     gtk_progress_bar_set_fraction(prog, 0.f);
@@ -1030,6 +1318,26 @@ void setup_time_updater(ArtemisApp *self, GtkBuilder* builder)
       self->time_source_id = g_timeout_add_seconds_full(G_PRIORITY_DEFAULT, 1, update_time, ctx, (GDestroyNotify)g_free);
 }
 
+// Poll at full rate only while the spot list has the user's attention
+static void on_window_activity_changed(GtkWindow *window, GParamSpec *pspec, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  ArtemisRefreshActivity activity = ARTEMIS_REFRESH_BACKGROUND;
+
+  if (gtk_window_is_suspended(window))
+    activity = ARTEMIS_REFRESH_HIDDEN;
+  else if (gtk_window_is_active(window))
+    activity = ARTEMIS_REFRESH_FOCUSED;
+
+  artemis_refresh_scheduler_set_activity(self->refresh_scheduler, activity);
+}
+
+static void on_scheduled_refresh(ArtemisRefreshScheduler *scheduler, gpointer user_data)
+{
+  ArtemisApp *self = ARTEMIS_APP(user_data);
+  artemis_spot_repo_update_spots(self->repo, 60);
+}
+
 GtkWindow *artemis_app_build_ui(ArtemisApp *self, GtkApplication *app) {
   adw_init();
 
@@ -1056,7 +1364,10 @@ GtkWindow *artemis_app_build_ui(ArtemisApp *self, GtkApplication *app) {
 
   g_signal_connect(self->repo, "busy-changed",  G_CALLBACK(on_repo_busy),       self);
   g_signal_connect(self->repo, "refreshed",     G_CALLBACK(on_repo_refreshed),  self);
+  g_signal_connect(self->repo, "applied",       G_CALLBACK(on_repo_applied),    self);
+  g_signal_connect(self->repo, "unchanged",     G_CALLBACK(on_repo_unchanged),  self);
   g_signal_connect(self->repo, "error",         G_CALLBACK(on_repo_error),      self);
+  g_signal_connect(self->repo, "stale-changed", G_CALLBACK(on_repo_stale_changed), self);
 
   GtkCssProvider* provider = gtk_css_provider_new();
   gtk_css_provider_load_from_resource(provider, RESOURCE_PATH "css/style.css");
@@ -1076,6 +1387,8 @@ GtkWindow *artemis_app_build_ui(ArtemisApp *self, GtkApplication *app) {
 
   AdwViewStack *stack = ADW_VIEW_STACK(gtk_builder_get_object(builder, "band_stack"));
   g_assert(stack);
+  self->band_stack = GTK_WIDGET(stack);
+  on_repo_stale_changed(self->repo, artemis_spot_repo_get_stale(self->repo, NULL), self);
   GPtrArray *pages = NULL;
   build_band_stack(stack, self->repo, self, &pages);
   self->pages = pages;
@@ -1083,10 +1396,21 @@ GtkWindow *artemis_app_build_ui(ArtemisApp *self, GtkApplication *app) {
   setup_time_updater(self, builder);
   setup_spots_updater(self, builder);
 
+  self->outbox_button = GTK_WIDGET(gtk_builder_get_object(builder, "outbox_button"));
+  self->outbox_list = GTK_LIST_BOX(gtk_builder_get_object(builder, "outbox_list"));
+  on_outbox_changed(self->outbox, self);
+
   // Connect search entry signal manually to pass app as user_data
   GtkWidget *search_entry = GTK_WIDGET(gtk_builder_get_object(builder, "search_entry"));
   if (search_entry) {
+    self->search_entry = GTK_SEARCH_ENTRY(search_entry);
     g_signal_connect(search_entry, "search-changed", G_CALLBACK(on_search_entry_changed), self);
+    g_signal_connect(search_entry, "activate", G_CALLBACK(on_search_entry_activate), self);
+  }
+
+  GtkWidget *history_toggle = GTK_WIDGET(gtk_builder_get_object(builder, "history_toggle"));
+  if (history_toggle && search_entry) {
+    g_signal_connect(history_toggle, "toggled", G_CALLBACK(on_history_toggled), self);
   }
 
   // Connect mode dropdown signal manually to pass app as user_data
@@ -1099,13 +1423,16 @@ GtkWindow *artemis_app_build_ui(ArtemisApp *self, GtkApplication *app) {
   g_object_unref(scope);
   g_object_unref(provider);
 
-  artemis_spot_repo_update_spots(self->repo, 60);
+  g_signal_connect(win, "notify::is-active", G_CALLBACK(on_window_activity_changed), self);
+  g_signal_connect(win, "notify::suspended", G_CALLBACK(on_window_activity_changed), self);
+  artemis_refresh_scheduler_refresh_now(self->refresh_scheduler);
 
   g_signal_connect(app, "spot-submitted", G_CALLBACK(on_spot_submitted), NULL);
   g_signal_connect(app, "tune-frequency", G_CALLBACK(on_tune_frequency), self);
 
   // Initialize radio connection if configured
   artemis_app_init_radio_connection_async(self);
+  artemis_app_load_rig_profiles(self);
 
   return win;
 }
@@ -1150,10 +1477,18 @@ static void artemis_app_preferences_action(GSimpleAction *action, GVariant *para
   show_preferences_dialog(GTK_WIDGET(window));
 }
 
+static void artemis_app_stats_action(GSimpleAction *action, GVariant *parameter, gpointer user_data)
+{
+  ArtemisApp *self = user_data;
+  GtkWindow *window = gtk_application_get_active_window(GTK_APPLICATION (self));
+  show_stats_dialog(GTK_WIDGET(window));
+}
+
 static const GActionEntry app_actions[] = {
   { "quit", artemis_app_quit_action },
   { "about", artemis_app_about_action },
   {"preferences", artemis_app_preferences_action},
+  {"stats", artemis_app_stats_action},
 };
 
 static void
@@ -1164,37 +1499,38 @@ artemis_app_dispose(GObject *object) {
     g_source_remove(self->time_source_id);
     self->time_source_id = 0;
   }
+  g_clear_object(&self->refresh_scheduler);
+
+  if (self->outbox) {
+    g_object_run_dispose(G_OBJECT(self->outbox));
+    g_clear_object(&self->outbox);
+  }
+  if (self->logbook_queue) {
+    g_object_run_dispose(G_OBJECT(self->logbook_queue));
+    g_clear_object(&self->logbook_queue);
+  }
 
   // Stop radio connection monitoring
   artemis_app_stop_connection_monitoring(self);
 
-  // Cleanup radio connection with crash protection
-  if (self->rig) {
-    if (self->radio_connected) {
-      int close_result = rig_close(self->rig);
-      if (close_result != RIG_OK) {
-        g_warning("Error closing radio during cleanup: %s", rigerror(close_result));
-      }
-    }
-    
-    // Safely cleanup the rig
-    int cleanup_result = rig_cleanup(self->rig);
-    if (cleanup_result != RIG_OK) {
-      g_warning("Error during rig cleanup: %s", rigerror(cleanup_result));
-    }
-    
-    self->rig = NULL;
+  // Tell the rig threads to stop; each closes its radio before exiting
+  if (self->rig_worker) {
+    g_object_run_dispose(G_OBJECT(self->rig_worker));
+    g_clear_object(&self->rig_worker);
   }
-  self->radio_connected = FALSE;
+  g_clear_pointer(&self->extra_rigs, g_ptr_array_unref);
 
   g_clear_pointer(&self->search_text, g_free);
+  g_clear_pointer(&self->search_park_refs, g_hash_table_unref);
   g_clear_pointer(&self->current_mode_filter, g_free);
+  g_clear_pointer(&self->spot_index, spot_index_free);
 
   g_ptr_array_unref(self->pages);
   
   // Cleanup singleton instances
   spot_db_cleanup_instance();
   artemis_pota_user_cache_cleanup_instance();
+  http_session_cleanup_instance();
 
   G_OBJECT_CLASS(artemis_app_parent_class)->dispose(object);
 }
@@ -1204,24 +1540,47 @@ static void on_update_interval_changed(GSettings *s, const char *key, gpointer u
   ArtemisApp *self = ARTEMIS_APP(user_data);
   int secs = g_settings_get_int (s, "update-interval");
 
-  self->seconds_to_update = secs;
-  self->seconds_elapsed = 0;
+  artemis_refresh_scheduler_set_interval(self->refresh_scheduler, secs);
 }
 
 static void artemis_app_init(ArtemisApp* self) 
 {
   GSettings *settings = artemis_app_get_settings();
   // Database is now singleton - no need to create instance here
-  self->seconds_to_update = g_settings_get_int(settings, "update-interval");
+  self->refresh_scheduler = artemis_refresh_scheduler_new(g_settings_get_int(settings, "update-interval"));
+  g_signal_connect(self->refresh_scheduler, "refresh", G_CALLBACK(on_scheduled_refresh), self);
 
   self->repo = artemis_spot_repo_new();
+
+  self->outbox = artemis_spot_outbox_new(artemis_spot_repo_get_pota_client(self->repo));
+  g_signal_connect(self->outbox, "changed", G_CALLBACK(on_outbox_changed), self);
+  g_signal_connect(self->outbox, "posted",  G_CALLBACK(on_spot_posted),    self);
+  g_signal_connect(self->outbox, "failed",  G_CALLBACK(on_spot_failed),    self);
+
+  self->logbook_queue = logbook_queue_new();
+  g_autoptr(LogbookQrz) qrz = logbook_qrz_new();
+  logbook_queue_add_provider(self->logbook_queue, "qrz", LOGBOOK_PROVIDER(qrz));
+  g_autoptr(LogbookAdifFile) adif = logbook_adif_file_new();
+  logbook_queue_add_provider(self->logbook_queue, "adif", LOGBOOK_PROVIDER(adif));
+  g_autoptr(LogbookUdp) udp = logbook_udp_new();
+  logbook_queue_add_provider(self->logbook_queue, "udp", LOGBOOK_PROVIDER(udp));
   
   // Initialize radio monitoring fields
+  self->rig_worker = artemis_rig_worker_new();
+  self->extra_rigs = g_ptr_array_new_with_free_func((GDestroyNotify)rig_slot_free);
   self->radio_check_source_id = 0;
   self->settings_changed_handler = 0;
   
   // Initialize pinned spot
   self->pinned_spot_hash = G_MAXUINT;
+  self->spot_index = spot_index_new();
+
+  // Last run's spots, so the first frame is not empty while the first fetch runs
+  if (artemis_spot_repo_load_snapshot(self->repo))
+    spot_index_rebuild(self->spot_index, artemis_spot_repo_get_model(self->repo));
+
+  g_signal_connect(self->rig_worker, "vfo-changed", G_CALLBACK(on_vfo_changed), self);
+  on_vfo_poll_rate_changed(settings, "vfo-poll-rate", self);
 
   g_action_map_add_action_entries (G_ACTION_MAP(self),
                                   app_actions,
@@ -1244,6 +1603,10 @@ static void artemis_app_init(ArtemisApp* self)
                   G_CALLBACK(on_update_interval_changed), self);
   g_signal_connect(artemis_app_get_settings(), "changed::highlight-unhunted-parks",
                   G_CALLBACK(on_highlight_unhunted_parks_changed), self);
+  g_signal_connect(artemis_app_get_settings(), "changed::vfo-poll-rate",
+                  G_CALLBACK(on_vfo_poll_rate_changed), self);
+  g_signal_connect(artemis_app_get_settings(), "changed::rig-profiles",
+                  G_CALLBACK(on_rig_profiles_changed), self);
 }
 
 GSettings *artemis_app_get_settings()
@@ -1306,7 +1669,52 @@ ArtemisSpotRepo *artemis_app_get_spot_repo(ArtemisApp *app)
   return app->repo;
 }
 
+LogbookQueue *artemis_app_get_logbook_queue(ArtemisApp *app)
+{
+  g_return_val_if_fail(ARTEMIS_IS_APP(app), NULL);
+  return app->logbook_queue;
+}
+
 gboolean artemis_app_is_rig_connected(ArtemisApp *app)
 {
-  return app->rig && app->radio_connected;
-}
\ No newline at end of file
+  if (app->rig_worker && artemis_rig_worker_is_connected(app->rig_worker)) return TRUE;
+
+  for (guint i = 0; app->extra_rigs && i < app->extra_rigs->len; i++) {
+    RigSlot *slot = g_ptr_array_index(app->extra_rigs, i);
+    if (artemis_rig_worker_is_connected(slot->worker)) return TRUE;
+  }
+  return FALSE;
+}
+
+gboolean artemis_app_is_rig_connected_for(ArtemisApp *app, guint64 frequency_khz)
+{
+  if (!app->rig_worker) return FALSE;
+  return artemis_rig_worker_is_connected(artemis_app_get_rig_for_khz(app, frequency_khz));
+}
+
+static void add_serial_device(GPtrArray *devices, const RigConfig *config)
+{
+  if (!config || !config->device_path || !*config->device_path) return;
+  if (g_strcmp0(config->connection_type, "serial") == 0 || g_strcmp0(config->connection_type, "usb") == 0) {
+    g_ptr_array_add(devices, g_strdup(config->device_path));
+  }
+}
+
+GStrv artemis_app_dup_busy_rig_devices(ArtemisApp *app)
+{
+  g_return_val_if_fail(ARTEMIS_IS_APP(app), NULL);
+  GPtrArray *devices = g_ptr_array_new();
+
+  // The main radio is (re)opened from the current radio-* settings
+  if (app->rig_worker && artemis_rig_worker_is_connected(app->rig_worker)) {
+    g_autoptr(RigConfig) config = rig_config_new_from_settings(artemis_app_get_settings());
+    add_serial_device(devices, config);
+  }
+  for (guint i = 0; app->extra_rigs && i < app->extra_rigs->len; i++) {
+    RigSlot *slot = g_ptr_array_index(app->extra_rigs, i);
+    if (artemis_rig_worker_is_connected(slot->worker)) add_serial_device(devices, slot->profile->config);
+  }
+
+  g_ptr_array_add(devices, NULL);
+  return (GStrv)g_ptr_array_free(devices, FALSE);
+}
@@ -48,8 +48,19 @@ artemis_app_emit_tune_frequency(ArtemisApp *app, guint64 frequency_khz, ArtemisS
 
 ArtemisSpot *artemis_app_get_pinned_spot(ArtemisApp *app);
 struct _ArtemisSpotRepo *artemis_app_get_spot_repo(ArtemisApp *app);
+struct _LogbookQueue *artemis_app_get_logbook_queue(ArtemisApp *app);
 
 gboolean
 artemis_app_is_rig_connected(ArtemisApp *app);
+// Whether the radio that would be tuned to frequency_khz is connected
+gboolean
+artemis_app_is_rig_connected_for(ArtemisApp *app, guint64 frequency_khz);
+// Serial/USB ports held open by connected radios; free with g_strfreev()
+GStrv
+artemis_app_dup_busy_rig_devices(ArtemisApp *app);
+
+// Re-evaluate hunted/unhunted styling of all visible spot cards
+void
+artemis_app_refresh_hunted_state(ArtemisApp *app);
 
 G_END_DECLS
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "avatar.h"
 
+#include "http_session.h"
+
 void
 avatar_update_data_free(AvatarUpdateData *data) {
   if (data) {
@@ -48,24 +50,6 @@ on_gravatar_loaded(GObject *source, GAsyncResult *result, gpointer user_data) {
   avatar_update_data_free(data);
 }
 
-// Global session for Gravatar requests
-static SoupSession *gravatar_session = NULL;
-static SoupCache *gravatar_cache = NULL;
-
-static SoupSession *get_gravatar_session(void) {
-  if (!gravatar_session) {
-    const gchar *data_dir = g_get_user_data_dir();
-    g_autofree gchar *app_dir = g_build_filename(data_dir, "artemis", NULL);
-    g_mkdir_with_parents(app_dir, 0700);
-    g_autofree gchar *cache_path = g_build_filename(app_dir, "gravatar.cache", NULL);
-    gravatar_cache = soup_cache_new(cache_path, SOUP_CACHE_SINGLE_USER);
-
-    soup_session_add_feature(gravatar_session, SOUP_SESSION_FEATURE(gravatar_cache));
-    gravatar_session = soup_session_new();
-  }
-  return gravatar_session;
-}
-
 void
 avatar_fetch_gravatar_async(const char *gravatar_hash, AvatarUpdateData *data) {
   g_autofree gchar *gravatar_url = generate_gravatar_url(gravatar_hash);
@@ -77,7 +61,7 @@ avatar_fetch_gravatar_async(const char *gravatar_hash, AvatarUpdateData *data) {
   
   g_debug("Fetching Gravatar from: %s for callsign: %s", gravatar_url, data->callsign ? data->callsign : "NULL");
   
-  SoupSession *session = get_gravatar_session();
+  SoupSession *session = http_session_get_instance();
   SoupMessage *msg = soup_message_new("GET", gravatar_url);
   
   soup_session_send_and_read_async(session, msg, G_PRIORITY_DEFAULT, NULL,
@@ -0,0 +1,173 @@
+// csv_reader.c - Streaming RFC 4180 CSV reader
+#include "csv_reader.h"
+
+#include <string.h>
+
+#define CSV_CHUNK_SIZE (64 * 1024)
+#define CSV_EOF (-1)
+#define CSV_ERR (-2)
+
+struct _CsvReader {
+  GInputStream *stream;
+  guint8       *chunk;
+  gsize         chunk_len;
+  gsize         chunk_pos;
+  gboolean      started;
+  gboolean      eof;
+
+  GString      *row;      // field bytes, each field NUL-terminated
+  GArray       *offsets;  // gsize start offset of each field in row
+  GPtrArray    *fields;   // pointers into row, rebuilt per row
+  guint         row_number;
+};
+
+CsvReader*
+csv_reader_new(GInputStream *stream)
+{
+  g_return_val_if_fail(G_IS_INPUT_STREAM(stream), NULL);
+
+  CsvReader *reader = g_new0(CsvReader, 1);
+  reader->stream = g_object_ref(stream);
+  reader->chunk = g_malloc(CSV_CHUNK_SIZE);
+  reader->row = g_string_sized_new(256);
+  reader->offsets = g_array_sized_new(FALSE, FALSE, sizeof(gsize), 16);
+  reader->fields = g_ptr_array_sized_new(16);
+  return reader;
+}
+
+void
+csv_reader_free(CsvReader *reader)
+{
+  if (!reader) return;
+  g_clear_object(&reader->stream);
+  g_free(reader->chunk);
+  g_string_free(reader->row, TRUE);
+  g_array_unref(reader->offsets);
+  g_ptr_array_unref(reader->fields);
+  g_free(reader);
+}
+
+static gint
+csv_reader_getc(CsvReader *reader, GCancellable *cancellable, GError **error)
+{
+  if (reader->chunk_pos >= reader->chunk_len) {
+    if (reader->eof) return CSV_EOF;
+
+    gssize n = g_input_stream_read(reader->stream, reader->chunk, CSV_CHUNK_SIZE,
+                                   cancellable, error);
+    if (n < 0) return CSV_ERR;
+    if (n == 0) {
+      reader->eof = TRUE;
+      return CSV_EOF;
+    }
+
+    reader->chunk_len = (gsize)n;
+    reader->chunk_pos = 0;
+
+    // Skip a UTF-8 byte order mark at the start of the input
+    if (!reader->started) {
+      reader->started = TRUE;
+      if (n >= 3 && memcmp(reader->chunk, "\xEF\xBB\xBF", 3) == 0) {
+        reader->chunk_pos = 3;
+        return csv_reader_getc(reader, cancellable, error);
+      }
+    }
+  }
+
+  return reader->chunk[reader->chunk_pos++];
+}
+
+static void
+csv_reader_end_field(CsvReader *reader)
+{
+  g_string_append_c(reader->row, '\0');
+  gsize next = reader->row->len;
+  g_array_append_val(reader->offsets, next);
+}
+
+gboolean
+csv_reader_next_row(CsvReader *reader, GCancellable *cancellable, GError **error)
+{
+  g_return_val_if_fail(reader != NULL, FALSE);
+
+  for (;;) {
+    g_string_truncate(reader->row, 0);
+    g_array_set_size(reader->offsets, 0);
+    g_ptr_array_set_size(reader->fields, 0);
+
+    gsize start = 0;
+    g_array_append_val(reader->offsets, start);
+
+    gint c = csv_reader_getc(reader, cancellable, error);
+    if (c == CSV_EOF || c == CSV_ERR) return FALSE;
+
+    gboolean in_quotes = FALSE;
+    for (;;) {
+      if (c == CSV_ERR) return FALSE;
+
+      if (in_quotes) {
+        if (c == CSV_EOF) break; // unterminated quote; keep what we have
+        if (c == '"') {
+          c = csv_reader_getc(reader, cancellable, error);
+          if (c == '"') {
+            g_string_append_c(reader->row, '"');
+            c = csv_reader_getc(reader, cancellable, error);
+          } else {
+            in_quotes = FALSE; // reprocess c outside the quotes
+          }
+          continue;
+        }
+        g_string_append_c(reader->row, (gchar)c);
+      } else if (c == CSV_EOF || c == '\n') {
+        break;
+      } else if (c == ',') {
+        csv_reader_end_field(reader);
+      } else if (c == '"' &&
+                 reader->row->len == g_array_index(reader->offsets, gsize, reader->offsets->len - 1)) {
+        in_quotes = TRUE;
+      } else if (c != '\r') {
+        g_string_append_c(reader->row, (gchar)c);
+      }
+
+      c = csv_reader_getc(reader, cancellable, error);
+    }
+
+    // Terminate the last field
+    g_string_append_c(reader->row, '\0');
+    reader->row_number++;
+
+    for (guint i = 0; i < reader->offsets->len; i++) {
+      g_ptr_array_add(reader->fields, reader->row->str + g_array_index(reader->offsets, gsize, i));
+    }
+
+    // Skip blank lines
+    if (reader->fields->len == 1 && *(const char *)reader->fields->pdata[0] == '\0') {
+      if (c == CSV_EOF) return FALSE;
+      continue;
+    }
+
+    return TRUE;
+  }
+}
+
+guint
+csv_reader_get_n_fields(CsvReader *reader)
+{
+  g_return_val_if_fail(reader != NULL, 0);
+  return reader->fields->len;
+}
+
+const char*
+csv_reader_get_field(CsvReader *reader, guint index)
+{
+  g_return_val_if_fail(reader != NULL, "");
+  if (index >= reader->fields->len) return "";
+  return reader->fields->pdata[index];
+}
+
+guint
+csv_reader_get_row_number(CsvReader *reader)
+{
+  g_return_val_if_fail(reader != NULL, 0);
+  return reader->row_number;
+}
@@ -0,0 +1,33 @@
+// csv_reader.h - Streaming RFC 4180 CSV reader over a GInputStream
+#pragma once
+
+#include <glib.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+typedef struct _CsvReader CsvReader;
+
+CsvReader*
+csv_reader_new(GInputStream *stream);
+void
+csv_reader_free(CsvReader *reader);
+
+// Advance to the next non-blank row. Returns FALSE at end of input or on error
+// (error is set only in the latter case). Quoted fields may span lines.
+gboolean csv_reader_next_row(CsvReader *reader, GCancellable *cancellable, GError **error);
+
+// Fields of the current row. Strings are owned by the reader and only valid
+// until the next call to csv_reader_next_row(). Out-of-range fields are "".
+guint
+csv_reader_get_n_fields(CsvReader *reader);
+const char*
+csv_reader_get_field(CsvReader *reader, guint index);
+
+// 1-based number of the row most recently returned
+guint
+csv_reader_get_row_number(CsvReader *reader);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(CsvReader, csv_reader_free)
+
+G_END_DECLS
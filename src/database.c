@@ -1,50 +1,193 @@
 // database.c
 #include "database.h"
+#include "csv_reader.h"
 #include "glib.h"
 #include <sqlite3.h>
+#include <stdio.h>
+
+#define IMPORT_BATCH_SIZE 2000
+#define SPOT_DB_READER_POOL_SIZE 3
+#define SPOT_DB_SCHEMA_VERSION 4
+
+/* Amateur band for a frequency column in kHz; mirrors band_from_hz() */
+#define STAT_BAND_SQL(khz) \
+    "CASE " \
+    "WHEN " khz " >= 1800 AND " khz " < 2000 THEN '160m' " \
+    "WHEN " khz " >= 3500 AND " khz " < 4100 THEN '80m' " \
+    "WHEN " khz " >= 5250 AND " khz " < 5450 THEN '60m' " \
+    "WHEN " khz " >= 7000 AND " khz " < 7300 THEN '40m' " \
+    "WHEN " khz " >= 10100 AND " khz " < 10150 THEN '30m' " \
+    "WHEN " khz " >= 14000 AND " khz " < 14350 THEN '20m' " \
+    "WHEN " khz " >= 18068 AND " khz " < 18168 THEN '17m' " \
+    "WHEN " khz " >= 21000 AND " khz " < 21450 THEN '15m' " \
+    "WHEN " khz " >= 24890 AND " khz " < 24990 THEN '12m' " \
+    "WHEN " khz " >= 28000 AND " khz " < 29700 THEN '10m' " \
+    "WHEN " khz " >= 50000 AND " khz " < 54000 THEN '6m' " \
+    "WHEN " khz " >= 144000 AND " khz " < 148000 THEN '2m' " \
+    "ELSE 'Other' END"
+
+/* parks.location ("US-CO,US-WY") as a JSON array for json_each. Quotes and
+ * backslashes are escaped; anything still not valid JSON (e.g. control
+ * characters) is taken as one key rather than failing the statement. */
+#define STAT_LOCATION_ARRAY(loc) \
+    "'[\"' || replace(replace(replace(" loc ", '\\', '\\\\'), '\"', '\\\"'), ',', '\",\"') || '\"]'"
+#define STAT_LOCATION_JSON(loc) \
+    "(CASE WHEN json_valid(" STAT_LOCATION_ARRAY(loc) ") THEN " STAT_LOCATION_ARRAY(loc) \
+    " ELSE json_array(" loc ") END)"
+
+/* (dimension, key) pairs a QSO row contributes to; q is NEW or a table alias.
+ * Multi-state parks ("US-CO,US-WY") count towards every listed location. */
+#define STAT_KEYS_SQL(q) \
+    "SELECT 'total' AS dimension, 'all' AS key " \
+    "UNION ALL SELECT 'band', " STAT_BAND_SQL(q ".frequency_hz") " " \
+    "UNION ALL SELECT 'mode', UPPER(" q ".mode) " \
+    "UNION ALL SELECT 'day', substr(" q ".created_utc, 1, 10) " \
+    "UNION ALL SELECT 'location', trim(j.value) FROM parks p, " \
+    "  json_each(" STAT_LOCATION_JSON("p.location") ") j " \
+    "  WHERE p.reference = " q ".park_ref " \
+    "UNION ALL SELECT 'entity', dx_entity FROM parks WHERE reference = " q ".park_ref"
+
+/* Trigger body for a park whose location or entity changed (INSERT OR REPLACE
+ * arrives as an insert): move its QSOs from the old keys to the new ones */
+#define STAT_PARK_KEYS_REFRESH \
+    "  UPDATE stat_park_counts SET qso_count = qso_count - " \
+    "    (SELECT COUNT(*) FROM stat_qso_keys k WHERE k.park_ref = NEW.reference " \
+    "       AND k.dimension = stat_park_counts.dimension AND k.key = stat_park_counts.key) " \
+    "  WHERE park_ref = NEW.reference AND dimension IN ('location', 'entity'); " \
+    "  DELETE FROM stat_park_counts WHERE park_ref = NEW.reference AND qso_count <= 0; " \
+    "  DELETE FROM stat_qso_keys WHERE park_ref = NEW.reference AND dimension IN ('location', 'entity'); " \
+    "  INSERT OR IGNORE INTO stat_qso_keys(qso_id, dimension, key, park_ref) " \
+    "  SELECT q.id, 'location', trim(j.value), q.park_ref " \
+    "  FROM qsos q, json_each(" STAT_LOCATION_JSON("NEW.location") ") j " \
+    "  WHERE q.park_ref = NEW.reference AND trim(j.value) <> ''; " \
+    "  INSERT OR IGNORE INTO stat_qso_keys(qso_id, dimension, key, park_ref) " \
+    "  SELECT q.id, 'entity', NEW.dx_entity, q.park_ref FROM qsos q " \
+    "  WHERE q.park_ref = NEW.reference AND NEW.dx_entity <> ''; " \
+    "  INSERT INTO stat_park_counts(dimension, key, park_ref, qso_count) " \
+    "  SELECT dimension, key, park_ref, COUNT(*) FROM stat_qso_keys " \
+    "  WHERE park_ref = NEW.reference AND dimension IN ('location', 'entity') " \
+    "  GROUP BY dimension, key " \
+    "  ON CONFLICT(dimension, key, park_ref) DO UPDATE SET qso_count = qso_count + excluded.qso_count; "
+
+/* Borrowed read connection, returned to the pool when it goes out of scope */
+typedef struct {
+    SpotDb  *db;
+    sqlite3 *conn;
+} SpotDbReadLease;
+
+static SpotDbReadLease spot_db_read_lease(SpotDb *db)
+{
+    SpotDbReadLease lease = { db, spot_db_reader_acquire(db) };
+    return lease;
+}
+
+static void spot_db_read_lease_clear(SpotDbReadLease *lease)
+{
+    spot_db_reader_release(lease->db, lease->conn);
+}
+G_DEFINE_AUTO_CLEANUP_CLEAR_FUNC(SpotDbReadLease, spot_db_read_lease_clear)
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(SpotDb, spot_db_free)
 
 static gboolean spot_db_init_schema(sqlite3 *db);
 static gboolean sqlite_exec_or_fail(sqlite3 *db, const char *sql);
+static gboolean rebuild_stats(sqlite3 *db, GError **error);
+static gboolean add_column_if_missing(sqlite3 *db, const char *table, const char *column, const char *decl);
 
 // Singleton instance
 static SpotDb *g_spot_db_instance = NULL;
 static GMutex g_spot_db_mutex;
 
+/* ----------------- connection pool ----------------- */
+static sqlite3* open_reader(const char *path)
+{
+    sqlite3 *conn = NULL;
+    int rc = sqlite3_open_v2(path, &conn, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, NULL);
+    if (rc != SQLITE_OK) {
+        g_warning("Cannot open read connection to %s: %s", path, conn ? sqlite3_errmsg(conn) : "out of memory");
+        if (conn) sqlite3_close(conn);
+        return NULL;
+    }
+    sqlite3_busy_timeout(conn, 3000);
+    return conn;
+}
+
+sqlite3* spot_db_reader_acquire(SpotDb *db)
+{
+    g_return_val_if_fail(db, NULL);
+
+    sqlite3 *conn = g_async_queue_try_pop(db->readers);
+    if (conn) return conn;
+
+    // Pool exhausted: never make the caller wait behind long-running readers
+    conn = open_reader(db->path);
+    if (conn) return conn;
+
+    // Last resort is the writer, which may only be used under the write lock;
+    // released again in spot_db_reader_release()
+    g_mutex_lock(&db->write_lock);
+    return db->spot_db;
+}
+
+void spot_db_reader_release(SpotDb *db, sqlite3 *conn)
+{
+    g_return_if_fail(db);
+    if (!conn) return;
+    if (conn == db->spot_db) {
+        g_mutex_unlock(&db->write_lock);
+        return;
+    }
+
+    if (g_async_queue_length(db->readers) < SPOT_DB_READER_POOL_SIZE) {
+        g_async_queue_push(db->readers, conn);
+    } else {
+        sqlite3_close(conn);
+    }
+}
+
 SpotDb* spot_db_new(void)
 {
     SpotDb* db = g_new0(SpotDb, 1);
+    g_mutex_init(&db->write_lock);
+    db->readers = g_async_queue_new();
 
     const gchar *data_dir = g_get_user_data_dir();
     g_autofree gchar *app_dir = g_build_filename(data_dir, "artemis", NULL);
     g_mkdir_with_parents(app_dir, 0700);
 
     g_autofree gchar *db_path = g_build_filename(app_dir, "spots.db", NULL);
+    db->path = g_strdup(db_path);
 
     int rc = sqlite3_open(db_path, &db->spot_db);
     if (rc != SQLITE_OK) {
         g_critical("Cannot open DB at %s: %s", db_path, sqlite3_errmsg(db->spot_db));
-        if (db->spot_db) sqlite3_close(db->spot_db);
-        g_free(db);
+        spot_db_free(db);
         return NULL;
     }
 
-    if (!sqlite_exec_or_fail(db->spot_db, "PRAGMA journal_mode=WAL;") ||
+    // Only takes effect on a brand-new file (before the first table), so
+    // archive pruning can hand pages back. Older databases keep their mode
+    // until compacted with VACUUM; rewriting them here would stall startup.
+    if (!sqlite_exec_or_fail(db->spot_db, "PRAGMA auto_vacuum = INCREMENTAL;") ||
+        !sqlite_exec_or_fail(db->spot_db, "PRAGMA journal_mode=WAL;") ||
         !sqlite_exec_or_fail(db->spot_db, "PRAGMA synchronous=NORMAL;") ||
         !sqlite_exec_or_fail(db->spot_db, "PRAGMA foreign_keys=ON;")) {
-        sqlite3_close(db->spot_db);
-        g_free(db);
+        spot_db_free(db);
         return NULL;
     }
     sqlite3_busy_timeout(db->spot_db, 3000);
 
     if (!spot_db_init_schema(db->spot_db)) {
-        sqlite3_close(db->spot_db);
-        g_free(db);
+        spot_db_free(db);
         return NULL;
     }
 
+    // Readers are opened after the schema exists; read-only connections cannot create it
+    for (guint i = 0; i < SPOT_DB_READER_POOL_SIZE; i++) {
+        sqlite3 *conn = open_reader(db_path);
+        if (conn) g_async_queue_push(db->readers, conn);
+    }
+
     g_message("DB opened: %s", db_path);
     return db;
 }
@@ -52,7 +195,14 @@ SpotDb* spot_db_new(void)
 void spot_db_free(SpotDb* db)
 {
     if (!db) return;
+    if (db->readers) {
+        sqlite3 *conn;
+        while ((conn = g_async_queue_try_pop(db->readers))) sqlite3_close(conn);
+        g_async_queue_unref(db->readers);
+    }
     if (db->spot_db) { sqlite3_close(db->spot_db); db->spot_db = NULL; }
+    g_mutex_clear(&db->write_lock);
+    g_free(db->path);
     g_free(db);
 }
 
@@ -106,17 +256,296 @@ static gboolean spot_db_init_schema(sqlite3 *db)
         "    SET qso_count = CASE WHEN qso_count > 0 THEN qso_count - 1 ELSE 0 END, "
         "        first_qso_date = (SELECT MIN(created_utc) FROM qsos WHERE park_ref = OLD.park_ref) "
         "  WHERE reference = OLD.park_ref; "
-        "END;"
+        "END;",
+
+        // Hunting statistics, maintained incrementally alongside parks.qso_count.
+        // stat_park_counts holds QSOs per (dimension, key, park); stat_totals
+        // rolls that up into QSO and distinct-park counts per (dimension, key).
+        "CREATE TABLE IF NOT EXISTS stat_totals ("
+        "  dimension  TEXT NOT NULL,"
+        "  key        TEXT NOT NULL,"
+        "  qso_count  INTEGER NOT NULL DEFAULT 0,"
+        "  park_count INTEGER NOT NULL DEFAULT 0,"
+        "  PRIMARY KEY(dimension, key)"
+        ") WITHOUT ROWID;",
+
+        "CREATE TABLE IF NOT EXISTS stat_park_counts ("
+        "  dimension TEXT NOT NULL,"
+        "  key       TEXT NOT NULL,"
+        "  park_ref  TEXT NOT NULL,"
+        "  qso_count INTEGER NOT NULL DEFAULT 0,"
+        "  PRIMARY KEY(dimension, key, park_ref)"
+        ") WITHOUT ROWID;",
+
+        "CREATE INDEX IF NOT EXISTS idx_stat_park_counts_park ON stat_park_counts(park_ref);",
+
+        // The keys each QSO was counted under, so a delete takes back exactly
+        // those even if the park's location or entity changed in between
+        "CREATE TABLE IF NOT EXISTS stat_qso_keys ("
+        "  qso_id    INTEGER NOT NULL,"
+        "  dimension TEXT NOT NULL,"
+        "  key       TEXT NOT NULL,"
+        "  park_ref  TEXT NOT NULL,"
+        "  PRIMARY KEY(qso_id, dimension, key)"
+        ") WITHOUT ROWID;",
+
+        "CREATE INDEX IF NOT EXISTS idx_stat_qso_keys_park ON stat_qso_keys(park_ref, dimension);",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_stat_park_counts_ai "
+        "AFTER INSERT ON stat_park_counts "
+        "FOR EACH ROW BEGIN "
+        "  INSERT INTO stat_totals(dimension, key, qso_count, park_count) "
+        "    VALUES(NEW.dimension, NEW.key, NEW.qso_count, 1) "
+        "  ON CONFLICT(dimension, key) DO UPDATE SET "
+        "    qso_count = qso_count + excluded.qso_count, park_count = park_count + 1; "
+        "END;",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_stat_park_counts_au "
+        "AFTER UPDATE OF qso_count ON stat_park_counts "
+        "FOR EACH ROW BEGIN "
+        "  UPDATE stat_totals SET qso_count = qso_count + (NEW.qso_count - OLD.qso_count) "
+        "  WHERE dimension = NEW.dimension AND key = NEW.key; "
+        "END;",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_stat_park_counts_ad "
+        "AFTER DELETE ON stat_park_counts "
+        "FOR EACH ROW BEGIN "
+        "  UPDATE stat_totals SET qso_count = qso_count - OLD.qso_count, park_count = park_count - 1 "
+        "  WHERE dimension = OLD.dimension AND key = OLD.key; "
+        "  DELETE FROM stat_totals WHERE dimension = OLD.dimension AND key = OLD.key AND park_count <= 0; "
+        "END;",
+
+        // Superseded by the stat_qso_keys triggers below
+        "DROP TRIGGER IF EXISTS trg_qsos_stats_ai;",
+        "DROP TRIGGER IF EXISTS trg_qsos_stats_ad;",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_qsos_stat_keys_ai "
+        "AFTER INSERT ON qsos "
+        "FOR EACH ROW WHEN NEW.park_ref IS NOT NULL BEGIN "
+        "  INSERT OR IGNORE INTO stat_qso_keys(qso_id, dimension, key, park_ref) "
+        "  SELECT NEW.id, dimension, key, NEW.park_ref FROM (" STAT_KEYS_SQL("NEW") ") "
+        "  WHERE key IS NOT NULL AND key <> ''; "
+        "  INSERT INTO stat_park_counts(dimension, key, park_ref, qso_count) "
+        "  SELECT dimension, key, park_ref, 1 FROM stat_qso_keys WHERE qso_id = NEW.id "
+        "  ON CONFLICT(dimension, key, park_ref) DO UPDATE SET qso_count = qso_count + 1; "
+        "END;",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_qsos_stat_keys_ad "
+        "AFTER DELETE ON qsos "
+        "FOR EACH ROW BEGIN "
+        "  UPDATE stat_park_counts SET qso_count = qso_count - 1 "
+        "  WHERE (dimension, key, park_ref) IN "
+        "    (SELECT dimension, key, park_ref FROM stat_qso_keys WHERE qso_id = OLD.id); "
+        "  DELETE FROM stat_park_counts WHERE park_ref = OLD.park_ref AND qso_count <= 0; "
+        "  DELETE FROM stat_qso_keys WHERE qso_id = OLD.id; "
+        "END;",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_parks_stat_keys_ai "
+        "AFTER INSERT ON parks "
+        "FOR EACH ROW BEGIN " STAT_PARK_KEYS_REFRESH "END;",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_parks_stat_keys_au "
+        "AFTER UPDATE OF location, dx_entity ON parks "
+        "FOR EACH ROW WHEN NEW.location IS NOT OLD.location OR NEW.dx_entity IS NOT OLD.dx_entity BEGIN "
+        STAT_PARK_KEYS_REFRESH "END;",
+
+        // Spot archive: one row per refresh, plus the changes relative to the
+        // previous refresh. spot_archive_live mirrors the last archived snapshot.
+        "CREATE TABLE IF NOT EXISTS spot_archive_snapshots ("
+        "  id INTEGER PRIMARY KEY,"
+        "  fetched_utc DATETIME NOT NULL,"
+        "  n_spots   INTEGER NOT NULL DEFAULT 0,"
+        "  n_changes INTEGER NOT NULL DEFAULT 0"
+        ");",
+
+        "CREATE INDEX IF NOT EXISTS idx_spot_archive_snapshots_fetched ON spot_archive_snapshots(fetched_utc);",
+
+        "CREATE TABLE IF NOT EXISTS spot_archive_events ("
+        "  id INTEGER PRIMARY KEY,"
+        "  snapshot_id INTEGER NOT NULL,"
+        "  spot_id   INTEGER NOT NULL,"
+        "  kind      INTEGER NOT NULL,"   // SpotArchiveChange
+        "  activator TEXT,"
+        "  park_ref  TEXT,"
+        "  park_name TEXT,"
+        "  location_desc TEXT,"
+        "  frequency_khz INTEGER,"
+        "  mode      TEXT,"
+        "  spot_time DATETIME,"
+        "  spotter   TEXT,"
+        "  comments  TEXT,"
+        "  spot_count INTEGER,"
+        "  activator_comment TEXT"
+        ");",
+
+        "CREATE INDEX IF NOT EXISTS idx_spot_archive_events_snapshot ON spot_archive_events(snapshot_id);",
+        "CREATE INDEX IF NOT EXISTS idx_spot_archive_events_spot ON spot_archive_events(spot_id, snapshot_id);",
+        "CREATE INDEX IF NOT EXISTS idx_spot_archive_events_park ON spot_archive_events(park_ref COLLATE NOCASE, spot_time);",
+        "CREATE INDEX IF NOT EXISTS idx_spot_archive_events_activator ON spot_archive_events(activator COLLATE NOCASE, spot_time);",
+        "CREATE INDEX IF NOT EXISTS idx_spot_archive_events_time ON spot_archive_events(spot_time);",
+
+        // Comment search over archived spots; removals carry no text and are skipped
+        "CREATE VIRTUAL TABLE IF NOT EXISTS spot_archive_fts USING fts5("
+        "  activator, park_ref, park_name, location_desc, comments, activator_comment,"
+        "  content='spot_archive_events', content_rowid='id',"
+        "  tokenize='unicode61 remove_diacritics 2'"
+        ");",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_spot_archive_fts_ai "
+        "AFTER INSERT ON spot_archive_events WHEN NEW.kind <> 2 BEGIN "
+        "  INSERT INTO spot_archive_fts(rowid, activator, park_ref, park_name, location_desc, comments, activator_comment) "
+        "  VALUES (NEW.id, NEW.activator, NEW.park_ref, NEW.park_name, NEW.location_desc, NEW.comments, NEW.activator_comment); "
+        "END;",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_spot_archive_fts_ad "
+        "AFTER DELETE ON spot_archive_events WHEN OLD.kind <> 2 BEGIN "
+        "  INSERT INTO spot_archive_fts(spot_archive_fts, rowid, activator, park_ref, park_name, location_desc, comments, activator_comment) "
+        "  VALUES ('delete', OLD.id, OLD.activator, OLD.park_ref, OLD.park_name, OLD.location_desc, OLD.comments, OLD.activator_comment); "
+        "END;",
+
+        "CREATE TABLE IF NOT EXISTS spot_archive_live ("
+        "  spot_id INTEGER PRIMARY KEY,"
+        "  fingerprint INTEGER NOT NULL"
+        ");",
+
+        "CREATE TABLE IF NOT EXISTS park_catalog ("
+        "  id INTEGER PRIMARY KEY,"
+        "  reference TEXT NOT NULL UNIQUE COLLATE NOCASE,"
+        "  name      TEXT,"
+        "  location  TEXT,"
+        "  grid      TEXT,"
+        "  latitude  REAL,"
+        "  longitude REAL,"
+        "  active    INTEGER NOT NULL DEFAULT 1,"
+        "  import_id INTEGER NOT NULL DEFAULT 0"   // catalog import that last wrote the row
+        ");",
+
+        // External-content index; rebuilt after each catalog import
+        "CREATE VIRTUAL TABLE IF NOT EXISTS park_catalog_fts USING fts5("
+        "  reference, name, location,"
+        "  content='park_catalog', content_rowid='id',"
+        "  tokenize='unicode61 remove_diacritics 2'"
+        ");",
+
+        // Spots waiting to be posted; rows are kept a while after sending for the UI
+        "CREATE TABLE IF NOT EXISTS spot_outbox ("
+        "  id INTEGER PRIMARY KEY,"
+        "  dedup_key TEXT NOT NULL,"
+        "  activator TEXT NOT NULL,"
+        "  park_ref  TEXT NOT NULL,"
+        "  frequency_khz INTEGER NOT NULL,"
+        "  mode      TEXT,"
+        "  spotter   TEXT NOT NULL,"
+        "  comments  TEXT,"
+        "  created_utc DATETIME NOT NULL,"
+        "  state     INTEGER NOT NULL DEFAULT 0,"   // SpotOutboxState
+        "  attempts  INTEGER NOT NULL DEFAULT 0,"
+        "  next_attempt INTEGER NOT NULL DEFAULT 0," // unix seconds
+        "  unconfirmed INTEGER NOT NULL DEFAULT 0,"
+        "  last_error TEXT,"
+        "  updated   INTEGER NOT NULL DEFAULT (strftime('%s','now'))"
+        ");",
+
+        // The same spot can only be waiting once
+        "CREATE UNIQUE INDEX IF NOT EXISTS idx_spot_outbox_dedup ON spot_outbox(dedup_key) WHERE state IN (0, 1);",
+
+        // QSOs waiting for (or done with) upload to a logbook provider; one row per provider
+        "CREATE TABLE IF NOT EXISTS logbook_queue ("
+        "  id INTEGER PRIMARY KEY,"
+        "  provider  TEXT NOT NULL,"
+        "  uid       TEXT NOT NULL,"                // idempotency key of the QSO
+        "  callsign  TEXT NOT NULL,"
+        "  park_ref  TEXT,"
+        "  mode      TEXT,"
+        "  frequency_khz INTEGER,"
+        "  qso_utc   DATETIME NOT NULL,"
+        "  rst_sent  TEXT,"
+        "  rst_rcvd  TEXT,"
+        "  comment   TEXT,"
+        "  state     INTEGER NOT NULL DEFAULT 0,"   // LogbookQueueState
+        "  attempts  INTEGER NOT NULL DEFAULT 0,"
+        "  next_attempt INTEGER NOT NULL DEFAULT 0," // unix seconds
+        "  last_error TEXT,"
+        "  log_id    TEXT,"                         // the provider's id once uploaded
+        "  updated   INTEGER NOT NULL DEFAULT (strftime('%s','now')),"
+        "  UNIQUE(provider, uid)"
+        ");",
+
+        "CREATE INDEX IF NOT EXISTS idx_logbook_queue_due ON logbook_queue(provider, state, next_attempt);"
     };
 
+    // Columns added after a table first shipped; must exist before the
+    // triggers and indexes below refer to them
+    if (!add_column_if_missing(db, "spot_archive_events", "activator_comment", "TEXT")) {
+        return FALSE;
+    }
+    if (!add_column_if_missing(db, "park_catalog", "import_id", "INTEGER NOT NULL DEFAULT 0")) {
+        return FALSE;
+    }
+
     for (gsize i = 0; i < G_N_ELEMENTS(schema); ++i) {
         if (!sqlite_exec_or_fail(db, schema[i])) {
             return FALSE;
         }
     }
+
+    // Migrations for databases created by older versions
+    sqlite3_stmt *st = NULL;
+    int version = 0;
+    if (sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &st, NULL) == SQLITE_OK &&
+        sqlite3_step(st) == SQLITE_ROW) {
+        version = sqlite3_column_int(st, 0);
+    }
+    sqlite3_finalize(st);
+
+    if (version < 4) {
+        // 1: stats tables introduced; seed them from the existing log
+        // 4: stat_qso_keys records what each QSO was counted under
+        GError *error = NULL;
+        if (!rebuild_stats(db, &error)) {
+            g_critical("Failed to build statistics: %s", error->message);
+            g_clear_error(&error);
+            return FALSE;
+        }
+    }
+
+    // 3: comment search; index whatever the archive already holds
+    if (version < 3 &&
+        !sqlite_exec_or_fail(db, "INSERT INTO spot_archive_fts(spot_archive_fts) VALUES('rebuild');")) {
+        return FALSE;
+    }
+
+    if (version < SPOT_DB_SCHEMA_VERSION) {
+        g_autofree gchar *sql = g_strdup_printf("PRAGMA user_version = %d;", SPOT_DB_SCHEMA_VERSION);
+        if (!sqlite_exec_or_fail(db, sql)) return FALSE;
+    }
     return TRUE;
 }
 
+// ALTER TABLE for a column introduced after the table shipped. A table that
+// does not exist yet is left alone; its CREATE statement has the column.
+static gboolean add_column_if_missing(sqlite3 *db, const char *table, const char *column, const char *decl)
+{
+    g_autofree gchar *info = g_strdup_printf("PRAGMA table_info(%s);", table);
+    sqlite3_stmt *st = NULL;
+    gboolean table_exists = FALSE, found = FALSE;
+
+    if (sqlite3_prepare_v2(db, info, -1, &st, NULL) != SQLITE_OK) {
+        g_critical("table_info(%s): %s", table, sqlite3_errmsg(db));
+        return FALSE;
+    }
+    while (sqlite3_step(st) == SQLITE_ROW) {
+        table_exists = TRUE;
+        if (g_ascii_strcasecmp((const char*)sqlite3_column_text(st, 1), column) == 0) found = TRUE;
+    }
+    sqlite3_finalize(st);
+
+    if (!table_exists || found) return TRUE;
+
+    g_autofree gchar *alter = g_strdup_printf("ALTER TABLE %s ADD COLUMN %s %s;", table, column, decl);
+    return sqlite_exec_or_fail(db, alter);
+}
+
 // helper: format a borrowed GDateTime* as ISO8601 Z (allocates; caller frees)
 static gchar *iso8601_from_borrowed_utc(GDateTime *dt) {
   if (!dt) return NULL;
@@ -129,6 +558,8 @@ gboolean spot_db_add_qso_from_spot(SpotDb *db, ArtemisSpot *spot,
                                    sqlite3_int64 *out_qso_id, GError **error) {
   g_return_val_if_fail(db && db->spot_db && spot, FALSE);
 
+  g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+
   // Borrowed pointers from ArtemisSpot (do not free)
   const char *callsign          = artemis_spot_get_callsign(spot);
   const char *park_ref          = artemis_spot_get_park_ref(spot);
@@ -238,6 +669,8 @@ gboolean spot_db_add_park(SpotDb *db, const char *reference, const char *park_na
                           gint qso_count, GError **error) {
   g_return_val_if_fail(db && db->spot_db && reference && *reference, FALSE);
 
+  g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+
   const char *sql = 
     "INSERT OR REPLACE INTO parks(reference, park_name, dx_entity, location, hasc, qso_count) "
     "VALUES(?, ?, ?, ?, ?, ?);";
@@ -271,12 +704,15 @@ gboolean
 spot_db_is_park_hunted(SpotDb *db, const char *park_reference) {
   g_return_val_if_fail(db && db->spot_db && park_reference && *park_reference, FALSE);
 
+  g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+  sqlite3 *conn = lease.conn;
+
   const char *sql = "SELECT qso_count FROM parks WHERE reference = ? AND qso_count > 0;";
 
   sqlite3_stmt *st = NULL;
-  int rc = sqlite3_prepare_v2(db->spot_db, sql, -1, &st, NULL);
+  int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
   if (rc != SQLITE_OK) {
-    g_warning("Failed to prepare park hunt check: %s", sqlite3_errmsg(db->spot_db));
+    g_warning("Failed to prepare park hunt check: %s", sqlite3_errmsg(conn));
     return FALSE;
   }
 
@@ -350,6 +786,9 @@ GPtrArray* spot_db_latest_qso_per_park(SpotDb *db, GError **error)
 {
     g_return_val_if_fail(db && db->spot_db, NULL);
 
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
     const char *sql =
         "SELECT q.id, q.park_ref, q.callsign, q.mode, q.frequency_hz, "
         "       q.created_utc, q.spotter, q.spotter_comment, q.activator_comment "
@@ -359,9 +798,9 @@ GPtrArray* spot_db_latest_qso_per_park(SpotDb *db, GError **error)
         "ORDER BY q.created_utc DESC;";
 
     sqlite3_stmt *st = NULL;
-    int rc = sqlite3_prepare_v2(db->spot_db, sql, -1, &st, NULL);
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
     if (rc != SQLITE_OK) {
-        g_set_error(error, G_IO_ERROR, rc, "prepare latest_qso_per_park: %s", sqlite3_errmsg(db->spot_db));
+        g_set_error(error, G_IO_ERROR, rc, "prepare latest_qso_per_park: %s", sqlite3_errmsg(conn));
         return NULL;
     }
 
@@ -371,7 +810,7 @@ GPtrArray* spot_db_latest_qso_per_park(SpotDb *db, GError **error)
     }
 
     if (rc != SQLITE_DONE) {
-        g_set_error(error, G_IO_ERROR, rc, "step latest_qso_per_park: %s", sqlite3_errmsg(db->spot_db));
+        g_set_error(error, G_IO_ERROR, rc, "step latest_qso_per_park: %s", sqlite3_errmsg(conn));
         sqlite3_finalize(st);
         qso_row_array_free(rows);
         return NULL;
@@ -385,6 +824,9 @@ GPtrArray* spot_db_latest_qso_per_park(SpotDb *db, GError **error)
 GPtrArray* spot_db_latest_qsos(SpotDb *db, int limit, GError **error)
 {
     g_return_val_if_fail(db && db->spot_db, NULL);
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
     if (limit <= 0) limit = 50;
 
     const char *sql =
@@ -395,9 +837,9 @@ GPtrArray* spot_db_latest_qsos(SpotDb *db, int limit, GError **error)
         "LIMIT ?;";
 
     sqlite3_stmt *st = NULL;
-    int rc = sqlite3_prepare_v2(db->spot_db, sql, -1, &st, NULL);
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
     if (rc != SQLITE_OK) {
-        g_set_error(error, G_IO_ERROR, rc, "prepare latest_qsos: %s", sqlite3_errmsg(db->spot_db));
+        g_set_error(error, G_IO_ERROR, rc, "prepare latest_qsos: %s", sqlite3_errmsg(conn));
         return NULL;
     }
     sqlite3_bind_int(st, 1, limit);
@@ -408,7 +850,7 @@ GPtrArray* spot_db_latest_qsos(SpotDb *db, int limit, GError **error)
     }
 
     if (rc != SQLITE_DONE) {
-        g_set_error(error, G_IO_ERROR, rc, "step latest_qsos: %s", sqlite3_errmsg(db->spot_db));
+        g_set_error(error, G_IO_ERROR, rc, "step latest_qsos: %s", sqlite3_errmsg(conn));
         sqlite3_finalize(st);
         qso_row_array_free(rows);
         return NULL;
@@ -423,6 +865,9 @@ QsoRow* spot_db_latest_qso_for_park(SpotDb *db, const char *park_ref, GError **e
 {
     g_return_val_if_fail(db && db->spot_db && park_ref, NULL);
 
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
     const char *sql =
         "SELECT id, park_ref, callsign, mode, frequency_hz, created_utc, "
         "       spotter, spotter_comment, activator_comment "
@@ -432,9 +877,9 @@ QsoRow* spot_db_latest_qso_for_park(SpotDb *db, const char *park_ref, GError **e
         "LIMIT 1;";
 
     sqlite3_stmt *st = NULL;
-    int rc = sqlite3_prepare_v2(db->spot_db, sql, -1, &st, NULL);
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
     if (rc != SQLITE_OK) {
-        g_set_error(error, G_IO_ERROR, rc, "prepare latest_qso_for_park: %s", sqlite3_errmsg(db->spot_db));
+        g_set_error(error, G_IO_ERROR, rc, "prepare latest_qso_for_park: %s", sqlite3_errmsg(conn));
         return NULL;
     }
     sqlite3_bind_text(st, 1, park_ref, -1, SQLITE_TRANSIENT);
@@ -448,7 +893,7 @@ QsoRow* spot_db_latest_qso_for_park(SpotDb *db, const char *park_ref, GError **e
 
     if (rc != SQLITE_DONE) {
         g_clear_pointer(&row, qso_row_free);
-        g_set_error(error, G_IO_ERROR, rc, "step latest_qso_for_park: %s", sqlite3_errmsg(db->spot_db));
+        g_set_error(error, G_IO_ERROR, rc, "step latest_qso_for_park: %s", sqlite3_errmsg(conn));
         sqlite3_finalize(st);
         return NULL;
     }
@@ -465,6 +910,9 @@ gboolean spot_db_had_qso_with_park_on_utc_day(SpotDb *db,
 {
     g_return_val_if_fail(db && db->spot_db && park_ref && utc_when_in_day, FALSE);
 
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
     // Ensure it’s UTC
     g_autoptr(GDateTime) utc = g_date_time_to_utc(utc_when_in_day);
     g_autofree gchar *start_iso = iso8601_day_start(utc);
@@ -477,9 +925,9 @@ gboolean spot_db_had_qso_with_park_on_utc_day(SpotDb *db,
         ");";
 
     sqlite3_stmt *st = NULL;
-    int rc = sqlite3_prepare_v2(db->spot_db, sql, -1, &st, NULL);
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
     if (rc != SQLITE_OK) {
-        g_set_error(error, G_IO_ERROR, rc, "prepare had_qso_on_day: %s", sqlite3_errmsg(db->spot_db));
+        g_set_error(error, G_IO_ERROR, rc, "prepare had_qso_on_day: %s", sqlite3_errmsg(conn));
         return FALSE;
     }
 
@@ -495,7 +943,7 @@ gboolean spot_db_had_qso_with_park_on_utc_day(SpotDb *db,
     }
 
     if (rc != SQLITE_DONE) {
-        g_set_error(error, G_IO_ERROR, rc, "step had_qso_on_day: %s", sqlite3_errmsg(db->spot_db));
+        g_set_error(error, G_IO_ERROR, rc, "step had_qso_on_day: %s", sqlite3_errmsg(conn));
         sqlite3_finalize(st);
         return FALSE;
     }
@@ -504,6 +952,1672 @@ gboolean spot_db_had_qso_with_park_on_utc_day(SpotDb *db,
     return exists;
 }
 
+/* ----------------- 4) Streaming iteration over qsos ----------------- */
+static void bind_text_or_null(sqlite3_stmt *st, int idx, const char *value)
+{
+    if (value && *value) sqlite3_bind_text(st, idx, value, -1, SQLITE_TRANSIENT);
+    else                 sqlite3_bind_null(st, idx);
+}
+
+/* Escape LIKE wildcards in a prefix and append '%' (caller frees) */
+static gchar* like_prefix_pattern(const char *prefix)
+{
+    GString *pat = g_string_sized_new(strlen(prefix) + 2);
+    for (const char *p = prefix; *p; ++p) {
+        if (*p == '%' || *p == '_' || *p == '\\') g_string_append_c(pat, '\\');
+        g_string_append_c(pat, *p);
+    }
+    g_string_append_c(pat, '%');
+    return g_string_free(pat, FALSE);
+}
+
+#define COL_TEXT_OR_NULL(st, i) \
+    (sqlite3_column_type((st), (i)) == SQLITE_NULL ? NULL : (gchar*)sqlite3_column_text((st), (i)))
+
+gboolean spot_db_foreach_qso(SpotDb *db,
+                             const QsoFilter *filter,
+                             GCancellable *cancellable,
+                             QsoRowFunc func,
+                             gpointer user_data,
+                             GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && func, FALSE);
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
+    const char *sql =
+        "SELECT id, park_ref, callsign, mode, frequency_hz, created_utc, "
+        "       spotter, spotter_comment, activator_comment "
+        "FROM qsos "
+        "WHERE (?1 IS NULL OR created_utc >= ?1) "
+        "  AND (?2 IS NULL OR created_utc <  ?2) "
+        "  AND (?3 IS NULL OR park_ref LIKE ?3 ESCAPE '\\') "
+        "  AND (?4 IS NULL OR mode = ?4 COLLATE NOCASE) "
+        "ORDER BY created_utc;";
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare foreach_qso: %s", sqlite3_errmsg(conn));
+        return FALSE;
+    }
+
+    if (filter) {
+        bind_text_or_null(st, 1, filter->from_utc);
+        bind_text_or_null(st, 2, filter->to_utc);
+        if (filter->park_prefix && *filter->park_prefix) {
+            g_autofree gchar *pattern = like_prefix_pattern(filter->park_prefix);
+            sqlite3_bind_text(st, 3, pattern, -1, SQLITE_TRANSIENT);
+        }
+        bind_text_or_null(st, 4, filter->mode);
+    }
+
+    guint n = 0;
+    while ((rc = sqlite3_step(st)) == SQLITE_ROW) {
+        // Check for cancellation periodically rather than on every row
+        if ((++n & 0xff) == 0 && g_cancellable_set_error_if_cancelled(cancellable, error)) {
+            sqlite3_finalize(st);
+            return FALSE;
+        }
+
+        QsoRow row = {
+            .id                = sqlite3_column_int64(st, 0),
+            .park_ref          = (gchar*)sqlite3_column_text(st, 1),
+            .callsign          = (gchar*)sqlite3_column_text(st, 2),
+            .mode              = COL_TEXT_OR_NULL(st, 3),
+            .frequency_hz      = sqlite3_column_type(st, 4)==SQLITE_NULL ? 0 : sqlite3_column_int(st, 4),
+            .created_utc       = (gchar*)sqlite3_column_text(st, 5),
+            .spotter           = COL_TEXT_OR_NULL(st, 6),
+            .spotter_comment   = COL_TEXT_OR_NULL(st, 7),
+            .activator_comment = COL_TEXT_OR_NULL(st, 8),
+        };
+
+        if (!func(&row, user_data, error)) {
+            sqlite3_finalize(st);
+            return FALSE;
+        }
+    }
+
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "step foreach_qso: %s", sqlite3_errmsg(conn));
+        sqlite3_finalize(st);
+        return FALSE;
+    }
+
+    sqlite3_finalize(st);
+    return TRUE;
+}
+
+/* ----------------- 5) Hunted parks CSV import ----------------- */
+enum {
+    HUNTED_COL_DX_ENTITY,
+    HUNTED_COL_LOCATION,
+    HUNTED_COL_HASC,
+    HUNTED_COL_REFERENCE,
+    HUNTED_COL_PARK_NAME,
+    HUNTED_COL_FIRST_QSO_DATE,
+    HUNTED_COL_QSOS,
+    HUNTED_N_COLS
+};
+
+static const char *const HUNTED_COL_NAMES[HUNTED_N_COLS] = {
+    "DX Entity", "Location", "HASC", "Reference", "Park Name", "First QSO Date", "QSOs"
+};
+
+/* Map header names to column indices; falls back to the pota.app column order */
+static void hunted_columns_from_header(CsvReader *reader, gint cols[HUNTED_N_COLS])
+{
+    gboolean found_reference = FALSE;
+    for (gint c = 0; c < HUNTED_N_COLS; ++c) cols[c] = -1;
+
+    for (guint i = 0; i < csv_reader_get_n_fields(reader); ++i) {
+        g_autofree gchar *name = g_strstrip(g_strdup(csv_reader_get_field(reader, i)));
+        for (gint c = 0; c < HUNTED_N_COLS; ++c) {
+            if (g_ascii_strcasecmp(name, HUNTED_COL_NAMES[c]) == 0) {
+                cols[c] = (gint)i;
+                if (c == HUNTED_COL_REFERENCE) found_reference = TRUE;
+            }
+        }
+    }
+
+    if (!found_reference) {
+        for (gint c = 0; c < HUNTED_N_COLS; ++c) cols[c] = c;
+    }
+}
+
+static gboolean exec_or_set_error(sqlite3 *db, const char *sql, GError **error)
+{
+    int rc = sqlite3_exec(db, sql, NULL, NULL, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "'%s' failed: %s", sql, sqlite3_errmsg(db));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Read up to IMPORT_BATCH_SIZE rows into batch, n_cols fields per row in cols
+ * order; missing and empty fields are NULL. batch is emptied first and comes
+ * back short (or empty) at the end of the input. */
+static gboolean read_csv_batch(CsvReader *reader, const gint *cols, guint n_cols,
+                               GCancellable *cancellable, GPtrArray *batch, GError **error)
+{
+    g_ptr_array_set_size(batch, 0);
+    for (guint n = 0; n < IMPORT_BATCH_SIZE; ++n) {
+        GError *local_error = NULL;
+        if (!csv_reader_next_row(reader, cancellable, &local_error)) {
+            if (local_error) {
+                g_propagate_error(error, local_error);
+                return FALSE;
+            }
+            break;
+        }
+        for (guint c = 0; c < n_cols; ++c) {
+            const char *value = cols[c] >= 0 ? csv_reader_get_field(reader, (guint)cols[c]) : NULL;
+            g_ptr_array_add(batch, (value && *value) ? g_strdup(value) : NULL);
+        }
+    }
+    return TRUE;
+}
+
+/* Upsert one batch of hunted rows in its own transaction. Rows the statement
+ * refuses are skipped; caller holds the write lock. */
+static gboolean write_hunted_batch(sqlite3 *conn, const char *sql, GPtrArray *batch,
+                                   guint *imported, guint *skipped, GError **error)
+{
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare hunted import: %s", sqlite3_errmsg(conn));
+        return FALSE;
+    }
+    if (!exec_or_set_error(conn, "BEGIN IMMEDIATE;", error)) {
+        sqlite3_finalize(st);
+        return FALSE;
+    }
+
+    for (guint i = 0; i < batch->len; i += HUNTED_N_COLS) {
+        const char *const *row = (const char *const *)&batch->pdata[i];
+        const char *reference = row[HUNTED_COL_REFERENCE];
+        if (!reference || *reference == '#') {
+            (*skipped)++;
+            continue;
+        }
+
+        // pota.app exports plain dates; store them comparable with created_utc
+        const char *first_qso = row[HUNTED_COL_FIRST_QSO_DATE];
+        g_autofree gchar *first_qso_iso = (first_qso && strlen(first_qso) == 10)
+            ? g_strconcat(first_qso, "T00:00:00Z", NULL)
+            : g_strdup(first_qso);
+
+        const char *qsos = row[HUNTED_COL_QSOS];
+        gint64 qso_count = qsos ? g_ascii_strtoll(qsos, NULL, 10) : 0;
+
+        sqlite3_bind_text(st, 1, reference, -1, SQLITE_STATIC);
+        bind_text_or_null(st, 2, row[HUNTED_COL_PARK_NAME]);
+        bind_text_or_null(st, 3, row[HUNTED_COL_DX_ENTITY]);
+        bind_text_or_null(st, 4, row[HUNTED_COL_LOCATION]);
+        bind_text_or_null(st, 5, row[HUNTED_COL_HASC]);
+        bind_text_or_null(st, 6, first_qso_iso);
+        sqlite3_bind_int64(st, 7, MAX(qso_count, 0));
+
+        rc = sqlite3_step(st);
+        sqlite3_reset(st);
+        sqlite3_clear_bindings(st);
+        if (rc != SQLITE_DONE) {
+            g_debug("Skipping park %s: %s", reference, sqlite3_errmsg(conn));
+            (*skipped)++;
+            continue;
+        }
+        (*imported)++;
+    }
+    sqlite3_finalize(st);
+
+    if (!exec_or_set_error(conn, "COMMIT;", error)) {
+        sqlite3_exec(conn, "ROLLBACK;", NULL, NULL, NULL);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+gboolean spot_db_import_hunted_parks_csv(SpotDb *db,
+                                         GInputStream *stream,
+                                         GCancellable *cancellable,
+                                         guint *out_imported,
+                                         guint *out_skipped,
+                                         GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && G_IS_INPUT_STREAM(stream), FALSE);
+
+    const char *sql =
+        "INSERT INTO parks(reference, park_name, dx_entity, location, hasc, first_qso_date, qso_count) "
+        "VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7) "
+        "ON CONFLICT(reference) DO UPDATE SET "
+        "  park_name = COALESCE(excluded.park_name, parks.park_name), "
+        "  dx_entity = COALESCE(excluded.dx_entity, parks.dx_entity), "
+        "  location  = COALESCE(excluded.location,  parks.location), "
+        "  hasc      = COALESCE(excluded.hasc,      parks.hasc), "
+        "  first_qso_date = CASE "
+        "      WHEN parks.first_qso_date IS NULL THEN excluded.first_qso_date "
+        "      WHEN excluded.first_qso_date < parks.first_qso_date THEN excluded.first_qso_date "
+        "      ELSE parks.first_qso_date "
+        "  END, "
+        "  qso_count = MAX(parks.qso_count, excluded.qso_count);";
+
+    g_autoptr(CsvReader) reader = csv_reader_new(stream);
+    GError *local_error = NULL;
+    guint imported = 0, skipped = 0;
+    gint cols[HUNTED_N_COLS];
+
+    if (!csv_reader_next_row(reader, cancellable, &local_error)) {
+        if (local_error) {
+            g_propagate_error(error, local_error);
+            return FALSE;
+        }
+        if (out_imported) *out_imported = 0;
+        if (out_skipped) *out_skipped = 0;
+        return TRUE; // empty file
+    }
+    hunted_columns_from_header(reader, cols);
+
+    // Each batch is read with the write lock released and only written under it,
+    // so QSO inserts are not held up by the file. Committed batches stay on error.
+    g_autoptr(GPtrArray) batch = g_ptr_array_new_with_free_func(g_free);
+    while (read_csv_batch(reader, cols, HUNTED_N_COLS, cancellable, batch, &local_error) && batch->len > 0) {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+        if (!write_hunted_batch(db->spot_db, sql, batch, &imported, &skipped, &local_error)) break;
+    }
+
+    if (local_error) {
+        g_propagate_error(error, local_error);
+        return FALSE;
+    }
+
+    if (out_imported) *out_imported = imported;
+    if (out_skipped) *out_skipped = skipped;
+    return TRUE;
+}
+
+/* ----------------- 6) Park catalog ----------------- */
+enum {
+    CATALOG_COL_REFERENCE,
+    CATALOG_COL_NAME,
+    CATALOG_COL_ACTIVE,
+    CATALOG_COL_LOCATION,
+    CATALOG_COL_LATITUDE,
+    CATALOG_COL_LONGITUDE,
+    CATALOG_COL_GRID,
+    CATALOG_N_COLS
+};
+
+static const char *const CATALOG_COL_NAMES[CATALOG_N_COLS] = {
+    "reference", "name", "active", "locationDesc", "latitude", "longitude", "grid"
+};
+
+void park_catalog_row_free(ParkCatalogRow *row)
+{
+    if (!row) return;
+    g_free(row->reference);
+    g_free(row->name);
+    g_free(row->location);
+    g_free(row->grid);
+    g_free(row);
+}
+
+static ParkCatalogRow* park_catalog_row_from_stmt(sqlite3_stmt *st)
+{
+    ParkCatalogRow *row = g_new0(ParkCatalogRow, 1);
+    row->reference = g_strdup(COL_TEXT_OR_NULL(st, 0));
+    row->name      = g_strdup(COL_TEXT_OR_NULL(st, 1));
+    row->location  = g_strdup(COL_TEXT_OR_NULL(st, 2));
+    row->grid      = g_strdup(COL_TEXT_OR_NULL(st, 3));
+    row->latitude  = sqlite3_column_double(st, 4);
+    row->longitude = sqlite3_column_double(st, 5);
+    row->active    = sqlite3_column_int(st, 6) != 0;
+    return row;
+}
+
+/* Upsert one batch of catalog rows stamped with import_id in its own
+ * transaction; caller holds the write lock. */
+static gboolean write_catalog_batch(sqlite3 *conn, const char *sql, GPtrArray *batch,
+                                    sqlite3_int64 import_id, guint *count, GError **error)
+{
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare catalog import: %s", sqlite3_errmsg(conn));
+        return FALSE;
+    }
+    if (!exec_or_set_error(conn, "BEGIN IMMEDIATE;", error)) {
+        sqlite3_finalize(st);
+        return FALSE;
+    }
+
+    for (guint i = 0; i < batch->len; i += CATALOG_N_COLS) {
+        const char *const *row = (const char *const *)&batch->pdata[i];
+        const char *reference = row[CATALOG_COL_REFERENCE];
+        if (!reference) continue;
+
+        const char *lat = row[CATALOG_COL_LATITUDE];
+        const char *lon = row[CATALOG_COL_LONGITUDE];
+        const char *active = row[CATALOG_COL_ACTIVE];
+
+        sqlite3_bind_text(st, 1, reference, -1, SQLITE_STATIC);
+        bind_text_or_null(st, 2, row[CATALOG_COL_NAME]);
+        bind_text_or_null(st, 3, row[CATALOG_COL_LOCATION]);
+        bind_text_or_null(st, 4, row[CATALOG_COL_GRID]);
+        if (lat) sqlite3_bind_double(st, 5, g_ascii_strtod(lat, NULL));
+        else sqlite3_bind_null(st, 5);
+        if (lon) sqlite3_bind_double(st, 6, g_ascii_strtod(lon, NULL));
+        else sqlite3_bind_null(st, 6);
+        sqlite3_bind_int(st, 7, active ? (gint)g_ascii_strtoll(active, NULL, 10) != 0 : 1);
+        sqlite3_bind_int64(st, 8, import_id);
+
+        rc = sqlite3_step(st);
+        sqlite3_reset(st);
+        sqlite3_clear_bindings(st);
+        if (rc != SQLITE_DONE) {
+            g_set_error(error, G_IO_ERROR, rc, "insert park %s: %s", reference, sqlite3_errmsg(conn));
+            sqlite3_finalize(st);
+            sqlite3_exec(conn, "ROLLBACK;", NULL, NULL, NULL);
+            return FALSE;
+        }
+        (*count)++;
+    }
+    sqlite3_finalize(st);
+
+    if (!exec_or_set_error(conn, "COMMIT;", error)) {
+        sqlite3_exec(conn, "ROLLBACK;", NULL, NULL, NULL);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+gboolean spot_db_import_park_catalog_csv(SpotDb *db,
+                                         GInputStream *stream,
+                                         GCancellable *cancellable,
+                                         guint *out_count,
+                                         GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && G_IS_INPUT_STREAM(stream), FALSE);
+
+    const char *sql =
+        "INSERT INTO park_catalog(reference, name, location, grid, latitude, longitude, active, import_id) "
+        "VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8) "
+        "ON CONFLICT(reference) DO UPDATE SET "
+        "  name = excluded.name, location = excluded.location, grid = excluded.grid, "
+        "  latitude = excluded.latitude, longitude = excluded.longitude, active = excluded.active, "
+        "  import_id = excluded.import_id;";
+
+    g_autoptr(CsvReader) reader = csv_reader_new(stream);
+    GError *local_error = NULL;
+    gint cols[CATALOG_N_COLS];
+    guint count = 0;
+
+    if (!csv_reader_next_row(reader, cancellable, &local_error)) {
+        if (!local_error) {
+            local_error = g_error_new(G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Park catalog file is empty");
+        }
+        g_propagate_error(error, local_error);
+        return FALSE;
+    }
+
+    for (gint c = 0; c < CATALOG_N_COLS; ++c) cols[c] = -1;
+    for (guint i = 0; i < csv_reader_get_n_fields(reader); ++i) {
+        for (gint c = 0; c < CATALOG_N_COLS; ++c) {
+            if (g_ascii_strcasecmp(csv_reader_get_field(reader, i), CATALOG_COL_NAMES[c]) == 0) {
+                cols[c] = (gint)i;
+            }
+        }
+    }
+    if (cols[CATALOG_COL_REFERENCE] < 0) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                    "Not a park catalog: missing \"reference\" column");
+        return FALSE;
+    }
+
+    /* Rows are upserted in batches. Each batch is read with the write lock
+     * released and only written under it, so the UI's writers are not held up
+     * for the whole file. Each row is stamped with this import's id; once the
+     * file is in, rows left with an older stamp are parks that were retired and
+     * get deleted. A failed import keeps the batches already committed and
+     * removes nothing. */
+    sqlite3_int64 import_id = 1;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+        sqlite3_stmt *st = NULL;
+        if (sqlite3_prepare_v2(db->spot_db, "SELECT COALESCE(MAX(import_id), 0) + 1 FROM park_catalog;",
+                               -1, &st, NULL) == SQLITE_OK && sqlite3_step(st) == SQLITE_ROW) {
+            import_id = sqlite3_column_int64(st, 0);
+        }
+        sqlite3_finalize(st);
+    }
+
+    gboolean committed = FALSE;
+    g_autoptr(GPtrArray) batch = g_ptr_array_new_with_free_func(g_free);
+    while (read_csv_batch(reader, cols, CATALOG_N_COLS, cancellable, batch, &local_error) && batch->len > 0) {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+        if (!write_catalog_batch(db->spot_db, sql, batch, import_id, &count, &local_error)) break;
+        committed = TRUE;
+    }
+
+    // Retired parks: not in this file, so still stamped by an earlier import
+    if (!local_error) {
+        g_autofree gchar *prune = g_strdup_printf("DELETE FROM park_catalog WHERE import_id <> %" G_GINT64_FORMAT ";",
+                                                  (gint64)import_id);
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+        exec_or_set_error(db->spot_db, prune, &local_error);
+    }
+
+    // The search index is rebuilt in a step of its own, whenever a batch made it
+    // in, so it matches the table even after a failed or cancelled import
+    if (committed) {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+        GError *fts_error = NULL;
+        if (!exec_or_set_error(db->spot_db,
+                               "INSERT INTO park_catalog_fts(park_catalog_fts) VALUES('rebuild');", &fts_error)) {
+            if (local_error) {
+                g_warning("Failed to rebuild park search index: %s", fts_error->message);
+                g_error_free(fts_error);
+            } else {
+                local_error = fts_error;
+            }
+        }
+    }
+
+    if (local_error) {
+        g_propagate_error(error, local_error);
+        return FALSE;
+    }
+
+    if (out_count) *out_count = count;
+    return TRUE;
+}
+
+ParkCatalogRow* spot_db_lookup_park(SpotDb *db, const char *reference, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db, NULL);
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+    if (!reference || !*reference) return NULL;
+
+    const char *sql =
+        "SELECT reference, name, location, grid, latitude, longitude, active "
+        "FROM park_catalog WHERE reference = ?1;";
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare park lookup: %s", sqlite3_errmsg(conn));
+        return NULL;
+    }
+    sqlite3_bind_text(st, 1, reference, -1, SQLITE_TRANSIENT);
+
+    ParkCatalogRow *row = NULL;
+    rc = sqlite3_step(st);
+    if (rc == SQLITE_ROW) {
+        row = park_catalog_row_from_stmt(st);
+    } else if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "park lookup: %s", sqlite3_errmsg(conn));
+    }
+    sqlite3_finalize(st);
+    return row;
+}
+
+/* Turn free text into an FTS5 query: every word becomes a quoted prefix term */
+static gchar* fts_prefix_query(const char *text)
+{
+    GString *query = g_string_new(NULL);
+    const char *p = text;
+
+    while (p && *p) {
+        while (*p && !g_unichar_isalnum(g_utf8_get_char(p))) p = g_utf8_next_char(p);
+        const char *start = p;
+        while (*p && g_unichar_isalnum(g_utf8_get_char(p))) p = g_utf8_next_char(p);
+        if (p > start) {
+            if (query->len) g_string_append_c(query, ' ');
+            g_string_append_c(query, '"');
+            g_string_append_len(query, start, p - start);
+            g_string_append(query, "\"*");
+        }
+    }
+
+    return g_string_free(query, query->len == 0);
+}
+
+GPtrArray* spot_db_search_parks(SpotDb *db, const char *text, guint limit, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db, NULL);
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
+    GPtrArray *rows = g_ptr_array_new_with_free_func((GDestroyNotify)park_catalog_row_free);
+    g_autofree gchar *match = fts_prefix_query(text);
+    if (!match) return rows;
+
+    // Reference prefix hits first, then by rank (reference > name > location)
+    const char *sql =
+        "SELECT c.reference, c.name, c.location, c.grid, c.latitude, c.longitude, c.active "
+        "FROM park_catalog_fts f JOIN park_catalog c ON c.id = f.rowid "
+        "WHERE park_catalog_fts MATCH ?1 "
+        "ORDER BY (c.reference LIKE ?2 ESCAPE '\\') DESC, bm25(park_catalog_fts, 10.0, 5.0, 1.0) "
+        "LIMIT ?3;";
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare park search: %s", sqlite3_errmsg(conn));
+        g_ptr_array_unref(rows);
+        return NULL;
+    }
+
+    g_autofree gchar *trimmed = g_strstrip(g_strdup(text));
+    g_autofree gchar *ref_prefix = like_prefix_pattern(trimmed);
+    sqlite3_bind_text(st, 1, match, -1, SQLITE_STATIC);
+    sqlite3_bind_text(st, 2, ref_prefix, -1, SQLITE_STATIC);
+    sqlite3_bind_int(st, 3, limit > 0 ? (int)limit : -1);
+
+    while ((rc = sqlite3_step(st)) == SQLITE_ROW) {
+        g_ptr_array_add(rows, park_catalog_row_from_stmt(st));
+    }
+
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "park search: %s", sqlite3_errmsg(conn));
+        g_ptr_array_unref(rows);
+        rows = NULL;
+    }
+
+    sqlite3_finalize(st);
+    return rows;
+}
+
+gint64 spot_db_park_catalog_count(SpotDb *db)
+{
+    g_return_val_if_fail(db && db->spot_db, 0);
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
+    sqlite3_stmt *st = NULL;
+    gint64 count = 0;
+    if (sqlite3_prepare_v2(conn, "SELECT COUNT(*) FROM park_catalog;", -1, &st, NULL) == SQLITE_OK &&
+        sqlite3_step(st) == SQLITE_ROW) {
+        count = sqlite3_column_int64(st, 0);
+    }
+    sqlite3_finalize(st);
+    return count;
+}
+
+/* ----------------- 7) Hunting statistics ----------------- */
+static gboolean rebuild_stats(sqlite3 *db, GError **error)
+{
+    const char *sql =
+        "DELETE FROM stat_totals;"
+        "DELETE FROM stat_park_counts;"
+        "DELETE FROM stat_qso_keys;"
+        "INSERT OR IGNORE INTO stat_qso_keys(qso_id, dimension, key, park_ref) "
+        "SELECT id, dimension, key, park_ref FROM ("
+        "  SELECT q.id, 'total' AS dimension, 'all' AS key, q.park_ref FROM qsos q "
+        "  UNION ALL SELECT q.id, 'band', " STAT_BAND_SQL("q.frequency_hz") ", q.park_ref FROM qsos q "
+        "  UNION ALL SELECT q.id, 'mode', UPPER(q.mode), q.park_ref FROM qsos q "
+        "  UNION ALL SELECT q.id, 'day', substr(q.created_utc, 1, 10), q.park_ref FROM qsos q "
+        "  UNION ALL SELECT q.id, 'location', trim(j.value), q.park_ref FROM qsos q "
+        "    JOIN parks p ON p.reference = q.park_ref, "
+        "    json_each(" STAT_LOCATION_JSON("p.location") ") j "
+        "  UNION ALL SELECT q.id, 'entity', p.dx_entity, q.park_ref FROM qsos q "
+        "    JOIN parks p ON p.reference = q.park_ref"
+        ") WHERE park_ref IS NOT NULL AND key IS NOT NULL AND key <> '';"
+        "INSERT INTO stat_park_counts(dimension, key, park_ref, qso_count) "
+        "SELECT dimension, key, park_ref, COUNT(*) FROM stat_qso_keys "
+        "GROUP BY dimension, key, park_ref;";
+
+    if (!exec_or_set_error(db, "BEGIN IMMEDIATE;", error)) return FALSE;
+
+    char *errmsg = NULL;
+    int rc = sqlite3_exec(db, sql, NULL, NULL, &errmsg);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "rebuild stats: %s", errmsg ? errmsg : sqlite3_errmsg(db));
+        sqlite3_free(errmsg);
+        sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
+        return FALSE;
+    }
+
+    if (!exec_or_set_error(db, "COMMIT;", error)) {
+        sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+gboolean spot_db_rebuild_stats(SpotDb *db, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db, FALSE);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+    return rebuild_stats(db->spot_db, error);
+}
+
+void stat_row_free(StatRow *row)
+{
+    if (!row) return;
+    g_free(row->key);
+    g_free(row);
+}
+
+GPtrArray* spot_db_get_stats(SpotDb *db, const char *dimension, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && dimension, NULL);
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
+    // Days read best newest first; everything else by parks hunted
+    const char *sql = g_strcmp0(dimension, SPOT_DB_STAT_DAY) == 0
+        ? "SELECT key, qso_count, park_count FROM stat_totals WHERE dimension = ?1 ORDER BY key DESC;"
+        : "SELECT key, qso_count, park_count FROM stat_totals WHERE dimension = ?1 "
+          "ORDER BY park_count DESC, qso_count DESC, key;";
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare get_stats: %s", sqlite3_errmsg(conn));
+        return NULL;
+    }
+    sqlite3_bind_text(st, 1, dimension, -1, SQLITE_STATIC);
+
+    GPtrArray *rows = g_ptr_array_new_with_free_func((GDestroyNotify)stat_row_free);
+    while ((rc = sqlite3_step(st)) == SQLITE_ROW) {
+        StatRow *row = g_new0(StatRow, 1);
+        row->key        = g_strdup((const char*)sqlite3_column_text(st, 0));
+        row->qso_count  = sqlite3_column_int64(st, 1);
+        row->park_count = sqlite3_column_int64(st, 2);
+        g_ptr_array_add(rows, row);
+    }
+
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "step get_stats: %s", sqlite3_errmsg(conn));
+        g_ptr_array_unref(rows);
+        rows = NULL;
+    }
+
+    sqlite3_finalize(st);
+    return rows;
+}
+
+static guint32 julian_from_iso_day(const char *day)
+{
+    gint y = 0, m = 0, d = 0;
+    if (!day || sscanf(day, "%4d-%2d-%2d", &y, &m, &d) != 3 || !g_date_valid_dmy(d, m, y)) return 0;
+    GDate date;
+    g_date_clear(&date, 1);
+    g_date_set_dmy(&date, d, m, y);
+    return g_date_get_julian(&date);
+}
+
+gboolean spot_db_get_streaks(SpotDb *db,
+                             GDateTime *utc_today,
+                             guint *out_current,
+                             guint *out_longest,
+                             GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && utc_today, FALSE);
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
+    const char *sql = "SELECT key FROM stat_totals WHERE dimension = 'day' ORDER BY key;";
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare get_streaks: %s", sqlite3_errmsg(conn));
+        return FALSE;
+    }
+
+    guint32 prev = 0;
+    guint run = 0, longest = 0;
+    while ((rc = sqlite3_step(st)) == SQLITE_ROW) {
+        guint32 day = julian_from_iso_day((const char*)sqlite3_column_text(st, 0));
+        if (!day) continue;
+        run = (prev && day == prev + 1) ? run + 1 : 1;
+        longest = MAX(longest, run);
+        prev = day;
+    }
+    sqlite3_finalize(st);
+
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "step get_streaks: %s", sqlite3_errmsg(conn));
+        return FALSE;
+    }
+
+    // The current streak survives until a full UTC day passes without a QSO
+    g_autoptr(GDateTime) utc = g_date_time_to_utc(utc_today);
+    g_autofree gchar *today_iso = g_date_time_format(utc, "%Y-%m-%d");
+    guint32 today = julian_from_iso_day(today_iso);
+
+    if (out_current) *out_current = (prev && (prev == today || prev + 1 == today)) ? run : 0;
+    if (out_longest) *out_longest = longest;
+    return TRUE;
+}
+
+/* ----------------- 8) Spot snapshot archive ----------------- */
+/* FNV-1a over the fields that make a spot "changed" between refreshes */
+static guint64 fingerprint_mix(guint64 h, const char *s)
+{
+    for (const guchar *p = (const guchar*)(s ? s : ""); *p; ++p) {
+        h ^= *p;
+        h *= G_GUINT64_CONSTANT(0x100000001b3);
+    }
+    h ^= 0x1f; // field separator
+    h *= G_GUINT64_CONSTANT(0x100000001b3);
+    return h;
+}
+
+static gint64 spot_fingerprint(ArtemisSpot *spot, const char *spot_time)
+{
+    char numbers[32];
+    guint64 h = G_GUINT64_CONSTANT(0xcbf29ce484222325);
+    h = fingerprint_mix(h, artemis_spot_get_callsign(spot));
+    h = fingerprint_mix(h, artemis_spot_get_park_ref(spot));
+    h = fingerprint_mix(h, artemis_spot_get_mode(spot));
+    h = fingerprint_mix(h, artemis_spot_get_spotter(spot));
+    h = fingerprint_mix(h, artemis_spot_get_spotter_comment(spot));
+    h = fingerprint_mix(h, artemis_spot_get_activator_comment(spot));
+    h = fingerprint_mix(h, spot_time);
+    g_snprintf(numbers, sizeof numbers, "%d/%d", artemis_spot_get_frequency_hz(spot),
+               artemis_spot_get_spot_count(spot));
+    h = fingerprint_mix(h, numbers);
+    return (gint64)h;
+}
+
+static gboolean exec_with_snapshot(sqlite3 *db, const char *sql, sqlite3_int64 snapshot_id, GError **error)
+{
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(db, sql, -1, &st, NULL);
+    if (rc == SQLITE_OK) {
+        sqlite3_bind_int64(st, 1, snapshot_id);
+        rc = sqlite3_step(st);
+    }
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "archive: %s", sqlite3_errmsg(db));
+    }
+    sqlite3_finalize(st);
+    return rc == SQLITE_DONE;
+}
+
+gboolean spot_db_archive_snapshot(SpotDb *db,
+                                  GPtrArray *spots,
+                                  GDateTime *fetched_utc,
+                                  guint *out_changes,
+                                  GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && spots && fetched_utc, FALSE);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+    sqlite3 *conn = db->spot_db;
+    GError *local_error = NULL;
+    sqlite3_stmt *st = NULL;
+    sqlite3_int64 snapshot_id = 0;
+    guint n_changes = 0;
+
+    // Staging table lives on the writer connection only
+    if (!exec_or_set_error(conn,
+            "CREATE TEMP TABLE IF NOT EXISTS spot_archive_incoming ("
+            "  spot_id INTEGER PRIMARY KEY, fingerprint INTEGER NOT NULL,"
+            "  activator TEXT, park_ref TEXT, park_name TEXT, location_desc TEXT,"
+            "  frequency_khz INTEGER, mode TEXT, spot_time DATETIME, spotter TEXT,"
+            "  comments TEXT, spot_count INTEGER, activator_comment TEXT);", error) ||
+        !exec_or_set_error(conn, "BEGIN IMMEDIATE;", error)) {
+        return FALSE;
+    }
+
+    g_autofree gchar *fetched_iso = iso8601_from_borrowed_utc(fetched_utc);
+    int rc = sqlite3_prepare_v2(conn,
+        "INSERT INTO spot_archive_snapshots(fetched_utc, n_spots) VALUES(?1, ?2);", -1, &st, NULL);
+    if (rc == SQLITE_OK) {
+        sqlite3_bind_text(st, 1, fetched_iso, -1, SQLITE_STATIC);
+        sqlite3_bind_int(st, 2, (int)spots->len);
+        rc = sqlite3_step(st);
+    }
+    sqlite3_finalize(st);
+    st = NULL;
+    if (rc != SQLITE_DONE) {
+        g_set_error(&local_error, G_IO_ERROR, rc, "insert snapshot: %s", sqlite3_errmsg(conn));
+        goto out;
+    }
+    snapshot_id = sqlite3_last_insert_rowid(conn);
+
+    rc = sqlite3_prepare_v2(conn,
+        "INSERT OR REPLACE INTO temp.spot_archive_incoming VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13);",
+        -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(&local_error, G_IO_ERROR, rc, "prepare archive staging: %s", sqlite3_errmsg(conn));
+        goto out;
+    }
+
+    for (guint i = 0; i < spots->len; i++) {
+        ArtemisSpot *spot = g_ptr_array_index(spots, i);
+        gint64 spot_id = artemis_spot_get_spot_id(spot);
+        if (spot_id <= 0) continue; // locally created, nothing to diff against
+
+        g_autofree gchar *spot_time = iso8601_from_borrowed_utc(artemis_spot_get_spot_time(spot));
+        sqlite3_bind_int64(st, 1, spot_id);
+        sqlite3_bind_int64(st, 2, spot_fingerprint(spot, spot_time));
+        bind_text_or_null(st, 3, artemis_spot_get_callsign(spot));
+        bind_text_or_null(st, 4, artemis_spot_get_park_ref(spot));
+        bind_text_or_null(st, 5, artemis_spot_get_park_name(spot));
+        bind_text_or_null(st, 6, artemis_spot_get_location_desc(spot));
+        sqlite3_bind_int(st, 7, artemis_spot_get_frequency_hz(spot));
+        bind_text_or_null(st, 8, artemis_spot_get_mode(spot));
+        bind_text_or_null(st, 9, spot_time);
+        bind_text_or_null(st, 10, artemis_spot_get_spotter(spot));
+        bind_text_or_null(st, 11, artemis_spot_get_spotter_comment(spot));
+        sqlite3_bind_int(st, 12, artemis_spot_get_spot_count(spot));
+        bind_text_or_null(st, 13, artemis_spot_get_activator_comment(spot));
+
+        rc = sqlite3_step(st);
+        sqlite3_reset(st);
+        sqlite3_clear_bindings(st);
+        if (rc != SQLITE_DONE) {
+            g_set_error(&local_error, G_IO_ERROR, rc, "stage spot: %s", sqlite3_errmsg(conn));
+            goto out;
+        }
+    }
+    sqlite3_finalize(st);
+    st = NULL;
+
+    // Added (kind 0) / updated (kind 1) spots carry a full row; removed (kind 2) only the id
+    if (!exec_with_snapshot(conn,
+            "INSERT INTO spot_archive_events(snapshot_id, spot_id, kind, activator, park_ref, park_name, "
+            "  location_desc, frequency_khz, mode, spot_time, spotter, comments, spot_count, activator_comment) "
+            "SELECT ?1, i.spot_id, CASE WHEN l.spot_id IS NULL THEN 0 ELSE 1 END, i.activator, i.park_ref, "
+            "  i.park_name, i.location_desc, i.frequency_khz, i.mode, i.spot_time, i.spotter, i.comments, "
+            "  i.spot_count, i.activator_comment "
+            "FROM temp.spot_archive_incoming i LEFT JOIN spot_archive_live l ON l.spot_id = i.spot_id "
+            "WHERE l.spot_id IS NULL OR l.fingerprint <> i.fingerprint;", snapshot_id, &local_error)) {
+        goto out;
+    }
+    n_changes += sqlite3_changes(conn);
+
+    if (!exec_with_snapshot(conn,
+            "INSERT INTO spot_archive_events(snapshot_id, spot_id, kind) "
+            "SELECT ?1, l.spot_id, 2 FROM spot_archive_live l "
+            "WHERE l.spot_id NOT IN (SELECT spot_id FROM temp.spot_archive_incoming);", snapshot_id, &local_error)) {
+        goto out;
+    }
+    n_changes += sqlite3_changes(conn);
+
+    if (!exec_or_set_error(conn, "DELETE FROM spot_archive_live;", &local_error) ||
+        !exec_or_set_error(conn,
+            "INSERT INTO spot_archive_live(spot_id, fingerprint) "
+            "SELECT spot_id, fingerprint FROM temp.spot_archive_incoming;", &local_error) ||
+        !exec_or_set_error(conn, "DELETE FROM temp.spot_archive_incoming;", &local_error)) {
+        goto out;
+    }
+
+    {
+        g_autofree gchar *sql = g_strdup_printf(
+            "UPDATE spot_archive_snapshots SET n_changes = %u WHERE id = ?1;", n_changes);
+        exec_with_snapshot(conn, sql, snapshot_id, &local_error);
+    }
+
+out:
+    sqlite3_finalize(st);
+
+    if (local_error) {
+        sqlite3_exec(conn, "ROLLBACK;", NULL, NULL, NULL);
+        sqlite3_exec(conn, "DELETE FROM temp.spot_archive_incoming;", NULL, NULL, NULL);
+        g_propagate_error(error, local_error);
+        return FALSE;
+    }
+
+    if (!exec_or_set_error(conn, "COMMIT;", error)) {
+        sqlite3_exec(conn, "ROLLBACK;", NULL, NULL, NULL);
+        return FALSE;
+    }
+
+    if (out_changes) *out_changes = n_changes;
+    return TRUE;
+}
+
+gboolean spot_db_archive_prune(SpotDb *db,
+                               GDateTime *older_than_utc,
+                               guint max_vacuum_pages,
+                               GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && older_than_utc, FALSE);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+    sqlite3 *conn = db->spot_db;
+    g_autofree gchar *cutoff = iso8601_from_borrowed_utc(older_than_utc);
+    sqlite3_stmt *st = NULL;
+    sqlite3_int64 keep_id = 0;
+
+    // Oldest snapshot to keep; everything before it goes
+    int rc = sqlite3_prepare_v2(conn,
+        "SELECT MIN(id) FROM spot_archive_snapshots WHERE fetched_utc >= ?1;", -1, &st, NULL);
+    if (rc == SQLITE_OK) {
+        sqlite3_bind_text(st, 1, cutoff, -1, SQLITE_STATIC);
+        if (sqlite3_step(st) == SQLITE_ROW) keep_id = sqlite3_column_int64(st, 0);
+    }
+    sqlite3_finalize(st);
+
+    if (keep_id == 0) {
+        // Nothing recent; keep the newest snapshot so the live state stays replayable
+        if (sqlite3_prepare_v2(conn, "SELECT MAX(id) FROM spot_archive_snapshots;", -1, &st, NULL) == SQLITE_OK &&
+            sqlite3_step(st) == SQLITE_ROW) {
+            keep_id = sqlite3_column_int64(st, 0);
+        }
+        sqlite3_finalize(st);
+        if (keep_id == 0) return TRUE; // empty archive
+    }
+
+    if (!exec_or_set_error(conn, "BEGIN IMMEDIATE;", error)) return FALSE;
+
+    // Turn the kept snapshot into a keyframe: re-add every spot that was live
+    // before it and is not already described by one of its own events.
+    if (!exec_with_snapshot(conn,
+            "INSERT INTO spot_archive_events(snapshot_id, spot_id, kind, activator, park_ref, park_name, "
+            "  location_desc, frequency_khz, mode, spot_time, spotter, comments, spot_count, activator_comment) "
+            "SELECT ?1, e.spot_id, 0, e.activator, e.park_ref, e.park_name, e.location_desc, "
+            "  e.frequency_khz, e.mode, e.spot_time, e.spotter, e.comments, e.spot_count, e.activator_comment "
+            "FROM spot_archive_events e "
+            "WHERE e.snapshot_id = (SELECT MAX(h.snapshot_id) FROM spot_archive_events h "
+            "                       WHERE h.spot_id = e.spot_id AND h.snapshot_id < ?1) "
+            "  AND e.kind <> 2 "
+            "  AND NOT EXISTS (SELECT 1 FROM spot_archive_events k WHERE k.spot_id = e.spot_id AND k.snapshot_id = ?1);",
+            keep_id, error) ||
+        !exec_with_snapshot(conn, "DELETE FROM spot_archive_events WHERE snapshot_id < ?1;", keep_id, error) ||
+        !exec_with_snapshot(conn, "DELETE FROM spot_archive_snapshots WHERE id < ?1;", keep_id, error)) {
+        sqlite3_exec(conn, "ROLLBACK;", NULL, NULL, NULL);
+        return FALSE;
+    }
+
+    if (!exec_or_set_error(conn, "COMMIT;", error)) {
+        sqlite3_exec(conn, "ROLLBACK;", NULL, NULL, NULL);
+        return FALSE;
+    }
+
+    // Return a bounded number of free pages to the filesystem; a no-op on
+    // databases created before incremental auto_vacuum was enabled
+    g_autofree gchar *vacuum = g_strdup_printf("PRAGMA incremental_vacuum(%u);", max_vacuum_pages);
+    return exec_or_set_error(conn, vacuum, error);
+}
+
+static ArtemisSpot* spot_from_archive_stmt(sqlite3_stmt *st)
+{
+    const char *spot_time = COL_TEXT_OR_NULL(st, 7);
+    g_autoptr(GTimeZone) utc = g_time_zone_new_utc();
+    g_autoptr(GDateTime) when = spot_time ? g_date_time_new_from_iso8601(spot_time, utc) : NULL;
+
+    return artemis_spot_new(COL_TEXT_OR_NULL(st, 0),    // activator
+                            COL_TEXT_OR_NULL(st, 1),    // park_ref
+                            COL_TEXT_OR_NULL(st, 2),    // park_name
+                            COL_TEXT_OR_NULL(st, 3),    // location_desc
+                            COL_TEXT_OR_NULL(st, 10),   // activator_comment
+                            sqlite3_column_int(st, 4),  // frequency_khz
+                            COL_TEXT_OR_NULL(st, 5),    // mode
+                            when,
+                            COL_TEXT_OR_NULL(st, 6),    // spotter
+                            COL_TEXT_OR_NULL(st, 8),    // comments
+                            sqlite3_column_int(st, 9)); // spot_count
+}
+
+GPtrArray* spot_db_archive_spots_at(SpotDb *db, GDateTime *utc_when, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && utc_when, NULL);
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
+    // Latest event per spot up to the last snapshot taken at or before utc_when.
+    // A spot has at most one event per snapshot, so snapshot_id orders them
+    // (keyframe rows written by a prune have newer rowids than later events).
+    const char *sql =
+        "SELECT e.activator, e.park_ref, e.park_name, e.location_desc, e.frequency_khz, e.mode, "
+        "  e.spotter, e.spot_time, e.comments, e.spot_count, e.activator_comment "
+        "FROM spot_archive_events e "
+        "WHERE e.snapshot_id = ("
+        "  SELECT MAX(h.snapshot_id) FROM spot_archive_events h "
+        "  WHERE h.spot_id = e.spot_id "
+        "    AND h.snapshot_id <= (SELECT MAX(id) FROM spot_archive_snapshots WHERE fetched_utc <= ?1)"
+        ") AND e.kind <> 2 "
+        "ORDER BY e.spot_time DESC;";
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare archive replay: %s", sqlite3_errmsg(conn));
+        return NULL;
+    }
+
+    g_autofree gchar *when_iso = iso8601_from_borrowed_utc(utc_when);
+    sqlite3_bind_text(st, 1, when_iso, -1, SQLITE_STATIC);
+
+    GPtrArray *spots = g_ptr_array_new_with_free_func(g_object_unref);
+    while ((rc = sqlite3_step(st)) == SQLITE_ROW) {
+        g_ptr_array_add(spots, spot_from_archive_stmt(st));
+    }
+
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "archive replay: %s", sqlite3_errmsg(conn));
+        g_ptr_array_unref(spots);
+        spots = NULL;
+    }
+
+    sqlite3_finalize(st);
+    return spots;
+}
+
+void spot_history_query_free(SpotHistoryQuery *query)
+{
+    if (!query) return;
+    g_free(query->park_ref);
+    g_free(query->activator);
+    g_free(query->band);
+    g_free(query->mode);
+    g_clear_pointer(&query->since_utc, g_date_time_unref);
+    g_clear_pointer(&query->until_utc, g_date_time_unref);
+    g_free(query->text);
+    g_free(query);
+}
+
+/* Modes the spot list groups together under one filter */
+static const char *const PHONE_MODES = "'SSB','USB','LSB','AM','FM'";
+static const char *const DATA_MODES  = "'FT8','FT4','RTTY','PSK31','JS8','DATA'";
+
+GPtrArray* spot_db_search_spot_history(SpotDb *db, const SpotHistoryQuery *query,
+                                       guint limit, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && query, NULL);
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
+    // Only the clauses that are actually set go into the SQL, so the planner
+    // can pick the park/activator/time index instead of scanning.
+    g_autoptr(GString) sql = g_string_new(
+        "SELECT e.activator, e.park_ref, e.park_name, e.location_desc, e.frequency_khz, e.mode, "
+        "  e.spotter, e.spot_time, e.comments, e.spot_count, e.activator_comment, MAX(e.snapshot_id) "
+        "FROM spot_archive_events e WHERE e.kind <> 2");
+    g_autoptr(GPtrArray) binds = g_ptr_array_new_with_free_func(g_free);
+    g_autofree gchar *match = fts_prefix_query(query->text);
+
+    if (query->park_ref) {
+        g_string_append(sql, " AND e.park_ref = ? COLLATE NOCASE");
+        g_ptr_array_add(binds, g_strdup(query->park_ref));
+    }
+    if (query->activator) {
+        g_string_append(sql, " AND e.activator = ? COLLATE NOCASE");
+        g_ptr_array_add(binds, g_strdup(query->activator));
+    }
+    if (query->band) {
+        g_string_append(sql, " AND " STAT_BAND_SQL("e.frequency_khz") " = ?");
+        g_ptr_array_add(binds, g_strdup(query->band));
+    }
+    if (query->mode) {
+        if (g_ascii_strcasecmp(query->mode, "PHONE") == 0) {
+            g_string_append_printf(sql, " AND UPPER(e.mode) IN (%s)", PHONE_MODES);
+        } else if (g_ascii_strcasecmp(query->mode, "DATA") == 0) {
+            g_string_append_printf(sql, " AND UPPER(e.mode) IN (%s)", DATA_MODES);
+        } else {
+            g_string_append(sql, " AND UPPER(e.mode) = UPPER(?)");
+            g_ptr_array_add(binds, g_strdup(query->mode));
+        }
+    }
+    if (query->since_utc) {
+        g_string_append(sql, " AND e.spot_time >= ?");
+        g_ptr_array_add(binds, iso8601_from_borrowed_utc(query->since_utc));
+    }
+    if (query->until_utc) {
+        g_string_append(sql, " AND e.spot_time < ?");
+        g_ptr_array_add(binds, iso8601_from_borrowed_utc(query->until_utc));
+    }
+    if (match) {
+        g_string_append(sql, " AND e.id IN (SELECT rowid FROM spot_archive_fts WHERE spot_archive_fts MATCH ?)");
+        g_ptr_array_add(binds, g_strdup(match));
+    }
+
+    // Keyframes repeat a spot across snapshots; report each spot once, as last seen
+    g_string_append(sql, " GROUP BY e.spot_id ORDER BY e.spot_time DESC LIMIT ?;");
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn, sql->str, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare history search: %s", sqlite3_errmsg(conn));
+        return NULL;
+    }
+
+    int idx = 1;
+    for (guint i = 0; i < binds->len; i++) {
+        sqlite3_bind_text(st, idx++, g_ptr_array_index(binds, i), -1, SQLITE_STATIC);
+    }
+    sqlite3_bind_int(st, idx, limit > 0 ? (int)limit : -1);
+
+    GPtrArray *spots = g_ptr_array_new_with_free_func(g_object_unref);
+    while ((rc = sqlite3_step(st)) == SQLITE_ROW) {
+        g_ptr_array_add(spots, spot_from_archive_stmt(st));
+    }
+
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "history search: %s", sqlite3_errmsg(conn));
+        g_ptr_array_unref(spots);
+        spots = NULL;
+    }
+
+    sqlite3_finalize(st);
+    return spots;
+}
+
+/* ----------------- Spot outbox ----------------- */
+void spot_outbox_row_free(SpotOutboxRow *row)
+{
+    if (!row) return;
+    g_clear_object(&row->spot);
+    g_free(row->last_error);
+    g_free(row);
+}
+
+static gchar* outbox_dedup_key(ArtemisSpot *spot)
+{
+    const char *mode = artemis_spot_get_mode(spot);
+    g_autofree gchar *key = g_strdup_printf("%s|%s|%d|%s|%s",
+                                            artemis_spot_get_callsign(spot),
+                                            artemis_spot_get_park_ref(spot),
+                                            artemis_spot_get_frequency_hz(spot),
+                                            mode ? mode : "",
+                                            artemis_spot_get_spotter(spot));
+    return g_ascii_strup(key, -1);
+}
+
+gboolean spot_db_outbox_add(SpotDb *db, ArtemisSpot *spot, sqlite3_int64 *out_id,
+                            gboolean *out_duplicate, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && spot, FALSE);
+
+    const char *callsign = artemis_spot_get_callsign(spot);
+    const char *park_ref = artemis_spot_get_park_ref(spot);
+    const char *spotter  = artemis_spot_get_spotter(spot);
+    if (!callsign || !*callsign || !park_ref || !*park_ref || !spotter || !*spotter) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                    "Missing required fields (callsign/park_ref/spotter)");
+        return FALSE;
+    }
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+
+    g_autofree gchar *key = outbox_dedup_key(spot);
+    g_autoptr(GDateTime) now = g_date_time_new_now_utc();
+    g_autofree gchar *created = g_date_time_format(now, "%Y-%m-%dT%H:%M:%SZ");
+
+    // A spot already waiting is not queued twice; hand back the waiting row
+    const char *sql =
+        "INSERT OR IGNORE INTO spot_outbox(dedup_key, activator, park_ref, frequency_khz, mode, "
+        "  spotter, comments, created_utc) VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(db->spot_db, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare outbox insert: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    sqlite3_bind_text(st, 1, key, -1, SQLITE_STATIC);
+    sqlite3_bind_text(st, 2, callsign, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 3, park_ref, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int (st, 4, artemis_spot_get_frequency_hz(spot));
+    bind_text_or_null(st, 5, artemis_spot_get_mode(spot));
+    sqlite3_bind_text(st, 6, spotter, -1, SQLITE_TRANSIENT);
+    bind_text_or_null(st, 7, artemis_spot_get_spotter_comment(spot));
+    sqlite3_bind_text(st, 8, created, -1, SQLITE_STATIC);
+
+    rc = sqlite3_step(st);
+    sqlite3_finalize(st);
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "outbox insert: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+
+    gboolean duplicate = sqlite3_changes(db->spot_db) == 0;
+    if (out_duplicate) *out_duplicate = duplicate;
+    if (!out_id) return TRUE;
+
+    if (!duplicate) {
+        *out_id = sqlite3_last_insert_rowid(db->spot_db);
+        return TRUE;
+    }
+
+    rc = sqlite3_prepare_v2(db->spot_db,
+                            "SELECT id FROM spot_outbox WHERE dedup_key = ? AND state IN (0, 1);",
+                            -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare outbox lookup: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    sqlite3_bind_text(st, 1, key, -1, SQLITE_STATIC);
+    *out_id = sqlite3_step(st) == SQLITE_ROW ? sqlite3_column_int64(st, 0) : 0;
+    sqlite3_finalize(st);
+    return TRUE;
+}
+
+GPtrArray* spot_db_outbox_list(SpotDb *db, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db, NULL);
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
+    const char *sql =
+        "SELECT id, activator, park_ref, frequency_khz, mode, spotter, comments, created_utc, "
+        "  state, attempts, next_attempt, unconfirmed, last_error "
+        "FROM spot_outbox ORDER BY id;";
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare outbox list: %s", sqlite3_errmsg(conn));
+        return NULL;
+    }
+
+    g_autoptr(GTimeZone) utc = g_time_zone_new_utc();
+    GPtrArray *rows = g_ptr_array_new_with_free_func((GDestroyNotify)spot_outbox_row_free);
+    while ((rc = sqlite3_step(st)) == SQLITE_ROW) {
+        g_autoptr(GDateTime) created = g_date_time_new_from_iso8601((const char*)sqlite3_column_text(st, 7), utc);
+
+        SpotOutboxRow *row = g_new0(SpotOutboxRow, 1);
+        row->id = sqlite3_column_int64(st, 0);
+        row->spot = artemis_spot_new((const char*)sqlite3_column_text(st, 1),
+                                     (const char*)sqlite3_column_text(st, 2),
+                                     NULL, NULL, NULL,
+                                     sqlite3_column_int(st, 3),
+                                     (const char*)sqlite3_column_text(st, 4),
+                                     created,
+                                     (const char*)sqlite3_column_text(st, 5),
+                                     (const char*)sqlite3_column_text(st, 6),
+                                     0);
+        row->state = (SpotOutboxState)sqlite3_column_int(st, 8);
+        row->attempts = sqlite3_column_int(st, 9);
+        row->next_attempt = sqlite3_column_int64(st, 10);
+        row->unconfirmed = sqlite3_column_int(st, 11) != 0;
+        row->last_error = g_strdup((const char*)sqlite3_column_text(st, 12));
+        g_ptr_array_add(rows, row);
+    }
+
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "outbox list: %s", sqlite3_errmsg(conn));
+        g_ptr_array_unref(rows);
+        rows = NULL;
+    }
+    sqlite3_finalize(st);
+    return rows;
+}
+
+gboolean spot_db_outbox_update(SpotDb *db, const SpotOutboxRow *row, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && row, FALSE);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+
+    const char *sql =
+        "UPDATE spot_outbox SET state = ?, attempts = ?, next_attempt = ?, unconfirmed = ?, "
+        "  last_error = ?, updated = strftime('%s','now') WHERE id = ?;";
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(db->spot_db, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare outbox update: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    sqlite3_bind_int  (st, 1, row->state);
+    sqlite3_bind_int  (st, 2, row->attempts);
+    sqlite3_bind_int64(st, 3, row->next_attempt);
+    sqlite3_bind_int  (st, 4, row->unconfirmed ? 1 : 0);
+    bind_text_or_null (st, 5, row->last_error);
+    sqlite3_bind_int64(st, 6, row->id);
+
+    rc = sqlite3_step(st);
+    sqlite3_finalize(st);
+    if ((rc & 0xff) == SQLITE_CONSTRAINT) {
+        // idx_spot_outbox_dedup: another row already has this spot waiting
+        g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_EXISTS, "The same spot is already waiting to be posted");
+        return FALSE;
+    }
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "outbox update: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+gboolean spot_db_outbox_remove(SpotDb *db, sqlite3_int64 id, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db, FALSE);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(db->spot_db, "DELETE FROM spot_outbox WHERE id = ?;", -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare outbox delete: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    sqlite3_bind_int64(st, 1, id);
+    rc = sqlite3_step(st);
+    sqlite3_finalize(st);
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "outbox delete: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+gboolean spot_db_outbox_prune_sent(SpotDb *db, gint64 sent_before, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db, FALSE);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(db->spot_db, "DELETE FROM spot_outbox WHERE state = 2 AND updated < ?;",
+                                -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare outbox prune: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    sqlite3_bind_int64(st, 1, sent_before);
+    rc = sqlite3_step(st);
+    sqlite3_finalize(st);
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "outbox prune: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* ----------------- Logbook queue ----------------- */
+void logbook_queue_row_free(LogbookQueueRow *row)
+{
+    if (!row) return;
+    g_free(row->provider);
+    logbook_qso_free(row->qso);
+    g_free(row->last_error);
+    g_free(row->log_id);
+    g_free(row);
+}
+
+gboolean spot_db_logbook_queue_add(SpotDb *db, const gchar *provider, const LogbookQso *qso,
+                                   sqlite3_int64 *out_id, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && provider && qso, FALSE);
+
+    g_autofree gchar *qso_iso = qso->qso_datetime ? iso8601_from_borrowed_utc(qso->qso_datetime) : NULL;
+    if (!qso->callsign || !*qso->callsign || !qso->uid || !qso_iso) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                    "Missing required fields (callsign/uid/qso_datetime)");
+        return FALSE;
+    }
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+
+    // Queuing the same QSO twice for a provider is a no-op
+    const char *sql =
+        "INSERT OR IGNORE INTO logbook_queue(provider, uid, callsign, park_ref, mode, frequency_khz, "
+        "  qso_utc, rst_sent, rst_rcvd, comment) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(db->spot_db, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare logbook queue insert: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    sqlite3_bind_text(st, 1, provider, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 2, qso->uid, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 3, qso->callsign, -1, SQLITE_TRANSIENT);
+    bind_text_or_null(st, 4, qso->park_ref);
+    bind_text_or_null(st, 5, qso->mode);
+    sqlite3_bind_int (st, 6, qso->frequency_hz);
+    sqlite3_bind_text(st, 7, qso_iso, -1, SQLITE_STATIC);
+    bind_text_or_null(st, 8, qso->rst_sent);
+    bind_text_or_null(st, 9, qso->rst_received);
+    bind_text_or_null(st, 10, qso->comment);
+
+    rc = sqlite3_step(st);
+    sqlite3_finalize(st);
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "logbook queue insert: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    if (!out_id) return TRUE;
+
+    rc = sqlite3_prepare_v2(db->spot_db, "SELECT id FROM logbook_queue WHERE provider = ? AND uid = ?;",
+                            -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare logbook queue lookup: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    sqlite3_bind_text(st, 1, provider, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 2, qso->uid, -1, SQLITE_TRANSIENT);
+    *out_id = sqlite3_step(st) == SQLITE_ROW ? sqlite3_column_int64(st, 0) : 0;
+    sqlite3_finalize(st);
+    return TRUE;
+}
+
+#define LOGBOOK_QUEUE_COLUMNS \
+    "id, provider, uid, callsign, park_ref, mode, frequency_khz, qso_utc, rst_sent, rst_rcvd, " \
+    "comment, state, attempts, next_attempt, last_error, log_id"
+
+static LogbookQueueRow* logbook_queue_row_from_stmt(sqlite3_stmt *st, GTimeZone *utc)
+{
+    LogbookQueueRow *row = g_new0(LogbookQueueRow, 1);
+    row->id = sqlite3_column_int64(st, 0);
+    row->provider = g_strdup((const char*)sqlite3_column_text(st, 1));
+
+    LogbookQso *qso = logbook_qso_new();
+    qso->uid = g_strdup((const char*)sqlite3_column_text(st, 2));
+    qso->callsign = g_strdup((const char*)sqlite3_column_text(st, 3));
+    qso->park_ref = g_strdup((const char*)sqlite3_column_text(st, 4));
+    qso->mode = g_strdup((const char*)sqlite3_column_text(st, 5));
+    qso->frequency_hz = sqlite3_column_int(st, 6);
+    qso->qso_datetime = g_date_time_new_from_iso8601((const char*)sqlite3_column_text(st, 7), utc);
+    qso->rst_sent = g_strdup((const char*)sqlite3_column_text(st, 8));
+    qso->rst_received = g_strdup((const char*)sqlite3_column_text(st, 9));
+    qso->comment = g_strdup((const char*)sqlite3_column_text(st, 10));
+    row->qso = qso;
+
+    row->state = (LogbookQueueState)sqlite3_column_int(st, 11);
+    row->attempts = sqlite3_column_int(st, 12);
+    row->next_attempt = sqlite3_column_int64(st, 13);
+    row->last_error = g_strdup((const char*)sqlite3_column_text(st, 14));
+    row->log_id = g_strdup((const char*)sqlite3_column_text(st, 15));
+    return row;
+}
+
+GPtrArray* spot_db_logbook_queue_claim(SpotDb *db, const gchar *provider, gint64 now,
+                                       guint limit, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && provider, NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+
+    if (!exec_or_set_error(db->spot_db, "BEGIN IMMEDIATE;", error)) return NULL;
+
+    const char *sql =
+        "SELECT " LOGBOOK_QUEUE_COLUMNS " FROM logbook_queue "
+        "WHERE provider = ? AND state = 0 AND next_attempt <= ? ORDER BY id LIMIT ?;";
+
+    g_autoptr(GTimeZone) utc = g_time_zone_new_utc();
+    GPtrArray *rows = g_ptr_array_new_with_free_func((GDestroyNotify)logbook_queue_row_free);
+    sqlite3_stmt *st = NULL;
+    sqlite3_stmt *upd = NULL;
+
+    int rc = sqlite3_prepare_v2(db->spot_db, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) goto fail;
+    sqlite3_bind_text (st, 1, provider, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(st, 2, now);
+    sqlite3_bind_int  (st, 3, (int)limit);
+    while ((rc = sqlite3_step(st)) == SQLITE_ROW) {
+        g_ptr_array_add(rows, logbook_queue_row_from_stmt(st, utc));
+    }
+    if (rc != SQLITE_DONE) goto fail;
+
+    rc = sqlite3_prepare_v2(db->spot_db,
+                            "UPDATE logbook_queue SET state = 1, updated = strftime('%s','now') WHERE id = ?;",
+                            -1, &upd, NULL);
+    if (rc != SQLITE_OK) goto fail;
+    for (guint i = 0; i < rows->len; i++) {
+        LogbookQueueRow *row = g_ptr_array_index(rows, i);
+        sqlite3_reset(upd);
+        sqlite3_bind_int64(upd, 1, row->id);
+        rc = sqlite3_step(upd);
+        if (rc != SQLITE_DONE) goto fail;
+        row->state = LOGBOOK_QUEUE_SENDING;
+    }
+
+    sqlite3_finalize(st);
+    sqlite3_finalize(upd);
+    if (!exec_or_set_error(db->spot_db, "COMMIT;", error)) {
+        sqlite3_exec(db->spot_db, "ROLLBACK;", NULL, NULL, NULL);
+        g_ptr_array_unref(rows);
+        return NULL;
+    }
+    return rows;
+
+fail:
+    g_set_error(error, G_IO_ERROR, rc, "logbook queue claim: %s", sqlite3_errmsg(db->spot_db));
+    if (st) sqlite3_finalize(st);
+    if (upd) sqlite3_finalize(upd);
+    sqlite3_exec(db->spot_db, "ROLLBACK;", NULL, NULL, NULL);
+    g_ptr_array_unref(rows);
+    return NULL;
+}
+
+gboolean spot_db_logbook_queue_update(SpotDb *db, const LogbookQueueRow *row, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && row, FALSE);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+
+    const char *sql =
+        "UPDATE logbook_queue SET state = ?, attempts = ?, next_attempt = ?, last_error = ?, "
+        "  log_id = ?, updated = strftime('%s','now') WHERE id = ?;";
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(db->spot_db, sql, -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare logbook queue update: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    sqlite3_bind_int  (st, 1, row->state);
+    sqlite3_bind_int  (st, 2, row->attempts);
+    sqlite3_bind_int64(st, 3, row->next_attempt);
+    bind_text_or_null (st, 4, row->last_error);
+    bind_text_or_null (st, 5, row->log_id);
+    sqlite3_bind_int64(st, 6, row->id);
+
+    rc = sqlite3_step(st);
+    sqlite3_finalize(st);
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "logbook queue update: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+gboolean spot_db_logbook_queue_next_due(SpotDb *db, const gchar *provider, gint64 *out_when, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db && provider && out_when, FALSE);
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn,
+                                "SELECT MIN(next_attempt) FROM logbook_queue WHERE provider = ? AND state = 0;",
+                                -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare logbook queue due: %s", sqlite3_errmsg(conn));
+        return FALSE;
+    }
+    sqlite3_bind_text(st, 1, provider, -1, SQLITE_TRANSIENT);
+
+    gboolean found = FALSE;
+    if (sqlite3_step(st) == SQLITE_ROW && sqlite3_column_type(st, 0) != SQLITE_NULL) {
+        *out_when = sqlite3_column_int64(st, 0);
+        found = TRUE;
+    }
+    sqlite3_finalize(st);
+    return found;
+}
+
+gchar* spot_db_logbook_queue_find_logged(SpotDb *db, const gchar *provider, const LogbookQso *qso)
+{
+    g_return_val_if_fail(db && db->spot_db && provider && qso, NULL);
+
+    g_autofree gchar *qso_iso = qso->qso_datetime ? iso8601_from_borrowed_utc(qso->qso_datetime) : NULL;
+    if (!qso->callsign || !qso_iso) return NULL;
+
+    g_auto(SpotDbReadLease) lease = spot_db_read_lease(db);
+    sqlite3 *conn = lease.conn;
+
+    // Same station, park and mode in the same minute ("YYYY-MM-DDTHH:MM")
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(conn,
+        "SELECT log_id FROM logbook_queue"
+        " WHERE provider = ? AND state = 2 AND log_id IS NOT NULL"
+        "   AND callsign = ? AND park_ref IS ? AND mode IS ?"
+        "   AND substr(qso_utc, 1, 16) = substr(?, 1, 16)"
+        " LIMIT 1;",
+        -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_warning("prepare logbook queue logged lookup: %s", sqlite3_errmsg(conn));
+        return NULL;
+    }
+    sqlite3_bind_text(st, 1, provider, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(st, 2, qso->callsign, -1, SQLITE_TRANSIENT);
+    bind_text_or_null(st, 3, qso->park_ref);
+    bind_text_or_null(st, 4, qso->mode);
+    sqlite3_bind_text(st, 5, qso_iso, -1, SQLITE_STATIC);
+
+    gchar *log_id = NULL;
+    if (sqlite3_step(st) == SQLITE_ROW) {
+        log_id = g_strdup((const char*)sqlite3_column_text(st, 0));
+    }
+    sqlite3_finalize(st);
+    return log_id;
+}
+
+gboolean spot_db_logbook_queue_requeue_sending(SpotDb *db, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db, FALSE);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+    return exec_or_set_error(db->spot_db, "UPDATE logbook_queue SET state = 0 WHERE state = 1;", error);
+}
+
+gboolean spot_db_logbook_queue_prune_done(SpotDb *db, gint64 done_before, GError **error)
+{
+    g_return_val_if_fail(db && db->spot_db, FALSE);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&db->write_lock);
+
+    sqlite3_stmt *st = NULL;
+    int rc = sqlite3_prepare_v2(db->spot_db, "DELETE FROM logbook_queue WHERE state = 2 AND updated < ?;",
+                                -1, &st, NULL);
+    if (rc != SQLITE_OK) {
+        g_set_error(error, G_IO_ERROR, rc, "prepare logbook queue prune: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    sqlite3_bind_int64(st, 1, done_before);
+    rc = sqlite3_step(st);
+    sqlite3_finalize(st);
+    if (rc != SQLITE_DONE) {
+        g_set_error(error, G_IO_ERROR, rc, "logbook queue prune: %s", sqlite3_errmsg(db->spot_db));
+        return FALSE;
+    }
+    return TRUE;
+}
+
 /* ----------------- tiny datetime helpers ----------------- */
 /* Returns "YYYY-MM-DDT00:00:00Z" for the UTC day containing utc_any */
 static gchar* iso8601_day_start(GDateTime *utc_any)
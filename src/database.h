@@ -1,11 +1,16 @@
 // database.h
 #pragma once
 #include <glib.h>
+#include <gio/gio.h>
 #include <sqlite3.h>
 #include "spot.h" 
+#include "logbook.h"
 
 typedef struct {
-    sqlite3 *spot_db;
+    sqlite3     *spot_db;     // single writer connection, guarded by write_lock
+    GMutex       write_lock;
+    GAsyncQueue *readers;     // idle read-only connections (WAL readers)
+    gchar       *path;
 } SpotDb;
 
 SpotDb*
@@ -19,6 +24,15 @@ spot_db_get_instance(void);
 void
 spot_db_cleanup_instance(void);
 
+// Borrow a read-only connection for queries from any thread. Readers never wait
+// for the writer (WAL); if the pool is exhausted a temporary connection is opened.
+// Should that fail too, the writer connection is lent out under the write lock,
+// so never acquire while holding it. Every acquire must be paired with a release.
+sqlite3*
+spot_db_reader_acquire(SpotDb *db);
+void
+spot_db_reader_release(SpotDb *db, sqlite3 *conn);
+
 gboolean spot_db_add_qso_from_spot(SpotDb *db, ArtemisSpot *spot,
                                    sqlite3_int64 *out_qso_id, GError **error);
 
@@ -70,3 +84,250 @@ gboolean spot_db_had_qso_with_park_on_utc_day(SpotDb *db,
                                                const char *park_ref,
                                                GDateTime *utc_when_in_day,
                                                GError **error);
+
+// 4) Streaming iteration over qsos with optional filters.
+//    NULL or empty filter members are ignored. Dates are ISO 8601 Z strings.
+typedef struct {
+    const char *from_utc;     // inclusive lower bound on created_utc
+    const char *to_utc;       // exclusive upper bound on created_utc
+    const char *park_prefix;  // e.g. "US-" or "K-"
+    const char *mode;
+} QsoFilter;
+
+// Row fields are borrowed from the statement and only valid during the call.
+// Return FALSE (and set error) to stop the iteration with a failure.
+typedef gboolean (*QsoRowFunc)(const QsoRow *row, gpointer user_data, GError **error);
+
+// Steps a single statement ordered by created_utc; memory use does not grow with
+// the number of rows. Safe to call from a worker thread.
+gboolean spot_db_foreach_qso(SpotDb *db,
+                             const QsoFilter *filter,
+                             GCancellable *cancellable,
+                             QsoRowFunc func,
+                             gpointer user_data,
+                             GError **error);
+
+// 5) Bulk import of the pota.app hunter "parks worked" CSV export.
+//    Upserts parks rows (names, location, qso_count, first_qso_date) in batched
+//    transactions without touching local QSO history. Safe to call from a worker thread.
+gboolean spot_db_import_hunted_parks_csv(SpotDb *db,
+                                         GInputStream *stream,
+                                         GCancellable *cancellable,
+                                         guint *out_imported,
+                                         guint *out_skipped,
+                                         GError **error);
+
+// 6) Local park catalog (pota.app all-parks CSV) with full-text search.
+typedef struct {
+    gchar   *reference;
+    gchar   *name;
+    gchar   *location;   // e.g. "US-CO" (comma separated when a park spans several)
+    gchar   *grid;
+    gdouble  latitude;
+    gdouble  longitude;
+    gboolean active;
+} ParkCatalogRow;
+
+void
+park_catalog_row_free(ParkCatalogRow *row);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(ParkCatalogRow, park_catalog_row_free)
+
+// Replace the catalog with the contents of the CSV, committed in batches, then
+// drop parks the file no longer lists and rebuild the search index. Safe to
+// call from a worker thread.
+gboolean spot_db_import_park_catalog_csv(SpotDb *db,
+                                         GInputStream *stream,
+                                         GCancellable *cancellable,
+                                         guint *out_count,
+                                         GError **error);
+
+// Indexed lookup by reference (case-insensitive). NULL if unknown.
+ParkCatalogRow*
+spot_db_lookup_park(SpotDb *db, const char *reference, GError **error);
+
+// Prefix search over reference, name and location, best matches first.
+// Returns a GPtrArray* of ParkCatalogRow*; free with g_ptr_array_unref().
+GPtrArray*
+spot_db_search_parks(SpotDb *db, const char *text, guint limit, GError **error);
+
+gint64
+spot_db_park_catalog_count(SpotDb *db);
+
+// 7) Hunting statistics, kept up to date by triggers on qsos so every query
+//    is a primary-key range scan independent of log size.
+#define SPOT_DB_STAT_TOTAL    "total"     // single key "all"
+#define SPOT_DB_STAT_BAND     "band"      // "20m", "40m", ... "Other"
+#define SPOT_DB_STAT_MODE     "mode"      // upper-cased mode
+#define SPOT_DB_STAT_DAY      "day"       // UTC "YYYY-MM-DD"
+#define SPOT_DB_STAT_LOCATION "location"  // state/province, e.g. "US-CO"
+#define SPOT_DB_STAT_ENTITY   "entity"    // DX entity
+
+typedef struct {
+    gchar  *key;
+    gint64  qso_count;
+    gint64  park_count;   // distinct parks hunted
+} StatRow;
+
+void
+stat_row_free(StatRow *row);
+
+// Returns a GPtrArray* of StatRow*; free with g_ptr_array_unref().
+// Days are ordered newest first, other dimensions by parks hunted.
+GPtrArray*
+spot_db_get_stats(SpotDb *db, const char *dimension, GError **error);
+
+// Consecutive UTC days with at least one QSO. The current streak is still
+// alive if the last QSO day is today or yesterday.
+gboolean spot_db_get_streaks(SpotDb *db,
+                             GDateTime *utc_today,
+                             guint *out_current,
+                             guint *out_longest,
+                             GError **error);
+
+// Recompute all statistics from qsos/parks (used by schema migration).
+gboolean
+spot_db_rebuild_stats(SpotDb *db, GError **error);
+
+// 8) Spot snapshot archive. Each refresh is stored as the changes relative to
+//    the previous one, in a single transaction. Safe to call from a worker thread.
+typedef enum {
+    SPOT_ARCHIVE_ADDED   = 0,
+    SPOT_ARCHIVE_UPDATED = 1,
+    SPOT_ARCHIVE_REMOVED = 2,
+} SpotArchiveChange;
+
+// spots is a GPtrArray* of ArtemisSpot*; spots without a POTA spot id are ignored.
+gboolean spot_db_archive_snapshot(SpotDb *db,
+                                  GPtrArray *spots,
+                                  GDateTime *fetched_utc,
+                                  guint *out_changes,
+                                  GError **error);
+
+// Drop snapshots fetched before older_than_utc (the oldest kept snapshot becomes a
+// full keyframe) and release up to max_vacuum_pages free pages (0 = all). Pages
+// are only released on databases created with incremental auto_vacuum.
+gboolean spot_db_archive_prune(SpotDb *db,
+                               GDateTime *older_than_utc,
+                               guint max_vacuum_pages,
+                               GError **error);
+
+// Spots that were on the air at utc_when, newest first.
+// Returns a GPtrArray* of ArtemisSpot*; free with g_ptr_array_unref().
+GPtrArray*
+spot_db_archive_spots_at(SpotDb *db, GDateTime *utc_when, GError **error);
+
+// 9) Spot history search over the archive.
+typedef struct {
+    gchar     *park_ref;   // exact reference, e.g. "K-1234"
+    gchar     *activator;  // exact callsign
+    gchar     *band;       // "40m"
+    gchar     *mode;       // "CW", or the "PHONE" / "DATA" groups
+    GDateTime *since_utc;  // inclusive
+    GDateTime *until_utc;  // exclusive
+    gchar     *text;       // free words, prefix-matched against names and comments
+} SpotHistoryQuery;          // every field optional
+
+void
+spot_history_query_free(SpotHistoryQuery *query);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(SpotHistoryQuery, spot_history_query_free)
+
+// Matching spots, newest first, one per POTA spot id.
+// Returns a GPtrArray* of ArtemisSpot*; free with g_ptr_array_unref().
+GPtrArray*
+spot_db_search_spot_history(SpotDb *db, const SpotHistoryQuery *query,
+                            guint limit, GError **error);
+
+// 10) Outbox of spots to post. Every spot is written here first and removed or
+//     marked sent by the sender, so nothing is lost when the network drops.
+typedef enum {
+    SPOT_OUTBOX_QUEUED  = 0,   // waiting for its next attempt
+    SPOT_OUTBOX_SENDING = 1,   // a POST is in flight
+    SPOT_OUTBOX_SENT    = 2,
+    SPOT_OUTBOX_FAILED  = 3,   // rejected by the server; not retried
+} SpotOutboxState;
+
+typedef struct {
+    sqlite3_int64    id;
+    ArtemisSpot     *spot;          // what gets posted; spot time is when it was queued
+    SpotOutboxState  state;
+    gint             attempts;
+    gint64           next_attempt;  // unix seconds; 0 = as soon as possible
+    gboolean         unconfirmed;   // an earlier attempt may have reached the server
+    gchar           *last_error;
+} SpotOutboxRow;
+
+void
+spot_outbox_row_free(SpotOutboxRow *row);
+
+// Queue a spot. If the same spot is already waiting nothing is added, out_duplicate
+// is set and out_id is the waiting row.
+gboolean spot_db_outbox_add(SpotDb *db, ArtemisSpot *spot, sqlite3_int64 *out_id,
+                            gboolean *out_duplicate, GError **error);
+
+// Every row, oldest first. Returns a GPtrArray* of SpotOutboxRow*; free with g_ptr_array_unref().
+GPtrArray*
+spot_db_outbox_list(SpotDb *db, GError **error);
+
+// Store state, attempts, next_attempt, unconfirmed and last_error of row. Fails
+// with G_IO_ERROR_EXISTS when requeuing it would leave the same spot waiting twice.
+gboolean
+spot_db_outbox_update(SpotDb *db, const SpotOutboxRow *row, GError **error);
+gboolean
+spot_db_outbox_remove(SpotDb *db, sqlite3_int64 id, GError **error);
+// Drop sent rows last touched before sent_before (unix seconds)
+gboolean
+spot_db_outbox_prune_sent(SpotDb *db, gint64 sent_before, GError **error);
+
+// 11) Logbook upload queue. A QSO is stored once per provider and drained by
+//     LogbookQueue; uploaded rows keep the provider's log id until pruned.
+typedef enum {
+    LOGBOOK_QUEUE_PENDING  = 0,
+    LOGBOOK_QUEUE_SENDING  = 1,
+    LOGBOOK_QUEUE_DONE     = 2,
+    LOGBOOK_QUEUE_FAILED   = 3,   // refused or out of attempts
+} LogbookQueueState;
+
+typedef struct {
+    sqlite3_int64      id;
+    gchar             *provider;
+    LogbookQso        *qso;           // qso->uid is the idempotency key
+    LogbookQueueState  state;
+    gint               attempts;
+    gint64             next_attempt;  // unix seconds
+    gchar             *last_error;
+    gchar             *log_id;
+} LogbookQueueRow;
+
+void
+logbook_queue_row_free(LogbookQueueRow *row);
+
+// Queue qso for provider. A QSO already queued for it (same uid) is left alone.
+gboolean spot_db_logbook_queue_add(SpotDb *db, const gchar *provider, const LogbookQso *qso,
+                                   sqlite3_int64 *out_id, GError **error);
+
+// Up to limit pending rows due by now, oldest first, marked sending in the same
+// transaction. Returns a GPtrArray* of LogbookQueueRow*.
+GPtrArray* spot_db_logbook_queue_claim(SpotDb *db, const gchar *provider, gint64 now,
+                                       guint limit, GError **error);
+
+// Store state, attempts, next_attempt, last_error and log_id of row
+gboolean
+spot_db_logbook_queue_update(SpotDb *db, const LogbookQueueRow *row, GError **error);
+
+// Earliest next_attempt of a pending row; FALSE if there is none
+gboolean spot_db_logbook_queue_next_due(SpotDb *db, const gchar *provider, gint64 *out_when,
+                                        GError **error);
+
+// Log id of an uploaded row for the same contact as qso (callsign, park, mode and
+// minute, whatever the uid), or NULL if the provider has none. Free with g_free().
+gchar* spot_db_logbook_queue_find_logged(SpotDb *db, const gchar *provider, const LogbookQso *qso);
+
+// Put rows left sending by an earlier run back in line
+gboolean
+spot_db_logbook_queue_requeue_sending(SpotDb *db, GError **error);
+
+// Drop uploaded rows last touched before done_before (unix seconds). Their log
+// ids go with them, so keep them as long as a resubmitted contact should still
+// be found by spot_db_logbook_queue_find_logged().
+gboolean
+spot_db_logbook_queue_prune_done(SpotDb *db, gint64 done_before, GError **error);
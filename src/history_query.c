@@ -0,0 +1,167 @@
+// history_query.c - Turn a search-entry phrase into a spot history query
+#include "history_query.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+
+static const char *const STOPWORDS[] = {
+  "who", "what", "which", "when", "did", "i", "me", "show", "find",
+  "worked", "work", "working", "spotted", "spot", "spots", "activated", "activating",
+  "was", "were", "is", "on", "in", "at", "the", "a", "an", "for", "with", "from",
+  "and", "during", "park", "parks",
+};
+
+static const char *const QUERY_MODES[] = {
+  "SSB", "CW", "FT8", "FT4", "FM", "AM", "RTTY", "JT65", "PSK31", "JS8", "PHONE", "DATA",
+};
+
+static gboolean
+word_in(const char *word, const char *const *list, gsize n)
+{
+  for (gsize i = 0; i < n; i++) {
+    if (g_ascii_strcasecmp(word, list[i]) == 0) return TRUE;
+  }
+  return FALSE;
+}
+
+static const char*
+match_band(const char *word)
+{
+  for (gsize i = 1; i < G_N_ELEMENTS(BANDS); i++) { // skip "All"
+    if (g_ascii_strcasecmp(word, BANDS[i]) == 0) return BANDS[i];
+  }
+  return NULL;
+}
+
+static gboolean
+looks_like_park_ref(const char *word)
+{
+  return g_regex_match_simple("^[A-Z0-9]{1,4}-[0-9]{4,5}$", word, G_REGEX_CASELESS, 0);
+}
+
+// Prefix with a digit, e.g. K0VCZ, VE3ABC, KH6/W1AW. Bands are checked first.
+static gboolean
+looks_like_callsign(const char *word)
+{
+  return g_regex_match_simple("^([A-Z0-9]{1,3}/)?[A-Z0-9]{0,2}[A-Z][0-9][A-Z]{1,4}(/[A-Z0-9]+)?$",
+                              word, G_REGEX_CASELESS, 0);
+}
+
+static GDateTime*
+start_of_day(GDateTime *utc)
+{
+  return g_date_time_new_utc(g_date_time_get_year(utc), g_date_time_get_month(utc),
+                             g_date_time_get_day_of_month(utc), 0, 0, 0);
+}
+
+// Consumes one or more words starting at words[*i]; on success sets the range
+static gboolean
+match_time_phrase(char **words, guint n_words, guint *i, GDateTime *now,
+                  GDateTime **since, GDateTime **until)
+{
+  const char *w = words[*i];
+  const char *next = *i + 1 < n_words ? words[*i + 1] : NULL;
+  const char *after = *i + 2 < n_words ? words[*i + 2] : NULL;
+  g_autoptr(GDateTime) today = start_of_day(now);
+
+  if (g_ascii_strcasecmp(w, "today") == 0) {
+    *since = g_date_time_ref(today);
+    *until = NULL;
+    return TRUE;
+  }
+  if (g_ascii_strcasecmp(w, "yesterday") == 0) {
+    *since = g_date_time_add_days(today, -1);
+    *until = g_date_time_ref(today);
+    return TRUE;
+  }
+  if (!next) return FALSE;
+
+  if (g_ascii_strcasecmp(w, "this") == 0) {
+    if (g_ascii_strcasecmp(next, "week") == 0) {        // since Monday
+      *since = g_date_time_add_days(today, 1 - g_date_time_get_day_of_week(today));
+    } else if (g_ascii_strcasecmp(next, "month") == 0) {
+      *since = g_date_time_add_days(today, 1 - g_date_time_get_day_of_month(today));
+    } else {
+      return FALSE;
+    }
+    *until = NULL;
+    *i += 1;
+    return TRUE;
+  }
+
+  if (g_ascii_strcasecmp(w, "last") != 0 && g_ascii_strcasecmp(w, "past") != 0) return FALSE;
+
+  // "last week" / "last month" are rolling windows ending now
+  if (g_ascii_strcasecmp(next, "week") == 0) {
+    *since = g_date_time_add_days(now, -7);
+  } else if (g_ascii_strcasecmp(next, "month") == 0) {
+    *since = g_date_time_add_days(now, -30);
+  } else if (g_ascii_isdigit(*next) && after) {         // "last 3 days"
+    gint64 n = g_ascii_strtoll(next, NULL, 10);
+    if (n <= 0 || n > 3650) return FALSE;
+    if (g_ascii_strncasecmp(after, "hour", 4) == 0) {
+      *since = g_date_time_add_hours(now, -(gint)n);
+    } else if (g_ascii_strncasecmp(after, "day", 3) == 0) {
+      *since = g_date_time_add_days(now, -(gint)n);
+    } else if (g_ascii_strncasecmp(after, "week", 4) == 0) {
+      *since = g_date_time_add_weeks(now, -(gint)n);
+    } else {
+      return FALSE;
+    }
+    *i += 1;
+  } else {
+    return FALSE;
+  }
+
+  *until = NULL;
+  *i += 1;
+  return TRUE;
+}
+
+SpotHistoryQuery*
+history_query_parse(const char *text, GDateTime *now_utc)
+{
+  SpotHistoryQuery *query = g_new0(SpotHistoryQuery, 1);
+  if (!text || !*text) return query;
+
+  g_autoptr(GDateTime) now = now_utc ? g_date_time_to_utc(now_utc) : g_date_time_new_now_utc();
+  g_autofree gchar *trimmed = g_strstrip(g_strdup(text));
+  g_auto(GStrv) words = g_strsplit_set(trimmed, " \t,", -1);
+  g_autoptr(GString) rest = g_string_new(NULL);
+  guint n_words = g_strv_length(words);
+
+  // Trim trailing punctuation ("K-1234?") but keep '-' and '/'
+  for (guint i = 0; i < n_words; i++) {
+    gsize len = strlen(words[i]);
+    while (len > 0 && strchr("?!.;:\"'", words[i][len - 1])) words[i][--len] = '\0';
+  }
+
+  for (guint i = 0; i < n_words; i++) {
+    const char *w = words[i];
+    const char *band;
+    GDateTime *since = NULL, *until = NULL;
+
+    if (!*w || word_in(w, STOPWORDS, G_N_ELEMENTS(STOPWORDS))) continue;
+
+    if (!query->park_ref && looks_like_park_ref(w)) {
+      query->park_ref = g_ascii_strup(w, -1);
+    } else if (!query->band && (band = match_band(w))) {
+      query->band = g_strdup(band);
+    } else if (!query->mode && word_in(w, QUERY_MODES, G_N_ELEMENTS(QUERY_MODES))) {
+      query->mode = g_ascii_strup(w, -1);
+    } else if (!query->since_utc && match_time_phrase(words, n_words, &i, now, &since, &until)) {
+      query->since_utc = since;
+      query->until_utc = until;
+    } else if (!query->activator && looks_like_callsign(w)) {
+      query->activator = g_ascii_strup(w, -1);
+    } else {
+      if (rest->len) g_string_append_c(rest, ' ');
+      g_string_append(rest, w);
+    }
+  }
+
+  if (rest->len) query->text = g_string_free(g_steal_pointer(&rest), FALSE);
+  return query;
+}
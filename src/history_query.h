@@ -0,0 +1,17 @@
+// history_query.h - Turn a search-entry phrase into a spot history query
+#pragma once
+
+#include <glib.h>
+
+#include "database.h"
+
+G_BEGIN_DECLS
+
+// Understands park references, callsigns, bands, modes and time phrases such as
+// "today", "yesterday", "this week", "last month" or "last 3 days"; filler words
+// ("who worked ... on") are dropped and anything else is searched as text.
+// now_utc anchors the time phrases. Never returns NULL.
+SpotHistoryQuery*
+history_query_parse(const char *text, GDateTime *now_utc);
+
+G_END_DECLS
@@ -0,0 +1,172 @@
+#include "http_session.h"
+
+#include "artemis.h"
+
+#include <glib/gstdio.h>
+
+// Write the cache index every few minutes so a crash only loses recent entries
+#define CACHE_DUMP_INTERVAL_SECS 300
+
+// Set on a message once it had to resolve or connect
+#define NEW_CONNECTION_KEY "http-session-new-connection"
+
+static SoupSession     *g_http_session = NULL;
+static SoupCache       *g_http_cache = NULL;
+static gboolean         g_cache_dirty = FALSE;  // requests since the last dump
+static guint            g_cache_dump_id = 0;
+static HttpSessionStats g_stats;
+
+static void
+log_stats(void)
+{
+  if (g_stats.requests == 0) return;
+  guint64 on_network = g_stats.new_connections + g_stats.reused;
+  g_debug("HTTP: %" G_GUINT64_FORMAT " requests, %" G_GUINT64_FORMAT " from cache, "
+          "%" G_GUINT64_FORMAT " new connections, %.0f%% connection reuse",
+          g_stats.requests, g_stats.from_cache, g_stats.new_connections,
+          on_network ? 100.0 * g_stats.reused / on_network : 0.0);
+}
+
+static gboolean
+cache_dump_idle(gpointer user_data)
+{
+  if (g_http_cache) soup_cache_dump(g_http_cache);
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+cache_dump_tick(gpointer user_data)
+{
+  if (g_cache_dirty) {
+    g_cache_dirty = FALSE;
+    // SoupCache is main-thread only; run the dump once nothing more urgent is pending
+    g_idle_add_full(G_PRIORITY_LOW, cache_dump_idle, NULL, NULL);
+    log_stats();
+  }
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+on_network_event(SoupMessage *msg, GSocketClientEvent event, GIOStream *connection, gpointer user_data)
+{
+  if (event == G_SOCKET_CLIENT_RESOLVING || event == G_SOCKET_CLIENT_CONNECTING) {
+    g_object_set_data(G_OBJECT(msg), NEW_CONNECTION_KEY, GINT_TO_POINTER(TRUE));
+  }
+}
+
+static void
+on_message_finished(SoupMessage *msg, gpointer user_data)
+{
+  g_stats.requests++;
+  if (g_object_get_data(G_OBJECT(msg), NEW_CONNECTION_KEY)) {
+    g_stats.new_connections++;
+  } else if (soup_message_get_connection_id(msg) != 0) {
+    g_stats.reused++;
+  } else if (SOUP_STATUS_IS_SUCCESSFUL(soup_message_get_status(msg))) {
+    g_stats.from_cache++;
+  }
+}
+
+static void
+on_request_queued(SoupSession *session, SoupMessage *msg, gpointer user_data)
+{
+  g_cache_dirty = TRUE;
+  g_signal_connect(msg, "network-event", G_CALLBACK(on_network_event), NULL);
+  g_signal_connect(msg, "finished", G_CALLBACK(on_message_finished), NULL);
+}
+
+// Per-client caches from before the session was shared; nothing reads them any more
+static const char *const LEGACY_CACHE_DIRS[] = { "pota_spots.cache", "gravatar.cache" };
+
+// SoupCache keeps a flat directory of entry files plus its index
+static void
+delete_cache_dir(const gchar *path)
+{
+  g_autoptr(GDir) dir = g_dir_open(path, 0, NULL);
+  if (!dir) return;
+
+  const gchar *name;
+  while ((name = g_dir_read_name(dir)) != NULL) {
+    g_autofree gchar *entry = g_build_filename(path, name, NULL);
+    g_remove(entry);
+  }
+  if (g_rmdir(path) == 0) g_debug("Removed old HTTP cache %s", path);
+}
+
+static void
+delete_legacy_caches_thread(GTask *task, gpointer source_object, gpointer task_data, GCancellable *cancellable)
+{
+  const gchar *app_dir = task_data;
+  for (guint i = 0; i < G_N_ELEMENTS(LEGACY_CACHE_DIRS); i++) {
+    g_autofree gchar *path = g_build_filename(app_dir, LEGACY_CACHE_DIRS[i], NULL);
+    delete_cache_dir(path);
+  }
+}
+
+static void
+on_cache_size_changed(GSettings *settings, const char *key, gpointer user_data)
+{
+  guint64 mib = (guint64)g_settings_get_int(settings, "http-cache-size");
+  soup_cache_set_max_size(g_http_cache, (guint)MIN(mib * 1024 * 1024, G_MAXUINT));
+}
+
+SoupSession *
+http_session_get_instance(void)
+{
+  if (g_http_session) return g_http_session;
+
+  g_autofree gchar *user_agent = g_strdup_printf("Artemis/%d.%d.%d",
+                                                 VERSION_MAJOR(APP_VERSION),
+                                                 VERSION_MINOR(APP_VERSION),
+                                                 VERSION_PATCH(APP_VERSION));
+  g_http_session = soup_session_new_with_options(
+    "timeout", 30,
+    "idle-timeout", 15,
+    "max-conns-per-host", HTTP_SESSION_MAX_CONNS_PER_HOST,
+    "user-agent", user_agent,
+    NULL);
+
+  g_autofree gchar *app_dir = g_build_filename(g_get_user_data_dir(), "artemis", NULL);
+  g_mkdir_with_parents(app_dir, 0700);
+  g_autofree gchar *cache_path = g_build_filename(app_dir, "http.cache", NULL);
+  g_http_cache = soup_cache_new(cache_path, SOUP_CACHE_SINGLE_USER);
+  soup_cache_load(g_http_cache);
+
+  // Off the main thread; an old cache can hold thousands of files
+  g_autoptr(GTask) cleanup = g_task_new(NULL, NULL, NULL, NULL);
+  g_task_set_task_data(cleanup, g_strdup(app_dir), g_free);
+  g_task_run_in_thread(cleanup, delete_legacy_caches_thread);
+
+  GSettings *settings = artemis_app_get_settings();
+  on_cache_size_changed(settings, "http-cache-size", NULL);
+  g_signal_connect(settings, "changed::http-cache-size", G_CALLBACK(on_cache_size_changed), NULL);
+
+  soup_session_add_feature(g_http_session, SOUP_SESSION_FEATURE(g_http_cache));
+  g_signal_connect(g_http_session, "request-queued", G_CALLBACK(on_request_queued), NULL);
+  g_cache_dump_id = g_timeout_add_seconds(CACHE_DUMP_INTERVAL_SECS, cache_dump_tick, NULL);
+
+  return g_http_session;
+}
+
+void
+http_session_cleanup_instance(void)
+{
+  if (!g_http_session) return;
+
+  log_stats();
+  g_clear_handle_id(&g_cache_dump_id, g_source_remove);
+  g_signal_handlers_disconnect_by_func(artemis_app_get_settings(), on_cache_size_changed, NULL);
+
+  soup_cache_flush(g_http_cache);
+  soup_cache_dump(g_http_cache);
+  soup_session_abort(g_http_session);
+  g_clear_object(&g_http_cache);
+  g_clear_object(&g_http_session);
+}
+
+void
+http_session_get_stats(HttpSessionStats *out_stats)
+{
+  g_return_if_fail(out_stats != NULL);
+  *out_stats = g_stats;
+}
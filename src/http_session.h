@@ -0,0 +1,29 @@
+#pragma once
+
+#include <glib.h>
+#include <libsoup/soup.h>
+
+G_BEGIN_DECLS
+
+// Connections kept open per host; request schedulers should not go above it
+#define HTTP_SESSION_MAX_CONNS_PER_HOST 4
+
+typedef struct {
+  guint64 requests;         // finished messages
+  guint64 new_connections;  // messages that had to open a connection
+  guint64 reused;           // messages sent on an already open connection
+  guint64 from_cache;       // messages answered from the disk cache
+} HttpSessionStats;
+
+/* The application's one SoupSession, shared by every HTTP client so they
+ * share the connection pool, TLS sessions and the disk cache. Main thread
+ * only; take a reference if you keep it. */
+SoupSession *http_session_get_instance(void);
+// Flushes and writes out the cache, then drops the session
+void
+http_session_cleanup_instance(void);
+
+void
+http_session_get_stats(HttpSessionStats *out_stats);
+
+G_END_DECLS
@@ -3,10 +3,20 @@
 
 G_DEFINE_ABSTRACT_TYPE(LogbookProvider, logbook_provider, G_TYPE_OBJECT)
 
+G_DEFINE_QUARK(logbook-error-quark, logbook_error)
+
+static void logbook_provider_real_log_qsos_async(LogbookProvider *provider,
+                                                 GPtrArray *qsos,
+                                                 GCancellable *cancellable,
+                                                 GAsyncReadyCallback callback,
+                                                 gpointer user_data);
+
 static void
 logbook_provider_class_init(LogbookProviderClass *klass)
 {
     // Virtual methods will be implemented by subclasses
+    klass->log_qsos_async = logbook_provider_real_log_qsos_async;
+    klass->max_batch = 1;
 }
 
 static void
@@ -78,6 +88,137 @@ logbook_provider_get_name(LogbookProvider *provider)
     return "Unknown";
 }
 
+// Default batch: one log_qso_async after another, collecting each outcome
+typedef struct {
+    GPtrArray *qsos;      // LogbookQso*
+    GPtrArray *results;   // LogbookResult*
+} SequentialBatch;
+
+static void
+sequential_batch_free(SequentialBatch *batch)
+{
+    g_ptr_array_unref(batch->qsos);
+    g_ptr_array_unref(batch->results);
+    g_free(batch);
+}
+
+static void sequential_batch_next(GTask *task);
+
+static void
+sequential_batch_logged(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+    SequentialBatch *batch = g_task_get_task_data(task);
+    LogbookProviderClass *klass = LOGBOOK_PROVIDER_GET_CLASS(source);
+    GError *error = NULL;
+    g_autofree gchar *log_id = NULL;
+
+    if (klass->log_qso_finish_with_id) {
+        klass->log_qso_finish_with_id(LOGBOOK_PROVIDER(source), res, &log_id, &error);
+    } else {
+        logbook_provider_log_qso_finish(LOGBOOK_PROVIDER(source), res, &error);
+    }
+    g_ptr_array_add(batch->results, logbook_result_new(error, log_id));
+    sequential_batch_next(g_steal_pointer(&task));
+}
+
+static void
+sequential_batch_next(GTask *task)
+{
+    SequentialBatch *batch = g_task_get_task_data(task);
+    guint i = batch->results->len;
+
+    if (i == batch->qsos->len) {
+        g_task_return_pointer(task, g_ptr_array_ref(batch->results), (GDestroyNotify)g_ptr_array_unref);
+        g_object_unref(task);
+        return;
+    }
+
+    LogbookProvider *provider = g_task_get_source_object(task);
+    logbook_provider_log_qso_async(provider, g_ptr_array_index(batch->qsos, i),
+                                   g_task_get_cancellable(task), sequential_batch_logged, task);
+}
+
+static void
+logbook_provider_real_log_qsos_async(LogbookProvider *provider,
+                                     GPtrArray *qsos,
+                                     GCancellable *cancellable,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data)
+{
+    SequentialBatch *batch = g_new0(SequentialBatch, 1);
+    batch->qsos = g_ptr_array_ref(qsos);
+    batch->results = g_ptr_array_new_with_free_func((GDestroyNotify)logbook_result_free);
+
+    GTask *task = g_task_new(provider, cancellable, callback, user_data);
+    g_task_set_source_tag(task, logbook_provider_real_log_qsos_async);
+    g_task_set_task_data(task, batch, (GDestroyNotify)sequential_batch_free);
+    sequential_batch_next(task);
+}
+
+void
+logbook_provider_log_qsos_async(LogbookProvider *provider,
+                                GPtrArray *qsos,
+                                GCancellable *cancellable,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
+{
+    g_return_if_fail(LOGBOOK_IS_PROVIDER(provider));
+    g_return_if_fail(qsos != NULL && qsos->len > 0);
+
+    LOGBOOK_PROVIDER_GET_CLASS(provider)->log_qsos_async(provider, qsos, cancellable, callback, user_data);
+}
+
+GPtrArray*
+logbook_provider_log_qsos_finish(LogbookProvider *provider,
+                                 GAsyncResult *result,
+                                 GError **error)
+{
+    g_return_val_if_fail(LOGBOOK_IS_PROVIDER(provider), NULL);
+    g_return_val_if_fail(G_IS_ASYNC_RESULT(result), NULL);
+
+    LogbookProviderClass *klass = LOGBOOK_PROVIDER_GET_CLASS(provider);
+    if (klass->log_qsos_finish) {
+        return klass->log_qsos_finish(provider, result, error);
+    }
+
+    return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+guint
+logbook_provider_get_max_batch(LogbookProvider *provider)
+{
+    g_return_val_if_fail(LOGBOOK_IS_PROVIDER(provider), 1);
+    return MAX(1, LOGBOOK_PROVIDER_GET_CLASS(provider)->max_batch);
+}
+
+gboolean
+logbook_provider_is_credential_key(LogbookProvider *provider, const gchar *key)
+{
+    g_return_val_if_fail(LOGBOOK_IS_PROVIDER(provider), FALSE);
+
+    const gchar *const *keys = LOGBOOK_PROVIDER_GET_CLASS(provider)->credential_keys;
+    return keys && key && g_strv_contains(keys, key);
+}
+
+LogbookResult*
+logbook_result_new(GError *error, const gchar *log_id)
+{
+    LogbookResult *result = g_new0(LogbookResult, 1);
+    result->error = error;
+    result->log_id = g_strdup(log_id);
+    return result;
+}
+
+void
+logbook_result_free(LogbookResult *result)
+{
+    if (!result) return;
+    g_clear_error(&result->error);
+    g_free(result->log_id);
+    g_free(result);
+}
+
 // QSO data helpers
 LogbookQso*
 logbook_qso_new(void)
@@ -97,12 +238,31 @@ logbook_qso_free(LogbookQso *qso)
     g_free(qso->rst_sent);
     g_free(qso->rst_received);
     g_free(qso->comment);
+    g_free(qso->uid);
     if (qso->qso_datetime) {
         g_date_time_unref(qso->qso_datetime);
     }
     g_free(qso);
 }
 
+LogbookQso*
+logbook_qso_copy(const LogbookQso *qso)
+{
+    g_return_val_if_fail(qso != NULL, NULL);
+
+    LogbookQso *copy = logbook_qso_new();
+    copy->callsign = g_strdup(qso->callsign);
+    copy->park_ref = g_strdup(qso->park_ref);
+    copy->mode = g_strdup(qso->mode);
+    copy->frequency_hz = qso->frequency_hz;
+    copy->qso_datetime = qso->qso_datetime ? g_date_time_ref(qso->qso_datetime) : NULL;
+    copy->rst_sent = g_strdup(qso->rst_sent);
+    copy->rst_received = g_strdup(qso->rst_received);
+    copy->comment = g_strdup(qso->comment);
+    copy->uid = g_strdup(qso->uid);
+    return copy;
+}
+
 LogbookQso*
 logbook_qso_from_spot(ArtemisSpot *spot, const gchar *rst_sent, const gchar *rst_received)
 {
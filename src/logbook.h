@@ -11,6 +11,20 @@ G_BEGIN_DECLS
 typedef struct _LogbookProvider LogbookProvider;
 typedef struct _LogbookProviderClass LogbookProviderClass;
 
+#define LOGBOOK_ERROR (logbook_error_quark())
+
+// Errors a provider reports for a record; anything else is treated as transient
+typedef enum {
+    // The service refused the record itself; sending it again will not help
+    LOGBOOK_ERROR_REJECTED,
+    // The service already has this record
+    LOGBOOK_ERROR_DUPLICATE,
+    // Missing or refused credentials
+    LOGBOOK_ERROR_AUTH,
+} LogbookError;
+
+GQuark logbook_error_quark(void);
+
 // QSO data structure for logging
 typedef struct {
     gchar *callsign;
@@ -21,8 +35,15 @@ typedef struct {
     gchar *rst_sent;
     gchar *rst_received;
     gchar *comment;
+    gchar *uid;         // idempotency key, stable across retries; set by the queue
 } LogbookQso;
 
+// Outcome of one record of a batch
+typedef struct {
+    GError *error;      // NULL if the record was accepted
+    gchar  *log_id;     // the service's id for the record, if it returns one
+} LogbookResult;
+
 #define LOGBOOK_TYPE_PROVIDER (logbook_provider_get_type())
 G_DECLARE_DERIVABLE_TYPE(LogbookProvider, logbook_provider, LOGBOOK, PROVIDER, GObject)
 
@@ -41,6 +62,32 @@ struct _LogbookProviderClass {
                               GAsyncResult *result,
                               GError **error);
     const gchar* (*get_name)(LogbookProvider *provider);
+
+    // Several records in one round trip. The default sends them one at a time
+    // through log_qso_async. finish returns a GPtrArray of LogbookResult*, one
+    // per QSO in order, or NULL if the batch as a whole failed.
+    void (*log_qsos_async)(LogbookProvider *provider,
+                          GPtrArray *qsos,
+                          GCancellable *cancellable,
+                          GAsyncReadyCallback callback,
+                          gpointer user_data);
+    GPtrArray* (*log_qsos_finish)(LogbookProvider *provider,
+                                 GAsyncResult *result,
+                                 GError **error);
+
+    // Optional. Finish log_qso_async and also hand back the service's id for the
+    // record (NULL if it gave none); the default batch uses it so the id is kept.
+    gboolean (*log_qso_finish_with_id)(LogbookProvider *provider,
+                                      GAsyncResult *result,
+                                      gchar **out_log_id,
+                                      GError **error);
+
+    // Largest batch the service accepts; 1 unless the subclass says otherwise
+    guint max_batch;
+
+    // NULL-terminated settings keys holding the credentials the service checks;
+    // NULL if it has none
+    const gchar *const *credential_keys;
 };
 
 // Interface methods
@@ -57,14 +104,36 @@ gboolean logbook_provider_log_qso_finish(LogbookProvider *provider,
 const gchar*
 logbook_provider_get_name(LogbookProvider *provider);
 
+// qsos: GPtrArray of LogbookQso*; at most logbook_provider_get_max_batch() of them
+void logbook_provider_log_qsos_async(LogbookProvider *provider,
+                                    GPtrArray *qsos,
+                                    GCancellable *cancellable,
+                                    GAsyncReadyCallback callback,
+                                    gpointer user_data);
+GPtrArray* logbook_provider_log_qsos_finish(LogbookProvider *provider,
+                                           GAsyncResult *result,
+                                           GError **error);
+guint
+logbook_provider_get_max_batch(LogbookProvider *provider);
+// Whether the settings key is one of the provider's credential_keys
+gboolean
+logbook_provider_is_credential_key(LogbookProvider *provider, const gchar *key);
+
 // QSO data helpers
 LogbookQso*
 logbook_qso_new(void);
 void
 logbook_qso_free(LogbookQso *qso);
 LogbookQso*
+logbook_qso_copy(const LogbookQso *qso);
+LogbookQso*
 logbook_qso_from_spot(ArtemisSpot *spot, const gchar *rst_sent, const gchar *rst_received);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(LogbookQso, logbook_qso_free)
 
+LogbookResult*
+logbook_result_new(GError *error, const gchar *log_id);
+void
+logbook_result_free(LogbookResult *result);
+
 G_END_DECLS
\ No newline at end of file
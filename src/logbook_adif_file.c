@@ -0,0 +1,454 @@
+// logbook_adif_file.c - Local ADIF file logbook provider
+#include "logbook_adif_file.h"
+#include "adif.h"
+#include "artemis.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+
+// Records arriving within this window share one write and one fsync
+#define FLUSH_WINDOW_MS 250
+
+// Records taken per log_qsos call; appending is cheap, so the queue may hand over a lot
+#define ADIF_MAX_BATCH  64
+
+// Open file state; only the flush thread touches it, and flushes never overlap
+typedef struct {
+    gchar      *path;
+    int         fd;
+    GHashTable *uids;     // uids of every record in the file
+} AdifWriter;
+
+struct _LogbookAdifFile {
+    LogbookProvider parent_instance;
+
+    GPtrArray *pending;   // PendingWrite*, waiting for the next flush
+    guint      flush_id;
+    gboolean   flushing;
+
+    AdifWriter writer;
+};
+
+G_DEFINE_FINAL_TYPE(LogbookAdifFile, logbook_adif_file, LOGBOOK_TYPE_PROVIDER)
+
+typedef struct {
+    gchar         *uid;
+    gchar         *text;
+    LogbookResult *result;  // filled in by the flush
+} AdifRecord;
+
+// One log_qso(s) call; completes when all of its records are on disk
+typedef struct {
+    GTask     *task;
+    GPtrArray *records;     // AdifRecord*
+    gboolean   single;      // from log_qso_async: return a boolean, not results
+} PendingWrite;
+
+typedef struct {
+    gchar     *path;
+    GPtrArray *writes;      // PendingWrite*
+} FlushJob;
+
+static void logbook_adif_file_schedule_flush(LogbookAdifFile *self);
+
+static void
+adif_record_free(AdifRecord *record)
+{
+    g_free(record->uid);
+    g_free(record->text);
+    logbook_result_free(record->result);
+    g_free(record);
+}
+
+static void
+pending_write_free(PendingWrite *write)
+{
+    g_clear_object(&write->task);
+    g_ptr_array_unref(write->records);
+    g_free(write);
+}
+
+static void
+flush_job_free(FlushJob *job)
+{
+    g_free(job->path);
+    g_ptr_array_unref(job->writes);
+    g_free(job);
+}
+
+static gchar*
+configured_path(void)
+{
+    g_autofree gchar *path = g_settings_get_string(artemis_app_get_settings(), "adif-log-path");
+    g_strstrip(path);
+    if (!*path) return NULL;
+    if (g_str_has_prefix(path, "~/")) return g_build_filename(g_get_home_dir(), path + 2, NULL);
+    return g_steal_pointer(&path);
+}
+
+/* ----------------- writer, flush thread only ----------------- */
+
+static void
+adif_writer_close(AdifWriter *w)
+{
+    if (w->fd >= 0) g_close(w->fd, NULL);
+    w->fd = -1;
+    g_clear_pointer(&w->path, g_free);
+    g_clear_pointer(&w->uids, g_hash_table_unref);
+}
+
+static gboolean
+set_errno_error(GError **error, int err, const char *what, const char *path)
+{
+    g_set_error(error, G_IO_ERROR, g_io_error_from_errno(err), "%s %s: %s", what, path, g_strerror(err));
+    return FALSE;
+}
+
+static gboolean
+write_all(int fd, const char *data, gsize len, const char *path, GError **error)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return set_errno_error(error, errno, "Cannot write", path);
+        }
+        data += n;
+        len -= (gsize)n;
+    }
+    if (fsync(fd) != 0) return set_errno_error(error, errno, "Cannot sync", path);
+    return TRUE;
+}
+
+// Length of data up to and including the last <EOR> or <EOH> and its line break
+static gsize
+complete_length(const gchar *data, gsize len)
+{
+    for (gsize i = len >= 5 ? len - 5 + 1 : 0; i-- > 0;) {
+        if (data[i] != '<') continue;
+        if (g_ascii_strncasecmp(data + i, "<eor>", 5) != 0 &&
+            g_ascii_strncasecmp(data + i, "<eoh>", 5) != 0) continue;
+
+        gsize end = i + 5;
+        if (end < len && data[end] == '\r') end++;
+        if (end < len && data[end] == '\n') end++;
+        return end;
+    }
+    return 0;
+}
+
+static void
+collect_uids(GHashTable *uids, const gchar *data, gsize len)
+{
+    static const gsize tag_len = sizeof("<" ADIF_UID_FIELD ":") - 1;
+
+    for (gsize i = 0; i + tag_len < len; i++) {
+        if (data[i] != '<' || g_ascii_strncasecmp(data + i, "<" ADIF_UID_FIELD ":", tag_len) != 0) continue;
+
+        gsize p = i + tag_len;
+        gsize value_len = 0;
+        while (p < len && g_ascii_isdigit(data[p])) value_len = value_len * 10 + (data[p++] - '0');
+        while (p < len && data[p] != '>') p++;   // skip an optional ":type"
+        if (p >= len || value_len == 0 || p + 1 + value_len > len) continue;
+
+        g_hash_table_add(uids, g_strndup(data + p + 1, value_len));
+        i = p + value_len;
+    }
+}
+
+/* Open path for appending. Anything after the last complete record is the tail
+ * of a write that was cut short; it is truncated away before we add to the file. */
+static gboolean
+adif_writer_open(AdifWriter *w, const gchar *path, GError **error)
+{
+    g_autofree gchar *dir = g_path_get_dirname(path);
+    if (g_mkdir_with_parents(dir, 0755) != 0) return set_errno_error(error, errno, "Cannot create", dir);
+
+    int fd = g_open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return set_errno_error(error, errno, "Cannot open", path);
+
+    g_autofree gchar *data = NULL;
+    gsize len = 0;
+    if (!g_file_get_contents(path, &data, &len, error)) {
+        g_close(fd, NULL);
+        return FALSE;
+    }
+
+    gsize good = complete_length(data, len);
+    if (good < len) {
+        if (ftruncate(fd, (off_t)good) != 0) {
+            int err = errno;
+            g_close(fd, NULL);
+            return set_errno_error(error, err, "Cannot truncate", path);
+        }
+        g_warning("Dropped %" G_GSIZE_FORMAT " bytes of an incomplete record from %s", len - good, path);
+    }
+    if (lseek(fd, 0, SEEK_END) < 0) {
+        int err = errno;
+        g_close(fd, NULL);
+        return set_errno_error(error, err, "Cannot seek", path);
+    }
+
+    GHashTable *uids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    collect_uids(uids, data, good);
+
+    if (good == 0) {
+        g_autoptr(GString) header = g_string_new(NULL);
+        adif_append_header(header);
+        if (!write_all(fd, header->str, header->len, path, error)) {
+            g_hash_table_unref(uids);
+            g_close(fd, NULL);
+            return FALSE;
+        }
+    }
+
+    w->path = g_strdup(path);
+    w->fd = fd;
+    w->uids = uids;
+    return TRUE;
+}
+
+static void
+flush_thread_func(GTask *task, gpointer source_object, gpointer task_data, GCancellable *cancellable)
+{
+    LogbookAdifFile *self = source_object;
+    FlushJob *job = task_data;
+    AdifWriter *w = &self->writer;
+    g_autoptr(GError) error = NULL;
+
+    if (w->fd >= 0 && g_strcmp0(w->path, job->path) != 0) adif_writer_close(w);
+    if (w->fd < 0) adif_writer_open(w, job->path, &error);
+
+    g_autoptr(GString) buffer = g_string_new(NULL);
+    for (guint i = 0; !error && i < job->writes->len; i++) {
+        PendingWrite *write = g_ptr_array_index(job->writes, i);
+        for (guint j = 0; j < write->records->len; j++) {
+            AdifRecord *record = g_ptr_array_index(write->records, j);
+            if (record->uid && g_hash_table_contains(w->uids, record->uid)) {
+                record->result = logbook_result_new(g_error_new(LOGBOOK_ERROR, LOGBOOK_ERROR_DUPLICATE,
+                                                                "QSO is already in %s", job->path), NULL);
+                continue;
+            }
+            if (record->uid) g_hash_table_add(w->uids, g_strdup(record->uid));
+            g_string_append(buffer, record->text);
+        }
+    }
+
+    if (!error && buffer->len > 0 && !write_all(w->fd, buffer->str, buffer->len, w->path, &error)) {
+        // Reopen next time; that also trims whatever part of the buffer made it out
+        adif_writer_close(w);
+    }
+
+    for (guint i = 0; i < job->writes->len; i++) {
+        PendingWrite *write = g_ptr_array_index(job->writes, i);
+        for (guint j = 0; j < write->records->len; j++) {
+            AdifRecord *record = g_ptr_array_index(write->records, j);
+            if (!record->result) record->result = logbook_result_new(error ? g_error_copy(error) : NULL, NULL);
+        }
+    }
+
+    g_task_return_boolean(task, TRUE);
+}
+
+/* ----------------- main thread ----------------- */
+
+static void
+complete_write(PendingWrite *write)
+{
+    if (write->single) {
+        AdifRecord *record = g_ptr_array_index(write->records, 0);
+        if (record->result->error && !g_error_matches(record->result->error, LOGBOOK_ERROR, LOGBOOK_ERROR_DUPLICATE)) {
+            g_task_return_error(write->task, g_steal_pointer(&record->result->error));
+        } else {
+            g_task_return_boolean(write->task, TRUE);
+        }
+        return;
+    }
+
+    GPtrArray *results = g_ptr_array_new_with_free_func((GDestroyNotify)logbook_result_free);
+    for (guint i = 0; i < write->records->len; i++) {
+        AdifRecord *record = g_ptr_array_index(write->records, i);
+        g_ptr_array_add(results, g_steal_pointer(&record->result));
+    }
+    g_task_return_pointer(write->task, results, (GDestroyNotify)g_ptr_array_unref);
+}
+
+static void
+on_flush_done(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    LogbookAdifFile *self = LOGBOOK_ADIF_FILE(source);
+    FlushJob *job = g_task_get_task_data(G_TASK(res));
+
+    for (guint i = 0; i < job->writes->len; i++) {
+        complete_write(g_ptr_array_index(job->writes, i));
+    }
+
+    self->flushing = FALSE;
+    if (self->pending->len > 0) logbook_adif_file_schedule_flush(self);
+}
+
+static gboolean
+on_flush_due(gpointer user_data)
+{
+    LogbookAdifFile *self = user_data;
+    self->flush_id = 0;
+
+    FlushJob *job = g_new0(FlushJob, 1);
+    job->path = configured_path();
+    job->writes = g_steal_pointer(&self->pending);
+    self->pending = g_ptr_array_new_with_free_func((GDestroyNotify)pending_write_free);
+
+    if (!job->path) {
+        // The setting was cleared while records were waiting
+        for (guint i = 0; i < job->writes->len; i++) {
+            PendingWrite *write = g_ptr_array_index(job->writes, i);
+            g_task_return_new_error(write->task, G_IO_ERROR, G_IO_ERROR_NOT_INITIALIZED,
+                                    "No ADIF log file is set");
+        }
+        flush_job_free(job);
+        return G_SOURCE_REMOVE;
+    }
+
+    self->flushing = TRUE;
+    g_autoptr(GTask) task = g_task_new(self, NULL, on_flush_done, NULL);
+    g_task_set_source_tag(task, on_flush_due);
+    g_task_set_task_data(task, job, (GDestroyNotify)flush_job_free);
+    g_task_run_in_thread(task, flush_thread_func);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+logbook_adif_file_schedule_flush(LogbookAdifFile *self)
+{
+    if (self->flush_id || self->flushing) return;
+    self->flush_id = g_timeout_add_full(G_PRIORITY_DEFAULT, FLUSH_WINDOW_MS, on_flush_due,
+                                        g_object_ref(self), g_object_unref);
+}
+
+static AdifRecord*
+adif_record_new(const LogbookQso *qso)
+{
+    AdifRecord *record = g_new0(AdifRecord, 1);
+    record->uid = g_strdup(qso->uid);
+
+    g_autoptr(GString) out = g_string_sized_new(256);
+    adif_append_logbook_qso(out, qso);
+
+    record->text = g_string_free(g_steal_pointer(&out), FALSE);
+    return record;
+}
+
+static void
+logbook_adif_file_queue(LogbookAdifFile *self, GTask *task, const LogbookQso *const *qsos, guint n, gboolean single)
+{
+    PendingWrite *write = g_new0(PendingWrite, 1);
+    write->task = task;
+    write->single = single;
+    write->records = g_ptr_array_new_full(n, (GDestroyNotify)adif_record_free);
+    for (guint i = 0; i < n; i++) {
+        g_ptr_array_add(write->records, adif_record_new(qsos[i]));
+    }
+
+    g_ptr_array_add(self->pending, write);
+    logbook_adif_file_schedule_flush(self);
+}
+
+static gboolean
+logbook_adif_file_is_configured(LogbookProvider *provider)
+{
+    g_autofree gchar *path = configured_path();
+    return path != NULL;
+}
+
+static const gchar*
+logbook_adif_file_get_name(LogbookProvider *provider)
+{
+    return "ADIF Log File";
+}
+
+static void
+logbook_adif_file_log_qso_async(LogbookProvider *provider,
+                                LogbookQso *qso,
+                                GCancellable *cancellable,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
+{
+    GTask *task = g_task_new(provider, cancellable, callback, user_data);
+    g_task_set_source_tag(task, logbook_adif_file_log_qso_async);
+    const LogbookQso *qsos[] = { qso };
+    logbook_adif_file_queue(LOGBOOK_ADIF_FILE(provider), task, qsos, 1, TRUE);
+}
+
+static gboolean
+logbook_adif_file_log_qso_finish(LogbookProvider *provider,
+                                 GAsyncResult *result,
+                                 GError **error)
+{
+    return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+static void
+logbook_adif_file_log_qsos_async(LogbookProvider *provider,
+                                 GPtrArray *qsos,
+                                 GCancellable *cancellable,
+                                 GAsyncReadyCallback callback,
+                                 gpointer user_data)
+{
+    GTask *task = g_task_new(provider, cancellable, callback, user_data);
+    g_task_set_source_tag(task, logbook_adif_file_log_qsos_async);
+    logbook_adif_file_queue(LOGBOOK_ADIF_FILE(provider), task,
+                            (const LogbookQso *const *)qsos->pdata, qsos->len, FALSE);
+}
+
+static GPtrArray*
+logbook_adif_file_log_qsos_finish(LogbookProvider *provider,
+                                  GAsyncResult *result,
+                                  GError **error)
+{
+    return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+static void
+logbook_adif_file_finalize(GObject *object)
+{
+    LogbookAdifFile *self = LOGBOOK_ADIF_FILE(object);
+
+    // Pending writes and flushes hold a reference, so by now there are none
+    g_ptr_array_unref(self->pending);
+    adif_writer_close(&self->writer);
+
+    G_OBJECT_CLASS(logbook_adif_file_parent_class)->finalize(object);
+}
+
+static void
+logbook_adif_file_class_init(LogbookAdifFileClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    LogbookProviderClass *provider_class = LOGBOOK_PROVIDER_CLASS(klass);
+
+    object_class->finalize = logbook_adif_file_finalize;
+
+    provider_class->is_configured = logbook_adif_file_is_configured;
+    provider_class->log_qso_async = logbook_adif_file_log_qso_async;
+    provider_class->log_qso_finish = logbook_adif_file_log_qso_finish;
+    provider_class->log_qsos_async = logbook_adif_file_log_qsos_async;
+    provider_class->log_qsos_finish = logbook_adif_file_log_qsos_finish;
+    provider_class->get_name = logbook_adif_file_get_name;
+    provider_class->max_batch = ADIF_MAX_BATCH;
+}
+
+static void
+logbook_adif_file_init(LogbookAdifFile *self)
+{
+    self->pending = g_ptr_array_new_with_free_func((GDestroyNotify)pending_write_free);
+    self->writer.fd = -1;
+}
+
+LogbookAdifFile*
+logbook_adif_file_new(void)
+{
+    return g_object_new(LOGBOOK_TYPE_ADIF_FILE, NULL);
+}
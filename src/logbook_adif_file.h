@@ -0,0 +1,19 @@
+// logbook_adif_file.h - Local ADIF file logbook provider
+#pragma once
+
+#include "logbook.h"
+
+G_BEGIN_DECLS
+
+/* Appends QSOs to the .adi file named by the adif-log-path setting. Records are
+ * buffered in memory and written together with one fsync a short while after
+ * the first of them arrives; each log call completes once its records are on
+ * disk. A record cut short by a crash is dropped when the file is opened, and a
+ * QSO whose uid is already in the file is reported as a duplicate. */
+#define LOGBOOK_TYPE_ADIF_FILE (logbook_adif_file_get_type())
+G_DECLARE_FINAL_TYPE(LogbookAdifFile, logbook_adif_file, LOGBOOK, ADIF_FILE, LogbookProvider)
+
+LogbookAdifFile*
+logbook_adif_file_new(void);
+
+G_END_DECLS
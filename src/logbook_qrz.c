@@ -2,14 +2,19 @@
 #include "logbook_qrz.h"
 #include "glib.h"
 #include "artemis.h"
+#include "http_session.h"
+#include "adif.h"
 #include "glibconfig.h"
 #include <libsoup/soup.h>
-#include <json-glib/json-glib.h>
+#include <string.h>
+
+#define QRZ_LOGBOOK_API "https://logbook.qrz.com/api"
+
+static const gchar *const QRZ_CREDENTIAL_KEYS[] = { "qrz-api-key", NULL };
 
 struct _LogbookQrz {
     LogbookProvider parent_instance;
-    SoupSession *session;
-    gchar *api_key;
+    SoupSession *session;   // the application's shared session
 };
 
 G_DEFINE_FINAL_TYPE(LogbookQrz, logbook_qrz, LOGBOOK_TYPE_PROVIDER)
@@ -24,6 +29,10 @@ static void logbook_qrz_log_qso_async(LogbookProvider *provider,
 static gboolean logbook_qrz_log_qso_finish(LogbookProvider *provider,
                                            GAsyncResult *result,
                                            GError **error);
+static gboolean logbook_qrz_log_qso_finish_with_id(LogbookProvider *provider,
+                                                   GAsyncResult *result,
+                                                   gchar **out_log_id,
+                                                   GError **error);
 static const gchar* logbook_qrz_get_name(LogbookProvider *provider);
 
 static void
@@ -37,17 +46,15 @@ logbook_qrz_class_init(LogbookQrzClass *klass)
     provider_class->is_configured = logbook_qrz_is_configured;
     provider_class->log_qso_async = logbook_qrz_log_qso_async;
     provider_class->log_qso_finish = logbook_qrz_log_qso_finish;
+    provider_class->log_qso_finish_with_id = logbook_qrz_log_qso_finish_with_id;
     provider_class->get_name = logbook_qrz_get_name;
+    provider_class->credential_keys = QRZ_CREDENTIAL_KEYS;
 }
 
 static void
 logbook_qrz_init(LogbookQrz *self)
 {
-    self->session = soup_session_new_with_options(
-        "timeout", 30,
-        "idle-timeout", 15,
-        NULL
-    );
+    self->session = g_object_ref(http_session_get_instance());
 }
 
 static void
@@ -58,7 +65,6 @@ logbook_qrz_finalize(GObject *object)
     if (self->session) {
         g_object_unref(self->session);
     }
-    g_free(self->api_key);
     
     G_OBJECT_CLASS(logbook_qrz_parent_class)->finalize(object);
 }
@@ -69,18 +75,18 @@ logbook_qrz_new(void)
     return g_object_new(LOGBOOK_TYPE_QRZ, NULL);
 }
 
+// Read on every use so a key entered in Preferences takes effect at once
+static gchar*
+qrz_api_key(void)
+{
+    return g_settings_get_string(artemis_app_get_settings(), "qrz-api-key");
+}
+
 static gboolean
 logbook_qrz_is_configured(LogbookProvider *provider)
 {
-    LogbookQrz *self = LOGBOOK_QRZ(provider);
-    
-    // Load API key from settings if not cached
-    if (!self->api_key) {
-        g_autoptr(GSettings) settings = g_settings_new("com.k0vcz.artemis");
-        self->api_key = g_settings_get_string(settings, "qrz-api-key");
-    }
-    
-    return self->api_key && strlen(self->api_key) > 0;
+    g_autofree gchar *api_key = qrz_api_key();
+    return api_key && *api_key;
 }
 
 static const gchar*
@@ -89,82 +95,112 @@ logbook_qrz_get_name(LogbookProvider *provider)
     return "QRZ Logbook";
 }
 
-typedef struct {
-    LogbookQrz *qrz;
-    LogbookQso *qso;
-    GTask *task;
-} QrzLogTask;
+/* ----------------- response parsing ----------------- */
 
-static void
-qrz_log_task_free(QrzLogTask *log_task)
+/* The API answers with form-encoded text, e.g. "RESULT=OK&LOGID=130877825&COUNT=1"
+ * or "RESULT=FAIL&REASON=...". Returns the value of key as a span of body (not
+ * NUL-terminated), or NULL if the key is absent. */
+static const gchar*
+qrz_response_get(const gchar *body, gsize len, const gchar *key, gsize *out_len)
+{
+    const gchar *end = body + len;
+    gsize key_len = strlen(key);
+
+    for (const gchar *p = body; p < end; ) {
+        const gchar *amp = memchr(p, '&', end - p);
+        const gchar *pair_end = amp ? amp : end;
+        const gchar *eq = memchr(p, '=', pair_end - p);
+
+        if (eq && (gsize)(eq - p) == key_len && memcmp(p, key, key_len) == 0) {
+            const gchar *value = eq + 1;
+            gsize value_len = pair_end - value;
+            // Trailing line break after the last pair
+            while (value_len > 0 && (value[value_len - 1] == '\n' || value[value_len - 1] == '\r')) value_len--;
+            *out_len = value_len;
+            return value;
+        }
+        p = pair_end + 1;
+    }
+    return NULL;
+}
+
+static gboolean
+span_equals(const gchar *span, gsize len, const gchar *literal)
+{
+    return span && len == strlen(literal) && memcmp(span, literal, len) == 0;
+}
+
+static gboolean
+span_contains_ci(const gchar *span, gsize len, const gchar *needle)
 {
-    if (log_task->qrz) {
-        g_object_unref(log_task->qrz);
+    gsize needle_len = strlen(needle);
+    for (gsize i = 0; span && i + needle_len <= len; i++) {
+        if (g_ascii_strncasecmp(span + i, needle, needle_len) == 0) return TRUE;
     }
-    if (log_task->qso) {
-        logbook_qso_free(log_task->qso);
+    return FALSE;
+}
+
+// On success returns the LOGID (NULL if none was sent); otherwise sets error
+static gchar*
+qrz_parse_insert_response(const gchar *body, gsize len, GError **error)
+{
+    gsize result_len = 0, reason_len = 0, logid_len = 0;
+    const gchar *result = qrz_response_get(body, len, "RESULT", &result_len);
+    const gchar *reason = qrz_response_get(body, len, "REASON", &reason_len);
+
+    if (span_equals(result, result_len, "OK") || span_equals(result, result_len, "REPLACE")) {
+        const gchar *logid = qrz_response_get(body, len, "LOGID", &logid_len);
+        return logid && logid_len > 0 ? g_strndup(logid, logid_len) : NULL;
     }
-    if (log_task->task) {
-        g_object_unref(log_task->task);
+
+    if (!result) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Unexpected QRZ response");
+    } else if (span_contains_ci(reason, reason_len, "duplicate")) {
+        g_set_error(error, LOGBOOK_ERROR, LOGBOOK_ERROR_DUPLICATE, "QSO already in QRZ logbook");
+    } else if (!reason) {
+        g_set_error(error, LOGBOOK_ERROR, span_equals(result, result_len, "AUTH") ?
+                    LOGBOOK_ERROR_AUTH : LOGBOOK_ERROR_REJECTED, "QRZ logging failed: Unknown error");
+    } else if (span_equals(result, result_len, "AUTH") ||
+               span_contains_ci(reason, reason_len, "invalid api key")) {
+        g_set_error(error, LOGBOOK_ERROR, LOGBOOK_ERROR_AUTH, "QRZ refused the API key: %.*s",
+                    (int)reason_len, reason);
+    } else {
+        g_set_error(error, LOGBOOK_ERROR, LOGBOOK_ERROR_REJECTED, "QRZ logging failed: %.*s",
+                    (int)reason_len, reason);
     }
-    g_free(log_task);
+    return NULL;
 }
 
+/* ----------------- upload ----------------- */
+
 static void
 qrz_log_response_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
 {
-    QrzLogTask *log_task = (QrzLogTask*)user_data;
-    g_autoptr(GError) error = NULL;
-    g_autoptr(GBytes) response_body = NULL;
-    
-    response_body = soup_session_send_and_read_finish(SOUP_SESSION(source_object), res, &error);
-    
-    if (error) {
-        g_task_return_error(log_task->task, g_error_copy(error));
-        qrz_log_task_free(log_task);
-        return;
-    }
-    
+    g_autoptr(GTask) task = user_data;
+    SoupMessage *msg = g_task_get_task_data(task);
+    GError *error = NULL;
+
+    g_autoptr(GBytes) response_body = soup_session_send_and_read_finish(SOUP_SESSION(source_object), res, &error);
     if (!response_body) {
-        g_task_return_new_error(log_task->task, G_IO_ERROR, G_IO_ERROR_FAILED,
-                               "No response from QRZ server");
-        qrz_log_task_free(log_task);
-        return;
-    }
-    
-    // Parse JSON response
-    const gchar *response_text = g_bytes_get_data(response_body, NULL);
-    g_autoptr(JsonParser) parser = json_parser_new();
-    
-    if (!json_parser_load_from_data(parser, response_text, -1, &error)) {
-        g_task_return_new_error(log_task->task, G_IO_ERROR, G_IO_ERROR_FAILED,
-                               "Failed to parse QRZ response: %s", error->message);
-        qrz_log_task_free(log_task);
+        g_task_return_error(task, error);
         return;
     }
-    
-    JsonNode *root = json_parser_get_root(parser);
-    if (!JSON_NODE_HOLDS_OBJECT(root)) {
-        g_task_return_new_error(log_task->task, G_IO_ERROR, G_IO_ERROR_FAILED,
-                               "Invalid QRZ response format");
-        qrz_log_task_free(log_task);
+
+    guint status = soup_message_get_status(msg);
+    if (!SOUP_STATUS_IS_SUCCESSFUL(status)) {
+        // Server trouble; worth another try later
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_FAILED, "QRZ returned HTTP %u", status);
         return;
     }
-    
-    JsonObject *obj = json_node_get_object(root);
-    
-    // Check for success
-    if (json_object_has_member(obj, "RESULT") && 
-        g_strcmp0(json_object_get_string_member(obj, "RESULT"), "OK") == 0) {
-        g_task_return_boolean(log_task->task, TRUE);
+
+    gsize len = 0;
+    const gchar *body = g_bytes_get_data(response_body, &len);
+    gchar *log_id = qrz_parse_insert_response(body, len, &error);
+    if (error) {
+        g_task_return_error(task, error);
     } else {
-        const gchar *reason = json_object_has_member(obj, "REASON") ?
-            json_object_get_string_member(obj, "REASON") : "Unknown error";
-        g_task_return_new_error(log_task->task, G_IO_ERROR, G_IO_ERROR_FAILED,
-                               "QRZ logging failed: %s", reason);
+        g_task_return_pointer(task, log_id, g_free);
     }
-    
-    qrz_log_task_free(log_task);
 }
 
 static void
@@ -175,90 +211,64 @@ logbook_qrz_log_qso_async(LogbookProvider *provider,
                           gpointer user_data)
 {
     LogbookQrz *self = LOGBOOK_QRZ(provider);
-    
-    if (!logbook_qrz_is_configured(provider)) {
-        GTask *task = g_task_new(provider, cancellable, callback, user_data);
+    GTask *task = g_task_new(provider, cancellable, callback, user_data);
+    g_task_set_source_tag(task, logbook_qrz_log_qso_async);
+
+    g_autofree gchar *api_key = qrz_api_key();
+    if (!api_key || !*api_key) {
         g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_INITIALIZED,
                                "QRZ logbook not configured - missing API key");
         g_object_unref(task);
         return;
     }
-    
-    // Create task data
-    QrzLogTask *log_task = g_new0(QrzLogTask, 1);
-    log_task->qrz = g_object_ref(self);
-    log_task->qso = logbook_qso_new();
-    log_task->task = g_task_new(provider, cancellable, callback, user_data);
-    
-    // Copy QSO data
-    log_task->qso->callsign = g_strdup(qso->callsign);
-    log_task->qso->park_ref = g_strdup(qso->park_ref);
-    log_task->qso->mode = g_strdup(qso->mode);
-    log_task->qso->frequency_hz = qso->frequency_hz;
-    log_task->qso->qso_datetime = qso->qso_datetime ? g_date_time_ref(qso->qso_datetime) : NULL;
-    log_task->qso->rst_sent = g_strdup(qso->rst_sent);
-    log_task->qso->rst_received = g_strdup(qso->rst_received);
-    log_task->qso->comment = g_strdup(qso->comment);
-    
-    // Format frequency in MHz
-    gdouble freq_mhz = qso->frequency_hz / 1000.0;
-    
-    // Format date/time
-    g_autofree gchar *qso_date = NULL;
-    g_autofree gchar *qso_time = NULL;
-    if (qso->qso_datetime) {
-        qso_date = g_date_time_format(qso->qso_datetime, "%Y-%m-%d");
-        qso_time = g_date_time_format(qso->qso_datetime, "%H:%M");
-    } else {
-        g_autoptr(GDateTime) now = g_date_time_new_now_utc();
-        qso_date = g_date_time_format(now, "%Y-%m-%d");
-        qso_time = g_date_time_format(now, "%H:%M");
-    }
-    
-    // Build comment with park reference
+
+    // QRZ shows COMMENT in its log view, so the park goes there as well as in SIG_INFO
     g_autofree gchar *full_comment = NULL;
+    const gchar *park = qso->park_ref ? qso->park_ref : "";
     if (qso->comment && strlen(qso->comment) > 0) {
-        full_comment = g_strdup_printf("POTA %s - %s", qso->park_ref, qso->comment);
+        full_comment = g_strdup_printf("POTA %s - %s", park, qso->comment);
     } else {
-        full_comment = g_strdup_printf("POTA %s", qso->park_ref);
+        full_comment = g_strdup_printf("POTA %s", park);
     }
-    
-    // Create QRZ API request
-    g_autoptr(SoupMessage) msg = soup_message_new("POST", "https://logbook.qrz.com/api");
-    SoupMessageHeaders *hdr = soup_message_get_request_headers(msg);
-    g_autofree gchar *user_agent = g_strdup_printf("Artemis/%d.%d.%d", 
-                                VERSION_MAJOR(APP_VERSION),
-                                VERSION_MINOR(APP_VERSION),
-                                VERSION_PATCH(APP_VERSION));
-    soup_message_headers_replace(hdr, "User-Agent", user_agent);
-    
-    // Build form data
-    GString *form_data = g_string_new(NULL);
-    g_autofree gchar *freq_str = g_strdup_printf("%.4f", freq_mhz);
-    g_string_append_printf(form_data, "KEY=%s", self->api_key);
-    g_string_append_printf(form_data, "&ACTION=INSERT");
-    g_string_append_printf(form_data, "&ADIF=<call:%ld>%s", strlen(qso->callsign), qso->callsign);
-    g_string_append_printf(form_data, "<qso_date:8>%s", qso_date);
-    g_string_append_printf(form_data, "<time_on:4>%s", qso_time);
-    g_string_append_printf(form_data, "<freq:%ld>%s", strlen(freq_str), freq_str);
-    g_string_append_printf(form_data, "<mode:%ld>%s", strlen(qso->mode), qso->mode);
-    
-    if (qso->rst_sent && strlen(qso->rst_sent) > 0) {
-        g_string_append_printf(form_data, "<rst_sent:%ld>%s", strlen(qso->rst_sent), qso->rst_sent);
+    LogbookQso record = *qso;
+    record.comment = full_comment;
+
+    g_autoptr(GString) adif = g_string_sized_new(256);
+    adif_append_logbook_qso(adif, &record);
+
+    gchar *form = soup_form_encode("KEY", api_key,
+                                   "ACTION", "INSERT",
+                                   "ADIF", adif->str,
+                                   NULL);
+
+    g_autoptr(GBytes) body = g_bytes_new_take(form, strlen(form));
+
+    SoupMessage *msg = soup_message_new("POST", QRZ_LOGBOOK_API);
+    soup_message_set_request_body_from_bytes(msg, "application/x-www-form-urlencoded", body);
+    g_task_set_task_data(task, msg, g_object_unref);
+
+    soup_session_send_and_read_async(self->session, msg, G_PRIORITY_DEFAULT,
+                                    cancellable, qrz_log_response_cb, task);
+}
+
+static gboolean
+logbook_qrz_log_qso_finish_with_id(LogbookProvider *provider,
+                                   GAsyncResult *result,
+                                   gchar **out_log_id,
+                                   GError **error)
+{
+    GError *local_error = NULL;
+    gchar *log_id = g_task_propagate_pointer(G_TASK(result), &local_error);
+    if (local_error) {
+        g_propagate_error(error, local_error);
+        return FALSE;
     }
-    if (qso->rst_received && strlen(qso->rst_received) > 0) {
-        g_string_append_printf(form_data, "<rst_rcvd:%ld>%s", strlen(qso->rst_received), qso->rst_received);
+    if (out_log_id) {
+        *out_log_id = log_id;
+    } else {
+        g_free(log_id);
     }
-    
-    g_string_append_printf(form_data, "<comment:%ld>%s", strlen(full_comment), full_comment);
-    g_string_append(form_data, "<eor>");
-    
-    soup_message_set_request_body_from_bytes(msg, "application/x-www-form-urlencoded",
-                                             g_bytes_new_take(g_string_free(form_data, FALSE), form_data->len));
-    
-    // Send request
-    soup_session_send_and_read_async(self->session, msg, G_PRIORITY_DEFAULT,
-                                    cancellable, qrz_log_response_cb, log_task);
+    return TRUE;
 }
 
 static gboolean
@@ -266,5 +276,5 @@ logbook_qrz_log_qso_finish(LogbookProvider *provider,
                            GAsyncResult *result,
                            GError **error)
 {
-    return g_task_propagate_boolean(G_TASK(result), error);
-}
\ No newline at end of file
+    return logbook_qrz_log_qso_finish_with_id(provider, result, NULL, error);
+}
@@ -0,0 +1,316 @@
+// logbook_queue.c - Durable upload queue in front of the logbook providers
+#include "logbook_queue.h"
+#include "artemis.h"
+#include "database.h"
+
+// Batches one provider may have outstanding at once
+#define MAX_IN_FLIGHT       2
+
+// Wait after the first failed attempt; doubles with every further failure
+#define BACKOFF_BASE_SECS   30
+#define BACKOFF_MAX_SECS    (60 * 60)
+
+// Give up on a record after this many transient failures
+#define MAX_ATTEMPTS        12
+
+// Uploaded rows are kept this long so a contact logged again is recognised
+#define DONE_KEEP_SECS      (30 * 24 * 60 * 60)
+
+typedef struct {
+    LogbookQueue    *queue;       // borrowed; the queue owns the slot
+    gchar           *id;
+    LogbookProvider *provider;
+    guint            in_flight;
+    guint            wake_id;
+    gboolean         auth_paused; // credentials refused; wait for new ones
+} ProviderSlot;
+
+struct _LogbookQueue {
+    GObject parent_instance;
+
+    GPtrArray    *slots;          // ProviderSlot*
+    GCancellable *cancellable;
+    GSettings    *settings;       // watched for new credentials
+};
+
+G_DEFINE_FINAL_TYPE(LogbookQueue, logbook_queue, G_TYPE_OBJECT)
+
+static void slot_pump(ProviderSlot *slot);
+
+static void
+provider_slot_free(ProviderSlot *slot)
+{
+    g_clear_handle_id(&slot->wake_id, g_source_remove);
+    g_free(slot->id);
+    g_clear_object(&slot->provider);
+    g_free(slot);
+}
+
+static gint64
+now_unix(void)
+{
+    return g_get_real_time() / G_USEC_PER_SEC;
+}
+
+typedef struct {
+    LogbookQueue *queue;
+    ProviderSlot *slot;
+    GPtrArray    *rows;           // LogbookQueueRow*
+} QueueBatch;
+
+static void
+queue_batch_free(QueueBatch *batch)
+{
+    g_ptr_array_unref(batch->rows);
+    g_object_unref(batch->queue);
+    g_free(batch);
+}
+
+static void
+row_store(LogbookQueueRow *row)
+{
+    g_autoptr(GError) error = NULL;
+    if (!spot_db_logbook_queue_update(spot_db_get_instance(), row, &error)) {
+        g_warning("Failed to update logbook queue row %" G_GINT64_FORMAT ": %s", (gint64)row->id, error->message);
+    }
+}
+
+static void
+row_finish(ProviderSlot *slot, LogbookQueueRow *row, const GError *error, const gchar *log_id)
+{
+    g_clear_pointer(&row->last_error, g_free);
+
+    if (!error || g_error_matches(error, LOGBOOK_ERROR, LOGBOOK_ERROR_DUPLICATE)) {
+        // A duplicate means an earlier attempt got through
+        row->state = LOGBOOK_QUEUE_DONE;
+        if (log_id) {
+            g_free(row->log_id);
+            row->log_id = g_strdup(log_id);
+        }
+        g_debug("QSO with %s uploaded to %s", row->qso->callsign, logbook_provider_get_name(slot->provider));
+    } else if (g_error_matches(error, LOGBOOK_ERROR, LOGBOOK_ERROR_AUTH)) {
+        // Not the record's fault: keep it waiting, without using up an attempt,
+        // and stop sending until the user changes the credentials
+        row->state = LOGBOOK_QUEUE_PENDING;
+        row->last_error = g_strdup(error->message);
+        if (!slot->auth_paused) {
+            g_warning("%s refused the credentials; holding uploads until they change: %s",
+                      logbook_provider_get_name(slot->provider), error->message);
+        }
+        slot->auth_paused = TRUE;
+    } else {
+        row->attempts++;
+        row->last_error = g_strdup(error->message);
+        if (g_error_matches(error, LOGBOOK_ERROR, LOGBOOK_ERROR_REJECTED) ||
+            row->attempts >= MAX_ATTEMPTS) {
+            row->state = LOGBOOK_QUEUE_FAILED;
+            g_warning("Failed to log QSO with %s to %s: %s", row->qso->callsign,
+                      logbook_provider_get_name(slot->provider), error->message);
+        } else {
+            guint shift = MIN(row->attempts - 1, 10);
+            row->state = LOGBOOK_QUEUE_PENDING;
+            row->next_attempt = now_unix() + MIN((gint64)BACKOFF_BASE_SECS << shift, BACKOFF_MAX_SECS);
+            g_debug("Logging QSO with %s to %s failed (attempt %d): %s", row->qso->callsign,
+                    logbook_provider_get_name(slot->provider), row->attempts, error->message);
+        }
+    }
+    row_store(row);
+}
+
+static void
+on_batch_logged(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    QueueBatch *batch = user_data;
+    ProviderSlot *slot = batch->slot;
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) results = logbook_provider_log_qsos_finish(LOGBOOK_PROVIDER(source), res, &error);
+
+    // Shutting down: leave the rows marked sending; the next run requeues them
+    if (g_cancellable_is_cancelled(batch->queue->cancellable)) {
+        queue_batch_free(batch);
+        return;
+    }
+
+    if (results && results->len != batch->rows->len) {
+        error = g_error_new(G_IO_ERROR, G_IO_ERROR_FAILED, "%s returned %u results for %u records",
+                            logbook_provider_get_name(slot->provider), results->len, batch->rows->len);
+        g_clear_pointer(&results, g_ptr_array_unref);
+    }
+
+    for (guint i = 0; i < batch->rows->len; i++) {
+        LogbookQueueRow *row = g_ptr_array_index(batch->rows, i);
+        LogbookResult *result = results ? g_ptr_array_index(results, i) : NULL;
+        row_finish(slot, row, result ? result->error : error, result ? result->log_id : NULL);
+    }
+
+    slot->in_flight--;
+    queue_batch_free(batch);
+    slot_pump(slot);
+}
+
+static gboolean
+on_slot_wake(gpointer user_data)
+{
+    ProviderSlot *slot = user_data;
+    slot->wake_id = 0;
+    slot_pump(slot);
+    return G_SOURCE_REMOVE;
+}
+
+// Start batches until the in-flight limit or the due rows run out, then arm the
+// timer for the next row that is backing off
+static void
+slot_pump(ProviderSlot *slot)
+{
+    LogbookQueue *self = slot->queue;
+    SpotDb *db = spot_db_get_instance();
+
+    g_clear_handle_id(&slot->wake_id, g_source_remove);
+    if (slot->auth_paused || !logbook_provider_is_configured(slot->provider)) return;
+
+    guint max_batch = logbook_provider_get_max_batch(slot->provider);
+    while (slot->in_flight < MAX_IN_FLIGHT) {
+        g_autoptr(GError) error = NULL;
+        GPtrArray *rows = spot_db_logbook_queue_claim(db, slot->id, now_unix(), max_batch, &error);
+        if (!rows) {
+            g_warning("Failed to read logbook queue: %s", error->message);
+            return;
+        }
+        if (rows->len == 0) {
+            g_ptr_array_unref(rows);
+            break;
+        }
+
+        QueueBatch *batch = g_new0(QueueBatch, 1);
+        batch->queue = g_object_ref(self);
+        batch->slot = slot;
+        batch->rows = rows;
+
+        g_autoptr(GPtrArray) qsos = g_ptr_array_sized_new(rows->len);
+        for (guint i = 0; i < rows->len; i++) {
+            LogbookQueueRow *row = g_ptr_array_index(rows, i);
+            g_ptr_array_add(qsos, row->qso);
+        }
+
+        slot->in_flight++;
+        logbook_provider_log_qsos_async(slot->provider, qsos, self->cancellable, on_batch_logged, batch);
+    }
+
+    if (slot->in_flight > 0) return;  // the next completion pumps again
+
+    gint64 when = 0;
+    if (spot_db_logbook_queue_next_due(db, slot->id, &when, NULL)) {
+        gint64 wait = when - now_unix();
+        slot->wake_id = g_timeout_add_seconds((guint)CLAMP(wait, 1, BACKOFF_MAX_SECS), on_slot_wake, slot);
+    }
+}
+
+// New credentials may fix a refused login; other settings cannot
+static void
+on_settings_changed(GSettings *settings, const gchar *key, gpointer user_data)
+{
+    LogbookQueue *self = LOGBOOK_QUEUE(user_data);
+
+    for (guint i = 0; i < self->slots->len; i++) {
+        ProviderSlot *slot = g_ptr_array_index(self->slots, i);
+        if (!slot->auth_paused || !logbook_provider_is_credential_key(slot->provider, key)) continue;
+        slot->auth_paused = FALSE;
+        slot_pump(slot);
+    }
+}
+
+static void
+logbook_queue_dispose(GObject *object)
+{
+    LogbookQueue *self = LOGBOOK_QUEUE(object);
+
+    if (self->settings) g_signal_handlers_disconnect_by_data(self->settings, self);
+    g_clear_object(&self->settings);
+    g_cancellable_cancel(self->cancellable);
+    g_clear_pointer(&self->slots, g_ptr_array_unref);
+
+    G_OBJECT_CLASS(logbook_queue_parent_class)->dispose(object);
+}
+
+static void
+logbook_queue_finalize(GObject *object)
+{
+    LogbookQueue *self = LOGBOOK_QUEUE(object);
+    g_clear_object(&self->cancellable);
+    G_OBJECT_CLASS(logbook_queue_parent_class)->finalize(object);
+}
+
+static void
+logbook_queue_class_init(LogbookQueueClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    object_class->dispose = logbook_queue_dispose;
+    object_class->finalize = logbook_queue_finalize;
+}
+
+static void
+logbook_queue_init(LogbookQueue *self)
+{
+    self->slots = g_ptr_array_new_with_free_func((GDestroyNotify)provider_slot_free);
+    self->cancellable = g_cancellable_new();
+    self->settings = g_object_ref(artemis_app_get_settings());
+    g_signal_connect(self->settings, "changed", G_CALLBACK(on_settings_changed), self);
+}
+
+LogbookQueue*
+logbook_queue_new(void)
+{
+    // Rows still marked sending were cut off by the last shutdown
+    g_autoptr(GError) error = NULL;
+    if (!spot_db_logbook_queue_requeue_sending(spot_db_get_instance(), &error)) {
+        g_warning("Failed to requeue interrupted logbook uploads: %s", error->message);
+        g_clear_error(&error);
+    }
+    if (!spot_db_logbook_queue_prune_done(spot_db_get_instance(), now_unix() - DONE_KEEP_SECS, &error)) {
+        g_warning("Failed to prune logbook queue: %s", error->message);
+    }
+    return g_object_new(LOGBOOK_TYPE_QUEUE, NULL);
+}
+
+void
+logbook_queue_add_provider(LogbookQueue *self, const gchar *id, LogbookProvider *provider)
+{
+    g_return_if_fail(LOGBOOK_IS_QUEUE(self));
+    g_return_if_fail(id && *id);
+    g_return_if_fail(LOGBOOK_IS_PROVIDER(provider));
+
+    ProviderSlot *slot = g_new0(ProviderSlot, 1);
+    slot->queue = self;
+    slot->id = g_strdup(id);
+    slot->provider = g_object_ref(provider);
+    g_ptr_array_add(self->slots, slot);
+
+    slot_pump(slot);
+}
+
+gboolean
+logbook_queue_enqueue(LogbookQueue *self, LogbookQso *qso, GError **error)
+{
+    g_return_val_if_fail(LOGBOOK_IS_QUEUE(self), FALSE);
+    g_return_val_if_fail(qso != NULL, FALSE);
+
+    if (!qso->uid) qso->uid = g_uuid_string_random();
+
+    for (guint i = 0; i < self->slots->len; i++) {
+        ProviderSlot *slot = g_ptr_array_index(self->slots, i);
+        if (!logbook_provider_is_configured(slot->provider)) {
+            g_debug("%s not configured - skipping logging", logbook_provider_get_name(slot->provider));
+            continue;
+        }
+        // Logged before under another uid, e.g. the same spot submitted twice
+        g_autofree gchar *log_id = spot_db_logbook_queue_find_logged(spot_db_get_instance(), slot->id, qso);
+        if (log_id) {
+            g_debug("QSO with %s already in %s as %s - skipping", qso->callsign,
+                    logbook_provider_get_name(slot->provider), log_id);
+            continue;
+        }
+        if (!spot_db_logbook_queue_add(spot_db_get_instance(), slot->id, qso, NULL, error)) return FALSE;
+        slot_pump(slot);
+    }
+    return TRUE;
+}
@@ -0,0 +1,34 @@
+// logbook_queue.h - Durable upload queue in front of the logbook providers
+#pragma once
+
+#include <glib.h>
+#include <gio/gio.h>
+#include "logbook.h"
+
+G_BEGIN_DECLS
+
+/* QSOs are written to the logbook_queue table, once per configured provider,
+ * before anything is sent. Each provider is drained in the background in
+ * batches of up to its max_batch, with a bounded number of batches in flight.
+ * Transient failures back off exponentially; records the service refuses, or
+ * that run out of attempts, are marked failed. A provider that refuses the
+ * credentials keeps its records pending and is paused until one of its
+ * credential settings changes. Every QSO carries a uid that stays the same
+ * across retries so providers can recognise a resend. Uploaded records are pruned after a while. */
+#define LOGBOOK_TYPE_QUEUE (logbook_queue_get_type())
+G_DECLARE_FINAL_TYPE(LogbookQueue, logbook_queue, LOGBOOK, QUEUE, GObject)
+
+LogbookQueue*
+logbook_queue_new(void);
+
+// Drain rows stored under id through provider. Rows left over from an earlier
+// run are picked up as soon as the provider is added.
+void
+logbook_queue_add_provider(LogbookQueue *self, const gchar *id, LogbookProvider *provider);
+
+// Store qso for every configured provider and start sending. A uid is assigned
+// if qso has none. FALSE only if it could not be stored.
+gboolean
+logbook_queue_enqueue(LogbookQueue *self, LogbookQso *qso, GError **error);
+
+G_END_DECLS
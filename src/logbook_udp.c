@@ -0,0 +1,301 @@
+// logbook_udp.c - UDP logbook provider for desktop logging programs
+#include "logbook_udp.h"
+#include "adif.h"
+#include "artemis.h"
+
+#include <string.h>
+
+// WSJT-X network message framing (NetworkMessage.hpp)
+#define WSJTX_MAGIC          0xadbccbda
+#define WSJTX_SCHEMA         2
+#define WSJTX_LOGGED_ADIF    12
+#define WSJTX_CLIENT_ID      "Artemis"
+
+// Datagrams are independent, so the queue may hand over as many as it likes
+#define UDP_MAX_BATCH        32
+
+typedef enum {
+    UDP_FORMAT_NONE,
+    UDP_FORMAT_WSJTX,
+    UDP_FORMAT_N1MM,
+} UdpFormat;
+
+struct _LogbookUdp {
+    LogbookProvider parent_instance;
+
+    GSocket    *socket;     // non-blocking, family of the last destination
+    GByteArray *packet;     // reused for every datagram
+    GString    *text;       // reused ADIF / XML body
+};
+
+G_DEFINE_FINAL_TYPE(LogbookUdp, logbook_udp, LOGBOOK_TYPE_PROVIDER)
+
+static UdpFormat
+configured_format(void)
+{
+    g_autofree gchar *format = g_settings_get_string(artemis_app_get_settings(), "udp-log-format");
+    if (g_strcmp0(format, "wsjtx") == 0) return UDP_FORMAT_WSJTX;
+    if (g_strcmp0(format, "n1mm") == 0) return UDP_FORMAT_N1MM;
+    return UDP_FORMAT_NONE;
+}
+
+static GSocketAddress*
+configured_address(GError **error)
+{
+    GSettings *settings = artemis_app_get_settings();
+    g_autofree gchar *host = g_settings_get_string(settings, "udp-log-host");
+    guint16 port = (guint16)g_settings_get_int(settings, "udp-log-port");
+
+    // Literal addresses only; resolving a name would block
+    g_strstrip(host);
+    if (g_ascii_strcasecmp(host, "localhost") == 0) {
+        g_free(host);
+        host = g_strdup("127.0.0.1");
+    }
+
+    GSocketAddress *address = g_inet_socket_address_new_from_string(host, port);
+    if (!address) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                    "Logger address \"%s\" is not an IP address", host);
+    }
+    return address;
+}
+
+static gboolean
+ensure_socket(LogbookUdp *self, GSocketFamily family, GError **error)
+{
+    if (self->socket && g_socket_get_family(self->socket) == family) return TRUE;
+
+    g_clear_object(&self->socket);
+    self->socket = g_socket_new(family, G_SOCKET_TYPE_DATAGRAM, G_SOCKET_PROTOCOL_UDP, error);
+    if (!self->socket) return FALSE;
+
+    g_socket_set_blocking(self->socket, FALSE);
+    // Loggers on other machines are often reached through the broadcast address
+    g_socket_set_broadcast(self->socket, TRUE);
+    return TRUE;
+}
+
+/* ----------------- packet formats ----------------- */
+
+static void
+put_u32(GByteArray *packet, guint32 value)
+{
+    guint32 be = GUINT32_TO_BE(value);
+    g_byte_array_append(packet, (const guint8 *)&be, sizeof be);
+}
+
+// QDataStream QByteArray: 32-bit length, then the bytes
+static void
+put_utf8(GByteArray *packet, const gchar *value, gsize len)
+{
+    put_u32(packet, (guint32)len);
+    g_byte_array_append(packet, (const guint8 *)value, (guint)len);
+}
+
+static void
+build_wsjtx(LogbookUdp *self, const LogbookQso *qso)
+{
+    g_string_truncate(self->text, 0);
+    adif_append_header(self->text);
+    adif_append_logbook_qso(self->text, qso);
+
+    put_u32(self->packet, WSJTX_MAGIC);
+    put_u32(self->packet, WSJTX_SCHEMA);
+    put_u32(self->packet, WSJTX_LOGGED_ADIF);
+    put_utf8(self->packet, WSJTX_CLIENT_ID, strlen(WSJTX_CLIENT_ID));
+    put_utf8(self->packet, self->text->str, self->text->len);
+}
+
+// N1MM names bands by their lower edge in MHz
+static gchar*
+n1mm_band(gint frequency_khz)
+{
+    if (frequency_khz < 2000) return g_strdup("1.8");
+    if (frequency_khz < 4000) return g_strdup("3.5");
+    return g_strdup_printf("%d", frequency_khz / 1000);
+}
+
+static void
+append_xml_element(GString *out, const char *name, const char *value)
+{
+    g_autofree gchar *escaped = g_markup_escape_text(value ? value : "", -1);
+    g_string_append_printf(out, "  <%s>%s</%s>\n", name, escaped, name);
+}
+
+static void
+build_n1mm(LogbookUdp *self, const LogbookQso *qso)
+{
+    g_autofree gchar *mycall = g_settings_get_string(artemis_app_get_settings(), "callsign");
+    g_autoptr(GDateTime) now = qso->qso_datetime ? NULL : g_date_time_new_now_utc();
+    g_autofree gchar *timestamp = g_date_time_format(qso->qso_datetime ? qso->qso_datetime : now,
+                                                     "%Y-%m-%d %H:%M:%S");
+    g_autofree gchar *band = n1mm_band(qso->frequency_hz);
+    g_autofree gchar *freq = g_strdup_printf("%d", qso->frequency_hz * 100);  // 10 Hz units
+    // N1MM ids are 32 hex digits without separators
+    g_auto(GStrv) uid_parts = qso->uid ? g_strsplit(qso->uid, "-", -1) : NULL;
+    g_autofree gchar *id = uid_parts ? g_strjoinv("", uid_parts) : NULL;
+    g_autofree gchar *comment = qso->comment && *qso->comment
+        ? g_strdup_printf("POTA %s - %s", qso->park_ref ? qso->park_ref : "", qso->comment)
+        : qso->park_ref ? g_strdup_printf("POTA %s", qso->park_ref) : NULL;
+
+    GString *out = self->text;
+    g_string_truncate(out, 0);
+    g_string_append(out, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<contactinfo>\n");
+    append_xml_element(out, "app", "Artemis");
+    append_xml_element(out, "timestamp", timestamp);
+    append_xml_element(out, "mycall", mycall);
+    append_xml_element(out, "band", band);
+    append_xml_element(out, "rxfreq", freq);
+    append_xml_element(out, "txfreq", freq);
+    append_xml_element(out, "mode", qso->mode);
+    append_xml_element(out, "call", qso->callsign);
+    append_xml_element(out, "snt", qso->rst_sent);
+    append_xml_element(out, "rcv", qso->rst_received);
+    append_xml_element(out, "comment", comment);
+    append_xml_element(out, "ID", id);
+    g_string_append(out, "</contactinfo>\n");
+
+    g_byte_array_append(self->packet, (const guint8 *)out->str, (guint)out->len);
+}
+
+static gboolean
+send_qso(LogbookUdp *self, const LogbookQso *qso, GCancellable *cancellable, GError **error)
+{
+    UdpFormat format = configured_format();
+    if (format == UDP_FORMAT_NONE) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_INITIALIZED, "UDP logging is off");
+        return FALSE;
+    }
+
+    g_autoptr(GSocketAddress) address = configured_address(error);
+    if (!address) return FALSE;
+    if (!ensure_socket(self, g_socket_address_get_family(address), error)) return FALSE;
+
+    g_byte_array_set_size(self->packet, 0);
+    if (format == UDP_FORMAT_WSJTX) {
+        build_wsjtx(self, qso);
+    } else {
+        build_n1mm(self, qso);
+    }
+
+    // Straight from the packet buffer; with nothing listening the datagram is simply dropped
+    gssize sent = g_socket_send_to(self->socket, address, (const gchar *)self->packet->data,
+                                   self->packet->len, cancellable, error);
+    if (sent < 0) return FALSE;
+    if ((guint)sent != self->packet->len) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE,
+                    "Sent %" G_GSSIZE_FORMAT " of %u bytes", sent, self->packet->len);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* ----------------- LogbookProvider ----------------- */
+
+static gboolean
+logbook_udp_is_configured(LogbookProvider *provider)
+{
+    return configured_format() != UDP_FORMAT_NONE;
+}
+
+static const gchar*
+logbook_udp_get_name(LogbookProvider *provider)
+{
+    return "Local Logger (UDP)";
+}
+
+static void
+logbook_udp_log_qso_async(LogbookProvider *provider,
+                          LogbookQso *qso,
+                          GCancellable *cancellable,
+                          GAsyncReadyCallback callback,
+                          gpointer user_data)
+{
+    g_autoptr(GTask) task = g_task_new(provider, cancellable, callback, user_data);
+    g_task_set_source_tag(task, logbook_udp_log_qso_async);
+
+    GError *error = NULL;
+    if (send_qso(LOGBOOK_UDP(provider), qso, cancellable, &error)) {
+        g_task_return_boolean(task, TRUE);
+    } else {
+        g_task_return_error(task, error);
+    }
+}
+
+static gboolean
+logbook_udp_log_qso_finish(LogbookProvider *provider,
+                           GAsyncResult *result,
+                           GError **error)
+{
+    return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+static void
+logbook_udp_log_qsos_async(LogbookProvider *provider,
+                           GPtrArray *qsos,
+                           GCancellable *cancellable,
+                           GAsyncReadyCallback callback,
+                           gpointer user_data)
+{
+    g_autoptr(GTask) task = g_task_new(provider, cancellable, callback, user_data);
+    g_task_set_source_tag(task, logbook_udp_log_qsos_async);
+
+    GPtrArray *results = g_ptr_array_new_with_free_func((GDestroyNotify)logbook_result_free);
+    for (guint i = 0; i < qsos->len; i++) {
+        GError *error = NULL;
+        send_qso(LOGBOOK_UDP(provider), g_ptr_array_index(qsos, i), cancellable, &error);
+        g_ptr_array_add(results, logbook_result_new(error, NULL));
+    }
+    g_task_return_pointer(task, results, (GDestroyNotify)g_ptr_array_unref);
+}
+
+static GPtrArray*
+logbook_udp_log_qsos_finish(LogbookProvider *provider,
+                            GAsyncResult *result,
+                            GError **error)
+{
+    return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+static void
+logbook_udp_finalize(GObject *object)
+{
+    LogbookUdp *self = LOGBOOK_UDP(object);
+
+    g_clear_object(&self->socket);
+    g_byte_array_unref(self->packet);
+    g_string_free(self->text, TRUE);
+
+    G_OBJECT_CLASS(logbook_udp_parent_class)->finalize(object);
+}
+
+static void
+logbook_udp_class_init(LogbookUdpClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    LogbookProviderClass *provider_class = LOGBOOK_PROVIDER_CLASS(klass);
+
+    object_class->finalize = logbook_udp_finalize;
+
+    provider_class->is_configured = logbook_udp_is_configured;
+    provider_class->log_qso_async = logbook_udp_log_qso_async;
+    provider_class->log_qso_finish = logbook_udp_log_qso_finish;
+    provider_class->log_qsos_async = logbook_udp_log_qsos_async;
+    provider_class->log_qsos_finish = logbook_udp_log_qsos_finish;
+    provider_class->get_name = logbook_udp_get_name;
+    provider_class->max_batch = UDP_MAX_BATCH;
+}
+
+static void
+logbook_udp_init(LogbookUdp *self)
+{
+    self->packet = g_byte_array_sized_new(1024);
+    self->text = g_string_sized_new(512);
+}
+
+LogbookUdp*
+logbook_udp_new(void)
+{
+    return g_object_new(LOGBOOK_TYPE_UDP, NULL);
+}
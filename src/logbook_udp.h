@@ -0,0 +1,19 @@
+// logbook_udp.h - UDP logbook provider for desktop logging programs
+#pragma once
+
+#include "logbook.h"
+
+G_BEGIN_DECLS
+
+/* Sends each QSO as one UDP datagram to the address in udp-log-host and
+ * udp-log-port, in the udp-log-format chosen: a WSJT-X "Logged ADIF" message
+ * (type 12) or an N1MM contactinfo XML packet. Loggers such as Log4OM, N1MM
+ * and CQRLOG listen for these. The socket is non-blocking and the packet is
+ * built in a buffer reused for every QSO, then handed to the kernel as is. */
+#define LOGBOOK_TYPE_UDP (logbook_udp_get_type())
+G_DECLARE_FINAL_TYPE(LogbookUdp, logbook_udp, LOGBOOK, UDP, LogbookProvider)
+
+LogbookUdp*
+logbook_udp_new(void);
+
+G_END_DECLS
@@ -0,0 +1,119 @@
+// park_import.c - Background import of pota.app park CSV exports
+#include "park_import.h"
+#include "database.h"
+
+typedef struct {
+  GFile *file;
+  guint  imported;
+  guint  skipped;
+} ParkImportData;
+
+typedef gboolean (*ParkImportFunc)(SpotDb *db, GInputStream *stream, GCancellable *cancellable,
+                                   ParkImportData *data, GError **error);
+
+static void
+park_import_data_free(ParkImportData *data)
+{
+  if (!data) return;
+  g_clear_object(&data->file);
+  g_free(data);
+}
+
+static gboolean
+import_hunted(SpotDb *db, GInputStream *stream, GCancellable *cancellable,
+              ParkImportData *data, GError **error)
+{
+  return spot_db_import_hunted_parks_csv(db, stream, cancellable,
+                                         &data->imported, &data->skipped, error);
+}
+
+static gboolean
+import_catalog(SpotDb *db, GInputStream *stream, GCancellable *cancellable,
+               ParkImportData *data, GError **error)
+{
+  return spot_db_import_park_catalog_csv(db, stream, cancellable, &data->imported, error);
+}
+
+static void
+import_thread_func(GTask *task, gpointer source_object, gpointer task_data, GCancellable *cancellable)
+{
+  ParkImportData *data = task_data;
+  ParkImportFunc func = g_task_get_source_tag(task) == park_import_catalog_csv_async
+    ? import_catalog : import_hunted;
+  GError *error = NULL;
+
+  SpotDb *db = spot_db_get_instance();
+  if (!db) {
+    g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_FAILED, "Database is not available");
+    return;
+  }
+
+  g_autoptr(GFileInputStream) in = g_file_read(data->file, cancellable, &error);
+  if (!in) {
+    g_task_return_error(task, error);
+    return;
+  }
+
+  if (!func(db, G_INPUT_STREAM(in), cancellable, data, &error)) {
+    g_task_return_error(task, error);
+    return;
+  }
+
+  g_task_return_boolean(task, TRUE);
+}
+
+static void
+park_import_start(GFile *file, gpointer source_tag, GCancellable *cancellable,
+                  GAsyncReadyCallback callback, gpointer user_data)
+{
+  ParkImportData *data = g_new0(ParkImportData, 1);
+  data->file = g_object_ref(file);
+
+  GTask *task = g_task_new(NULL, cancellable, callback, user_data);
+  g_task_set_source_tag(task, source_tag);
+  g_task_set_task_data(task, data, (GDestroyNotify)park_import_data_free);
+  g_task_run_in_thread(task, import_thread_func);
+  g_object_unref(task);
+}
+
+void
+park_import_hunted_csv_async(GFile *file,
+                             GCancellable *cancellable,
+                             GAsyncReadyCallback callback,
+                             gpointer user_data)
+{
+  g_return_if_fail(G_IS_FILE(file));
+  park_import_start(file, park_import_hunted_csv_async, cancellable, callback, user_data);
+}
+
+gboolean
+park_import_hunted_csv_finish(GAsyncResult *result,
+                              guint *out_imported,
+                              guint *out_skipped,
+                              GError **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, NULL), FALSE);
+
+  if (!g_task_propagate_boolean(G_TASK(result), error)) return FALSE;
+
+  ParkImportData *data = g_task_get_task_data(G_TASK(result));
+  if (out_imported) *out_imported = data->imported;
+  if (out_skipped) *out_skipped = data->skipped;
+  return TRUE;
+}
+
+void
+park_import_catalog_csv_async(GFile *file,
+                              GCancellable *cancellable,
+                              GAsyncReadyCallback callback,
+                              gpointer user_data)
+{
+  g_return_if_fail(G_IS_FILE(file));
+  park_import_start(file, park_import_catalog_csv_async, cancellable, callback, user_data);
+}
+
+gboolean
+park_import_catalog_csv_finish(GAsyncResult *result, guint *out_count, GError **error)
+{
+  return park_import_hunted_csv_finish(result, out_count, NULL, error);
+}
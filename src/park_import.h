@@ -0,0 +1,31 @@
+// park_import.h - Background import of pota.app park CSV exports
+#pragma once
+
+#include <glib.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+// Import a pota.app hunter "parks worked" CSV into the parks table.
+// The file is streamed and written in batched transactions from a worker thread.
+void park_import_hunted_csv_async(GFile *file,
+                                  GCancellable *cancellable,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data);
+
+gboolean park_import_hunted_csv_finish(GAsyncResult *result,
+                                       guint *out_imported,
+                                       guint *out_skipped,
+                                       GError **error);
+
+// Replace the local park catalog with a pota.app all-parks CSV in a worker thread.
+void park_import_catalog_csv_async(GFile *file,
+                                   GCancellable *cancellable,
+                                   GAsyncReadyCallback callback,
+                                   gpointer user_data);
+
+gboolean park_import_catalog_csv_finish(GAsyncResult *result,
+                                        guint *out_count,
+                                        GError **error);
+
+G_END_DECLS
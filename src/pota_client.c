@@ -3,7 +3,8 @@
 #include "glib-object.h"
 #include "glib.h"
 #include "artemis.h"
-#include "libsoup/soup-cache.h"
+#include "activator.h"
+#include "http_session.h"
 #include "libsoup/soup-session.h"
 #include "spot.h"
 
@@ -11,28 +12,78 @@
 #include <json-glib/json-glib.h>
 #include <unistd.h>
 
+// What we last received from an endpoint, for conditional requests
+typedef struct {
+  gchar *etag;
+  gchar *last_modified;
+  gchar *body_hash;
+} Validators;
+
+static void
+validators_free(Validators *v) {
+  if (!v) return;
+  g_free(v->etag);
+  g_free(v->last_modified);
+  g_free(v->body_hash);
+  g_free(v);
+}
+
 struct _PotaClient {
   GObject parent_instance;
 
   SoupSession *session;
-  SoupCache   *session_cache;
+  GHashTable  *validators; // endpoint path -> Validators*
+
+  // Request scheduling, see engine_pump()
+  GQueue       queues[POTA_N_PRIORITIES]; // PotaRequest*, waiting for a slot
+  GHashTable  *pending;         // url -> shareable PotaRequest* not yet complete
+  guint        in_flight;
+  gdouble      tokens;
+  gint64       tokens_updated_us;
+  guint        pump_id;         // waiting for the bucket to refill
+
   gchar       *auth_header;
   gchar       *source;
   gchar       *base_url;
 };
 
-typedef struct {
-    SoupMessage *msg;
-} TaskData;
+G_DEFINE_FINAL_TYPE(PotaClient, pota_client, G_TYPE_OBJECT)
+G_DEFINE_QUARK(pota-client-error-quark, pota_client_error)
+
+#define SPOTS_PATH "/v1/spots"
 
 static void
-task_data_free(TaskData *d) {
-    if (!d) return;
-    if (d->msg) g_object_unref(d->msg);
-    g_free(d);
+validators_apply(PotaClient *self, const char *path, SoupMessage *msg) {
+  Validators *v = g_hash_table_lookup(self->validators, path);
+  if (!v) return;
+
+  SoupMessageHeaders *hdr = soup_message_get_request_headers(msg);
+  if (v->etag) soup_message_headers_replace(hdr, "If-None-Match", v->etag);
+  if (v->last_modified) soup_message_headers_replace(hdr, "If-Modified-Since", v->last_modified);
 }
 
-G_DEFINE_FINAL_TYPE(PotaClient, pota_client, G_TYPE_OBJECT)
+// Remember a 2xx response. Returns FALSE if its body is identical to the last one.
+static gboolean
+validators_record(PotaClient *self, const char *path, SoupMessage *msg, GBytes *body) {
+  Validators *v = g_hash_table_lookup(self->validators, path);
+  if (!v) {
+    v = g_new0(Validators, 1);
+    g_hash_table_insert(self->validators, g_strdup(path), v);
+  }
+
+  SoupMessageHeaders *hdr = soup_message_get_response_headers(msg);
+  g_free(v->etag);
+  v->etag = g_strdup(soup_message_headers_get_one(hdr, "ETag"));
+  g_free(v->last_modified);
+  v->last_modified = g_strdup(soup_message_headers_get_one(hdr, "Last-Modified"));
+
+  // Servers without validators still send the same bytes when nothing changed
+  gchar *hash = body ? g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, body) : NULL;
+  gboolean changed = g_strcmp0(hash, v->body_hash) != 0 || hash == NULL;
+  g_free(v->body_hash);
+  v->body_hash = hash;
+  return changed;
+}
 
 JsonNode *build_json_from_spot(PotaClient *self, 
                                ArtemisSpot *spot, 
@@ -85,159 +136,335 @@ JsonNode *build_json_from_spot(PotaClient *self,
   return root;
 }
 
-static void
-post_spot_cb(GObject *source, GAsyncResult *res, gpointer user_data) {
-  GTask       *task = G_TASK(user_data);
-  PotaClient  *self = g_task_get_source_object(task);
-  TaskData *td  = g_task_get_task_data(task);
-  (void)self;
+// Retry-After is either delta-seconds or an HTTP date
+static gint
+parse_retry_after(const char *value)
+{
+  if (!value || !*value) return -1;
 
-  GError *error = NULL;
-  GBytes *body  = soup_session_send_and_read_finish(SOUP_SESSION(source), res, &error);
-  if (error) 
-  {
-    g_task_return_error(task, error);
-    g_object_unref(task);
-    return;
+  if (g_ascii_isdigit(*value)) {
+    return (gint)CLAMP(g_ascii_strtoll(value, NULL, 10), 0, G_MAXINT);
   }
 
-  guint status = soup_message_get_status(td->msg);
-  if (status < 200 || status >= 300) 
-  {
-    const char *phrase = soup_status_get_phrase(status);
-    g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_FAILED,
-                            "HTTP %u %s", status, phrase ? phrase : "");
-    if (body) g_bytes_unref(body);
-    g_object_unref(task);
-    return;
+  g_autoptr(GDateTime) when = soup_date_time_new_from_http_string(value);
+  if (!when) return -1;
+  g_autoptr(GDateTime) now = g_date_time_new_now_utc();
+  return (gint)MAX(0, g_date_time_difference(when, now) / G_TIME_SPAN_SECOND);
+}
+
+static gint
+parse_max_age(SoupMessageHeaders *hdr)
+{
+  const char *cache_control = soup_message_headers_get_one(hdr, "Cache-Control");
+  if (!cache_control) return -1;
+
+  GHashTable *params = soup_header_parse_param_list(cache_control);
+  gint max_age = -1;
+  const char *value = NULL;
+  if (!g_hash_table_contains(params, "no-cache") && !g_hash_table_contains(params, "no-store") &&
+      g_hash_table_lookup_extended(params, "max-age", NULL, (gpointer *)&value) && value) {
+    max_age = (gint)CLAMP(g_ascii_strtoll(value, NULL, 10), 0, G_MAXINT);
+
+    // A proxy or our own cache may already have held the response for a while
+    const char *age = soup_message_headers_get_one(hdr, "Age");
+    if (age) max_age = MAX(0, max_age - (gint)CLAMP(g_ascii_strtoll(age, NULL, 10), 0, G_MAXINT));
   }
+  soup_header_free_param_list(params);
+  return max_age;
+}
 
-  JsonNode *result_root = NULL;
-  if (body) 
-  {
-    gsize len = 0;
-    const char *data = g_bytes_get_data(body, &len);
-    if (len > 0 && data) {
-      JsonParser *parser = json_parser_new();
-      if (json_parser_load_from_data(parser, data, len, NULL))
-        result_root = json_parser_steal_root(parser);
-      g_object_unref(parser);
+/* ----------------- Request engine ----------------- */
+
+// Total tries for a GET that fails transiently; POSTs are never repeated
+#define MAX_ATTEMPTS          3
+// Wait before the second attempt; doubles for each one after
+#define RETRY_BASE_DELAY_MS   500
+// A longer Retry-After goes back to the caller instead of being waited out here
+#define MAX_RETRY_AFTER_SECS  5
+
+// Not in SoupStatus
+#define HTTP_TOO_MANY_REQUESTS 429
+
+/* Every request goes to base_url, so these are per host, and the shared session
+ * keeps no more connections than that open to it. Lookups may only use
+ * the slots left after RESERVED_SLOTS, so a burst of them never makes a user
+ * action or the spot list wait for a connection. */
+#define MAX_IN_FLIGHT         HTTP_SESSION_MAX_CONNS_PER_HOST
+#define RESERVED_SLOTS        1
+
+// Token bucket: sustained requests per second, and how many may go at once
+#define RATE_PER_SEC          4.0
+#define RATE_BURST            8.0
+
+/* Turns a response body into an endpoint's typed result. Runs in a worker
+ * thread, so it must only touch the JSON and the objects it creates.
+ * root is NULL when the body was empty. */
+typedef gpointer (*PotaDecodeFunc)(JsonNode *root, GError **error);
+
+typedef struct {
+  const char     *name;         // for log messages
+  PotaDecodeFunc  decode;
+  GBoxedCopyFunc  result_ref;   // one reference per waiting caller
+  GDestroyNotify  result_free;
+} PotaDecoder;
+
+/* One HTTP request and everyone waiting for it. Identical GETs issued while
+ * one is pending join it instead of going out again. Refcounted: the engine
+ * holds one reference and every waiting GTask another, for refresh hints. */
+typedef struct {
+  PotaClient          *client;         // kept alive by the waiting tasks
+  const PotaDecoder   *decoder;
+  PotaRequestPriority  priority;
+  gchar       *method;
+  gchar       *url;
+  GBytes      *payload;         // request body, NULL for GET
+  const char  *validator_path;  // conditional endpoint, or NULL
+  GPtrArray   *waiters;         // GTask*; only shared when none has a cancellable
+  SoupMessage *msg;             // the current or last attempt
+  GBytes      *body;            // response body, handed to the decoder
+  guint        attempt;
+  gint64       queued_us;       // monotonic, first enqueue
+  gint64       started_us;      // monotonic, first send
+  gint64       received_us;     // monotonic, final response
+} PotaRequest;
+
+static void
+pota_request_clear(PotaRequest *req) {
+  g_free(req->method);
+  g_free(req->url);
+  g_clear_pointer(&req->payload, g_bytes_unref);
+  g_clear_pointer(&req->waiters, g_ptr_array_unref);
+  g_clear_object(&req->msg);
+  g_clear_pointer(&req->body, g_bytes_unref);
+}
+
+static void
+pota_request_unref(PotaRequest *req) {
+  g_rc_box_release_full(req, (GDestroyNotify)pota_request_clear);
+}
+
+static void engine_pump(PotaClient *self);
+
+// Only requests nobody can cancel are shared, so one caller never cancels another's
+static gboolean
+request_is_shareable(PotaRequest *req)
+{
+  return req->payload == NULL && req->validator_path == NULL &&
+         g_strcmp0(req->method, "GET") == 0;
+}
+
+static GCancellable *
+request_get_cancellable(PotaRequest *req)
+{
+  return req->waiters->len == 1 ? g_task_get_cancellable(g_ptr_array_index(req->waiters, 0)) : NULL;
+}
+
+// Hands the outcome to every waiter and drops the engine's reference
+static void
+request_complete(PotaRequest *req, gpointer result, GError *error)
+{
+  PotaClient *self = req->client;
+
+  // Gone before the callbacks run, so anything they request starts afresh
+  if (g_hash_table_lookup(self->pending, req->url) == req) {
+    g_hash_table_remove(self->pending, req->url);
+  }
+
+  g_autoptr(GPtrArray) waiters = g_steal_pointer(&req->waiters);
+  req->waiters = g_ptr_array_new();
+  for (guint i = 0; i < waiters->len; i++) {
+    GTask *task = g_ptr_array_index(waiters, i);
+    if (error) {
+      g_task_return_error(task, g_error_copy(error));
+    } else {
+      g_task_return_pointer(task, result ? req->decoder->result_ref(result) : NULL,
+                            req->decoder->result_free);
     }
-    g_bytes_unref(body);
   }
 
-  g_task_return_pointer(task, result_root, (GDestroyNotify)json_node_unref);
-  g_object_unref(task);
+  if (result) req->decoder->result_free(result);
+  if (error) g_error_free(error);
+  pota_request_unref(req);
 }
 
-void pota_client_post_spot_async(PotaClient *self,
-                                 ArtemisSpot *spot,
-                                 GCancellable *cancellable,
-                                 GAsyncReadyCallback callback,
-                                 gpointer user_data)
+static gboolean
+is_transient_error(const GError *error)
 {
-  g_return_if_fail(ARTEMIS_IS_POTA_CLIENT(self));
-  g_return_if_fail(ARTEMIS_IS_SPOT(spot));
+  return g_error_matches(error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT) ||
+         g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED) ||
+         g_error_matches(error, G_IO_ERROR, G_IO_ERROR_BROKEN_PIPE) ||
+         g_error_matches(error, G_RESOLVER_ERROR, G_RESOLVER_ERROR_TEMPORARY_FAILURE);
+}
 
-  GError *err = NULL;
-  JsonNode *root = build_json_from_spot(self, spot, &err);
-  if (!root)
-  {
-    g_task_report_error(self, callback, user_data, NULL, err);
-    return;
-  }
+static PotaClientError
+status_error_code(guint status)
+{
+  if (status == SOUP_STATUS_UNAUTHORIZED || status == SOUP_STATUS_FORBIDDEN)
+    return POTA_CLIENT_ERROR_UNAUTHORIZED;
+  if (status == HTTP_TOO_MANY_REQUESTS)
+    return POTA_CLIENT_ERROR_RATE_LIMITED;
+  if (status >= 500)
+    return POTA_CLIENT_ERROR_SERVER;
+  return POTA_CLIENT_ERROR_HTTP;
+}
 
-  JsonGenerator *gen = json_generator_new();
-  json_generator_set_root(gen, root);
-  gsize payload_len = 0;
-  gchar *payload = json_generator_to_data(gen, &payload_len);
-  json_node_unref(root);
-  g_object_unref(gen);
+static void
+request_decode_thread(GTask        *task,
+                      gpointer      source_object,
+                      gpointer      task_data,
+                      GCancellable *cancellable)
+{
+  PotaRequest *req = task_data;
+  gint64 decode_start_us = g_get_monotonic_time();
+
+  gsize len = 0;
+  const char *data = req->body ? g_bytes_get_data(req->body, &len) : NULL;
+  g_autoptr(JsonNode) root = NULL;
+  GError *error = NULL;
 
-  GBytes *bytes = g_bytes_new_take(payload, payload_len);
-  g_autofree gchar *url = g_strconcat(self->base_url, "/spot", NULL);
+  if (data && len > 0) {
+    g_autoptr(JsonParser) parser = json_parser_new();
+    if (!json_parser_load_from_data(parser, data, (gssize)len, &error)) {
+      g_task_return_new_error(task, POTA_CLIENT_ERROR, POTA_CLIENT_ERROR_INVALID_RESPONSE,
+                              "Invalid %s response: %s", req->decoder->name, error->message);
+      g_error_free(error);
+      return;
+    }
+    root = json_parser_steal_root(parser);
+  }
 
-  SoupMessage *msg = soup_message_new("POST", url);
+  gpointer result = req->decoder->decode(root, &error);
 
-  soup_message_set_request_body_from_bytes(msg, "application/json", bytes);
-  g_bytes_unref(bytes);
+  g_debug("%s: %" G_GSIZE_FORMAT " bytes, %" G_GINT64_FORMAT " ms queued, %" G_GINT64_FORMAT
+          " ms on the network over %u attempt(s), %" G_GINT64_FORMAT " ms to decode",
+          req->decoder->name, len,
+          (req->started_us - req->queued_us) / 1000,
+          (req->received_us - req->started_us) / 1000, req->attempt,
+          (g_get_monotonic_time() - decode_start_us) / 1000);
 
-  SoupMessageHeaders *hdr = soup_message_get_request_headers(msg);
-  soup_message_headers_replace(hdr, "Accept", "application/json");
-  soup_message_headers_replace(hdr, "User-Agent", self->source);
-  if (self->auth_header && *self->auth_header)
-  {    
-    soup_message_headers_replace(hdr, "Authorization", self->auth_header);
+  if (error) {
+    g_task_return_error(task, error);
+  } else {
+    g_task_return_pointer(task, result, req->decoder->result_free);
   }
+}
 
-  GTask *task = g_task_new(self, cancellable, callback, user_data);
-  TaskData *data = g_new0(TaskData, 1);
-  data->msg = g_object_ref(msg);
-  g_task_set_task_data(task, data, (GDestroyNotify)task_data_free);
+static void
+request_decoded_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+  PotaRequest *req = user_data;
+  GError *error = NULL;
+  gpointer result = g_task_propagate_pointer(G_TASK(res), &error);
+  request_complete(req, result, error);
+}
+
+static gboolean
+request_retry_cb(gpointer user_data)
+{
+  PotaRequest *req = user_data;
+  PotaClient *self = req->client;
 
-  soup_session_send_and_read_async(self->session, msg, G_PRIORITY_DEFAULT, cancellable, post_spot_cb, task);
-  g_object_unref(msg);
+  // Retries go to the front of their class; they have waited long enough
+  g_queue_push_head(&self->queues[req->priority], req);
+  engine_pump(self);
+  return G_SOURCE_REMOVE;
 }
 
-JsonNode *pota_client_post_spot_finish(PotaClient *self, GAsyncResult *res, GError **error) {
-  g_return_val_if_fail(ARTEMIS_IS_POTA_CLIENT(self), NULL);
-  g_return_val_if_fail(g_task_is_valid(res, self), NULL);
-  return g_task_propagate_pointer(G_TASK(res), error);
+// Whether to try again, and after how long
+static gboolean
+request_should_retry(PotaRequest *req, const GError *error, guint status, guint *out_delay_ms)
+{
+  if (g_strcmp0(req->method, "GET") != 0 || req->attempt >= MAX_ATTEMPTS) return FALSE;
+  if (error ? !is_transient_error(error)
+            : status != HTTP_TOO_MANY_REQUESTS && status < 500) return FALSE;
+
+  guint delay_ms = RETRY_BASE_DELAY_MS << (req->attempt - 1);
+  if (!error) {
+    SoupMessageHeaders *hdr = soup_message_get_response_headers(req->msg);
+    gint retry_after = parse_retry_after(soup_message_headers_get_one(hdr, "Retry-After"));
+    if (retry_after > MAX_RETRY_AFTER_SECS) return FALSE;
+    if (retry_after > 0) delay_ms = MAX(delay_ms, (guint)retry_after * 1000);
+  }
+  *out_delay_ms = delay_ms;
+  return TRUE;
 }
 
 static void
-get_spots_cb(GObject *source, GAsyncResult *res, gpointer user_data) {
-  GTask *task = G_TASK(user_data);
-  PotaClient *self = g_task_get_source_object(task);
-  TaskData *td = g_task_get_task_data(task);
-  (void)self;
+request_sent_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+  PotaRequest *req  = user_data;
+  PotaClient  *self = req->client;
 
   GError *error = NULL;
   GBytes *body  = soup_session_send_and_read_finish(SOUP_SESSION(source), res, &error);
+  guint status  = error ? 0 : soup_message_get_status(req->msg);
+  const char *phrase = soup_status_get_phrase(status);
+
+  self->in_flight--;
+  engine_pump(self);
+
+  guint delay_ms = 0;
+  if (!g_cancellable_is_cancelled(request_get_cancellable(req)) &&
+      request_should_retry(req, error, status, &delay_ms)) {
+    g_debug("%s: attempt %u failed (%s), retrying in %u ms", req->decoder->name, req->attempt,
+            error ? error->message : phrase ? phrase : "", delay_ms);
+    g_clear_error(&error);
+    if (body) g_bytes_unref(body);
+    g_timeout_add(delay_ms, request_retry_cb, req);
+    return;
+  }
+
+  req->received_us = g_get_monotonic_time();
+
   if (error) {
-    g_task_return_error(task, error);
-    g_object_unref(task);
+    g_debug("%s: failed after %u attempt(s): %s", req->decoder->name, req->attempt, error->message);
+    request_complete(req, NULL, error);
     return;
   }
 
-  guint status = soup_message_get_status(td->msg);
-  if (status < 200 || status >= 300) {
-    const char *phrase = soup_status_get_phrase(status);
-    g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_FAILED,
-                            "HTTP %u %s", status, phrase ? phrase : "");
+  // Validators live on the main thread, so "unchanged" is decided before decoding
+  if (req->validator_path &&
+      (status == SOUP_STATUS_NOT_MODIFIED ||
+       (SOUP_STATUS_IS_SUCCESSFUL(status) && !validators_record(self, req->validator_path, req->msg, body)))) {
     if (body) g_bytes_unref(body);
-    g_object_unref(task);
+    request_complete(req, NULL, g_error_new(POTA_CLIENT_ERROR, POTA_CLIENT_ERROR_NOT_MODIFIED,
+                                            "%s have not changed", req->decoder->name));
     return;
   }
 
-  JsonNode *root = NULL;
-  if (body) {
-    gsize len = 0;
-    const char *data = g_bytes_get_data(body, &len);
-    if (len > 0 && data) {
-      JsonParser *parser = json_parser_new();
-      if (json_parser_load_from_data(parser, data, len, NULL))
-        root = json_parser_steal_root(parser);
-      g_object_unref(parser);
-    }
-    g_bytes_unref(body);
+  if (!SOUP_STATUS_IS_SUCCESSFUL(status)) {
+    if (body) g_bytes_unref(body);
+    request_complete(req, NULL, g_error_new(POTA_CLIENT_ERROR, status_error_code(status),
+                                            "HTTP %u %s", status, phrase ? phrase : ""));
+    return;
   }
 
-  g_task_return_pointer(task, root, (GDestroyNotify)json_node_unref);
-  g_object_unref(task);
+  req->body = body;
+  g_autoptr(GTask) decode = g_task_new(self, NULL, request_decoded_cb, req);
+  g_task_set_task_data(decode, req, NULL);
+  g_task_run_in_thread(decode, request_decode_thread);
 }
 
-void pota_client_get_spots_async(PotaClient *self,
-                                 GCancellable *cancellable,
-                                 GAsyncReadyCallback callback,
-                                 gpointer user_data)
+static void
+request_send(PotaRequest *req)
 {
-  g_return_if_fail(ARTEMIS_IS_POTA_CLIENT(self));
+  PotaClient *self = req->client;
+
+  // A message is sent once; retries get a fresh one
+  g_clear_object(&req->msg);
+  req->msg = soup_message_new(req->method, req->url);
+  if (!req->msg) {
+    request_complete(req, NULL, g_error_new(G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                                            "Invalid URL %s", req->url));
+    return;
+  }
+  if (req->attempt++ == 0) req->started_us = g_get_monotonic_time();
 
-  g_autofree gchar *url = g_strconcat(self->base_url, "/v1/spots", NULL);
-  SoupMessage *msg = soup_message_new("GET", url);
+  if (req->payload) {
+    soup_message_set_request_body_from_bytes(req->msg, "application/json", req->payload);
+  }
 
-  SoupMessageHeaders *hdr = soup_message_get_request_headers(msg);
+  SoupMessageHeaders *hdr = soup_message_get_request_headers(req->msg);
   soup_message_headers_replace(hdr, "Accept", "application/json");
   soup_message_headers_replace(hdr, "User-Agent", self->source);
   if (self->auth_header && *self->auth_header)
@@ -245,147 +472,265 @@ void pota_client_get_spots_async(PotaClient *self,
     soup_message_headers_replace(hdr, "Authorization", self->auth_header);
   }
 
+  if (req->validator_path) {
+    /* We validate this endpoint ourselves. Left to SoupCache, a 304 would be
+     * turned back into the full cached body and re-parsed anyway. */
+    soup_message_disable_feature(req->msg, SOUP_TYPE_CACHE);
+    validators_apply(self, req->validator_path, req->msg);
+  }
+
+  self->in_flight++;
+  soup_session_send_and_read_async(self->session, req->msg,
+                                   req->priority == POTA_PRIORITY_USER ? G_PRIORITY_HIGH : G_PRIORITY_DEFAULT,
+                                   request_get_cancellable(req), request_sent_cb, req);
+}
+
+static void
+engine_refill(PotaClient *self)
+{
+  gint64 now = g_get_monotonic_time();
+  gdouble elapsed = (gdouble)(now - self->tokens_updated_us) / G_USEC_PER_SEC;
+  self->tokens = MIN(RATE_BURST, self->tokens + elapsed * RATE_PER_SEC);
+  self->tokens_updated_us = now;
+}
+
+static gboolean
+engine_pump_cb(gpointer user_data)
+{
+  PotaClient *self = ARTEMIS_POTA_CLIENT(user_data);
+  self->pump_id = 0;
+  engine_pump(self);
+  return G_SOURCE_REMOVE;
+}
+
+/* Start as many queued requests as the slots and the token bucket allow,
+ * highest priority first. User actions never wait for a token; they take
+ * one when there is one so the lookups behind them slow down instead. */
+static void
+engine_pump(PotaClient *self)
+{
+  while (self->in_flight < MAX_IN_FLIGHT) {
+    PotaRequestPriority priority = 0;
+    while (priority < POTA_N_PRIORITIES && g_queue_is_empty(&self->queues[priority])) priority++;
+    if (priority == POTA_N_PRIORITIES) return;
+
+    if (priority >= POTA_PRIORITY_VISIBLE && self->in_flight >= MAX_IN_FLIGHT - RESERVED_SLOTS) return;
+
+    engine_refill(self);
+    if (priority != POTA_PRIORITY_USER && self->tokens < 1.0) {
+      if (!self->pump_id) {
+        guint wait_ms = (guint)((1.0 - self->tokens) / RATE_PER_SEC * 1000) + 1;
+        self->pump_id = g_timeout_add(wait_ms, engine_pump_cb, self);
+      }
+      return;
+    }
+    self->tokens = MAX(0.0, self->tokens - 1.0);
+
+    PotaRequest *req = g_queue_pop_head(&self->queues[priority]);
+    if (g_cancellable_is_cancelled(request_get_cancellable(req))) {
+      request_complete(req, NULL, g_error_new_literal(G_IO_ERROR, G_IO_ERROR_CANCELLED,
+                                                      "Operation was cancelled"));
+      continue;
+    }
+    request_send(req);
+  }
+}
+
+/* Send method to base_url + path once the scheduler gets to it, and decode the
+ * 2xx body with decoder in a worker thread. Non-2xx statuses come back as
+ * POTA_CLIENT_ERROR codes. */
+static void
+pota_request_start(PotaClient          *self,
+                   const PotaDecoder   *decoder,
+                   PotaRequestPriority  priority,
+                   const char          *method,
+                   const char          *path,
+                   GBytes              *payload,
+                   const char          *validator_path,
+                   gpointer             source_tag,
+                   GCancellable        *cancellable,
+                   GAsyncReadyCallback  callback,
+                   gpointer             user_data)
+{
+  g_autofree gchar *url = g_strconcat(self->base_url, path, NULL);
+
   GTask *task = g_task_new(self, cancellable, callback, user_data);
-  TaskData *td = g_new0(TaskData, 1);
-  td->msg = g_object_ref(msg);
-  g_task_set_task_data(task, td, (GDestroyNotify)task_data_free);
+  g_task_set_source_tag(task, source_tag);
+
+  PotaRequest *req = g_hash_table_lookup(self->pending, url);
+  if (req && !cancellable && req->decoder == decoder) {
+    // Already on its way; a more urgent caller pulls a still-queued request forward
+    if (priority < req->priority && g_queue_remove(&self->queues[req->priority], req)) {
+      g_queue_push_tail(&self->queues[priority], req);
+      req->priority = priority;
+    }
+    g_ptr_array_add(req->waiters, task);
+    g_task_set_task_data(task, g_rc_box_acquire(req), (GDestroyNotify)pota_request_unref);
+    engine_pump(self);
+    return;
+  }
 
-  soup_session_send_and_read_async(self->session, msg, G_PRIORITY_DEFAULT,
-                                    cancellable, get_spots_cb, task);
+  req = g_rc_box_new0(PotaRequest);
+  req->client = self;
+  req->decoder = decoder;
+  req->priority = priority;
+  req->method = g_strdup(method);
+  req->url = g_steal_pointer(&url);
+  req->payload = payload ? g_bytes_ref(payload) : NULL;
+  req->validator_path = validator_path;
+  req->waiters = g_ptr_array_new_with_free_func(g_object_unref);
+  req->queued_us = g_get_monotonic_time();
+
+  g_ptr_array_add(req->waiters, task);
+  g_task_set_task_data(task, g_rc_box_acquire(req), (GDestroyNotify)pota_request_unref);
+  if (!cancellable && request_is_shareable(req)) {
+    g_hash_table_insert(self->pending, req->url, req);
+  }
 
-  g_object_unref(msg);
+  g_queue_push_tail(&self->queues[priority], req);
+  engine_pump(self);
 }
 
-JsonNode *pota_client_get_spots_finish(PotaClient *self, GAsyncResult *res, GError **error) {
+static gpointer
+pota_request_finish(PotaClient *self, GAsyncResult *res, gpointer source_tag, GError **error)
+{
   g_return_val_if_fail(ARTEMIS_IS_POTA_CLIENT(self), NULL);
   g_return_val_if_fail(g_task_is_valid(res, self), NULL);
+  g_return_val_if_fail(g_task_get_source_tag(G_TASK(res)) == source_tag, NULL);
   return g_task_propagate_pointer(G_TASK(res), error);
 }
 
-static void
-get_activator_cb(GObject *source, GAsyncResult *res, gpointer user_data) {
-  GTask *task = G_TASK(user_data);
-  PotaClient *self = g_task_get_source_object(task);
-  TaskData *td = g_task_get_task_data(task);
-  (void)self;
+/* ----------------- Decoders ----------------- */
 
-  GError *error = NULL;
-  GBytes *body  = soup_session_send_and_read_finish(SOUP_SESSION(source), res, &error);
-  if (error) {
-    g_task_return_error(task, error);
-    g_object_unref(task);
-    return;
+// Spot list, spot history and the POST reply are all arrays of spot objects
+static gpointer
+decode_spot_array(JsonNode *root, GError **error)
+{
+  if (!root || !JSON_NODE_HOLDS_ARRAY(root)) {
+    g_set_error(error, POTA_CLIENT_ERROR, POTA_CLIENT_ERROR_INVALID_RESPONSE,
+                "Expected a list of spots");
+    return NULL;
   }
 
-  guint status = soup_message_get_status(td->msg);
-  if (status < 200 || status >= 300) {
-    const char *phrase = soup_status_get_phrase(status);
-    g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_FAILED,
-                            "HTTP %u %s", status, phrase ? phrase : "");
-    if (body) g_bytes_unref(body);
-    g_object_unref(task);
-    return;
+  JsonArray *arr = json_node_get_array(root);
+  guint len = json_array_get_length(arr);
+  GPtrArray *spots = g_ptr_array_new_full(len, g_object_unref);
+  for (guint i = 0; i < len; i++) {
+    JsonNode *element = json_array_get_element(arr, i);
+    if (!JSON_NODE_HOLDS_OBJECT(element)) continue;
+    g_ptr_array_add(spots, artemis_spot_new_from_json(json_node_get_object(element)));
   }
+  return spots;
+}
 
-  JsonNode *root = NULL;
-  if (body) {
-    gsize len = 0;
-    const char *data = g_bytes_get_data(body, &len);
-    if (len > 0 && data) {
-      JsonParser *parser = json_parser_new();
-      if (json_parser_load_from_data(parser, data, len, NULL))
-        root = json_parser_steal_root(parser);
-      g_object_unref(parser);
-    }
-    g_bytes_unref(body);
+static gpointer
+decode_activator(JsonNode *root, GError **error)
+{
+  if (!root || !JSON_NODE_HOLDS_OBJECT(root)) {
+    g_set_error(error, POTA_CLIENT_ERROR, POTA_CLIENT_ERROR_INVALID_RESPONSE,
+                "Expected a user object");
+    return NULL;
   }
-
-  g_task_return_pointer(task, root, (GDestroyNotify)json_node_unref);
-  g_object_unref(task);
+  return artemis_activator_new_from_json(json_node_get_object(root));
 }
 
-void pota_client_get_activator_async(PotaClient *self,
-                                     const gchar *callsign,
-                                     GCancellable *cancellable,
-                                     GAsyncReadyCallback callback,
-                                     gpointer user_data)
+#define SPOT_ARRAY_DECODER(name) \
+  { name, decode_spot_array, (GBoxedCopyFunc)g_ptr_array_ref, (GDestroyNotify)g_ptr_array_unref }
+
+static const PotaDecoder SPOTS_DECODER        = SPOT_ARRAY_DECODER("Spots");
+static const PotaDecoder SPOT_HISTORY_DECODER = SPOT_ARRAY_DECODER("Spot history");
+static const PotaDecoder POST_SPOT_DECODER    = SPOT_ARRAY_DECODER("Posted spot");
+static const PotaDecoder ACTIVATOR_DECODER    = { "User stats", decode_activator, (GBoxedCopyFunc)g_object_ref, g_object_unref };
+
+/* ----------------- Endpoints ----------------- */
+
+void pota_client_post_spot_async(PotaClient *self,
+                                 ArtemisSpot *spot,
+                                 GCancellable *cancellable,
+                                 GAsyncReadyCallback callback,
+                                 gpointer user_data)
 {
   g_return_if_fail(ARTEMIS_IS_POTA_CLIENT(self));
-  g_return_if_fail(callsign && *callsign);
-
-  g_autofree gchar *escaped_callsign = g_uri_escape_string(callsign, NULL, FALSE);
-  g_autofree gchar *url = g_strconcat(self->base_url, "/stats/user/", escaped_callsign, NULL);
-  SoupMessage *msg = soup_message_new("GET", url);
+  g_return_if_fail(ARTEMIS_IS_SPOT(spot));
 
-  SoupMessageHeaders *hdr = soup_message_get_request_headers(msg);
-  soup_message_headers_replace(hdr, "Accept", "application/json");
-  soup_message_headers_replace(hdr, "User-Agent", self->source);
-  if (self->auth_header && *self->auth_header)
+  GError *err = NULL;
+  JsonNode *root = build_json_from_spot(self, spot, &err);
+  if (!root)
   {
-    soup_message_headers_replace(hdr, "Authorization", self->auth_header);
+    g_task_report_error(self, callback, user_data, pota_client_post_spot_async, err);
+    return;
   }
 
-  GTask *task = g_task_new(self, cancellable, callback, user_data);
-  TaskData *td = g_new0(TaskData, 1);
-  td->msg = g_object_ref(msg);
-  g_task_set_task_data(task, td, (GDestroyNotify)task_data_free);
+  JsonGenerator *gen = json_generator_new();
+  json_generator_set_root(gen, root);
+  gsize payload_len = 0;
+  gchar *payload = json_generator_to_data(gen, &payload_len);
+  json_node_unref(root);
+  g_object_unref(gen);
 
-  soup_session_send_and_read_async(self->session, msg, G_PRIORITY_DEFAULT,
-                                    cancellable, get_activator_cb, task);
+  g_autoptr(GBytes) bytes = g_bytes_new_take(payload, payload_len);
+  pota_request_start(self, &POST_SPOT_DECODER, POTA_PRIORITY_USER, "POST", "/spot", bytes, NULL,
+                     pota_client_post_spot_async, cancellable, callback, user_data);
+}
 
-  g_object_unref(msg);
+GPtrArray *pota_client_post_spot_finish(PotaClient *self, GAsyncResult *res, GError **error) {
+  return pota_request_finish(self, res, pota_client_post_spot_async, error);
 }
 
-JsonNode *pota_client_get_activator_finish(PotaClient *self, GAsyncResult *res, GError **error) {
-  g_return_val_if_fail(ARTEMIS_IS_POTA_CLIENT(self), NULL);
-  g_return_val_if_fail(g_task_is_valid(res, self), NULL);
-  return g_task_propagate_pointer(G_TASK(res), error);
+void pota_client_get_spots_async(PotaClient *self,
+                                 GCancellable *cancellable,
+                                 GAsyncReadyCallback callback,
+                                 gpointer user_data)
+{
+  g_return_if_fail(ARTEMIS_IS_POTA_CLIENT(self));
+
+  pota_request_start(self, &SPOTS_DECODER, POTA_PRIORITY_SPOTS, "GET", SPOTS_PATH, NULL, SPOTS_PATH,
+                     pota_client_get_spots_async, cancellable, callback, user_data);
 }
 
-static void
-get_spot_history_cb(GObject *source, GAsyncResult *res, gpointer user_data) {
-  GTask *task = G_TASK(user_data);
-  PotaClient *self = g_task_get_source_object(task);
-  TaskData *td = g_task_get_task_data(task);
-  (void)self;
+void pota_client_reset_spots_validators(PotaClient *self) {
+  g_return_if_fail(ARTEMIS_IS_POTA_CLIENT(self));
+  g_hash_table_remove(self->validators, SPOTS_PATH);
+}
 
-  GError *error = NULL;
-  GBytes *body  = soup_session_send_and_read_finish(SOUP_SESSION(source), res, &error);
-  if (error) {
-    g_task_return_error(task, error);
-    g_object_unref(task);
-    return;
-  }
+GPtrArray *pota_client_get_spots_finish(PotaClient *self, GAsyncResult *res, GError **error) {
+  return pota_request_finish(self, res, pota_client_get_spots_async, error);
+}
 
-  guint status = soup_message_get_status(td->msg);
-  if (status < 200 || status >= 300) {
-    const char *phrase = soup_status_get_phrase(status);
-    g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_FAILED,
-                            "HTTP %u %s", status, phrase ? phrase : "");
-    if (body) g_bytes_unref(body);
-    g_object_unref(task);
-    return;
-  }
+gint pota_client_get_spots_refresh_hint(PotaClient *self, GAsyncResult *res)
+{
+  g_return_val_if_fail(ARTEMIS_IS_POTA_CLIENT(self), -1);
+  g_return_val_if_fail(g_task_is_valid(res, self), -1);
 
-  gsize body_size;
-  const char *body_str = g_bytes_get_data(body, &body_size);
-  
-  JsonParser *parser = json_parser_new();
-  if (!json_parser_load_from_data(parser, body_str, body_size, &error)) {
-    g_task_return_error(task, error);
-    g_object_unref(parser);
-    g_bytes_unref(body);
-    g_object_unref(task);
-    return;
-  }
+  PotaRequest *req = g_task_get_task_data(G_TASK(res));
+  if (!req || !req->msg) return -1;
 
-  JsonNode *root = json_parser_get_root(parser);
-  JsonNode *copy = json_node_copy(root);
-  
-  g_task_return_pointer(task, copy, (GDestroyNotify)json_node_unref);
-  g_object_unref(parser);
-  g_bytes_unref(body);
-  g_object_unref(task);
+  SoupMessageHeaders *hdr = soup_message_get_response_headers(req->msg);
+  if (!hdr) return -1;
+
+  gint retry_after = parse_retry_after(soup_message_headers_get_one(hdr, "Retry-After"));
+  if (retry_after >= 0) return retry_after;
+  return parse_max_age(hdr);
+}
+
+void pota_client_get_activator_async(PotaClient *self,
+                                     const gchar *callsign,
+                                     PotaRequestPriority priority,
+                                     GCancellable *cancellable,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data)
+{
+  g_return_if_fail(ARTEMIS_IS_POTA_CLIENT(self));
+  g_return_if_fail(callsign && *callsign);
+
+  g_autofree gchar *escaped_callsign = g_uri_escape_string(callsign, NULL, FALSE);
+  g_autofree gchar *path = g_strconcat("/stats/user/", escaped_callsign, NULL);
+  pota_request_start(self, &ACTIVATOR_DECODER, priority, "GET", path, NULL, NULL,
+                     pota_client_get_activator_async, cancellable, callback, user_data);
+}
+
+ArtemisActivator *pota_client_get_activator_finish(PotaClient *self, GAsyncResult *res, GError **error) {
+  return pota_request_finish(self, res, pota_client_get_activator_async, error);
 }
 
 void pota_client_get_spot_history_async(PotaClient *self,
@@ -399,51 +744,26 @@ void pota_client_get_spot_history_async(PotaClient *self,
   g_return_if_fail(callsign && *callsign);
   g_return_if_fail(park_ref && *park_ref);
 
-  g_debug("pota_client_get_spot_history_async: callsign='%s' (%zu chars), park_ref='%s' (%zu chars)", 
-          callsign, strlen(callsign), park_ref, strlen(park_ref));
-
   g_autofree gchar *escaped_callsign = g_uri_escape_string(callsign, NULL, FALSE);
   g_autofree gchar *escaped_park_ref = g_uri_escape_string(park_ref, NULL, FALSE);
-  g_autofree gchar *url = g_strconcat(self->base_url, "/v1/spots/", escaped_callsign, "/", escaped_park_ref, NULL);
-  
-  g_debug("Constructed URL: %s", url);
-  
-  SoupMessage *msg = soup_message_new("GET", url);
-
-  SoupMessageHeaders *hdr = soup_message_get_request_headers(msg);
-  soup_message_headers_replace(hdr, "Accept", "application/json");
-  soup_message_headers_replace(hdr, "User-Agent", self->source);
-  if (self->auth_header && *self->auth_header)
-  {
-    soup_message_headers_replace(hdr, "Authorization", self->auth_header);
-  }
-
-  GTask *task = g_task_new(self, cancellable, callback, user_data);
-  TaskData *td = g_new0(TaskData, 1);
-  td->msg = g_object_ref(msg);
-  g_task_set_task_data(task, td, (GDestroyNotify)task_data_free);
-
-  soup_session_send_and_read_async(self->session, msg, G_PRIORITY_DEFAULT,
-                                   cancellable, get_spot_history_cb, task);
-
-  g_object_unref(msg);
+  g_autofree gchar *path = g_strconcat(SPOTS_PATH "/", escaped_callsign, "/", escaped_park_ref, NULL);
+  pota_request_start(self, &SPOT_HISTORY_DECODER, POTA_PRIORITY_USER, "GET", path, NULL, NULL,
+                     pota_client_get_spot_history_async, cancellable, callback, user_data);
 }
 
-JsonNode *pota_client_get_spot_history_finish(PotaClient *self, GAsyncResult *res, GError **error) {
-  g_return_val_if_fail(ARTEMIS_IS_POTA_CLIENT(self), NULL);
-  g_return_val_if_fail(g_task_is_valid(res, self), NULL);
-  return g_task_propagate_pointer(G_TASK(res), error);
+GPtrArray *pota_client_get_spot_history_finish(PotaClient *self, GAsyncResult *res, GError **error) {
+  return pota_request_finish(self, res, pota_client_get_spot_history_async, error);
 }
 
 static void pota_client_finalize(GObject *obj)
 {
   PotaClient *self = ARTEMIS_POTA_CLIENT(obj);
   
-  soup_cache_flush(self->session_cache);
-  soup_cache_dump(self->session_cache);
+  g_clear_handle_id(&self->pump_id, g_source_remove);
 
   g_clear_object(&self->session);
-  g_clear_object(&self->session_cache);
+  g_clear_pointer(&self->validators, g_hash_table_unref);
+  g_clear_pointer(&self->pending, g_hash_table_unref);
   g_clear_pointer(&self->auth_header, g_free);
   g_clear_pointer(&self->source, g_free);
   g_clear_pointer(&self->base_url, g_free);
@@ -459,18 +779,13 @@ static void pota_client_class_init(PotaClientClass *klass)
 
 static void pota_client_init(PotaClient *self)
 {
-  self->session = soup_session_new_with_options(
-    "timeout", 30,
-    "idle-timeout", 15
-    , NULL);
-
-  const gchar *data_dir = g_get_user_data_dir();
-  g_autofree gchar *app_dir = g_build_filename(data_dir, "artemis", NULL);
-  g_mkdir_with_parents(app_dir, 0700);
-  g_autofree gchar *cache_path = g_build_filename(app_dir, "pota_spots.cache", NULL);
-  self->session_cache = soup_cache_new(cache_path, SOUP_CACHE_SINGLE_USER);
-
-  soup_session_add_feature(self->session, SOUP_SESSION_FEATURE(self->session_cache));
+  self->session = g_object_ref(http_session_get_instance());
+
+  self->validators = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)validators_free);
+  self->pending = g_hash_table_new(g_str_hash, g_str_equal);
+  self->tokens = RATE_BURST;
+  self->tokens_updated_us = g_get_monotonic_time();
+
   self->source = g_strdup_printf("Artemis/%d.%d.%d", 
                                 VERSION_MAJOR(APP_VERSION),
                                 VERSION_MINOR(APP_VERSION),
@@ -482,13 +797,3 @@ PotaClient *pota_client_new()
 {
   return g_object_new(POTA_TYPE_CLIENT, NULL);
 }
-
-void pota_client_set_timeout(PotaClient *self, guint io_timeout_sec, guint idle_timeout_sec)
-{
-  g_return_if_fail(ARTEMIS_IS_POTA_CLIENT(self));
-
-  g_object_set(self->session, 
-    "timeout", io_timeout_sec,
-  "idle-timeout", idle_timeout_sec, 
-  NULL);
-}
\ No newline at end of file
@@ -4,43 +4,86 @@
 #include <json-glib/json-glib.h>
 #include "glib.h"
 #include "spot.h"
+#include "activator.h"
 
 G_BEGIN_DECLS
 
+#define POTA_CLIENT_ERROR (pota_client_error_quark())
+
+typedef enum {
+  // The resource matches what the last successful request returned
+  POTA_CLIENT_ERROR_NOT_MODIFIED,
+  // 401 or 403; the API did not accept our credentials
+  POTA_CLIENT_ERROR_UNAUTHORIZED,
+  // 429, after retrying
+  POTA_CLIENT_ERROR_RATE_LIMITED,
+  // 5xx, after retrying
+  POTA_CLIENT_ERROR_SERVER,
+  // Any other non-2xx status
+  POTA_CLIENT_ERROR_HTTP,
+  // 2xx, but the body was not the JSON the endpoint returns
+  POTA_CLIENT_ERROR_INVALID_RESPONSE,
+} PotaClientError;
+
+GQuark pota_client_error_quark(void);
+
+// Scheduling class of a request, most urgent first
+typedef enum {
+  POTA_PRIORITY_USER,      // something the user just asked for
+  POTA_PRIORITY_SPOTS,     // the spot list refresh
+  POTA_PRIORITY_VISIBLE,   // lookups for cards on screen
+  POTA_PRIORITY_PREFETCH,  // warming caches in the background
+  POTA_N_PRIORITIES
+} PotaRequestPriority;
+
 #define POTA_TYPE_CLIENT (pota_client_get_type())
 G_DECLARE_FINAL_TYPE(PotaClient, pota_client, ARTEMIS, POTA_CLIENT, GObject)
 
 PotaClient *pota_client_new(void);
 
-void
-pota_client_set_timeout     (PotaClient *self, guint io_timeout_sec, guint idle_timeout_sec);
-
 void        pota_client_post_spot_async (PotaClient        *self,
                                          ArtemisSpot       *spot,
                                          GCancellable      *cancellable,
                                          GAsyncReadyCallback callback,
                                          gpointer           user_data);
 
-JsonNode   *pota_client_post_spot_finish(PotaClient   *self,
+// The server's current spot list (ArtemisSpot*), which includes the new spot
+GPtrArray  *pota_client_post_spot_finish(PotaClient   *self,
                                          GAsyncResult *res,
                                          GError      **error);
 
+/* Conditional: sends the ETag / Last-Modified of the last successful response
+ * and fails with POTA_CLIENT_ERROR_NOT_MODIFIED on a 304, or when a 200 body
+ * hashes the same as the previous one, without parsing anything. */
 void      pota_client_get_spots_async (PotaClient         *self,
                                        GCancellable       *cancellable,
                                        GAsyncReadyCallback callback,
                                        gpointer            user_data);
 
-JsonNode* pota_client_get_spots_finish(PotaClient   *self,
+// ArtemisSpot*, decoded off the main thread
+GPtrArray* pota_client_get_spots_finish(PotaClient   *self,
                                        GAsyncResult *res,
                                        GError      **error);
 
+// Make the next request unconditional, e.g. after the caller dropped its copy
+void      pota_client_reset_spots_validators(PotaClient *self);
+
+// How long the server asked us to wait before polling /v1/spots again, from
+// Retry-After or Cache-Control max-age. -1 if it said nothing. Valid for the
+// same result as pota_client_get_spots_finish, success or not.
+gint      pota_client_get_spots_refresh_hint(PotaClient   *self,
+                                             GAsyncResult *res);
+
+/* Identical lookups made without a cancellable while one is outstanding share
+ * it, and a higher priority moves a still-queued lookup forward. */
 void      pota_client_get_activator_async (PotaClient         *self,
                                            const gchar        *callsign,
+                                           PotaRequestPriority priority,
                                            GCancellable       *cancellable,
                                            GAsyncReadyCallback callback,
                                            gpointer            user_data);
 
-JsonNode* pota_client_get_activator_finish(PotaClient   *self,
+ArtemisActivator* pota_client_get_activator_finish(PotaClient   *self,
                                            GAsyncResult *res,
                                            GError      **error);
 
@@ -51,7 +94,8 @@ void      pota_client_get_spot_history_async (PotaClient         *self,
                                               GAsyncReadyCallback callback,
                                               gpointer            user_data);
 
-JsonNode* pota_client_get_spot_history_finish(PotaClient   *self,
+// ArtemisSpot*, one per past spot of this activation
+GPtrArray* pota_client_get_spot_history_finish(PotaClient   *self,
                                               GAsyncResult *res,
                                               GError      **error);
 G_END_DECLS
@@ -72,7 +72,7 @@ get_activator_from_api_cb(GObject *source, GAsyncResult *res, gpointer user_data
   PotaClient *client = ARTEMIS_POTA_CLIENT(source);
   
   GError *error = NULL;
-  JsonNode *root = pota_client_get_activator_finish(client, res, &error);
+  ArtemisActivator *activator = pota_client_get_activator_finish(client, res, &error);
   
   if (error) {
     g_task_return_error(task, error);
@@ -80,25 +80,15 @@ get_activator_from_api_cb(GObject *source, GAsyncResult *res, gpointer user_data
     return;
   }
   
-  ArtemisActivator *activator = NULL;
-  if (root && JSON_NODE_HOLDS_OBJECT(root)) {
-    JsonObject *obj = json_node_get_object(root);
-    activator = artemis_activator_new_from_json(obj);
-    
-    if (activator) {
-      // Cache the result
-      const gchar *callsign = artemis_activator_get_callsign(activator);
-      guint ttl_seconds = GPOINTER_TO_UINT(g_task_get_task_data(task));
-      
-      PotaUserCacheEntry *entry = g_new0(PotaUserCacheEntry, 1);
-      entry->activator = g_object_ref(activator);
-      entry->expires_at = g_get_monotonic_time() + (ttl_seconds * G_TIME_SPAN_SECOND);
-      
-      g_hash_table_replace(self->cache, g_strdup(callsign), entry);
-    }
-  }
+  // Cache the result
+  const gchar *callsign = artemis_activator_get_callsign(activator);
+  guint ttl_seconds = GPOINTER_TO_UINT(g_task_get_task_data(task));
+  
+  PotaUserCacheEntry *entry = g_new0(PotaUserCacheEntry, 1);
+  entry->activator = g_object_ref(activator);
+  entry->expires_at = g_get_monotonic_time() + (ttl_seconds * G_TIME_SPAN_SECOND);
   
-  if (root) json_node_unref(root);
+  g_hash_table_replace(self->cache, g_strdup(callsign), entry);
   
   g_task_return_pointer(task, activator, g_object_unref);
   g_object_unref(task);
@@ -107,6 +97,7 @@ get_activator_from_api_cb(GObject *source, GAsyncResult *res, gpointer user_data
 void artemis_pota_user_cache_get_async(ArtemisPotaUserCache *self,
                                        const gchar          *callsign,
                                        guint                 ttl_seconds,
+                                       PotaRequestPriority   priority,
                                        GCancellable         *cancellable,
                                        GAsyncReadyCallback   callback,
                                        gpointer              user_data) {
@@ -131,7 +122,7 @@ void artemis_pota_user_cache_get_async(ArtemisPotaUserCache *self,
   GTask *task = g_task_new(self, cancellable, callback, user_data);
   g_task_set_task_data(task, GUINT_TO_POINTER(ttl_seconds), NULL);
   
-  pota_client_get_activator_async(self->client, callsign, cancellable, 
+  pota_client_get_activator_async(self->client, callsign, priority, cancellable,
                                   get_activator_from_api_cb, task);
 }
 
@@ -172,6 +163,23 @@ ArtemisPotaUserCache *artemis_pota_user_cache_get_instance(void)
   return g_pota_user_cache_instance;
 }
 
+ArtemisPotaUserCache *artemis_pota_user_cache_init_instance(PotaClient *client)
+{
+  g_return_val_if_fail(ARTEMIS_IS_POTA_CLIENT(client), NULL);
+
+  g_mutex_lock(&g_pota_user_cache_mutex);
+
+  if (!g_pota_user_cache_instance) {
+    g_pota_user_cache_instance = artemis_pota_user_cache_new(client);
+  } else if (g_pota_user_cache_instance->client != client) {
+    g_set_object(&g_pota_user_cache_instance->client, client);
+  }
+  ArtemisPotaUserCache *instance = g_object_ref(g_pota_user_cache_instance);
+
+  g_mutex_unlock(&g_pota_user_cache_mutex);
+  return instance;
+}
+
 void artemis_pota_user_cache_cleanup_instance(void)
 {
   g_mutex_lock(&g_pota_user_cache_mutex);
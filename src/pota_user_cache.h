@@ -18,6 +18,7 @@ ArtemisPotaUserCache *artemis_pota_user_cache_new(PotaClient *client);
 void artemis_pota_user_cache_get_async(ArtemisPotaUserCache *self,
                                        const gchar          *callsign,
                                        guint                 ttl_seconds,
+                                       PotaRequestPriority   priority,
                                        GCancellable         *cancellable,
                                        GAsyncReadyCallback   callback,
                                        gpointer              user_data);
@@ -33,6 +34,9 @@ artemis_pota_user_cache_set_ttl_default(ArtemisPotaUserCache *self, guint ttl_se
 
 // Singleton access (initialized when first spot repo is created)
 ArtemisPotaUserCache *artemis_pota_user_cache_get_instance(void);
+// Returns a new reference to the singleton, which from now on fetches through
+// client so its lookups are scheduled together with the client's other requests
+ArtemisPotaUserCache *artemis_pota_user_cache_init_instance(PotaClient *client);
 void
 artemis_pota_user_cache_cleanup_instance(void);
 
@@ -5,6 +5,7 @@
 #include "glib-object.h"
 
 #include <math.h>
+#include <stdio.h>
 #include <hamlib/rig.h>
 
 #include "glib.h"
@@ -15,6 +16,11 @@
 #include "radio_models.h"
 #include "artemis.h"
 #include "database.h"
+#include "adif_export.h"
+#include "park_import.h"
+#include "rig_worker.h"
+#include "rig_probe.h"
+#include "rig_profile.h"
 
 typedef struct {
   const char *const *items;
@@ -56,6 +62,13 @@ static const char *const CONNECTION_TYPES_VALUES[] = {
   "none", "serial", "network", "usb"
 };
 
+static const char *const UDP_LOG_FORMATS[] = {
+  "none", "wsjtx", "n1mm"
+};
+static const StringListMap udp_log_formats_map = {
+  .items = UDP_LOG_FORMATS, .n_items = G_N_ELEMENTS(UDP_LOG_FORMATS)
+};
+
 static const char *const BAUD_RATES[] = {
   "1200", "2400", "4800", "9600", "19200", "38400", "57600", "115200"
 };
@@ -66,15 +79,40 @@ typedef struct {
   GtkWidget *test_button;
   GtkWidget *parent_dialog;
   GSettings *settings;
+  GCancellable *cancellable;  // non-NULL while a test is running
+  AdwActionRow *detect_row;
+  GtkWidget *detect_button;
+  GCancellable *detect_cancellable;  // non-NULL while probing
 } RadioTestData;
 
 typedef struct {
+  GtkWidget     *parent_dialog;
   AdwActionRow  *import_action_row;
   GtkFileDialog *file_dialog;
   GtkWidget     *import_button;
   char          *selected_file_path;
+  GCancellable  *cancellable;
 } ImportLogbookData;
 
+typedef struct {
+  GtkWidget     *parent_dialog;
+  AdwEntryRow   *park_prefix_row;
+  AdwComboRow   *mode_row;
+  AdwEntryRow   *from_row;
+  AdwEntryRow   *to_row;
+  AdwActionRow  *export_row;
+  GtkWidget     *export_button;
+  GtkWidget     *cancel_button;
+  GCancellable  *cancellable;
+} ExportLogbookData;
+
+typedef struct {
+  GtkWidget     *parent_dialog;
+  AdwActionRow  *catalog_row;
+  GtkWidget     *import_button;
+  GCancellable  *cancellable;
+} CatalogImportData;
+
 typedef struct {
   GtkWidget *serial_settings_group;
   GtkWidget *network_settings_group;
@@ -107,75 +145,152 @@ update_connection_status(RadioTestData *data, gboolean connected, const char *me
   gtk_button_set_label(GTK_BUTTON(data->test_button), "Test Connection");
 }
 
+// Long enough for a slow serial rig to answer rig_open's retries
+#define RADIO_TEST_TIMEOUT_SECONDS 10
+
+static void
+on_radio_test_progress(const gchar *stage, gpointer user_data)
+{
+  RadioTestData *data = g_object_get_data(G_OBJECT(user_data), "radio-test-data");
+  if (data) {
+    gtk_label_set_text(GTK_LABEL(data->connection_status_label), stage);
+  }
+}
+
+static void
+on_radio_test_complete(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  GtkWidget *dlg = GTK_WIDGET(user_data);
+  RadioTestData *data = g_object_get_data(G_OBJECT(dlg), "radio-test-data");
+  GError *error = NULL;
+  gdouble freq_hz = -1;
+
+  gboolean ok = rig_config_test_finish(result, &freq_hz, &error);
+
+  if (data) {
+    g_clear_object(&data->cancellable);
+
+    if (ok && freq_hz >= 0) {
+      g_autofree gchar *msg = g_strdup_printf("Connected (%.3f MHz)", freq_hz / 1000000.0);
+      update_connection_status(data, TRUE, msg);
+    } else if (ok) {
+      update_connection_status(data, TRUE, "Connected");
+    } else if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      update_connection_status(data, FALSE, NULL);
+    } else if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)) {
+      g_autofree gchar *detail = g_strdup_printf("The radio did not respond within %d seconds.\n\nPlease verify your connection settings and ensure your radio is powered on and properly connected.", RADIO_TEST_TIMEOUT_SECONDS);
+      show_error_dialog(data, "Radio Connection Timed Out", detail);
+      update_connection_status(data, FALSE, NULL);
+    } else {
+      g_autofree gchar *detail = g_strdup_printf("%s\n\nPlease verify your connection settings and ensure your radio is powered on and properly connected.", error->message);
+      show_error_dialog(data, "Radio Connection Failed", detail);
+      update_connection_status(data, FALSE, NULL);
+    }
+  }
+
+  g_clear_error(&error);
+  g_object_unref(dlg);
+}
+
 static void
 on_test_connection_clicked(GtkButton *button, gpointer user_data) {
   RadioTestData *data = (RadioTestData *)user_data;
-  
-  gtk_widget_set_sensitive(data->test_button, FALSE);
-  gtk_button_set_label(GTK_BUTTON(data->test_button), "Testing...");
-  
-  gtk_image_set_from_icon_name(GTK_IMAGE(data->connection_status_icon), "content-loading-symbolic");
-  gtk_widget_remove_css_class(data->connection_status_icon, "success");
-  gtk_widget_remove_css_class(data->connection_status_icon, "error");
-  gtk_label_set_text(GTK_LABEL(data->connection_status_label), "Testing connection...");
-  
-  // Get radio settings
-  g_autofree gchar *connection_type = g_settings_get_string(data->settings, "radio-connection-type");
-  gint model_id = g_settings_get_int(data->settings, "radio-model");
-  g_autofree gchar *device_path = g_settings_get_string(data->settings, "radio-device");
-  g_autofree gchar *network_host = g_settings_get_string(data->settings, "radio-network-host");
-  gint network_port = g_settings_get_int(data->settings, "radio-network-port");
-  gint baud_rate = g_settings_get_int(data->settings, "radio-baud-rate");
-  
-  // Check if connection type is selected
-  if (g_strcmp0(connection_type, "none") == 0) {
-    show_error_dialog(data, "No Connection Type", "Please select a connection type (Serial, Network, or USB) before testing.");
-    update_connection_status(data, FALSE, NULL);
+
+  // The button doubles as "Cancel" while a test is running
+  if (data->cancellable) {
+    g_cancellable_cancel(data->cancellable);
     return;
   }
-  
-  // Initialize rig
-  RIG *rig = rig_init(model_id);
-  if (!rig) {
-    show_error_dialog(data, "Radio Model Error", "Failed to initialize the selected radio model. Please verify the model selection.");
+
+  g_autoptr(RigConfig) config = rig_config_new_from_settings(data->settings);
+  if (!config) {
+    show_error_dialog(data, "No Connection Type", "Please select a connection type (Serial, Network, or USB) before testing.");
     update_connection_status(data, FALSE, NULL);
     return;
   }
-  
-  // Configure connection based on type
-  if (g_strcmp0(connection_type, "serial") == 0) {
-    strncpy(rig->state.rigport.pathname, device_path, HAMLIB_FILPATHLEN - 1);
-    rig->state.rigport.parm.serial.rate = baud_rate;
-  } else if (g_strcmp0(connection_type, "network") == 0) {
-    g_autofree gchar *network_path = g_strdup_printf("%s:%d", network_host, network_port);
-    strncpy(rig->state.rigport.pathname, network_path, HAMLIB_FILPATHLEN - 1);
-    rig->state.rigport.type.rig = RIG_PORT_NETWORK;
-  } else if (g_strcmp0(connection_type, "usb") == 0) {
-    strncpy(rig->state.rigport.pathname, device_path, HAMLIB_FILPATHLEN - 1);
-    rig->state.rigport.type.rig = RIG_PORT_USB;
+
+  gtk_button_set_label(GTK_BUTTON(data->test_button), "Cancel");
+
+  gtk_image_set_from_icon_name(GTK_IMAGE(data->connection_status_icon), "content-loading-symbolic");
+  gtk_widget_remove_css_class(data->connection_status_icon, "success");
+  gtk_widget_remove_css_class(data->connection_status_icon, "error");
+  gtk_label_set_text(GTK_LABEL(data->connection_status_label), "Testing connection...");
+
+  data->cancellable = g_cancellable_new();
+
+  // dlg reference is handed over to on_radio_test_complete
+  rig_config_test_async(config, RADIO_TEST_TIMEOUT_SECONDS,
+                        on_radio_test_progress, data->parent_dialog,
+                        data->cancellable, on_radio_test_complete,
+                        g_object_ref(data->parent_dialog));
+}
+
+static const gchar *
+radio_model_name(gint model_id)
+{
+  for (guint i = 0; i < RADIO_MODELS_COUNT; i++) {
+    if (RADIO_MODELS[i].model_id == model_id) return RADIO_MODELS[i].display_name;
   }
-  
-  // Test connection
-  int result = rig_open(rig);
-  if (result == RIG_OK) {
-    // Try to get frequency to verify communication
-    freq_t freq;
-    int freq_result = rig_get_freq(rig, RIG_VFO_CURR, &freq);
-    rig_close(rig);
-    
-    if (freq_result == RIG_OK) {
-      g_autofree gchar *msg = g_strdup_printf("Connected (%.3f MHz)", freq / 1000000.0);
-      update_connection_status(data, TRUE, msg);
+  return "Unknown radio";
+}
+
+static void
+on_radio_detect_complete(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  GtkWidget *dlg = GTK_WIDGET(user_data);
+  RadioTestData *data = g_object_get_data(G_OBJECT(dlg), "radio-test-data");
+  GError *error = NULL;
+
+  g_autoptr(RigProbeResult) found = rig_probe_finish(result, &error);
+
+  if (data) {
+    g_clear_object(&data->detect_cancellable);
+    gtk_button_set_label(GTK_BUTTON(data->detect_button), "Detect");
+
+    if (found) {
+      // USB-serial adapters and native USB CAT ports are both opened as serial
+      // ports, so keep "usb" if that is what the user picked
+      g_autofree gchar *connection_type = g_settings_get_string(data->settings, "radio-connection-type");
+      if (g_strcmp0(connection_type, "usb") != 0) {
+        g_settings_set_string(data->settings, "radio-connection-type", "serial");
+      }
+      g_settings_set_int(data->settings, "radio-model", found->model_id);
+      g_settings_set_string(data->settings, "radio-device", found->device_path);
+      g_settings_set_int(data->settings, "radio-baud-rate", found->baud_rate);
+
+      g_autofree gchar *msg = g_strdup_printf("Found %s at %d baud", radio_model_name(found->model_id), found->baud_rate);
+      adw_action_row_set_subtitle(data->detect_row, msg);
+    } else if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      adw_action_row_set_subtitle(data->detect_row, "Scan serial and USB ports for a connected radio");
     } else {
-      update_connection_status(data, TRUE, "Connected");
+      adw_action_row_set_subtitle(data->detect_row, error->message);
     }
-  } else {
-    g_autofree gchar *error_detail = g_strdup_printf("Connection failed: %s\n\nPlease verify your connection settings and ensure your radio is powered on and properly connected.", rigerror(result));
-    show_error_dialog(data, "Radio Connection Failed", error_detail);
-    update_connection_status(data, FALSE, NULL);
   }
-  
-  rig_cleanup(rig);
+
+  g_clear_error(&error);
+  g_object_unref(dlg);
+}
+
+static void
+on_detect_radio_clicked(GtkButton *button, gpointer user_data)
+{
+  RadioTestData *data = (RadioTestData *)user_data;
+
+  if (data->detect_cancellable) {
+    g_cancellable_cancel(data->detect_cancellable);
+    return;
+  }
+
+  data->detect_cancellable = g_cancellable_new();
+  gtk_button_set_label(GTK_BUTTON(data->detect_button), "Cancel");
+  adw_action_row_set_subtitle(data->detect_row, "Probing serial and USB ports…");
+
+  // Ports a connected radio is using are left alone
+  g_auto(GStrv) busy = artemis_app_dup_busy_rig_devices(ARTEMIS_APP(g_application_get_default()));
+
+  // dlg reference is handed over to on_radio_detect_complete
+  rig_probe_async((const gchar *const *)busy, data->detect_cancellable, on_radio_detect_complete,
+                  g_object_ref(data->parent_dialog));
 }
 
 /* Baud rate mapping functions */
@@ -237,6 +352,14 @@ static GVariant *index_to_radio_model(const GValue *in_prop, const GVariantType
 static void radio_test_data_free(RadioTestData *data) 
 {
   if (data) {
+    if (data->cancellable) {
+      g_cancellable_cancel(data->cancellable);
+    }
+    g_clear_object(&data->cancellable);
+    if (data->detect_cancellable) {
+      g_cancellable_cancel(data->detect_cancellable);
+    }
+    g_clear_object(&data->detect_cancellable);
     g_free(data);
   }
 }
@@ -248,11 +371,37 @@ static void import_data_free(ImportLogbookData *data)
     if (data->file_dialog) {
       g_object_unref(data->file_dialog);
     }
+    if (data->cancellable) {
+      g_cancellable_cancel(data->cancellable);
+      g_object_unref(data->cancellable);
+    }
     g_free(data->selected_file_path);
     g_free(data);
   }
 }
 
+static void export_data_free(ExportLogbookData *data)
+{
+  if (data) {
+    if (data->cancellable) {
+      g_cancellable_cancel(data->cancellable);
+      g_object_unref(data->cancellable);
+    }
+    g_free(data);
+  }
+}
+
+static void catalog_data_free(CatalogImportData *data)
+{
+  if (data) {
+    if (data->cancellable) {
+      g_cancellable_cancel(data->cancellable);
+      g_object_unref(data->cancellable);
+    }
+    g_free(data);
+  }
+}
+
 static void connection_type_data_free(ConnectionTypeData *data) 
 {
   if (data) {
@@ -337,6 +486,37 @@ static void on_file_dialog_complete(GObject *source_object,
     g_object_unref(file);
 }
 
+static void
+on_import_complete(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  GtkWidget *dlg = GTK_WIDGET(user_data);
+  ImportLogbookData *data = g_object_get_data(G_OBJECT(dlg), "import-logbook-data");
+  GError *error = NULL;
+  guint imported = 0, skipped = 0;
+
+  gboolean ok = park_import_hunted_csv_finish(result, &imported, &skipped, &error);
+
+  if (data) {
+    g_autofree gchar *msg = NULL;
+    if (ok) {
+      msg = g_strdup_printf(_("Imported %u parks, %u skipped"), imported, skipped);
+    } else {
+      msg = g_strdup_printf(_("Import failed: %s"), error->message);
+    }
+    adw_action_row_set_subtitle(data->import_action_row, msg);
+    gtk_widget_set_sensitive(data->import_button, TRUE);
+    g_clear_object(&data->cancellable);
+  }
+
+  // Parks seen elsewhere may now be hunted; refresh the unhunted highlight
+  if (ok) {
+    artemis_app_refresh_hunted_state(ARTEMIS_APP(g_application_get_default()));
+  }
+
+  g_clear_error(&error);
+  g_object_unref(dlg);
+}
+
 static void on_import_button_clicked(GtkButton *button, gpointer user_data)
 {
   ImportLogbookData *data = (ImportLogbookData *)user_data;
@@ -345,96 +525,540 @@ static void on_import_button_clicked(GtkButton *button, gpointer user_data)
     g_warning("No file selected for import");
     return;
   }
-  
-  // Create a file object from the stored path
-  GFile *file = g_file_new_for_path(data->selected_file_path);
+
+  g_autoptr(GFile) file = g_file_new_for_path(data->selected_file_path);
+
+  g_clear_object(&data->cancellable);
+  data->cancellable = g_cancellable_new();
+
+  adw_action_row_set_subtitle(data->import_action_row, _("Importing…"));
+  gtk_widget_set_sensitive(data->import_button, FALSE);
+
+  // dlg reference is handed over to on_import_complete
+  park_import_hunted_csv_async(file, data->cancellable, on_import_complete,
+                               g_object_ref(data->parent_dialog));
+}
+
+/* Parse "YYYY-MM-DD" into an ISO 8601 UTC bound. Empty text yields NULL.
+ * With next_day the bound is the start of the following day (exclusive end). */
+static gboolean
+export_date_to_utc(const char *text, gboolean next_day, gchar **out_iso)
+{
+  *out_iso = NULL;
+  if (!text || !*text) return TRUE;
+
+  gint y = 0, m = 0, d = 0;
+  if (sscanf(text, "%4d-%2d-%2d", &y, &m, &d) != 3 || !g_date_valid_dmy(d, m, y)) {
+    return FALSE;
+  }
+
+  g_autoptr(GDateTime) day = g_date_time_new_utc(y, m, d, 0, 0, 0);
+  g_autoptr(GDateTime) bound = next_day ? g_date_time_add_days(day, 1) : g_date_time_ref(day);
+  *out_iso = g_date_time_format(bound, "%Y-%m-%dT%H:%M:%SZ");
+  return TRUE;
+}
+
+static void
+export_set_running(ExportLogbookData *data, gboolean running)
+{
+  gtk_widget_set_sensitive(data->export_button, !running);
+  gtk_widget_set_visible(data->cancel_button, running);
+}
+
+static void
+on_export_complete(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  GtkWidget *dlg = GTK_WIDGET(user_data);
+  ExportLogbookData *data = g_object_get_data(G_OBJECT(dlg), "export-logbook-data");
   GError *error = NULL;
-  
-  // Read the file contents
-  gchar *contents = NULL;
-  gsize length = 0;
-  gboolean success = g_file_load_contents(file, NULL, &contents, &length, NULL, &error);
-  
-  if (!success || error) {
-    g_warning("Failed to read import file '%s': %s", 
-              data->selected_file_path, 
-              error ? error->message : "Unknown error");
-    if (error) g_error_free(error);
-    g_object_unref(file);
+  guint count = 0;
+
+  gboolean ok = adif_export_to_file_finish(result, &count, &error);
+
+  if (data) {
+    g_autofree gchar *msg = NULL;
+    if (ok) {
+      msg = g_strdup_printf(ngettext("Exported %u QSO", "Exported %u QSOs", count), count);
+    } else if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      msg = g_strdup(_("Export cancelled"));
+    } else {
+      msg = g_strdup_printf(_("Export failed: %s"), error->message);
+    }
+    adw_action_row_set_subtitle(data->export_row, msg);
+    export_set_running(data, FALSE);
+    g_clear_object(&data->cancellable);
+  }
+
+  g_clear_error(&error);
+  g_object_unref(dlg);
+}
+
+static void
+on_export_file_chosen(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  GtkWidget *dlg = GTK_WIDGET(user_data);
+  ExportLogbookData *data = g_object_get_data(G_OBJECT(dlg), "export-logbook-data");
+  GError *error = NULL;
+
+  g_autoptr(GFile) file = gtk_file_dialog_save_finish(GTK_FILE_DIALOG(source), result, &error);
+  if (!file || !data) {
+    if (error && !g_error_matches(error, GTK_DIALOG_ERROR, GTK_DIALOG_ERROR_DISMISSED)) {
+      g_warning("Error selecting export file: %s", error->message);
+    }
+    g_clear_error(&error);
+    g_object_unref(dlg);
     return;
   }
-  
-  g_print("Successfully read %zu bytes from %s\n", length, data->selected_file_path);
-  
-  // Parse CSV and import parks
-  SpotDb *db = spot_db_get_instance();
-  if (!db) {
-    g_warning("Failed to get database instance for import");
-    g_free(contents);
-    g_object_unref(file);
-    adw_action_row_set_subtitle(data->import_action_row, "Import failed: Database error");
+
+  g_autofree gchar *from_utc = NULL;
+  g_autofree gchar *to_utc = NULL;
+  if (!export_date_to_utc(gtk_editable_get_text(GTK_EDITABLE(data->from_row)), FALSE, &from_utc) ||
+      !export_date_to_utc(gtk_editable_get_text(GTK_EDITABLE(data->to_row)), TRUE, &to_utc)) {
+    adw_action_row_set_subtitle(data->export_row, _("Dates must be in YYYY-MM-DD format"));
+    g_object_unref(dlg);
     return;
   }
-  
-  gchar **lines = g_strsplit(contents, "\n", -1);
-  guint imported_count = 0;
-  guint error_count = 0;
-  
-  // skip the first line
-  for (guint i = 1; lines[i] != NULL; i++) {
-    gchar *line = g_strstrip(lines[i]);
-    if (!line || *line == '\0' || *line == '#') {
-      continue; // Skip empty lines and comments
+
+  const char *mode = NULL;
+  guint idx = adw_combo_row_get_selected(data->mode_row);
+  GtkStringList *modes = GTK_STRING_LIST(adw_combo_row_get_model(data->mode_row));
+  if (idx > 0 && idx < g_list_model_get_n_items(G_LIST_MODEL(modes))) {
+    mode = gtk_string_list_get_string(modes, idx); // index 0 is "All"
+  }
+
+  g_autofree gchar *park_prefix = g_strstrip(g_strdup(gtk_editable_get_text(GTK_EDITABLE(data->park_prefix_row))));
+
+  QsoFilter filter = {
+    .from_utc = from_utc,
+    .to_utc = to_utc,
+    .park_prefix = park_prefix,
+    .mode = mode,
+  };
+
+  g_clear_object(&data->cancellable);
+  data->cancellable = g_cancellable_new();
+
+  adw_action_row_set_subtitle(data->export_row, _("Exporting…"));
+  export_set_running(data, TRUE);
+
+  // dlg reference is handed over to on_export_complete
+  adif_export_to_file_async(file, &filter, data->cancellable, on_export_complete, dlg);
+}
+
+static void
+on_export_button_clicked(GtkButton *button, gpointer user_data)
+{
+  ExportLogbookData *data = (ExportLogbookData *)user_data;
+
+  g_autoptr(GtkFileDialog) save_dialog = gtk_file_dialog_new();
+  gtk_file_dialog_set_title(save_dialog, _("Export ADIF"));
+  gtk_file_dialog_set_initial_name(save_dialog, "artemis.adi");
+
+  gtk_file_dialog_save(save_dialog,
+    gtk_application_get_active_window(GTK_APPLICATION(g_application_get_default())),
+    NULL, on_export_file_chosen, g_object_ref(data->parent_dialog));
+}
+
+static void
+on_export_cancel_clicked(GtkButton *button, gpointer user_data)
+{
+  ExportLogbookData *data = (ExportLogbookData *)user_data;
+  if (data->cancellable) {
+    g_cancellable_cancel(data->cancellable);
+  }
+}
+
+static void
+on_prefs_dialog_closed(AdwDialog *dialog, gpointer user_data)
+{
+  ExportLogbookData *data = (ExportLogbookData *)user_data;
+  if (data->cancellable) {
+    g_cancellable_cancel(data->cancellable);
+  }
+
+  ImportLogbookData *import_data = g_object_get_data(G_OBJECT(dialog), "import-logbook-data");
+  if (import_data && import_data->cancellable) {
+    g_cancellable_cancel(import_data->cancellable);
+  }
+
+  CatalogImportData *catalog_data = g_object_get_data(G_OBJECT(dialog), "catalog-import-data");
+  if (catalog_data && catalog_data->cancellable) {
+    g_cancellable_cancel(catalog_data->cancellable);
+  }
+
+  RadioTestData *test_data = g_object_get_data(G_OBJECT(dialog), "radio-test-data");
+  if (test_data && test_data->cancellable) {
+    g_cancellable_cancel(test_data->cancellable);
+  }
+  if (test_data && test_data->detect_cancellable) {
+    g_cancellable_cancel(test_data->detect_cancellable);
+  }
+}
+
+static void
+catalog_update_subtitle(CatalogImportData *data)
+{
+  gint64 count = spot_db_park_catalog_count(spot_db_get_instance());
+  g_autofree gchar *msg = count > 0
+    ? g_strdup_printf(_("%u parks available offline"), (guint)count)
+    : g_strdup(_("No parks loaded"));
+  adw_action_row_set_subtitle(data->catalog_row, msg);
+}
+
+static void
+on_catalog_import_complete(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  GtkWidget *dlg = GTK_WIDGET(user_data);
+  CatalogImportData *data = g_object_get_data(G_OBJECT(dlg), "catalog-import-data");
+  GError *error = NULL;
+  guint count = 0;
+
+  gboolean ok = park_import_catalog_csv_finish(result, &count, &error);
+
+  if (data) {
+    if (ok) {
+      catalog_update_subtitle(data);
+    } else {
+      g_autofree gchar *msg = g_strdup_printf(_("Import failed: %s"), error->message);
+      adw_action_row_set_subtitle(data->catalog_row, msg);
     }
-    
-    // Split CSV line by commas
-    gchar **fields = g_strsplit(line, ",", -1);
-    gint field_count = g_strv_length(fields);
-    
-    // Expect at least reference field, optionally: reference,name,dx_entity,location,hasc,qso_count
-    if (field_count >= 1) {
-      const char *dx_entity = g_strstrip(fields[0]);
-      const char *location = (field_count > 1) ? g_strstrip(fields[1]) : NULL;
-      const char *hasc = (field_count > 2) ? g_strstrip(fields[2]) : NULL;
-      const char *reference = (field_count > 3) ? g_strstrip(fields[3]) : NULL;
-      const char *park_name = (field_count > 4) ? g_strstrip(fields[4]) : NULL;
-      
-      gint qso_count = 0;
-      if (field_count > 5) {
-        const char *qso_count_str = g_strstrip(fields[6]);
-        if (qso_count_str && *qso_count_str) {
-          qso_count = (gint)g_ascii_strtoll(qso_count_str, NULL, 10);
-          if (qso_count < 0) qso_count = 0;  // Ensure non-negative
-        }
-      }
-      
-      if (reference && *reference) {
-        GError *db_error = NULL;
-        if (spot_db_add_park(db, reference, park_name, dx_entity, location, hasc, qso_count, &db_error)) {
-          imported_count++;
-          g_print("Imported park: %s (QSOs: %d)\n", reference, qso_count);
-        } else {
-          error_count++;
-          g_warning("Failed to import park %s: %s", reference, 
-                   db_error ? db_error->message : "Unknown error");
-          if (db_error) g_error_free(db_error);
-        }
+    gtk_widget_set_sensitive(data->import_button, TRUE);
+    g_clear_object(&data->cancellable);
+  }
+
+  g_clear_error(&error);
+  g_object_unref(dlg);
+}
+
+static void
+on_catalog_file_chosen(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  GtkWidget *dlg = GTK_WIDGET(user_data);
+  CatalogImportData *data = g_object_get_data(G_OBJECT(dlg), "catalog-import-data");
+  GError *error = NULL;
+
+  g_autoptr(GFile) file = gtk_file_dialog_open_finish(GTK_FILE_DIALOG(source), result, &error);
+  if (!file || !data) {
+    if (error && !g_error_matches(error, GTK_DIALOG_ERROR, GTK_DIALOG_ERROR_DISMISSED)) {
+      g_warning("Error selecting park catalog: %s", error->message);
+    }
+    g_clear_error(&error);
+    g_object_unref(dlg);
+    return;
+  }
+
+  g_clear_object(&data->cancellable);
+  data->cancellable = g_cancellable_new();
+
+  adw_action_row_set_subtitle(data->catalog_row, _("Importing…"));
+  gtk_widget_set_sensitive(data->import_button, FALSE);
+
+  // dlg reference is handed over to on_catalog_import_complete
+  park_import_catalog_csv_async(file, data->cancellable, on_catalog_import_complete, dlg);
+}
+
+static void
+on_catalog_import_clicked(GtkButton *button, gpointer user_data)
+{
+  CatalogImportData *data = (CatalogImportData *)user_data;
+
+  g_autoptr(GtkFileDialog) open_dialog = gtk_file_dialog_new();
+  gtk_file_dialog_set_title(open_dialog, _("Import Park Catalog"));
+
+  gtk_file_dialog_open(open_dialog,
+    gtk_application_get_active_window(GTK_APPLICATION(g_application_get_default())),
+    NULL, on_catalog_file_chosen, g_object_ref(data->parent_dialog));
+}
+
+/* ---- Additional radios (rig-profiles) ---- */
+
+typedef struct {
+  AdwPreferencesGroup *group;
+  GSettings  *settings;
+  GListModel *radio_models;
+  GListModel *connection_types;
+  GListModel *baud_rates;
+  GPtrArray  *profiles;  // RigProfile*
+  GPtrArray  *rows;      // AdwExpanderRow* currently in group
+} RigProfilesEditor;
+
+static void rig_profiles_editor_rebuild(RigProfilesEditor *editor);
+
+static void
+rig_profiles_editor_free(RigProfilesEditor *editor)
+{
+  if (!editor) return;
+  g_ptr_array_unref(editor->profiles);
+  g_ptr_array_unref(editor->rows);
+  g_free(editor);
+}
+
+static RigProfile *
+rig_profile_from_widget(gpointer widget)
+{
+  return g_object_get_data(G_OBJECT(widget), "rig-profile");
+}
+
+static void
+rig_profile_row_update(AdwExpanderRow *row, RigProfile *profile)
+{
+  adw_preferences_row_set_title(ADW_PREFERENCES_ROW(row), profile->name);
+
+  g_autofree gchar *bands = g_strjoinv(", ", profile->bands);
+  adw_expander_row_set_subtitle(row, *bands ? bands : _("No bands assigned"));
+
+  gboolean network = g_strcmp0(profile->config->connection_type, "network") == 0;
+  gboolean serial = g_strcmp0(profile->config->connection_type, "serial") == 0 ||
+                    g_strcmp0(profile->config->connection_type, "usb") == 0;
+  gtk_widget_set_visible(g_object_get_data(G_OBJECT(row), "device-row"), serial);
+  gtk_widget_set_visible(g_object_get_data(G_OBJECT(row), "baud-row"), serial);
+  gtk_widget_set_visible(g_object_get_data(G_OBJECT(row), "host-row"), network);
+  gtk_widget_set_visible(g_object_get_data(G_OBJECT(row), "port-row"), network);
+}
+
+static void
+rig_profiles_editor_changed(RigProfilesEditor *editor, gpointer widget)
+{
+  AdwExpanderRow *row = g_object_get_data(G_OBJECT(widget), "rig-profile-row");
+  rig_profile_row_update(row, rig_profile_from_widget(widget));
+  rig_profiles_save(editor->settings, editor->profiles);
+}
+
+// "6m, 2m" -> { "6m", "2m" }; names outside BANDS are dropped
+static GStrv
+parse_band_list(const char *text)
+{
+  g_autoptr(GStrvBuilder) builder = g_strv_builder_new();
+  g_auto(GStrv) parts = g_strsplit_set(text, ", ", -1);
+
+  for (guint i = 0; parts[i]; i++) {
+    for (guint b = 1; b < G_N_ELEMENTS(BANDS); b++) {
+      if (g_ascii_strcasecmp(parts[i], BANDS[b]) == 0) {
+        g_strv_builder_add(builder, BANDS[b]);
+        break;
       }
     }
-    
-    g_strfreev(fields);
   }
-  
-  g_strfreev(lines);
-  g_free(contents);
-  g_object_unref(file);
-  
-  // Update UI with import results
-  g_autofree gchar *result_msg = g_strdup_printf("Imported %u parks, %u errors", 
-                                                 imported_count, error_count);
-  adw_action_row_set_subtitle(data->import_action_row, result_msg);
-  
-  g_print("Import completed: %s\n", result_msg);
+  return g_strv_builder_end(builder);
+}
+
+static void
+on_rig_profile_name_applied(AdwEntryRow *entry, gpointer user_data)
+{
+  RigProfile *profile = rig_profile_from_widget(entry);
+  g_free(profile->name);
+  profile->name = g_strdup(gtk_editable_get_text(GTK_EDITABLE(entry)));
+  rig_profiles_editor_changed(user_data, entry);
+}
+
+static void
+on_rig_profile_bands_applied(AdwEntryRow *entry, gpointer user_data)
+{
+  RigProfile *profile = rig_profile_from_widget(entry);
+  g_strfreev(profile->bands);
+  profile->bands = parse_band_list(gtk_editable_get_text(GTK_EDITABLE(entry)));
+
+  // Show what was understood
+  g_autofree gchar *canonical = g_strjoinv(", ", profile->bands);
+  gtk_editable_set_text(GTK_EDITABLE(entry), canonical);
+  rig_profiles_editor_changed(user_data, entry);
+}
+
+static void
+on_rig_profile_device_applied(AdwEntryRow *entry, gpointer user_data)
+{
+  RigProfile *profile = rig_profile_from_widget(entry);
+  g_free(profile->config->device_path);
+  profile->config->device_path = g_strdup(gtk_editable_get_text(GTK_EDITABLE(entry)));
+  rig_profiles_editor_changed(user_data, entry);
+}
+
+static void
+on_rig_profile_host_applied(AdwEntryRow *entry, gpointer user_data)
+{
+  RigProfile *profile = rig_profile_from_widget(entry);
+  g_free(profile->config->network_host);
+  profile->config->network_host = g_strdup(gtk_editable_get_text(GTK_EDITABLE(entry)));
+  rig_profiles_editor_changed(user_data, entry);
+}
+
+static void
+on_rig_profile_model_selected(AdwComboRow *combo, GParamSpec *pspec, gpointer user_data)
+{
+  guint idx = adw_combo_row_get_selected(combo);
+  if (idx >= RADIO_MODELS_COUNT) return;
+  rig_profile_from_widget(combo)->config->model_id = RADIO_MODELS[idx].model_id;
+  rig_profiles_editor_changed(user_data, combo);
+}
+
+static void
+on_rig_profile_connection_selected(AdwComboRow *combo, GParamSpec *pspec, gpointer user_data)
+{
+  guint idx = adw_combo_row_get_selected(combo);
+  if (idx >= G_N_ELEMENTS(CONNECTION_TYPES_VALUES)) return;
+  RigConfig *config = rig_profile_from_widget(combo)->config;
+  g_free(config->connection_type);
+  config->connection_type = g_strdup(CONNECTION_TYPES_VALUES[idx]);
+  rig_profiles_editor_changed(user_data, combo);
+}
+
+static void
+on_rig_profile_baud_selected(AdwComboRow *combo, GParamSpec *pspec, gpointer user_data)
+{
+  guint idx = adw_combo_row_get_selected(combo);
+  if (idx >= G_N_ELEMENTS(BAUD_RATES)) return;
+  rig_profile_from_widget(combo)->config->baud_rate = g_ascii_strtoll(BAUD_RATES[idx], NULL, 10);
+  rig_profiles_editor_changed(user_data, combo);
+}
+
+static void
+on_rig_profile_port_changed(AdwSpinRow *spin, GParamSpec *pspec, gpointer user_data)
+{
+  rig_profile_from_widget(spin)->config->network_port = (gint)adw_spin_row_get_value(spin);
+  rig_profiles_editor_changed(user_data, spin);
+}
+
+static void
+on_rig_profile_remove_clicked(GtkButton *button, gpointer user_data)
+{
+  RigProfilesEditor *editor = user_data;
+  guint idx;
+  if (g_ptr_array_find(editor->profiles, rig_profile_from_widget(button), &idx)) {
+    g_ptr_array_remove_index(editor->profiles, idx);
+    rig_profiles_save(editor->settings, editor->profiles);
+    rig_profiles_editor_rebuild(editor);
+  }
+}
+
+static void
+on_add_rig_profile_clicked(GtkButton *button, gpointer user_data)
+{
+  RigProfilesEditor *editor = user_data;
+  RigProfile *profile = rig_profile_new();
+  g_free(profile->name);
+  profile->name = g_strdup_printf(_("Radio %u"), editor->profiles->len + 2);
+  g_ptr_array_add(editor->profiles, profile);
+  rig_profiles_save(editor->settings, editor->profiles);
+  rig_profiles_editor_rebuild(editor);
+
+  AdwExpanderRow *row = g_ptr_array_index(editor->rows, editor->rows->len - 1);
+  adw_expander_row_set_expanded(row, TRUE);
+}
+
+static guint
+string_index(const char *const *items, guint n_items, const char *value)
+{
+  for (guint i = 0; i < n_items; i++) {
+    if (g_strcmp0(items[i], value) == 0) return i;
+  }
+  return 0;
+}
+
+// Attach a child row to the profile and its expander so the handlers can find both
+static GtkWidget *
+rig_profile_child(AdwExpanderRow *row, RigProfile *profile, GtkWidget *child, const char *key)
+{
+  g_object_set_data(G_OBJECT(child), "rig-profile", profile);
+  g_object_set_data(G_OBJECT(child), "rig-profile-row", row);
+  if (key) g_object_set_data(G_OBJECT(row), key, child);
+  adw_expander_row_add_row(row, child);
+  return child;
+}
+
+static GtkWidget *
+rig_profile_entry_row(AdwExpanderRow *row, RigProfile *profile, const char *title,
+                      const char *text, const char *key, GCallback on_apply, RigProfilesEditor *editor)
+{
+  GtkWidget *entry = adw_entry_row_new();
+  adw_preferences_row_set_title(ADW_PREFERENCES_ROW(entry), title);
+  adw_entry_row_set_show_apply_button(ADW_ENTRY_ROW(entry), TRUE);
+  gtk_editable_set_text(GTK_EDITABLE(entry), text ? text : "");
+  g_signal_connect(entry, "apply", on_apply, editor);
+  return rig_profile_child(row, profile, entry, key);
+}
+
+static GtkWidget *
+rig_profile_combo_row(AdwExpanderRow *row, RigProfile *profile, const char *title, GListModel *model,
+                      guint selected, const char *key, GCallback on_selected, RigProfilesEditor *editor)
+{
+  GtkWidget *combo = adw_combo_row_new();
+  adw_preferences_row_set_title(ADW_PREFERENCES_ROW(combo), title);
+  adw_combo_row_set_model(ADW_COMBO_ROW(combo), model);
+  adw_combo_row_set_selected(ADW_COMBO_ROW(combo), selected);
+  g_signal_connect(combo, "notify::selected", on_selected, editor);
+  return rig_profile_child(row, profile, combo, key);
+}
+
+static AdwExpanderRow *
+create_rig_profile_row(RigProfilesEditor *editor, RigProfile *profile)
+{
+  RigConfig *config = profile->config;
+  AdwExpanderRow *row = ADW_EXPANDER_ROW(adw_expander_row_new());
+
+  rig_profile_entry_row(row, profile, _("Name"), profile->name, NULL,
+                        G_CALLBACK(on_rig_profile_name_applied), editor);
+  g_autofree gchar *bands = g_strjoinv(", ", profile->bands);
+  GtkWidget *bands_row = rig_profile_entry_row(row, profile, _("Bands (e.g. 6m, 2m)"), bands, NULL,
+                                               G_CALLBACK(on_rig_profile_bands_applied), editor);
+  gtk_widget_set_tooltip_text(bands_row, _("Comma-separated band names"));
+
+  guint model_idx = 0;
+  for (guint i = 0; i < RADIO_MODELS_COUNT; i++) {
+    if (RADIO_MODELS[i].model_id == config->model_id) { model_idx = i; break; }
+  }
+  GtkWidget *model_row = rig_profile_combo_row(row, profile, _("Radio Model"), editor->radio_models, model_idx,
+                                               NULL, G_CALLBACK(on_rig_profile_model_selected), editor);
+  adw_combo_row_set_enable_search(ADW_COMBO_ROW(model_row), TRUE);
+  GtkExpression *expr = gtk_property_expression_new(GTK_TYPE_STRING_OBJECT, NULL, "string");
+  adw_combo_row_set_expression(ADW_COMBO_ROW(model_row), expr);
+  gtk_expression_unref(expr);
+
+  rig_profile_combo_row(row, profile, _("Connection Type"), editor->connection_types,
+                        string_index(CONNECTION_TYPES_VALUES, G_N_ELEMENTS(CONNECTION_TYPES_VALUES), config->connection_type),
+                        NULL, G_CALLBACK(on_rig_profile_connection_selected), editor);
+
+  rig_profile_entry_row(row, profile, _("Device Path"), config->device_path, "device-row",
+                        G_CALLBACK(on_rig_profile_device_applied), editor);
+  g_autofree gchar *baud = g_strdup_printf("%d", config->baud_rate);
+  rig_profile_combo_row(row, profile, _("Baud Rate"), editor->baud_rates,
+                        string_index(BAUD_RATES, G_N_ELEMENTS(BAUD_RATES), baud),
+                        "baud-row", G_CALLBACK(on_rig_profile_baud_selected), editor);
+
+  rig_profile_entry_row(row, profile, _("Host"), config->network_host, "host-row",
+                        G_CALLBACK(on_rig_profile_host_applied), editor);
+  GtkWidget *port_row = adw_spin_row_new_with_range(1, 65535, 1);
+  adw_preferences_row_set_title(ADW_PREFERENCES_ROW(port_row), _("Port"));
+  adw_spin_row_set_value(ADW_SPIN_ROW(port_row), config->network_port);
+  g_signal_connect(port_row, "notify::value", G_CALLBACK(on_rig_profile_port_changed), editor);
+  rig_profile_child(row, profile, port_row, "port-row");
+
+  GtkWidget *remove_row = adw_action_row_new();
+  adw_preferences_row_set_title(ADW_PREFERENCES_ROW(remove_row), _("Remove This Radio"));
+  GtkWidget *remove_button = gtk_button_new_with_label(_("Remove"));
+  gtk_widget_set_valign(remove_button, GTK_ALIGN_CENTER);
+  gtk_widget_add_css_class(remove_button, "destructive-action");
+  g_object_set_data(G_OBJECT(remove_button), "rig-profile", profile);
+  g_signal_connect(remove_button, "clicked", G_CALLBACK(on_rig_profile_remove_clicked), editor);
+  adw_action_row_add_suffix(ADW_ACTION_ROW(remove_row), remove_button);
+  adw_expander_row_add_row(row, remove_row);
+
+  rig_profile_row_update(row, profile);
+  return row;
+}
+
+static void
+rig_profiles_editor_rebuild(RigProfilesEditor *editor)
+{
+  for (guint i = 0; i < editor->rows->len; i++) {
+    adw_preferences_group_remove(editor->group, g_ptr_array_index(editor->rows, i));
+  }
+  g_ptr_array_set_size(editor->rows, 0);
+
+  for (guint i = 0; i < editor->profiles->len; i++) {
+    AdwExpanderRow *row = create_rig_profile_row(editor, g_ptr_array_index(editor->profiles, i));
+    adw_preferences_group_add(editor->group, GTK_WIDGET(row));
+    g_ptr_array_add(editor->rows, row);
+  }
 }
 
 static void on_import_file_activated(AdwActionRow *action_row, gpointer userdata)
@@ -457,6 +1081,12 @@ void show_preferences_dialog(GtkWidget *parent)
   AdwEntryRow *row_location  = ADW_ENTRY_ROW(gtk_builder_get_object(b, "row_location"));
   AdwEntryRow *row_spot_msg  = ADW_ENTRY_ROW(gtk_builder_get_object(b, "row_spot_message"));
   AdwEntryRow *row_qrz_key   = ADW_ENTRY_ROW(gtk_builder_get_object(b, "row_qrz_api_key"));
+  AdwEntryRow *row_adif_path = ADW_ENTRY_ROW(gtk_builder_get_object(b, "row_adif_log_path"));
+  AdwComboRow *row_udp_format = ADW_COMBO_ROW(gtk_builder_get_object(b, "row_udp_log_format"));
+  AdwEntryRow *row_udp_host  = ADW_ENTRY_ROW(gtk_builder_get_object(b, "row_udp_log_host"));
+  AdwSpinRow *row_udp_port   = ADW_SPIN_ROW (gtk_builder_get_object(b, "row_udp_log_port"));
+  AdwSpinRow *row_retention  = ADW_SPIN_ROW (gtk_builder_get_object(b, "row_archive_retention"));
+  AdwSpinRow *row_cache_size = ADW_SPIN_ROW (gtk_builder_get_object(b, "row_http_cache_size"));
   
   // Logbook preferences
   AdwSwitchRow *row_enable_logging     = ADW_SWITCH_ROW(gtk_builder_get_object(b, "row_enable_logging"));
@@ -469,6 +1099,8 @@ void show_preferences_dialog(GtkWidget *parent)
   AdwComboRow *row_baud_rate       = ADW_COMBO_ROW(gtk_builder_get_object(b, "row_baud_rate"));
   AdwEntryRow *row_network_host    = ADW_ENTRY_ROW(gtk_builder_get_object(b, "row_network_host"));
   AdwSpinRow  *row_network_port    = ADW_SPIN_ROW(gtk_builder_get_object(b, "row_network_port"));
+  AdwSpinRow  *row_vfo_poll_rate   = ADW_SPIN_ROW(gtk_builder_get_object(b, "row_vfo_poll_rate"));
+  AdwSpinRow  *row_vfo_tolerance   = ADW_SPIN_ROW(gtk_builder_get_object(b, "row_vfo_tolerance"));
   
   // Test connection widgets
   GtkWidget *connection_status_icon  = GTK_WIDGET(gtk_builder_get_object(b, "connection_status_icon"));
@@ -477,9 +1109,22 @@ void show_preferences_dialog(GtkWidget *parent)
   
   // Settings groups for show/hide
   GtkWidget *serial_settings_group   = GTK_WIDGET(gtk_builder_get_object(b, "serial_settings_group"));
+  AdwActionRow *detect_radio_row     = ADW_ACTION_ROW(gtk_builder_get_object(b, "detect_radio_row"));
+  GtkWidget *detect_radio_button     = GTK_WIDGET(gtk_builder_get_object(b, "detect_radio_button"));
   GtkWidget *network_settings_group  = GTK_WIDGET(gtk_builder_get_object(b, "network_settings_group"));
 
   GtkWidget *import_action_row       = GTK_WIDGET(gtk_builder_get_object(b, "import_file_row"));
+
+  // Export widgets
+  AdwEntryRow *row_export_park_prefix = ADW_ENTRY_ROW(gtk_builder_get_object(b, "row_export_park_prefix"));
+  AdwComboRow *row_export_mode        = ADW_COMBO_ROW(gtk_builder_get_object(b, "row_export_mode"));
+  AdwEntryRow *row_export_from        = ADW_ENTRY_ROW(gtk_builder_get_object(b, "row_export_from"));
+  AdwEntryRow *row_export_to          = ADW_ENTRY_ROW(gtk_builder_get_object(b, "row_export_to"));
+  GtkWidget   *export_row             = GTK_WIDGET(gtk_builder_get_object(b, "export_row"));
+  GtkWidget   *export_button          = GTK_WIDGET(gtk_builder_get_object(b, "export_button"));
+  GtkWidget   *export_cancel_button   = GTK_WIDGET(gtk_builder_get_object(b, "export_cancel_button"));
+  GtkWidget   *catalog_row            = GTK_WIDGET(gtk_builder_get_object(b, "catalog_row"));
+  GtkWidget   *catalog_import_button  = GTK_WIDGET(gtk_builder_get_object(b, "catalog_import_button"));
   
   // Create the file dialog programmatically (not from UI file)
   GtkFileDialog *file_dialog = gtk_file_dialog_new();
@@ -514,7 +1159,18 @@ void show_preferences_dialog(GtkWidget *parent)
     adw_combo_row_set_expression(row_mode, expr);
     gtk_expression_unref(expr);
   }
+  {
+    GtkExpression *expr = gtk_property_expression_new (GTK_TYPE_STRING_OBJECT, NULL, "string");
+    adw_combo_row_set_expression(row_export_mode, expr);
+    gtk_expression_unref(expr);
+  }
   
+  {
+    GtkExpression *expr = gtk_property_expression_new (GTK_TYPE_STRING_OBJECT, NULL, "string");
+    adw_combo_row_set_expression(row_udp_format, expr);
+    gtk_expression_unref(expr);
+  }
+
   /* Radio combo row expressions */
   {
     GtkExpression *expr = gtk_property_expression_new (GTK_TYPE_STRING_OBJECT, NULL, "string");
@@ -545,11 +1201,17 @@ void show_preferences_dialog(GtkWidget *parent)
   /* Spin range to match your schema's <range> */
   adw_spin_row_set_range(row_interval, 60.0, 3600.0);
   adw_spin_row_set_range(row_network_port, 1.0, 65535.0);
+  adw_spin_row_set_range(row_retention, 0.0, 365.0);
+  adw_spin_row_set_range(row_cache_size, 1.0, 500.0);
+  adw_spin_row_set_range(row_vfo_poll_rate, 0.0, 20.0);
+  adw_spin_row_set_range(row_vfo_tolerance, 100.0, 10000.0);
 
   g_settings_bind(settings, "callsign",      row_callsign, "text", G_SETTINGS_BIND_DEFAULT);
   g_settings_bind(settings, "location",      row_location, "text", G_SETTINGS_BIND_DEFAULT);
   g_settings_bind(settings, "spot-message",  row_spot_msg, "text", G_SETTINGS_BIND_DEFAULT);
   g_settings_bind(settings, "qrz-api-key",   row_qrz_key,  "text", G_SETTINGS_BIND_DEFAULT);
+  g_settings_bind(settings, "adif-log-path", row_adif_path, "text", G_SETTINGS_BIND_DEFAULT);
+  g_settings_bind(settings, "udp-log-host",  row_udp_host,  "text", G_SETTINGS_BIND_DEFAULT);
   
   g_settings_bind(settings, "enable-logging",           row_enable_logging,     "active", G_SETTINGS_BIND_DEFAULT);
   g_settings_bind(settings, "highlight-unhunted-parks", row_highlight_unhunted, "active", G_SETTINGS_BIND_DEFAULT);
@@ -568,11 +1230,32 @@ void show_preferences_dialog(GtkWidget *parent)
                                 G_SETTINGS_BIND_DEFAULT,
                                 map_i_to_d, map_d_to_i, NULL, NULL);
 
+  g_settings_bind_with_mapping(settings, "vfo-poll-rate",
+                                row_vfo_poll_rate, "value",
+                                G_SETTINGS_BIND_DEFAULT,
+                                map_i_to_d, map_d_to_i, NULL, NULL);
+  g_settings_bind_with_mapping(settings, "vfo-match-tolerance",
+                                row_vfo_tolerance, "value",
+                                G_SETTINGS_BIND_DEFAULT,
+                                map_i_to_d, map_d_to_i, NULL, NULL);
+
   /* int <-> double mapping for the SpinRow */
   g_settings_bind_with_mapping(settings, "update-interval",
                                 row_interval, "value",
                                 G_SETTINGS_BIND_DEFAULT,
                                 map_i_to_d, map_d_to_i, NULL, NULL);
+  g_settings_bind_with_mapping(settings, "archive-retention-days",
+                                row_retention, "value",
+                                G_SETTINGS_BIND_DEFAULT,
+                                map_i_to_d, map_d_to_i, NULL, NULL);
+  g_settings_bind_with_mapping(settings, "http-cache-size",
+                                row_cache_size, "value",
+                                G_SETTINGS_BIND_DEFAULT,
+                                map_i_to_d, map_d_to_i, NULL, NULL);
+  g_settings_bind_with_mapping(settings, "udp-log-port",
+                                row_udp_port, "value",
+                                G_SETTINGS_BIND_DEFAULT,
+                                map_i_to_d, map_d_to_i, NULL, NULL);
 
   /* string <-> index mapping for combo rows */
   StringListMap bands_map = { .items = BANDS, .n_items = G_N_ELEMENTS(BANDS) };
@@ -589,6 +1272,12 @@ void show_preferences_dialog(GtkWidget *parent)
                                 map_str_to_index, map_index_to_str,
                                 &modes_map, NULL);
 
+  g_settings_bind_with_mapping(settings, "udp-log-format",
+                                row_udp_format, "selected",
+                                G_SETTINGS_BIND_DEFAULT,
+                                map_str_to_index, map_index_to_str,
+                                (gpointer)&udp_log_formats_map, NULL);
+
   /* Radio combo row bindings */
   g_settings_bind_with_mapping(settings, "radio-connection-type",
                                 row_connection_type, "selected",
@@ -610,12 +1299,16 @@ void show_preferences_dialog(GtkWidget *parent)
   test_data->test_button = test_connection_button;
   test_data->parent_dialog = dlg;
   test_data->settings = settings;
+  test_data->detect_row = detect_radio_row;
+  test_data->detect_button = detect_radio_button;
   
   g_signal_connect(test_connection_button, "clicked", G_CALLBACK(on_test_connection_clicked), test_data);
+  g_signal_connect(detect_radio_button, "clicked", G_CALLBACK(on_detect_radio_clicked), test_data);
   g_object_set_data_full(G_OBJECT(dlg), "radio-test-data", test_data, (GDestroyNotify)radio_test_data_free);
 
   
   ImportLogbookData *logbook_data = g_new0(ImportLogbookData, 1);
+  logbook_data->parent_dialog = dlg;
   logbook_data->import_action_row = ADW_ACTION_ROW(import_action_row);
   logbook_data->file_dialog = g_object_ref(file_dialog);
   logbook_data->import_button = NULL;
@@ -624,6 +1317,30 @@ void show_preferences_dialog(GtkWidget *parent)
   g_signal_connect(import_action_row, "activated", G_CALLBACK(on_import_file_activated), logbook_data);
   g_object_set_data_full(G_OBJECT(dlg), "import-logbook-data", logbook_data, (GDestroyNotify)import_data_free);
 
+  ExportLogbookData *export_data = g_new0(ExportLogbookData, 1);
+  export_data->parent_dialog = dlg;
+  export_data->park_prefix_row = row_export_park_prefix;
+  export_data->mode_row = row_export_mode;
+  export_data->from_row = row_export_from;
+  export_data->to_row = row_export_to;
+  export_data->export_row = ADW_ACTION_ROW(export_row);
+  export_data->export_button = export_button;
+  export_data->cancel_button = export_cancel_button;
+
+  g_signal_connect(export_button, "clicked", G_CALLBACK(on_export_button_clicked), export_data);
+  g_signal_connect(export_cancel_button, "clicked", G_CALLBACK(on_export_cancel_clicked), export_data);
+  g_signal_connect(dlg, "closed", G_CALLBACK(on_prefs_dialog_closed), export_data);
+  g_object_set_data_full(G_OBJECT(dlg), "export-logbook-data", export_data, (GDestroyNotify)export_data_free);
+
+  CatalogImportData *catalog_data = g_new0(CatalogImportData, 1);
+  catalog_data->parent_dialog = dlg;
+  catalog_data->catalog_row = ADW_ACTION_ROW(catalog_row);
+  catalog_data->import_button = catalog_import_button;
+  catalog_update_subtitle(catalog_data);
+
+  g_signal_connect(catalog_import_button, "clicked", G_CALLBACK(on_catalog_import_clicked), catalog_data);
+  g_object_set_data_full(G_OBJECT(dlg), "catalog-import-data", catalog_data, (GDestroyNotify)catalog_data_free);
+
   /* Setup connection type change handler */
   ConnectionTypeData *connection_data = g_new0(ConnectionTypeData, 1);
   connection_data->serial_settings_group = serial_settings_group;
@@ -636,6 +1353,20 @@ void show_preferences_dialog(GtkWidget *parent)
   /* Set initial visibility based on current connection type */
   on_connection_type_changed(row_connection_type, NULL, connection_data);
 
+  /* Additional radios */
+  RigProfilesEditor *rig_editor = g_new0(RigProfilesEditor, 1);
+  rig_editor->group = ADW_PREFERENCES_GROUP(gtk_builder_get_object(b, "rig_profiles_group"));
+  rig_editor->settings = settings;
+  rig_editor->radio_models = G_LIST_MODEL(gtk_builder_get_object(b, "radio_models_model"));
+  rig_editor->connection_types = G_LIST_MODEL(gtk_builder_get_object(b, "connection_types_model"));
+  rig_editor->baud_rates = G_LIST_MODEL(gtk_builder_get_object(b, "baud_rates_model"));
+  rig_editor->profiles = rig_profiles_load(settings);
+  rig_editor->rows = g_ptr_array_new();
+  rig_profiles_editor_rebuild(rig_editor);
+  g_object_set_data_full(G_OBJECT(dlg), "rig-profiles-editor", rig_editor, (GDestroyNotify)rig_profiles_editor_free);
+  g_signal_connect(gtk_builder_get_object(b, "add_rig_profile_button"), "clicked",
+                   G_CALLBACK(on_add_rig_profile_clicked), rig_editor);
+
   /* Present */
   adw_dialog_present(ADW_DIALOG (dlg), GTK_WIDGET(parent));
 }
\ No newline at end of file
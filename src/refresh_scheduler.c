@@ -0,0 +1,233 @@
+#include "refresh_scheduler.h"
+
+// Background windows poll at half speed, hidden ones at a tenth
+#define BACKGROUND_MULTIPLIER 2
+#define HIDDEN_MULTIPLIER     10
+
+// Ceiling for error backoff and for what we accept from the server
+#define MAX_DELAY_SECS        900
+
+// Each wait is stretched or shrunk by up to this fraction so clients
+// started together do not keep hitting the API in lockstep
+#define JITTER_FRACTION       0.1
+
+struct _ArtemisRefreshScheduler {
+  GObject parent_instance;
+
+  guint                  interval_secs;
+  ArtemisRefreshActivity activity;
+  gboolean               paused;
+  gboolean               in_flight;
+
+  // Inputs to the current wait, kept so activity changes can recompute it
+  guint    failures;
+  gint     server_delay_secs;  // -1 = none
+  gdouble  jitter;             // multiplier in [1 - JITTER_FRACTION, 1 + JITTER_FRACTION]
+  gint64   wait_started_us;    // monotonic
+  gint64   deadline_us;        // monotonic, 0 = not armed
+
+  guint    source_id;
+};
+
+enum {
+  SIGNAL_REFRESH,
+  N_SIGNALS
+};
+static guint signals[N_SIGNALS];
+
+G_DEFINE_FINAL_TYPE(ArtemisRefreshScheduler, artemis_refresh_scheduler, G_TYPE_OBJECT)
+
+static void scheduler_fire(ArtemisRefreshScheduler *self);
+
+static void
+scheduler_disarm(ArtemisRefreshScheduler *self)
+{
+  g_clear_handle_id(&self->source_id, g_source_remove);
+  self->deadline_us = 0;
+}
+
+static guint
+scheduler_delay_secs(ArtemisRefreshScheduler *self)
+{
+  guint base = self->interval_secs;
+  switch (self->activity) {
+  case ARTEMIS_REFRESH_FOCUSED:    break;
+  case ARTEMIS_REFRESH_BACKGROUND: base *= BACKGROUND_MULTIPLIER; break;
+  case ARTEMIS_REFRESH_HIDDEN:     base *= HIDDEN_MULTIPLIER; break;
+  }
+
+  guint delay = base;
+  if (self->failures > 0) {
+    // interval, 2x, 4x, ... so a flapping API is not polled at full rate
+    guint shift = MIN(self->failures - 1, 10);
+    delay = MAX(base, MIN((guint64)self->interval_secs << shift, MAX_DELAY_SECS));
+  }
+  if (self->server_delay_secs > 0) {
+    delay = MAX(delay, (guint)MIN(self->server_delay_secs, MAX_DELAY_SECS));
+  }
+
+  return MAX(1, (guint)(delay * self->jitter + 0.5));
+}
+
+static gboolean
+on_deadline(gpointer user_data)
+{
+  ArtemisRefreshScheduler *self = user_data;
+  self->source_id = 0;
+  scheduler_fire(self);
+  return G_SOURCE_REMOVE;
+}
+
+// (Re)compute the deadline from the current wait's start; fires immediately if it has passed
+static void
+scheduler_arm(ArtemisRefreshScheduler *self)
+{
+  g_clear_handle_id(&self->source_id, g_source_remove);
+  if (self->paused || self->in_flight) return;
+
+  self->deadline_us = self->wait_started_us + (gint64)scheduler_delay_secs(self) * G_USEC_PER_SEC;
+  gint64 remaining_us = self->deadline_us - g_get_monotonic_time();
+  if (remaining_us <= 0) {
+    scheduler_fire(self);
+    return;
+  }
+  self->source_id = g_timeout_add_full(G_PRIORITY_DEFAULT, (guint)(remaining_us / 1000) + 1,
+                                       on_deadline, self, NULL);
+}
+
+static void
+scheduler_fire(ArtemisRefreshScheduler *self)
+{
+  if (self->in_flight) return;
+
+  scheduler_disarm(self);
+  self->in_flight = TRUE;
+  g_signal_emit(self, signals[SIGNAL_REFRESH], 0);
+}
+
+static void
+artemis_refresh_scheduler_dispose(GObject *object)
+{
+  ArtemisRefreshScheduler *self = ARTEMIS_REFRESH_SCHEDULER(object);
+  scheduler_disarm(self);
+  G_OBJECT_CLASS(artemis_refresh_scheduler_parent_class)->dispose(object);
+}
+
+static void
+artemis_refresh_scheduler_class_init(ArtemisRefreshSchedulerClass *klass)
+{
+  G_OBJECT_CLASS(klass)->dispose = artemis_refresh_scheduler_dispose;
+
+  signals[SIGNAL_REFRESH] = g_signal_new(
+    "refresh",
+    G_TYPE_FROM_CLASS(klass),
+    G_SIGNAL_RUN_LAST,
+    0, NULL, NULL, NULL,
+    G_TYPE_NONE, 0
+  );
+}
+
+static void
+artemis_refresh_scheduler_init(ArtemisRefreshScheduler *self)
+{
+  self->activity = ARTEMIS_REFRESH_FOCUSED;
+  self->server_delay_secs = -1;
+  self->jitter = 1.0;
+}
+
+ArtemisRefreshScheduler *
+artemis_refresh_scheduler_new(guint interval_secs)
+{
+  ArtemisRefreshScheduler *self = g_object_new(ARTEMIS_TYPE_REFRESH_SCHEDULER, NULL);
+  self->interval_secs = MAX(1, interval_secs);
+  self->wait_started_us = g_get_monotonic_time();
+  return self;  // idle until the first refresh_now()
+}
+
+void
+artemis_refresh_scheduler_set_interval(ArtemisRefreshScheduler *self, guint interval_secs)
+{
+  g_return_if_fail(ARTEMIS_IS_REFRESH_SCHEDULER(self));
+  self->interval_secs = MAX(1, interval_secs);
+  scheduler_arm(self);
+}
+
+void
+artemis_refresh_scheduler_set_activity(ArtemisRefreshScheduler *self, ArtemisRefreshActivity activity)
+{
+  g_return_if_fail(ARTEMIS_IS_REFRESH_SCHEDULER(self));
+  if (self->activity == activity) return;
+
+  // Coming back to a window that has been hidden for a while refreshes at
+  // once rather than waiting out the slow hidden-window timer
+  self->activity = activity;
+  scheduler_arm(self);
+}
+
+void
+artemis_refresh_scheduler_set_paused(ArtemisRefreshScheduler *self, gboolean paused)
+{
+  g_return_if_fail(ARTEMIS_IS_REFRESH_SCHEDULER(self));
+  if (self->paused == paused) return;
+
+  self->paused = paused;
+  if (paused) {
+    scheduler_disarm(self);
+  } else {
+    self->wait_started_us = g_get_monotonic_time();
+    scheduler_arm(self);
+  }
+}
+
+gboolean
+artemis_refresh_scheduler_get_paused(ArtemisRefreshScheduler *self)
+{
+  g_return_val_if_fail(ARTEMIS_IS_REFRESH_SCHEDULER(self), FALSE);
+  return self->paused;
+}
+
+void
+artemis_refresh_scheduler_refresh_now(ArtemisRefreshScheduler *self)
+{
+  g_return_if_fail(ARTEMIS_IS_REFRESH_SCHEDULER(self));
+  scheduler_fire(self);
+}
+
+void
+artemis_refresh_scheduler_complete(ArtemisRefreshScheduler *self, gboolean ok, gint server_delay_secs)
+{
+  g_return_if_fail(ARTEMIS_IS_REFRESH_SCHEDULER(self));
+
+  self->in_flight = FALSE;
+  self->failures = ok ? 0 : self->failures + 1;
+  self->server_delay_secs = server_delay_secs;
+  self->jitter = g_random_double_range(1.0 - JITTER_FRACTION, 1.0 + JITTER_FRACTION);
+  self->wait_started_us = g_get_monotonic_time();
+  scheduler_arm(self);
+}
+
+gboolean
+artemis_refresh_scheduler_is_in_flight(ArtemisRefreshScheduler *self)
+{
+  g_return_val_if_fail(ARTEMIS_IS_REFRESH_SCHEDULER(self), FALSE);
+  return self->in_flight;
+}
+
+guint
+artemis_refresh_scheduler_get_failures(ArtemisRefreshScheduler *self)
+{
+  g_return_val_if_fail(ARTEMIS_IS_REFRESH_SCHEDULER(self), 0);
+  return self->failures;
+}
+
+gboolean
+artemis_refresh_scheduler_get_countdown(ArtemisRefreshScheduler *self, guint *out_remaining, guint *out_total)
+{
+  g_return_val_if_fail(ARTEMIS_IS_REFRESH_SCHEDULER(self), FALSE);
+  if (self->paused || self->in_flight || self->deadline_us == 0) return FALSE;
+
+  gint64 remaining_us = MAX(0, self->deadline_us - g_get_monotonic_time());
+  if (out_remaining) *out_remaining = (guint)((remaining_us + G_USEC_PER_SEC - 1) / G_USEC_PER_SEC);
+  if (out_total) *out_total = (guint)((self->deadline_us - self->wait_started_us) / G_USEC_PER_SEC);
+  return TRUE;
+}
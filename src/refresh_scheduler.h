@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glib.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+// How much the user can see of the spot list; slower polling when less
+typedef enum {
+  ARTEMIS_REFRESH_FOCUSED,     // window is active
+  ARTEMIS_REFRESH_BACKGROUND,  // visible but another window has focus
+  ARTEMIS_REFRESH_HIDDEN,      // minimized or otherwise suspended
+} ArtemisRefreshActivity;
+
+/* Decides when the spot list is fetched next. Emits "refresh" when a fetch is
+ * due and waits for artemis_refresh_scheduler_complete() before arming the next
+ * one, so fetches never overlap. Failures back off exponentially, the server's
+ * max-age / Retry-After is a lower bound, and every wait carries some jitter. */
+#define ARTEMIS_TYPE_REFRESH_SCHEDULER (artemis_refresh_scheduler_get_type())
+G_DECLARE_FINAL_TYPE(ArtemisRefreshScheduler, artemis_refresh_scheduler, ARTEMIS, REFRESH_SCHEDULER, GObject)
+
+ArtemisRefreshScheduler *artemis_refresh_scheduler_new(guint interval_secs);
+
+// Base interval while focused, from the update-interval setting
+void
+artemis_refresh_scheduler_set_interval(ArtemisRefreshScheduler *self, guint interval_secs);
+void
+artemis_refresh_scheduler_set_activity(ArtemisRefreshScheduler *self, ArtemisRefreshActivity activity);
+void
+artemis_refresh_scheduler_set_paused(ArtemisRefreshScheduler *self, gboolean paused);
+gboolean
+artemis_refresh_scheduler_get_paused(ArtemisRefreshScheduler *self);
+
+// Fetch now unless one is already in flight
+void
+artemis_refresh_scheduler_refresh_now(ArtemisRefreshScheduler *self);
+
+/* Report the end of the fetch started by "refresh". server_delay_secs is the
+ * server's max-age or Retry-After, or -1 if it sent none. */
+void
+artemis_refresh_scheduler_complete(ArtemisRefreshScheduler *self, gboolean ok, gint server_delay_secs);
+
+gboolean
+artemis_refresh_scheduler_is_in_flight(ArtemisRefreshScheduler *self);
+// Consecutive failed fetches; 0 after a success
+guint
+artemis_refresh_scheduler_get_failures(ArtemisRefreshScheduler *self);
+// Time until the next fetch and the length of the current wait, in seconds.
+// FALSE while paused or while a fetch is in flight.
+gboolean
+artemis_refresh_scheduler_get_countdown(ArtemisRefreshScheduler *self, guint *out_remaining, guint *out_total);
+
+G_END_DECLS
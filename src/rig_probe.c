@@ -0,0 +1,306 @@
+#include "rig_probe.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <hamlib/rig.h>
+
+#include "radio_models.h"
+
+// Per attempt; most rigs answer a frequency read in well under 100 ms
+#define PROBE_TIMEOUT_MS 250
+
+// Most common factory CAT rates first
+static const gint PROBE_BAUD_RATES[] = { 38400, 115200, 19200, 9600, 4800 };
+
+/* One model per CAT dialect in common portable use. Kenwood and Elecraft share
+ * a protocol, as do the newer Yaesus; Icom CI-V needs the right default address,
+ * so the popular rigs are listed individually. */
+static const gint PROBE_MODELS[] = {
+  RIG_MODEL_IC705,
+  RIG_MODEL_IC7300,
+  RIG_MODEL_TS590S,
+  RIG_MODEL_K3,
+  RIG_MODEL_FT991,
+  RIG_MODEL_FTDX10,
+  RIG_MODEL_FT710,
+};
+
+void
+rig_probe_result_free(RigProbeResult *result)
+{
+  if (!result) return;
+  g_free(result->device_path);
+  g_free(result);
+}
+
+static void
+add_device(GPtrArray *devices, GHashTable *seen, const gchar *path)
+{
+  char *real = realpath(path, NULL);
+  const gchar *key = real ? real : path;
+
+  if (!g_hash_table_contains(seen, key)) {
+    g_hash_table_add(seen, g_strdup(key));
+    g_ptr_array_add(devices, g_strdup(path));
+  }
+  free(real);
+}
+
+static gint
+compare_names(gconstpointer a, gconstpointer b)
+{
+  return g_strcmp0(*(const gchar *const *)a, *(const gchar *const *)b);
+}
+
+static void
+add_devices_in(GPtrArray *devices, GHashTable *seen, const gchar *dir_path,
+               const gchar *const *prefixes)
+{
+  g_autoptr(GDir) dir = g_dir_open(dir_path, 0, NULL);
+  if (!dir) return;
+
+  g_autoptr(GPtrArray) names = g_ptr_array_new_with_free_func(g_free);
+  const gchar *name;
+  while ((name = g_dir_read_name(dir)) != NULL) {
+    gboolean wanted = prefixes == NULL;
+    for (guint i = 0; prefixes && prefixes[i]; i++) {
+      if (g_str_has_prefix(name, prefixes[i])) { wanted = TRUE; break; }
+    }
+    if (wanted) g_ptr_array_add(names, g_strdup(name));
+  }
+
+  // Directory order is arbitrary; keep ttyUSB0 ahead of ttyUSB1
+  g_ptr_array_sort(names, compare_names);
+  for (guint i = 0; i < names->len; i++) {
+    g_autofree gchar *path = g_build_filename(dir_path, g_ptr_array_index(names, i), NULL);
+    add_device(devices, seen, path);
+  }
+}
+
+GPtrArray*
+rig_probe_list_devices(void)
+{
+  GPtrArray *devices = g_ptr_array_new_with_free_func(g_free);
+  g_autoptr(GHashTable) seen = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+  // by-id names survive replugging, so prefer them over the ttyUSBn they point to
+  add_devices_in(devices, seen, "/dev/serial/by-id", NULL);
+
+  static const gchar *const tty_prefixes[] = { "ttyUSB", "ttyACM", NULL };
+  add_devices_in(devices, seen, "/dev", tty_prefixes);
+
+  return devices;
+}
+
+/* ----------------- Probe run ----------------- */
+
+typedef struct {
+  GMutex          lock;
+  RigProbeResult *found;        // first responder wins
+  gint            stop;         // atomic
+  GCancellable   *cancellable;
+} ProbeRun;
+
+typedef struct {
+  ProbeRun *run;
+  gchar    *device_path;
+} ProbeDevice;
+
+static gboolean
+probe_run_should_stop(ProbeRun *run)
+{
+  return g_atomic_int_get(&run->stop) || g_cancellable_is_cancelled(run->cancellable);
+}
+
+static gboolean
+probe_attempt(const gchar *device_path, gint model_id, gint baud_rate)
+{
+  RIG *rig = rig_init(model_id);
+  if (!rig) return FALSE;
+
+  g_strlcpy(rig->state.rigport.pathname, device_path, HAMLIB_FILPATHLEN);
+  rig->state.rigport.parm.serial.rate = baud_rate;
+  rig->state.rigport.timeout = PROBE_TIMEOUT_MS;
+  rig->state.rigport.retry = 0;
+
+  gboolean ok = FALSE;
+  if (rig_open(rig) == RIG_OK) {
+    freq_t freq = 0;
+    ok = rig_get_freq(rig, RIG_VFO_CURR, &freq) == RIG_OK && freq > 0;
+    rig_close(rig);
+  }
+  rig_cleanup(rig);
+  return ok;
+}
+
+// Ask hamlib's backend probes which model is on the port; they identify the
+// rig by its ID reply rather than by whether a guess happens to work.
+static gint
+probe_identify(const gchar *device_path)
+{
+  hamlib_port_t port;
+  memset(&port, 0, sizeof(port));
+  port.type.rig = RIG_PORT_SERIAL;
+  g_strlcpy(port.pathname, device_path, HAMLIB_FILPATHLEN);
+  port.parm.serial.rate = PROBE_BAUD_RATES[0];
+  port.parm.serial.data_bits = 8;
+  port.parm.serial.stop_bits = 1;
+  port.parm.serial.parity = RIG_PARITY_NONE;
+  port.parm.serial.handshake = RIG_HANDSHAKE_NONE;
+  port.timeout = PROBE_TIMEOUT_MS;
+  port.retry = 0;
+
+  return rig_probe(&port);
+}
+
+// Preferences can only display models from RADIO_MODELS
+static gboolean
+is_listed_model(gint model_id)
+{
+  for (guint i = 0; i < RADIO_MODELS_COUNT; i++) {
+    if (RADIO_MODELS[i].model_id == model_id) return TRUE;
+  }
+  return FALSE;
+}
+
+static gpointer
+probe_device_thread(gpointer user_data)
+{
+  ProbeDevice *device = user_data;
+  ProbeRun *run = device->run;
+
+  g_autoptr(GArray) models = g_array_new(FALSE, FALSE, sizeof(gint));
+  gint identified = probe_identify(device->device_path);
+  if (identified != RIG_MODEL_NONE && is_listed_model(identified)) {
+    g_debug("%s identifies as hamlib model %d", device->device_path, identified);
+    g_array_append_val(models, identified);
+  }
+  for (guint i = 0; i < G_N_ELEMENTS(PROBE_MODELS); i++) {
+    if (PROBE_MODELS[i] != identified) g_array_append_val(models, PROBE_MODELS[i]);
+  }
+
+  // Baud-major: a rig set to 38400 answers the first model of its family
+  // sooner than cycling every baud rate per model would reach it
+  for (guint b = 0; b < G_N_ELEMENTS(PROBE_BAUD_RATES); b++) {
+    for (guint m = 0; m < models->len; m++) {
+      if (probe_run_should_stop(run)) return NULL;
+
+      gint model_id = g_array_index(models, gint, m);
+      if (!probe_attempt(device->device_path, model_id, PROBE_BAUD_RATES[b])) continue;
+
+      g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&run->lock);
+      if (!run->found) {
+        run->found = g_new0(RigProbeResult, 1);
+        run->found->model_id = model_id;
+        run->found->device_path = g_strdup(device->device_path);
+        run->found->baud_rate = PROBE_BAUD_RATES[b];
+        g_atomic_int_set(&run->stop, TRUE);
+      }
+      return NULL;
+    }
+  }
+  return NULL;
+}
+
+// Compared by target, so a by-id link matches the ttyUSBn it points to
+static gboolean
+is_busy_device(const gchar *path, const gchar *const *busy_devices)
+{
+  if (!busy_devices) return FALSE;
+
+  char *real = realpath(path, NULL);
+  gboolean busy = FALSE;
+  for (guint i = 0; busy_devices[i] && !busy; i++) {
+    char *busy_real = realpath(busy_devices[i], NULL);
+    busy = g_strcmp0(busy_real ? busy_real : busy_devices[i], real ? real : path) == 0;
+    free(busy_real);
+  }
+  free(real);
+  return busy;
+}
+
+static void
+probe_thread_func(GTask        *task,
+                  gpointer      source_object,
+                  gpointer      task_data,
+                  GCancellable *cancellable)
+{
+  const gchar *const *busy_devices = task_data;
+  g_autoptr(GPtrArray) devices = rig_probe_list_devices();
+  if (devices->len == 0) {
+    g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                            "No serial or USB devices found");
+    return;
+  }
+
+  guint skipped = 0;
+  for (guint i = devices->len; i-- > 0;) {
+    if (is_busy_device(g_ptr_array_index(devices, i), busy_devices)) {
+      g_debug("Not probing %s; a connected radio is using it",
+              (const gchar *)g_ptr_array_index(devices, i));
+      g_ptr_array_remove_index(devices, i);
+      skipped++;
+    }
+  }
+  if (devices->len == 0) {
+    g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_BUSY,
+                            "Every port is in use by a connected radio");
+    return;
+  }
+
+  // Backend registration is not thread-safe; do it before fanning out
+  rig_load_all_backends();
+
+  ProbeRun run = { 0 };
+  g_mutex_init(&run.lock);
+  run.cancellable = cancellable;
+
+  ProbeDevice *per_device = g_new0(ProbeDevice, devices->len);
+  GThread **threads = g_new0(GThread *, devices->len);
+  for (guint i = 0; i < devices->len; i++) {
+    per_device[i].run = &run;
+    per_device[i].device_path = g_ptr_array_index(devices, i);
+    threads[i] = g_thread_new("rig-probe", probe_device_thread, &per_device[i]);
+  }
+  for (guint i = 0; i < devices->len; i++) {
+    g_thread_join(threads[i]);
+  }
+  g_free(threads);
+  g_free(per_device);
+  g_mutex_clear(&run.lock);
+
+  if (run.found) {
+    g_task_return_pointer(task, run.found, (GDestroyNotify)rig_probe_result_free);
+  } else if (!g_task_return_error_if_cancelled(task)) {
+    if (skipped > 0) {
+      g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                              "No radio answered on %u device(s); skipped %u in use by a connected radio",
+                              devices->len, skipped);
+    } else {
+      g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                              "No radio answered on %u device(s)", devices->len);
+    }
+  }
+}
+
+void
+rig_probe_async(const gchar *const *busy_devices,
+                GCancellable       *cancellable,
+                GAsyncReadyCallback callback,
+                gpointer            user_data)
+{
+  g_autoptr(GTask) task = g_task_new(NULL, cancellable, callback, user_data);
+  g_task_set_source_tag(task, rig_probe_async);
+  g_task_set_task_data(task, g_strdupv((gchar **)busy_devices), (GDestroyNotify)g_strfreev);
+  g_task_run_in_thread(task, probe_thread_func);
+}
+
+RigProbeResult*
+rig_probe_finish(GAsyncResult *result,
+                 GError      **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, NULL), NULL);
+  g_return_val_if_fail(g_task_get_source_tag(G_TASK(result)) == rig_probe_async, NULL);
+
+  return g_task_propagate_pointer(G_TASK(result), error);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glib.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+// First model/device/baud combination that answered a frequency read
+typedef struct {
+  gint   model_id;
+  gchar *device_path;
+  gint   baud_rate;
+} RigProbeResult;
+
+void
+rig_probe_result_free(RigProbeResult *result);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(RigProbeResult, rig_probe_result_free)
+
+// Serial and USB CAT ports, /dev/serial/by-id links first. Free with g_ptr_array_unref.
+GPtrArray*
+rig_probe_list_devices(void);
+
+/* Probe every device at once, one thread per device, trying the likely
+ * model/baud combinations with short timeouts. Devices in busy_devices
+ * (NULL-terminated, may be NULL) are held open by a connected radio and are
+ * skipped; probing them would interleave with that radio's CAT traffic.
+ * Fails with G_IO_ERROR_NOT_FOUND when nothing answers, or G_IO_ERROR_BUSY
+ * when every device was skipped. */
+void rig_probe_async(const gchar *const *busy_devices,
+                     GCancellable       *cancellable,
+                     GAsyncReadyCallback callback,
+                     gpointer            user_data);
+RigProbeResult *rig_probe_finish(GAsyncResult *result,
+                                 GError      **error);
+
+G_END_DECLS
@@ -0,0 +1,138 @@
+#include "rig_profile.h"
+
+#include <hamlib/rig.h>
+
+RigProfile*
+rig_profile_new(void)
+{
+  RigProfile *profile = g_new0(RigProfile, 1);
+  profile->name = g_strdup("Radio");
+  profile->bands = g_new0(gchar *, 1);
+  profile->config = g_new0(RigConfig, 1);
+  profile->config->model_id = RIG_MODEL_DUMMY;
+  profile->config->connection_type = g_strdup("none");
+  profile->config->device_path = g_strdup("/dev/ttyUSB1");
+  profile->config->network_host = g_strdup("localhost");
+  profile->config->network_port = 4532;
+  profile->config->baud_rate = 9600;
+  return profile;
+}
+
+void
+rig_profile_free(RigProfile *profile)
+{
+  if (!profile) return;
+  g_free(profile->name);
+  g_strfreev(profile->bands);
+  rig_config_free(profile->config);
+  g_free(profile);
+}
+
+gboolean
+rig_profile_covers_band(const RigProfile *profile, const gchar *band)
+{
+  for (guint i = 0; profile->bands && profile->bands[i]; i++) {
+    if (g_ascii_strcasecmp(profile->bands[i], band) == 0) return TRUE;
+  }
+  return FALSE;
+}
+
+gboolean
+rig_profile_is_enabled(const RigProfile *profile)
+{
+  return g_strcmp0(profile->config->connection_type, "none") != 0;
+}
+
+static RigProfile*
+rig_profile_new_from_variant(GVariant *dict)
+{
+  RigProfile *profile = rig_profile_new();
+  RigConfig *config = profile->config;
+  const gchar *s;
+
+  if (g_variant_lookup(dict, "name", "&s", &s)) {
+    g_free(profile->name);
+    profile->name = g_strdup(s);
+  }
+  GStrv bands = NULL;
+  if (g_variant_lookup(dict, "bands", "^as", &bands)) {
+    g_strfreev(profile->bands);
+    profile->bands = bands;
+  }
+  g_variant_lookup(dict, "model", "i", &config->model_id);
+  if (g_variant_lookup(dict, "connection-type", "&s", &s)) {
+    g_free(config->connection_type);
+    config->connection_type = g_strdup(s);
+  }
+  if (g_variant_lookup(dict, "device", "&s", &s)) {
+    g_free(config->device_path);
+    config->device_path = g_strdup(s);
+  }
+  if (g_variant_lookup(dict, "network-host", "&s", &s)) {
+    g_free(config->network_host);
+    config->network_host = g_strdup(s);
+  }
+  g_variant_lookup(dict, "network-port", "i", &config->network_port);
+  g_variant_lookup(dict, "baud-rate", "i", &config->baud_rate);
+
+  return profile;
+}
+
+static GVariant*
+rig_profile_to_variant(const RigProfile *profile)
+{
+  const RigConfig *config = profile->config;
+  GVariantBuilder builder;
+
+  g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+  g_variant_builder_add(&builder, "{sv}", "name", g_variant_new_string(profile->name ? profile->name : ""));
+  g_variant_builder_add(&builder, "{sv}", "bands",
+                        g_variant_new_strv((const gchar *const *)profile->bands, -1));
+  g_variant_builder_add(&builder, "{sv}", "model", g_variant_new_int32(config->model_id));
+  g_variant_builder_add(&builder, "{sv}", "connection-type", g_variant_new_string(config->connection_type));
+  g_variant_builder_add(&builder, "{sv}", "device", g_variant_new_string(config->device_path ? config->device_path : ""));
+  g_variant_builder_add(&builder, "{sv}", "network-host", g_variant_new_string(config->network_host ? config->network_host : ""));
+  g_variant_builder_add(&builder, "{sv}", "network-port", g_variant_new_int32(config->network_port));
+  g_variant_builder_add(&builder, "{sv}", "baud-rate", g_variant_new_int32(config->baud_rate));
+  return g_variant_builder_end(&builder);
+}
+
+GPtrArray*
+rig_profiles_load(GSettings *settings)
+{
+  GPtrArray *profiles = g_ptr_array_new_with_free_func((GDestroyNotify)rig_profile_free);
+  g_autoptr(GVariant) value = g_settings_get_value(settings, "rig-profiles");
+
+  GVariantIter iter;
+  GVariant *dict;
+  g_variant_iter_init(&iter, value);
+  while ((dict = g_variant_iter_next_value(&iter)) != NULL) {
+    g_ptr_array_add(profiles, rig_profile_new_from_variant(dict));
+    g_variant_unref(dict);
+  }
+  return profiles;
+}
+
+void
+rig_profiles_save(GSettings *settings, GPtrArray *profiles)
+{
+  GVariantBuilder builder;
+  g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+  for (guint i = 0; i < profiles->len; i++) {
+    g_variant_builder_add_value(&builder, rig_profile_to_variant(g_ptr_array_index(profiles, i)));
+  }
+  g_settings_set_value(settings, "rig-profiles", g_variant_builder_end(&builder));
+}
+
+gboolean
+rig_config_equal(const RigConfig *a, const RigConfig *b)
+{
+  if (a == b) return TRUE;
+  if (!a || !b) return FALSE;
+  return a->model_id == b->model_id &&
+         g_strcmp0(a->connection_type, b->connection_type) == 0 &&
+         g_strcmp0(a->device_path, b->device_path) == 0 &&
+         g_strcmp0(a->network_host, b->network_host) == 0 &&
+         a->network_port == b->network_port &&
+         a->baud_rate == b->baud_rate;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "rig_worker.h"
+
+G_BEGIN_DECLS
+
+/* An additional radio from the rig-profiles setting. Tune requests for the
+ * listed bands go to this rig; every other band stays on the main radio. */
+typedef struct {
+  gchar     *name;
+  GStrv      bands;   // BANDS[] names, e.g. "6m"
+  RigConfig *config;  // connection_type may be "none" while being set up
+} RigProfile;
+
+RigProfile*
+rig_profile_new(void);
+void
+rig_profile_free(RigProfile *profile);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(RigProfile, rig_profile_free)
+
+gboolean
+rig_profile_covers_band(const RigProfile *profile, const gchar *band);
+// Whether the profile should be connected at all
+gboolean
+rig_profile_is_enabled(const RigProfile *profile);
+
+// GPtrArray of RigProfile*; free with g_ptr_array_unref
+GPtrArray*
+rig_profiles_load(GSettings *settings);
+void
+rig_profiles_save(GSettings *settings, GPtrArray *profiles);
+
+gboolean
+rig_config_equal(const RigConfig *a, const RigConfig *b);
+
+G_END_DECLS
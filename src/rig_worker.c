@@ -0,0 +1,759 @@
+#include "rig_worker.h"
+
+#include <math.h>
+#include <string.h>
+
+/* ----------------- RigConfig ----------------- */
+
+RigConfig*
+rig_config_new_from_settings(GSettings *settings)
+{
+  g_autofree gchar *connection_type = g_settings_get_string(settings, "radio-connection-type");
+  if (g_strcmp0(connection_type, "none") == 0) {
+    return NULL;
+  }
+
+  RigConfig *config = g_new0(RigConfig, 1);
+  config->model_id = g_settings_get_int(settings, "radio-model");
+  config->connection_type = g_steal_pointer(&connection_type);
+  config->device_path = g_settings_get_string(settings, "radio-device");
+  config->network_host = g_settings_get_string(settings, "radio-network-host");
+  config->network_port = g_settings_get_int(settings, "radio-network-port");
+  config->baud_rate = g_settings_get_int(settings, "radio-baud-rate");
+  return config;
+}
+
+RigConfig*
+rig_config_copy(const RigConfig *config)
+{
+  if (!config) return NULL;
+
+  RigConfig *copy = g_new0(RigConfig, 1);
+  copy->model_id = config->model_id;
+  copy->connection_type = g_strdup(config->connection_type);
+  copy->device_path = g_strdup(config->device_path);
+  copy->network_host = g_strdup(config->network_host);
+  copy->network_port = config->network_port;
+  copy->baud_rate = config->baud_rate;
+  return copy;
+}
+
+void
+rig_config_free(RigConfig *config)
+{
+  if (!config) return;
+  g_free(config->connection_type);
+  g_free(config->device_path);
+  g_free(config->network_host);
+  g_free(config);
+}
+
+RIG*
+rig_config_open(const RigConfig *config, GError **error)
+{
+  g_return_val_if_fail(config != NULL, NULL);
+
+  RIG *rig = rig_init(config->model_id);
+  if (!rig) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                "Failed to initialize radio model %d", config->model_id);
+    return NULL;
+  }
+
+  // Configure connection based on type
+  if (g_strcmp0(config->connection_type, "serial") == 0 || g_strcmp0(config->connection_type, "usb") == 0) {
+    g_strlcpy(rig->state.rigport.pathname, config->device_path ? config->device_path : "", HAMLIB_FILPATHLEN);
+    rig->state.rigport.parm.serial.rate = config->baud_rate;
+  } else if (g_strcmp0(config->connection_type, "network") == 0) {
+    g_snprintf(rig->state.rigport.pathname, HAMLIB_FILPATHLEN, "%s:%d",
+               config->network_host, config->network_port);
+  }
+
+  int result = rig_open(rig);
+  if (result != RIG_OK) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_CONNECTION_REFUSED,
+                "Failed to connect to radio: %s", rigerror(result));
+    rig_cleanup(rig);
+    return NULL;
+  }
+
+  return rig;
+}
+
+/* ----------------- Connection test ----------------- */
+
+typedef struct {
+  RigConfig          *config;
+  RigTestProgressFunc progress;
+  gpointer            progress_data;
+  GCancellable       *caller_cancellable;
+  gulong              cancelled_id;
+  GSource            *deadline;
+  gint                timed_out;  // atomic
+  gdouble             freq_hz;    // < 0 when the rig did not report one
+} RigTestData;
+
+static void
+rig_test_data_free(RigTestData *data)
+{
+  if (data->caller_cancellable) {
+    g_cancellable_disconnect(data->caller_cancellable, data->cancelled_id);
+    g_object_unref(data->caller_cancellable);
+  }
+  if (data->deadline) {
+    g_source_destroy(data->deadline);
+    g_source_unref(data->deadline);
+  }
+  rig_config_free(data->config);
+  g_free(data);
+}
+
+typedef struct {
+  GTask *task;
+  gchar *stage;
+} RigTestProgress;
+
+static void
+rig_test_progress_free(RigTestProgress *progress)
+{
+  g_object_unref(progress->task);
+  g_free(progress->stage);
+  g_free(progress);
+}
+
+static gboolean
+rig_test_report_progress(gpointer user_data)
+{
+  RigTestProgress *progress = user_data;
+  RigTestData *data = g_task_get_task_data(progress->task);
+
+  // Nothing to report once the caller has already seen the result
+  if (!g_task_get_completed(progress->task) &&
+      !g_cancellable_is_cancelled(g_task_get_cancellable(progress->task))) {
+    data->progress(progress->stage, data->progress_data);
+  }
+  return G_SOURCE_REMOVE;
+}
+
+// Test thread: hand a stage description to the caller's main context
+static void
+rig_test_progress(GTask *task, const gchar *stage)
+{
+  RigTestData *data = g_task_get_task_data(task);
+  if (!data->progress) return;
+
+  RigTestProgress *progress = g_new0(RigTestProgress, 1);
+  progress->task = g_object_ref(task);
+  progress->stage = g_strdup(stage);
+  g_main_context_invoke_full(g_task_get_context(task), G_PRIORITY_DEFAULT,
+                             rig_test_report_progress, progress,
+                             (GDestroyNotify)rig_test_progress_free);
+}
+
+static void
+rig_test_thread(GTask        *task,
+                gpointer      source_object,
+                gpointer      task_data,
+                GCancellable *cancellable)
+{
+  RigTestData *data = task_data;
+  GError *error = NULL;
+
+  const gchar *target = data->config->device_path;
+  g_autofree gchar *network_target = NULL;
+  if (g_strcmp0(data->config->connection_type, "network") == 0) {
+    network_target = g_strdup_printf("%s:%d", data->config->network_host, data->config->network_port);
+    target = network_target;
+  }
+  g_autofree gchar *opening = g_strdup_printf("Opening %s…", target ? target : "radio");
+  rig_test_progress(task, opening);
+
+  // hamlib calls cannot be interrupted; on cancel or deadline the task has
+  // already returned and this thread only cleans up behind it.
+  RIG *rig = rig_config_open(data->config, &error);
+  if (!rig) {
+    g_task_return_error(task, error);
+    return;
+  }
+
+  if (!g_cancellable_is_cancelled(cancellable)) {
+    rig_test_progress(task, "Reading frequency…");
+    freq_t freq = 0;
+    int result = rig_get_freq(rig, RIG_VFO_CURR, &freq);
+    data->freq_hz = result == RIG_OK ? (gdouble)freq : -1;
+  }
+
+  rig_close(rig);
+  rig_cleanup(rig);
+  g_task_return_boolean(task, TRUE);
+}
+
+static gboolean
+rig_test_deadline_reached(gpointer user_data)
+{
+  GTask *task = user_data;
+  RigTestData *data = g_task_get_task_data(task);
+
+  g_atomic_int_set(&data->timed_out, TRUE);
+  g_cancellable_cancel(g_task_get_cancellable(task));
+  return G_SOURCE_REMOVE;
+}
+
+static void
+rig_test_caller_cancelled(GCancellable *caller_cancellable, gpointer user_data)
+{
+  g_cancellable_cancel(G_CANCELLABLE(user_data));
+}
+
+void
+rig_config_test_async(const RigConfig    *config,
+                      guint               timeout_seconds,
+                      RigTestProgressFunc progress,
+                      gpointer            progress_data,
+                      GCancellable       *cancellable,
+                      GAsyncReadyCallback callback,
+                      gpointer            user_data)
+{
+  g_return_if_fail(config != NULL);
+
+  /* The task runs against its own cancellable so the deadline can fire it
+   * without touching the caller's; the caller's is chained onto it. */
+  g_autoptr(GCancellable) task_cancellable = g_cancellable_new();
+  GTask *task = g_task_new(NULL, task_cancellable, callback, user_data);
+  g_task_set_source_tag(task, rig_config_test_async);
+  g_task_set_return_on_cancel(task, TRUE);
+
+  RigTestData *data = g_new0(RigTestData, 1);
+  data->config = rig_config_copy(config);
+  data->progress = progress;
+  data->progress_data = progress_data;
+  data->freq_hz = -1;
+  g_task_set_task_data(task, data, (GDestroyNotify)rig_test_data_free);
+
+  if (cancellable) {
+    data->caller_cancellable = g_object_ref(cancellable);
+    data->cancelled_id = g_cancellable_connect(cancellable, G_CALLBACK(rig_test_caller_cancelled),
+                                               g_object_ref(task_cancellable), g_object_unref);
+  }
+
+  if (timeout_seconds > 0) {
+    data->deadline = g_timeout_source_new_seconds(timeout_seconds);
+    g_source_set_callback(data->deadline, rig_test_deadline_reached, task, NULL);
+    g_source_attach(data->deadline, g_task_get_context(task));
+  }
+
+  g_task_run_in_thread(task, rig_test_thread);
+  g_object_unref(task);
+}
+
+gboolean
+rig_config_test_finish(GAsyncResult *result,
+                       gdouble      *out_freq_hz,
+                       GError      **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, NULL), FALSE);
+  g_return_val_if_fail(g_task_get_source_tag(G_TASK(result)) == rig_config_test_async, FALSE);
+
+  RigTestData *data = g_task_get_task_data(G_TASK(result));
+  GError *local_error = NULL;
+  if (!g_task_propagate_boolean(G_TASK(result), &local_error)) {
+    if (g_atomic_int_get(&data->timed_out) &&
+        g_error_matches(local_error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      g_clear_error(&local_error);
+      g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+                          "The radio did not respond before the deadline");
+    } else {
+      g_propagate_error(error, local_error);
+    }
+    return FALSE;
+  }
+
+  if (out_freq_hz) *out_freq_hz = data->freq_hz;
+  return TRUE;
+}
+
+/* ----------------- Worker ----------------- */
+
+typedef enum {
+  RIG_CMD_OPEN,
+  RIG_CMD_CLOSE,
+  RIG_CMD_SET_FREQ,
+  RIG_CMD_TUNE,      // marker: run whatever set_freq is pending when dequeued
+  RIG_CMD_GET_FREQ,
+  RIG_CMD_WAKE,      // no-op; makes the thread re-read the poll interval
+  RIG_CMD_QUIT,
+} RigCommandKind;
+
+typedef struct {
+  RigCommandKind kind;
+  GTask         *task;     // NULL for fire-and-forget commands
+  RigConfig     *config;   // RIG_CMD_OPEN
+  gdouble        freq_hz;  // RIG_CMD_SET_FREQ
+} RigCommand;
+
+/* State shared with the I/O thread. Refcounted so the thread can outlive the
+ * GObject when the last task reference is dropped on the worker thread. */
+typedef struct {
+  GAsyncQueue *queue;        // RigCommand*
+  GMutex       tune_lock;
+  RigCommand  *pending_tune; // latest set_freq not yet picked up
+  gint         connected;    // atomic
+  gint         poll_interval_ms; // atomic, 0 = no VFO polling
+  GWeakRef     owner;        // ArtemisRigWorker, for signal emission
+
+  // I/O thread only
+  RIG         *rig;
+  RigConfig   *config;       // last successfully opened, for reconnects
+  gdouble      last_vfo_hz;  // last reported VFO frequency, 0 = unknown
+} RigShared;
+
+struct _ArtemisRigWorker {
+  GObject parent_instance;
+
+  RigShared *shared;
+  GThread   *thread;
+};
+
+enum {
+  SIGNAL_CONNECTION_CHANGED,
+  SIGNAL_VFO_CHANGED,
+  N_SIGNALS
+};
+static guint signals[N_SIGNALS];
+
+G_DEFINE_FINAL_TYPE(ArtemisRigWorker, artemis_rig_worker, G_TYPE_OBJECT)
+
+static void
+rig_command_free(RigCommand *cmd)
+{
+  if (!cmd) return;
+  g_clear_object(&cmd->task);
+  rig_config_free(cmd->config);
+  g_free(cmd);
+}
+
+static void
+rig_shared_clear(RigShared *shared)
+{
+  RigCommand *cmd;
+  while ((cmd = g_async_queue_try_pop(shared->queue))) rig_command_free(cmd);
+  g_async_queue_unref(shared->queue);
+  rig_command_free(shared->pending_tune);
+  g_mutex_clear(&shared->tune_lock);
+  g_weak_ref_clear(&shared->owner);
+  rig_config_free(shared->config);
+}
+
+static void
+rig_shared_unref(RigShared *shared)
+{
+  g_atomic_rc_box_release_full(shared, (GDestroyNotify)rig_shared_clear);
+}
+
+static gboolean
+emit_connection_changed(gpointer user_data)
+{
+  RigShared *shared = user_data;
+  g_autoptr(ArtemisRigWorker) self = g_weak_ref_get(&shared->owner);
+  if (self) {
+    g_signal_emit(self, signals[SIGNAL_CONNECTION_CHANGED], 0,
+                  (gboolean)g_atomic_int_get(&shared->connected));
+  }
+  return G_SOURCE_REMOVE;
+}
+
+typedef struct {
+  RigShared *shared;
+  gdouble    freq_hz;
+} VfoChange;
+
+static void
+vfo_change_free(VfoChange *change)
+{
+  rig_shared_unref(change->shared);
+  g_free(change);
+}
+
+static gboolean
+emit_vfo_changed(gpointer user_data)
+{
+  VfoChange *change = user_data;
+  g_autoptr(ArtemisRigWorker) self = g_weak_ref_get(&change->shared->owner);
+  if (self) {
+    g_signal_emit(self, signals[SIGNAL_VFO_CHANGED], 0, change->freq_hz);
+  }
+  return G_SOURCE_REMOVE;
+}
+
+// I/O thread: read the VFO and report it if it moved. Failures are left to
+// the periodic health check, which decides when to reconnect.
+static void
+rig_shared_poll_vfo(RigShared *shared)
+{
+  freq_t freq = 0;
+  int result = rig_get_freq(shared->rig, RIG_VFO_CURR, &freq);
+  if (result != RIG_OK) {
+    g_debug("VFO poll failed: %s", rigerror(result));
+    return;
+  }
+  if (fabs((gdouble)freq - shared->last_vfo_hz) < 1.0) return;
+
+  shared->last_vfo_hz = (gdouble)freq;
+  VfoChange *change = g_new0(VfoChange, 1);
+  change->shared = g_atomic_rc_box_acquire(shared);
+  change->freq_hz = (gdouble)freq;
+  g_main_context_invoke_full(NULL, G_PRIORITY_DEFAULT, emit_vfo_changed,
+                             change, (GDestroyNotify)vfo_change_free);
+}
+
+// I/O thread: record the state and tell the main thread if it changed
+static void
+rig_shared_set_connected(RigShared *shared, gboolean connected)
+{
+  if (g_atomic_int_get(&shared->connected) == connected) return;
+  g_atomic_int_set(&shared->connected, connected);
+  g_main_context_invoke_full(NULL, G_PRIORITY_DEFAULT, emit_connection_changed,
+                             g_atomic_rc_box_acquire(shared), (GDestroyNotify)rig_shared_unref);
+}
+
+static void
+rig_shared_close(RigShared *shared)
+{
+  if (!shared->rig) return;
+
+  int result = rig_close(shared->rig);
+  if (result != RIG_OK) {
+    g_warning("Error closing radio connection: %s", rigerror(result));
+  }
+  rig_cleanup(shared->rig);
+  shared->rig = NULL;
+  shared->last_vfo_hz = 0;
+  g_debug("Radio disconnected");
+}
+
+static gboolean
+rig_shared_open(RigShared *shared, const RigConfig *config, GError **error)
+{
+  rig_shared_close(shared);
+  shared->rig = rig_config_open(config, error);
+  return shared->rig != NULL;
+}
+
+static void
+run_open(RigShared *shared, RigCommand *cmd)
+{
+  GError *error = NULL;
+  if (!rig_shared_open(shared, cmd->config, &error)) {
+    rig_shared_set_connected(shared, FALSE);
+    g_task_return_error(cmd->task, error);
+    return;
+  }
+
+  rig_config_free(shared->config);
+  shared->config = g_steal_pointer(&cmd->config);
+  rig_shared_set_connected(shared, TRUE);
+  g_debug("Radio connected successfully");
+  g_task_return_boolean(cmd->task, TRUE);
+}
+
+static void
+run_set_freq(RigShared *shared, RigCommand *cmd)
+{
+  if (!shared->rig) {
+    g_task_return_new_error(cmd->task, G_IO_ERROR, G_IO_ERROR_NOT_CONNECTED, "Radio is not connected");
+    return;
+  }
+
+  int result = rig_set_freq(shared->rig, RIG_VFO_CURR, (freq_t)cmd->freq_hz);
+  if (result != RIG_OK && shared->config) {
+    // Serial links and rigctld drop out; reopen and retry once
+    g_warning("Radio frequency setting failed: %s, attempting reconnect", rigerror(result));
+    if (rig_shared_open(shared, shared->config, NULL)) {
+      result = rig_set_freq(shared->rig, RIG_VFO_CURR, (freq_t)cmd->freq_hz);
+    }
+  }
+
+  if (result != RIG_OK) {
+    rig_shared_set_connected(shared, shared->rig != NULL);
+    g_task_return_new_error(cmd->task, G_IO_ERROR, G_IO_ERROR_FAILED,
+                            "Failed to set frequency: %s", rigerror(result));
+    return;
+  }
+
+  rig_shared_set_connected(shared, TRUE);
+  g_task_return_boolean(cmd->task, TRUE);
+}
+
+static void
+run_get_freq(RigShared *shared, RigCommand *cmd)
+{
+  freq_t freq = 0;
+  int result = shared->rig ? rig_get_freq(shared->rig, RIG_VFO_CURR, &freq) : -RIG_EINVAL;
+
+  if (!shared->rig || result != RIG_OK) {
+    rig_shared_set_connected(shared, FALSE);
+    g_task_return_new_error(cmd->task, G_IO_ERROR,
+                            shared->rig ? G_IO_ERROR_FAILED : G_IO_ERROR_NOT_CONNECTED,
+                            "Failed to read frequency: %s",
+                            shared->rig ? rigerror(result) : "radio is not connected");
+    return;
+  }
+
+  gdouble *out = g_new(gdouble, 1);
+  *out = (gdouble)freq;
+  g_task_return_pointer(cmd->task, out, g_free);
+}
+
+static gpointer
+rig_worker_thread(gpointer user_data)
+{
+  RigShared *shared = user_data;
+  gint64 next_poll = 0;
+
+  for (;;) {
+    RigCommand *cmd = NULL;
+    guint interval_ms = (guint)g_atomic_int_get(&shared->poll_interval_ms);
+
+    if (interval_ms > 0 && shared->rig) {
+      // Poll on a fixed cadence; queued commands are served in between
+      gint64 now = g_get_monotonic_time();
+      if (now >= next_poll) {
+        rig_shared_poll_vfo(shared);
+        next_poll = now + (gint64)interval_ms * 1000;
+      }
+      gint64 wait = next_poll - g_get_monotonic_time();
+      cmd = g_async_queue_timeout_pop(shared->queue, wait > 0 ? (guint64)wait : 0);
+      if (!cmd) continue;
+    } else {
+      cmd = g_async_queue_pop(shared->queue);
+    }
+
+    if (cmd->kind == RIG_CMD_QUIT) {
+      rig_command_free(cmd);
+      break;
+    }
+
+    if (cmd->kind == RIG_CMD_TUNE) {
+      rig_command_free(cmd);
+      g_mutex_lock(&shared->tune_lock);
+      cmd = g_steal_pointer(&shared->pending_tune);
+      g_mutex_unlock(&shared->tune_lock);
+      if (!cmd) continue;
+    }
+
+    if (cmd->task && g_task_return_error_if_cancelled(cmd->task)) {
+      rig_command_free(cmd);
+      continue;
+    }
+
+    switch (cmd->kind) {
+      case RIG_CMD_OPEN:     run_open(shared, cmd); break;
+      case RIG_CMD_CLOSE:    rig_shared_close(shared); rig_shared_set_connected(shared, FALSE); break;
+      case RIG_CMD_SET_FREQ: run_set_freq(shared, cmd); break;
+      case RIG_CMD_GET_FREQ: run_get_freq(shared, cmd); break;
+      default: break;
+    }
+    rig_command_free(cmd);
+  }
+
+  rig_shared_close(shared);
+
+  // Anything queued behind the quit never runs
+  RigCommand *cmd;
+  while ((cmd = g_async_queue_try_pop(shared->queue))) {
+    if (cmd->task) {
+      g_task_return_new_error(cmd->task, G_IO_ERROR, G_IO_ERROR_CANCELLED, "Radio worker stopped");
+    }
+    rig_command_free(cmd);
+  }
+
+  rig_shared_unref(shared);
+  return NULL;
+}
+
+static void
+rig_worker_push(ArtemisRigWorker *self, RigCommandKind kind, GTask *task)
+{
+  RigCommand *cmd = g_new0(RigCommand, 1);
+  cmd->kind = kind;
+  cmd->task = task ? g_object_ref(task) : NULL;
+  g_async_queue_push(self->shared->queue, cmd);
+}
+
+static void
+artemis_rig_worker_dispose(GObject *object)
+{
+  ArtemisRigWorker *self = ARTEMIS_RIG_WORKER(object);
+
+  // Not joined: a hamlib call stuck on a dead port would block the caller. The
+  // thread holds its own reference to the shared state, closes the rig once it
+  // reaches the quit and exits on its own.
+  if (self->thread) {
+    rig_worker_push(self, RIG_CMD_QUIT, NULL);
+    g_clear_pointer(&self->thread, g_thread_unref);
+  }
+
+  G_OBJECT_CLASS(artemis_rig_worker_parent_class)->dispose(object);
+}
+
+static void
+artemis_rig_worker_finalize(GObject *object)
+{
+  ArtemisRigWorker *self = ARTEMIS_RIG_WORKER(object);
+  g_clear_pointer(&self->shared, rig_shared_unref);
+
+  G_OBJECT_CLASS(artemis_rig_worker_parent_class)->finalize(object);
+}
+
+static void
+artemis_rig_worker_class_init(ArtemisRigWorkerClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+  object_class->dispose = artemis_rig_worker_dispose;
+  object_class->finalize = artemis_rig_worker_finalize;
+
+  signals[SIGNAL_VFO_CHANGED] = g_signal_new(
+    "vfo-changed",
+    G_TYPE_FROM_CLASS(klass),
+    G_SIGNAL_RUN_LAST,
+    0, NULL, NULL, g_cclosure_marshal_VOID__DOUBLE,
+    G_TYPE_NONE, 1, G_TYPE_DOUBLE
+  );
+
+  signals[SIGNAL_CONNECTION_CHANGED] = g_signal_new(
+    "connection-changed",
+    G_TYPE_FROM_CLASS(klass),
+    G_SIGNAL_RUN_LAST,
+    0, NULL, NULL, g_cclosure_marshal_VOID__BOOLEAN,
+    G_TYPE_NONE, 1, G_TYPE_BOOLEAN
+  );
+}
+
+static void
+artemis_rig_worker_init(ArtemisRigWorker *self)
+{
+  self->shared = g_atomic_rc_box_new0(RigShared);
+  self->shared->queue = g_async_queue_new();
+  g_mutex_init(&self->shared->tune_lock);
+  g_weak_ref_init(&self->shared->owner, self);
+
+  self->thread = g_thread_new("rig-io", rig_worker_thread, g_atomic_rc_box_acquire(self->shared));
+}
+
+ArtemisRigWorker *artemis_rig_worker_new(void)
+{
+  return g_object_new(ARTEMIS_TYPE_RIG_WORKER, NULL);
+}
+
+gboolean
+artemis_rig_worker_is_connected(ArtemisRigWorker *self)
+{
+  g_return_val_if_fail(ARTEMIS_IS_RIG_WORKER(self), FALSE);
+  return g_atomic_int_get(&self->shared->connected);
+}
+
+void
+artemis_rig_worker_set_poll_interval(ArtemisRigWorker *self, guint interval_ms)
+{
+  g_return_if_fail(ARTEMIS_IS_RIG_WORKER(self));
+  g_atomic_int_set(&self->shared->poll_interval_ms, (gint)interval_ms);
+  rig_worker_push(self, RIG_CMD_WAKE, NULL);
+}
+
+void artemis_rig_worker_open_async(ArtemisRigWorker   *self,
+                                   const RigConfig    *config,
+                                   GCancellable       *cancellable,
+                                   GAsyncReadyCallback callback,
+                                   gpointer            user_data)
+{
+  g_return_if_fail(ARTEMIS_IS_RIG_WORKER(self));
+  g_return_if_fail(config != NULL);
+
+  g_autoptr(GTask) task = g_task_new(self, cancellable, callback, user_data);
+  g_task_set_source_tag(task, artemis_rig_worker_open_async);
+
+  RigCommand *cmd = g_new0(RigCommand, 1);
+  cmd->kind = RIG_CMD_OPEN;
+  cmd->task = g_object_ref(task);
+  cmd->config = rig_config_copy(config);
+  g_async_queue_push(self->shared->queue, cmd);
+}
+
+gboolean artemis_rig_worker_open_finish(ArtemisRigWorker *self,
+                                        GAsyncResult     *result,
+                                        GError          **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, self), FALSE);
+  return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+void
+artemis_rig_worker_close(ArtemisRigWorker *self)
+{
+  g_return_if_fail(ARTEMIS_IS_RIG_WORKER(self));
+  rig_worker_push(self, RIG_CMD_CLOSE, NULL);
+}
+
+void artemis_rig_worker_set_freq_async(ArtemisRigWorker   *self,
+                                       gdouble             freq_hz,
+                                       GCancellable       *cancellable,
+                                       GAsyncReadyCallback callback,
+                                       gpointer            user_data)
+{
+  g_return_if_fail(ARTEMIS_IS_RIG_WORKER(self));
+
+  g_autoptr(GTask) task = g_task_new(self, cancellable, callback, user_data);
+  g_task_set_source_tag(task, artemis_rig_worker_set_freq_async);
+
+  RigCommand *cmd = g_new0(RigCommand, 1);
+  cmd->kind = RIG_CMD_SET_FREQ;
+  cmd->task = g_object_ref(task);
+  cmd->freq_hz = freq_hz;
+
+  // Only the newest tune request matters; replace one that has not started yet
+  g_mutex_lock(&self->shared->tune_lock);
+  RigCommand *superseded = g_steal_pointer(&self->shared->pending_tune);
+  self->shared->pending_tune = cmd;
+  g_mutex_unlock(&self->shared->tune_lock);
+
+  if (superseded) {
+    g_task_return_new_error(superseded->task, G_IO_ERROR, G_IO_ERROR_CANCELLED,
+                            "Superseded by a newer tune request");
+    rig_command_free(superseded);
+  } else {
+    rig_worker_push(self, RIG_CMD_TUNE, NULL);
+  }
+}
+
+gboolean artemis_rig_worker_set_freq_finish(ArtemisRigWorker *self,
+                                            GAsyncResult     *result,
+                                            GError          **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, self), FALSE);
+  return g_task_propagate_boolean(G_TASK(result), error);
+}
+
+void artemis_rig_worker_get_freq_async(ArtemisRigWorker   *self,
+                                       GCancellable       *cancellable,
+                                       GAsyncReadyCallback callback,
+                                       gpointer            user_data)
+{
+  g_return_if_fail(ARTEMIS_IS_RIG_WORKER(self));
+
+  g_autoptr(GTask) task = g_task_new(self, cancellable, callback, user_data);
+  g_task_set_source_tag(task, artemis_rig_worker_get_freq_async);
+  rig_worker_push(self, RIG_CMD_GET_FREQ, task);
+}
+
+gboolean artemis_rig_worker_get_freq_finish(ArtemisRigWorker *self,
+                                            GAsyncResult     *result,
+                                            gdouble          *out_freq_hz,
+                                            GError          **error)
+{
+  g_return_val_if_fail(g_task_is_valid(result, self), FALSE);
+
+  g_autofree gdouble *freq = g_task_propagate_pointer(G_TASK(result), error);
+  if (!freq) return FALSE;
+  if (out_freq_hz) *out_freq_hz = *freq;
+  return TRUE;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+#include <hamlib/rig.h>
+
+G_BEGIN_DECLS
+
+// Connection parameters for one radio, as stored in the radio-* settings
+typedef struct {
+  gint   model_id;
+  gchar *connection_type;  // "serial", "usb" or "network"
+  gchar *device_path;
+  gchar *network_host;
+  gint   network_port;
+  gint   baud_rate;
+} RigConfig;
+
+// NULL when radio-connection-type is "none"
+RigConfig*
+rig_config_new_from_settings(GSettings *settings);
+RigConfig*
+rig_config_copy(const RigConfig *config);
+void
+rig_config_free(RigConfig *config);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(RigConfig, rig_config_free)
+
+// Blocking: rig_init() + rig_open(). Only call off the main thread.
+RIG*
+rig_config_open(const RigConfig *config, GError **error);
+
+// Called on the caller's main context with a short description of each step
+typedef void (*RigTestProgressFunc)(const gchar *stage, gpointer user_data);
+
+/* One-shot open + frequency read on a throwaway thread. Completes with
+ * G_IO_ERROR_TIMED_OUT after timeout_seconds (0 = no deadline), or with
+ * G_IO_ERROR_CANCELLED as soon as cancellable fires, even while hamlib is
+ * still blocked; the thread then finishes and closes the rig on its own. */
+void rig_config_test_async(const RigConfig    *config,
+                           guint               timeout_seconds,
+                           RigTestProgressFunc progress,
+                           gpointer            progress_data,
+                           GCancellable       *cancellable,
+                           GAsyncReadyCallback callback,
+                           gpointer            user_data);
+// out_freq_hz is negative when the rig opened but did not report a frequency
+gboolean rig_config_test_finish(GAsyncResult *result,
+                                gdouble      *out_freq_hz,
+                                GError      **error);
+
+/* Owns the RIG* on a dedicated thread. Commands are queued and run in order;
+ * completions arrive on the main context. A set_freq that is still waiting
+ * when a newer one is queued completes with G_IO_ERROR_CANCELLED. Disposing
+ * does not wait for the thread; it closes the rig and exits in the background.
+ *
+ * Signals (main context):
+ *   connection-changed (gboolean connected)
+ *   vfo-changed        (gdouble freq_hz)   while polling is enabled */
+#define ARTEMIS_TYPE_RIG_WORKER (artemis_rig_worker_get_type())
+G_DECLARE_FINAL_TYPE(ArtemisRigWorker, artemis_rig_worker, ARTEMIS, RIG_WORKER, GObject)
+
+ArtemisRigWorker *artemis_rig_worker_new(void);
+
+// Whether the last open succeeded and no command has failed since
+gboolean
+artemis_rig_worker_is_connected(ArtemisRigWorker *self);
+
+// Close any open rig, then open config (copied)
+void artemis_rig_worker_open_async(ArtemisRigWorker   *self,
+                                   const RigConfig    *config,
+                                   GCancellable       *cancellable,
+                                   GAsyncReadyCallback callback,
+                                   gpointer            user_data);
+gboolean artemis_rig_worker_open_finish(ArtemisRigWorker *self,
+                                        GAsyncResult     *result,
+                                        GError          **error);
+
+void
+artemis_rig_worker_close(ArtemisRigWorker *self);
+
+// Read the VFO every interval_ms between commands; 0 stops polling
+void
+artemis_rig_worker_set_poll_interval(ArtemisRigWorker *self, guint interval_ms);
+
+// Retries once after reopening the rig if the first attempt fails
+void artemis_rig_worker_set_freq_async(ArtemisRigWorker   *self,
+                                       gdouble             freq_hz,
+                                       GCancellable       *cancellable,
+                                       GAsyncReadyCallback callback,
+                                       gpointer            user_data);
+gboolean artemis_rig_worker_set_freq_finish(ArtemisRigWorker *self,
+                                            GAsyncResult     *result,
+                                            GError          **error);
+
+void artemis_rig_worker_get_freq_async(ArtemisRigWorker   *self,
+                                       GCancellable       *cancellable,
+                                       GAsyncReadyCallback callback,
+                                       gpointer            user_data);
+gboolean artemis_rig_worker_get_freq_finish(ArtemisRigWorker *self,
+                                            GAsyncResult     *result,
+                                            gdouble          *out_freq_hz,
+                                            GError          **error);
+
+G_END_DECLS
@@ -5,6 +5,7 @@
 
 struct _ArtemisSpot {
   GObject    parent_instance;
+  gint64     spot_id;       /* POTA spotId, 0 for locally created spots */
   char      *callsign;
   char      *park_ref;
   char      *park_name;
@@ -110,6 +111,7 @@ artemis_spot_new_from_json(JsonObject *o) {
   int freq_hz = atoi(obj_str(o, "frequency"));
   GDateTime *dt  = parse_dt(o);
   int count      = obj_int(o, "count", 0);
+  gint64 spot_id = json_object_has_member(o, "spotId") ? json_object_get_int_member(o, "spotId") : 0;
 
   ArtemisSpot *spot = artemis_spot_new(
     callsign, 
@@ -123,6 +125,7 @@ artemis_spot_new_from_json(JsonObject *o) {
     spotter, 
     spotter_comment, 
     count);
+  spot->spot_id = spot_id;
   return spot;
 }
 
@@ -151,6 +154,12 @@ GDateTime  *
 artemis_spot_get_spot_time (ArtemisSpot *s){ return s->spot_time; }
 int
 artemis_spot_get_spot_count  (ArtemisSpot *s){ return s->spot_count; }
+gint64
+artemis_spot_get_spot_id     (ArtemisSpot *s){ return s->spot_id; }
+
+/* For spots rebuilt from storage; call before the spot is shared */
+void
+artemis_spot_set_spot_id     (ArtemisSpot *s, gint64 spot_id){ s->spot_id = spot_id; }
 
 
 /* Store helpers */
@@ -37,6 +37,10 @@ artemis_spot_get_frequency_hz (ArtemisSpot *self);
 GDateTime  *artemis_spot_get_spot_time    (ArtemisSpot *self); /* borrowed */
 int
 artemis_spot_get_spot_count   (ArtemisSpot *self);
+gint64
+artemis_spot_get_spot_id      (ArtemisSpot *self); /* 0 if not from pota.app */
+void
+artemis_spot_set_spot_id      (ArtemisSpot *self, gint64 spot_id);
 const char *artemis_spot_get_spotter      (ArtemisSpot *self);
 
 const char *artemis_spot_get_spotter_comment  (ArtemisSpot *self);
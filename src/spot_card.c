@@ -122,7 +122,7 @@ static void on_spot_history_received(GObject *source, GAsyncResult *result, gpoi
   SpotCard *self = ARTEMIS_SPOT_CARD(user_data);
   
   GError *error = NULL;
-  JsonNode *root = pota_client_get_spot_history_finish(client, result, &error);
+  g_autoptr(GPtrArray) history = pota_client_get_spot_history_finish(client, result, &error);
   
   if (error) {
     g_warning("Failed to fetch spot history: %s", error->message);
@@ -133,9 +133,8 @@ static void on_spot_history_received(GObject *source, GAsyncResult *result, gpoi
     return;
   }
   
-  if (root && self->history_dialog) {
-    spot_history_dialog_show_history(self->history_dialog, root);
-    json_node_unref(root);
+  if (self->history_dialog) {
+    spot_history_dialog_show_history(self->history_dialog, history);
   }
 }
 
@@ -342,9 +341,24 @@ GtkWidget *spot_card_new_from_spot(gpointer user_data)
   g_autofree char *freq = g_strdup_printf("%d kHz", artemis_spot_get_frequency_hz(spot));
   g_autofree char *spot_count = g_strdup_printf("%d", artemis_spot_get_spot_count(spot));
 
+  const char *location_desc = artemis_spot_get_location_desc(spot);
+
+  // Fill gaps (e.g. locally submitted spots) and build the tooltip from the offline catalog
+  SpotDb *catalog_db = spot_db_get_instance();
+  g_autoptr(ParkCatalogRow) park = catalog_db ? spot_db_lookup_park(catalog_db, park_ref, NULL) : NULL;
+  if (park) {
+    if (!park_name || !*park_name) park_name = park->name;
+    if (!location_desc || !*location_desc) location_desc = park->location;
+
+    g_autofree gchar *tooltip = g_strdup_printf("%s\n%s%s%s", park->name ? park->name : park->reference,
+                                                park->location ? park->location : "",
+                                                park->grid ? " · " : "", park->grid ? park->grid : "");
+    gtk_widget_set_tooltip_text(GTK_WIDGET(card->park_label), tooltip);
+  }
+
   gtk_label_set_label(card->title, title);
   gtk_label_set_label(card->park_label, park_name);
-  gtk_label_set_label(card->location_desc, artemis_spot_get_location_desc(spot));
+  gtk_label_set_label(card->location_desc, location_desc);
   gtk_label_set_label(card->frequency, freq);
   gtk_label_set_label(card->mode, artemis_spot_get_mode(spot));
   gtk_label_set_label(card->hunter_callsign, artemis_spot_get_spotter(spot));
@@ -353,7 +367,7 @@ GtkWidget *spot_card_new_from_spot(gpointer user_data)
 
   g_weak_ref_init(&card->spot, spot);
 
-  if (!artemis_app_is_rig_connected(app))
+  if (!artemis_app_is_rig_connected_for(app, artemis_spot_get_frequency_hz(spot)))
   {
     gtk_button_set_label(card->tune_button, _("Track"));
   }
@@ -367,7 +381,7 @@ GtkWidget *spot_card_new_from_spot(gpointer user_data)
     activator_data->target_avatar = card->activator_avatar;
     activator_data->callsign = g_strdup(callsign);
     
-    artemis_pota_user_cache_get_async(cache, callsign, 3600, NULL,
+    artemis_pota_user_cache_get_async(cache, callsign, 3600, POTA_PRIORITY_VISIBLE, NULL,
                                       on_avatar_data_fetched, activator_data);
   }
 
@@ -378,7 +392,7 @@ GtkWidget *spot_card_new_from_spot(gpointer user_data)
     spotter_data->target_avatar = card->hunter_avatar;
     spotter_data->callsign = g_strdup(spotter);
     
-    artemis_pota_user_cache_get_async(cache, spotter, 3600, NULL,
+    artemis_pota_user_cache_get_async(cache, spotter, 3600, POTA_PRIORITY_VISIBLE, NULL,
                                       on_avatar_data_fetched, spotter_data);
   }
 
@@ -404,7 +418,7 @@ void spot_card_update_hunted_state(SpotCard *self)
   g_autoptr(GDateTime) now = g_date_time_new_now_utc();
   GError *db_err = NULL;
   const char *park_ref = artemis_spot_get_park_ref(card_spot);
-  gboolean hunted_today = spot_db_had_qso_with_park_on_utc_day(db, park_ref, now, &db_err);
+  gboolean hunted_today = db ? spot_db_had_qso_with_park_on_utc_day(db, park_ref, now, &db_err) : FALSE;
   
   if (db_err) {
     g_debug("Error checking if park %s was hunted today: %s", park_ref, db_err->message);
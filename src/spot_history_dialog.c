@@ -102,25 +102,9 @@ void spot_history_dialog_show_error(SpotHistoryDialog *self, const char *error_m
   gtk_widget_set_visible(GTK_WIDGET(self->error_page), TRUE);
 }
 
-static GtkWidget *create_spot_row(JsonObject *spot_obj)
+static GtkWidget *create_history_row(const char *heading, const char *spot_dt,
+                                     const char *spotter, const char *comments)
 {
-  // Extract data from JSON
-  const char *spotter = json_object_has_member(spot_obj, "spotter") ? 
-                        json_object_get_string_member(spot_obj, "spotter") : "";
-  const char *frequency = json_object_has_member(spot_obj, "frequency") ? 
-                          json_object_get_string_member(spot_obj, "frequency") : "";
-  const char *mode = json_object_has_member(spot_obj, "mode") ? 
-                     json_object_get_string_member(spot_obj, "mode") : "";
-  const char *spot_time = json_object_has_member(spot_obj, "spotTime") ? 
-                          json_object_get_string_member(spot_obj, "spotTime") : "";
-
-  g_autoptr(GTimeZone) utc_tz = g_time_zone_new_utc();
-  g_autoptr(GDateTime) dt = g_date_time_new_from_iso8601(spot_time, utc_tz);
-  g_autofree char *spot_dt = dt ? g_date_time_format(dt, "%x %X UTC") : g_strdup(spot_time);
-
-  const char *comments = json_object_has_member(spot_obj, "comments") ? 
-                         json_object_get_string_member(spot_obj, "comments") : "";
-
   // Create main container
   GtkWidget *row = gtk_list_box_row_new();
   gtk_widget_add_css_class(row, "card");
@@ -141,9 +125,8 @@ static GtkWidget *create_spot_row(JsonObject *spot_obj)
   GtkWidget *header_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
   gtk_box_append(GTK_BOX(main_box), header_box);
 
-  // Frequency and mode label
-  g_autofree char *freq_mode = g_strdup_printf("%s kHz %s", frequency, mode);
-  GtkWidget *freq_label = gtk_label_new(freq_mode);
+  // Heading label (frequency and mode)
+  GtkWidget *freq_label = gtk_label_new(heading);
   gtk_label_set_xalign(GTK_LABEL(freq_label), 0.0);
   gtk_widget_add_css_class(freq_label, "title-4");
   gtk_widget_set_hexpand(freq_label, TRUE);
@@ -176,43 +159,94 @@ static GtkWidget *create_spot_row(JsonObject *spot_obj)
   return row;
 }
 
-void spot_history_dialog_show_history(SpotHistoryDialog *self, JsonNode *history_data)
+static GtkWidget *create_spot_row(ArtemisSpot *spot)
 {
-  g_return_if_fail(ARTEMIS_IS_SPOT_HISTORY_DIALOG(self));
-  g_return_if_fail(history_data != NULL);
+  GDateTime *dt = artemis_spot_get_spot_time(spot);
+  g_autofree char *spot_dt = dt ? g_date_time_format(dt, "%x %X UTC") : g_strdup("");
+  const char *mode = artemis_spot_get_mode(spot);
+  const char *spotter = artemis_spot_get_spotter(spot);
+  const char *comments = artemis_spot_get_spotter_comment(spot);
+
+  g_autofree char *freq_mode = g_strdup_printf("%d kHz %s", artemis_spot_get_frequency_hz(spot),
+                                               mode ? mode : "");
+  return create_history_row(freq_mode, spot_dt, spotter ? spotter : "", comments ? comments : "");
+}
 
-  // Clear existing items
+static GtkWidget *create_archived_spot_row(ArtemisSpot *spot)
+{
+  GDateTime *dt = artemis_spot_get_spot_time(spot);
+  g_autofree char *spot_dt = dt ? g_date_time_format(dt, "%x %X UTC") : g_strdup("");
+  const char *mode = artemis_spot_get_mode(spot);
+
+  g_autofree char *heading = g_strdup_printf("%s @ %s · %d kHz %s",
+                                             artemis_spot_get_callsign(spot),
+                                             artemis_spot_get_park_ref(spot),
+                                             artemis_spot_get_frequency_hz(spot),
+                                             mode ? mode : "");
+  const char *spotter = artemis_spot_get_spotter(spot);
+  return create_history_row(heading, spot_dt, spotter ? spotter : "",
+                            artemis_spot_get_spotter_comment(spot));
+}
+
+static void clear_history_list(SpotHistoryDialog *self)
+{
   GtkWidget *child = gtk_widget_get_first_child(GTK_WIDGET(self->history_list));
   while (child) {
     GtkWidget *next = gtk_widget_get_next_sibling(child);
     gtk_list_box_remove(self->history_list, child);
     child = next;
   }
+}
 
-  if (!JSON_NODE_HOLDS_ARRAY(history_data)) {
-    spot_history_dialog_show_error(self, _("Invalid response format from POTA API"));
-    return;
-  }
+void spot_history_dialog_show_history(SpotHistoryDialog *self, GPtrArray *history)
+{
+  g_return_if_fail(ARTEMIS_IS_SPOT_HISTORY_DIALOG(self));
+  g_return_if_fail(history != NULL);
 
-  JsonArray *spots_array = json_node_get_array(history_data);
-  guint array_length = json_array_get_length(spots_array);
+  clear_history_list(self);
 
-  if (array_length == 0) {
+  if (history->len == 0) {
     spot_history_dialog_show_error(self, _("No spot history found"));
     return;
   }
 
   // Add each spot to the list
-  for (guint i = 0; i < array_length; i++) {
-    JsonObject *spot_obj = json_array_get_object_element(spots_array, i);
-    if (spot_obj) {
-      GtkWidget *row = create_spot_row(spot_obj);
-      gtk_list_box_append(self->history_list, row);
-    }
+  for (guint i = 0; i < history->len; i++) {
+    gtk_list_box_append(self->history_list, create_spot_row(g_ptr_array_index(history, i)));
   }
 
   // Show the history list
   gtk_widget_set_visible(GTK_WIDGET(self->loading_page), FALSE);
   gtk_widget_set_visible(GTK_WIDGET(self->history_scroll), TRUE);
   gtk_widget_set_visible(GTK_WIDGET(self->error_page), FALSE);
-}
\ No newline at end of file
+}
+
+void spot_history_dialog_set_title(SpotHistoryDialog *self, const char *title, const char *subtitle)
+{
+  g_return_if_fail(ARTEMIS_IS_SPOT_HISTORY_DIALOG(self));
+
+  adw_window_title_set_title(self->title_widget, title);
+  adw_window_title_set_subtitle(self->title_widget, subtitle ? subtitle : "");
+}
+
+void spot_history_dialog_show_spots(SpotHistoryDialog *self, GPtrArray *spots)
+{
+  g_return_if_fail(ARTEMIS_IS_SPOT_HISTORY_DIALOG(self));
+  g_return_if_fail(spots != NULL);
+
+  clear_history_list(self);
+
+  if (spots->len == 0) {
+    adw_status_page_set_title(self->error_page, _("No matching spots"));
+    spot_history_dialog_show_error(self, _("Nothing in the spot archive matches this search"));
+    return;
+  }
+
+  for (guint i = 0; i < spots->len; i++) {
+    gtk_list_box_append(self->history_list, create_archived_spot_row(g_ptr_array_index(spots, i)));
+  }
+
+  gtk_widget_set_visible(GTK_WIDGET(self->loading_page), FALSE);
+  gtk_widget_set_visible(GTK_WIDGET(self->history_scroll), TRUE);
+  gtk_widget_set_visible(GTK_WIDGET(self->error_page), FALSE);
+}
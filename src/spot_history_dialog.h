@@ -4,6 +4,8 @@
 #include <adwaita.h>
 #include <json-glib/json-glib.h>
 
+#include "spot.h"
+
 G_BEGIN_DECLS
 
 #define ARTEMIS_TYPE_SPOT_HISTORY_DIALOG (spot_history_dialog_get_type())
@@ -18,6 +20,12 @@ spot_history_dialog_show_loading(SpotHistoryDialog *self);
 void
 spot_history_dialog_show_error(SpotHistoryDialog *self, const char *error_message);
 void
-spot_history_dialog_show_history(SpotHistoryDialog *self, JsonNode *history_data);
+spot_history_dialog_show_history(SpotHistoryDialog *self, GPtrArray *history); /* ArtemisSpot* */
+
+/* Local archive results */
+void
+spot_history_dialog_set_title(SpotHistoryDialog *self, const char *title, const char *subtitle);
+void
+spot_history_dialog_show_spots(SpotHistoryDialog *self, GPtrArray *spots); /* ArtemisSpot* */
 
 G_END_DECLS
\ No newline at end of file
@@ -0,0 +1,109 @@
+// spot_index.c - Spots sorted by frequency for nearest-spot lookups
+#include "spot_index.h"
+
+typedef struct {
+  gint         freq_khz;
+  ArtemisSpot *spot;  // owned
+} SpotIndexEntry;
+
+struct _SpotIndex {
+  GArray *entries;  // SpotIndexEntry, ascending freq_khz
+};
+
+static void
+spot_index_entry_clear(gpointer data)
+{
+  SpotIndexEntry *entry = data;
+  g_clear_object(&entry->spot);
+}
+
+static gint
+compare_entries(gconstpointer a, gconstpointer b)
+{
+  const SpotIndexEntry *ea = a, *eb = b;
+  return (ea->freq_khz > eb->freq_khz) - (ea->freq_khz < eb->freq_khz);
+}
+
+SpotIndex*
+spot_index_new(void)
+{
+  SpotIndex *index = g_new0(SpotIndex, 1);
+  index->entries = g_array_new(FALSE, FALSE, sizeof(SpotIndexEntry));
+  g_array_set_clear_func(index->entries, spot_index_entry_clear);
+  return index;
+}
+
+void
+spot_index_free(SpotIndex *index)
+{
+  if (!index) return;
+  g_array_unref(index->entries);
+  g_free(index);
+}
+
+void
+spot_index_rebuild(SpotIndex *index, GListModel *model)
+{
+  g_return_if_fail(index != NULL);
+
+  g_array_set_size(index->entries, 0);
+  if (!model) return;
+
+  guint n = g_list_model_get_n_items(model);
+  for (guint i = 0; i < n; i++) {
+    SpotIndexEntry entry;
+    entry.spot = g_list_model_get_item(model, i);  // transfers the ref
+    entry.freq_khz = artemis_spot_get_frequency_hz(entry.spot);
+    g_array_append_val(index->entries, entry);
+  }
+
+  g_array_sort(index->entries, compare_entries);
+}
+
+ArtemisSpot*
+spot_index_find_nearest(SpotIndex *index, gdouble freq_khz, gdouble tolerance_khz)
+{
+  g_return_val_if_fail(index != NULL, NULL);
+
+  guint n = index->entries->len;
+  if (n == 0) return NULL;
+
+  // Lower bound: first entry at or above freq_khz
+  guint lo = 0, hi = n;
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+    if (g_array_index(index->entries, SpotIndexEntry, mid).freq_khz < freq_khz) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  // The nearest is either the lower bound or the entry just below it
+  SpotIndexEntry *best = NULL;
+  gdouble best_delta = tolerance_khz;
+  if (lo < n) {
+    SpotIndexEntry *above = &g_array_index(index->entries, SpotIndexEntry, lo);
+    gdouble delta = above->freq_khz - freq_khz;
+    if (delta <= best_delta) {
+      best = above;
+      best_delta = delta;
+    }
+  }
+  if (lo > 0) {
+    SpotIndexEntry *below = &g_array_index(index->entries, SpotIndexEntry, lo - 1);
+    gdouble delta = freq_khz - below->freq_khz;
+    if (delta <= best_delta) {
+      best = below;
+    }
+  }
+
+  return best ? best->spot : NULL;
+}
+
+guint
+spot_index_get_n_spots(SpotIndex *index)
+{
+  g_return_val_if_fail(index != NULL, 0);
+  return index->entries->len;
+}
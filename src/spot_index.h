@@ -0,0 +1,31 @@
+// spot_index.h - Spots sorted by frequency for nearest-spot lookups
+#pragma once
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "spot.h"
+
+G_BEGIN_DECLS
+
+typedef struct _SpotIndex SpotIndex;
+
+SpotIndex*
+spot_index_new(void);
+void
+spot_index_free(SpotIndex *index);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(SpotIndex, spot_index_free)
+
+// Replace the contents with the ArtemisSpot items of model
+void
+spot_index_rebuild(SpotIndex *index, GListModel *model);
+
+// Closest spot to freq_khz that is at most tolerance_khz away, or NULL.
+// Borrowed; valid until the next rebuild.
+ArtemisSpot*
+spot_index_find_nearest(SpotIndex *index, gdouble freq_khz, gdouble tolerance_khz);
+
+guint
+spot_index_get_n_spots(SpotIndex *index);
+
+G_END_DECLS
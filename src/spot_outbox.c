@@ -0,0 +1,472 @@
+#include "spot_outbox.h"
+
+#include <gio/gio.h>
+
+// Wait after the first failed attempt; doubles with every further failure
+#define BACKOFF_BASE_SECS   30
+#define BACKOFF_MAX_SECS    (30 * 60)
+
+// Sent rows stay listed this long so the user sees the spot went out
+#define SENT_KEEP_SECS      (60 * 60)
+
+// A spot in the server's history counts as ours if it was created no earlier
+// than this before we queued it, to allow for clock differences
+#define DEDUP_SLACK_SECS    120
+
+struct _ArtemisSpotOutbox {
+  GObject parent_instance;
+
+  PotaClient      *client;
+  GNetworkMonitor *monitor;
+  gulong           network_handler;
+  gboolean         network_available;
+
+  GPtrArray       *rows;          // SpotOutboxRow*, as last read from the database
+
+  // The single row being sent, 0 when idle
+  sqlite3_int64    sending_id;
+  ArtemisSpot     *sending_spot;
+
+  guint            wake_id;       // timer for the next due row
+  GCancellable    *cancellable;
+};
+
+enum {
+  SIGNAL_CHANGED,
+  SIGNAL_POSTED,
+  SIGNAL_FAILED,
+  N_SIGNALS
+};
+static guint signals[N_SIGNALS];
+
+G_DEFINE_FINAL_TYPE(ArtemisSpotOutbox, artemis_spot_outbox, G_TYPE_OBJECT)
+
+static void outbox_schedule(ArtemisSpotOutbox *self);
+
+static gint64
+now_unix(void)
+{
+  return g_get_real_time() / G_USEC_PER_SEC;
+}
+
+static SpotOutboxRow*
+outbox_find(ArtemisSpotOutbox *self, sqlite3_int64 id)
+{
+  for (guint i = 0; self->rows && i < self->rows->len; i++) {
+    SpotOutboxRow *row = g_ptr_array_index(self->rows, i);
+    if (row->id == id) return row;
+  }
+  return NULL;
+}
+
+static void
+outbox_reload(ArtemisSpotOutbox *self)
+{
+  g_autoptr(GError) error = NULL;
+  GPtrArray *rows = spot_db_outbox_list(spot_db_get_instance(), &error);
+  if (!rows) {
+    g_warning("Failed to read spot outbox: %s", error->message);
+    return;
+  }
+  g_clear_pointer(&self->rows, g_ptr_array_unref);
+  self->rows = rows;
+  g_signal_emit(self, signals[SIGNAL_CHANGED], 0);
+}
+
+static void
+outbox_store(SpotOutboxRow *row)
+{
+  g_autoptr(GError) error = NULL;
+  if (!spot_db_outbox_update(spot_db_get_instance(), row, &error)) {
+    g_warning("Failed to update spot outbox row %" G_GINT64_FORMAT ": %s", (gint64)row->id, error->message);
+  }
+}
+
+static gboolean
+on_wake(gpointer user_data)
+{
+  ArtemisSpotOutbox *self = user_data;
+  self->wake_id = 0;
+  outbox_schedule(self);
+  return G_SOURCE_REMOVE;
+}
+
+static void
+outbox_end_attempt(ArtemisSpotOutbox *self)
+{
+  self->sending_id = 0;
+  g_clear_object(&self->sending_spot);
+  outbox_reload(self);
+  outbox_schedule(self);
+}
+
+static void
+outbox_sent(ArtemisSpotOutbox *self, GPtrArray *server_spots)
+{
+  SpotOutboxRow *row = outbox_find(self, self->sending_id);
+  if (row) {
+    row->state = SPOT_OUTBOX_SENT;
+    row->unconfirmed = FALSE;
+    g_clear_pointer(&row->last_error, g_free);
+    outbox_store(row);
+  }
+
+  g_autoptr(GError) error = NULL;
+  if (!spot_db_outbox_prune_sent(spot_db_get_instance(), now_unix() - SENT_KEEP_SECS, &error)) {
+    g_warning("Failed to prune spot outbox: %s", error->message);
+  }
+
+  g_autoptr(ArtemisSpot) spot = g_object_ref(self->sending_spot);
+  outbox_end_attempt(self);
+  g_signal_emit(self, signals[SIGNAL_POSTED], 0, spot, server_spots);
+}
+
+// Anything the server answered with a 4xx other than 429 will be answered the same way again
+static gboolean
+is_permanent_error(const GError *error)
+{
+  return g_error_matches(error, POTA_CLIENT_ERROR, POTA_CLIENT_ERROR_HTTP) ||
+         g_error_matches(error, POTA_CLIENT_ERROR, POTA_CLIENT_ERROR_UNAUTHORIZED) ||
+         g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT);
+}
+
+// permanent: the server refused the spot itself, so retrying cannot help
+static void
+outbox_failed(ArtemisSpotOutbox *self, const GError *error, gboolean permanent, gboolean maybe_delivered)
+{
+  SpotOutboxRow *row = outbox_find(self, self->sending_id);
+  g_autoptr(ArtemisSpot) spot = g_object_ref(self->sending_spot);
+  if (row) {
+    g_free(row->last_error);
+    row->last_error = g_strdup(error->message);
+    if (permanent) {
+      row->state = SPOT_OUTBOX_FAILED;
+    } else {
+      guint shift = MIN(MAX(row->attempts, 1) - 1, 10);
+      row->state = SPOT_OUTBOX_QUEUED;
+      row->next_attempt = now_unix() + MIN((gint64)BACKOFF_BASE_SECS << shift, BACKOFF_MAX_SECS);
+      row->unconfirmed = row->unconfirmed || maybe_delivered;
+    }
+    outbox_store(row);
+    g_debug("Spot outbox row %" G_GINT64_FORMAT " attempt %d failed: %s",
+            (gint64)row->id, row->attempts, error->message);
+  }
+  outbox_end_attempt(self);
+  if (permanent) g_signal_emit(self, signals[SIGNAL_FAILED], 0, spot);
+}
+
+static void
+on_posted(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+  g_autoptr(ArtemisSpotOutbox) self = user_data;
+  g_autoptr(GError) error = NULL;
+  g_autoptr(GPtrArray) spots = pota_client_post_spot_finish(ARTEMIS_POTA_CLIENT(source), res, &error);
+
+  if (g_cancellable_is_cancelled(self->cancellable)) return;
+
+  if (spots) {
+    outbox_sent(self, spots);
+  } else if (g_error_matches(error, POTA_CLIENT_ERROR, POTA_CLIENT_ERROR_INVALID_RESPONSE)) {
+    // The server took the spot; only its reply was unreadable
+    outbox_sent(self, NULL);
+  } else {
+    // Unless the server said it is busy, it may have stored the spot before we lost the reply
+    outbox_failed(self, error, is_permanent_error(error),
+                  !g_error_matches(error, POTA_CLIENT_ERROR, POTA_CLIENT_ERROR_RATE_LIMITED));
+  }
+}
+
+static void
+outbox_post(ArtemisSpotOutbox *self)
+{
+  pota_client_post_spot_async(self->client, self->sending_spot, self->cancellable,
+                              on_posted, g_object_ref(self));
+}
+
+static gboolean
+history_has_spot(GPtrArray *history, ArtemisSpot *spot)
+{
+  GDateTime *queued = artemis_spot_get_spot_time(spot);
+  g_autoptr(GDateTime) earliest = queued ? g_date_time_add_seconds(queued, -DEDUP_SLACK_SECS) : NULL;
+
+  for (guint i = 0; history && i < history->len; i++) {
+    ArtemisSpot *past = g_ptr_array_index(history, i);
+    GDateTime *when = artemis_spot_get_spot_time(past);
+
+    if (g_ascii_strcasecmp(artemis_spot_get_spotter(past) ? artemis_spot_get_spotter(past) : "",
+                           artemis_spot_get_spotter(spot)) != 0) continue;
+    if (artemis_spot_get_frequency_hz(past) != artemis_spot_get_frequency_hz(spot)) continue;
+    if (earliest && (!when || g_date_time_compare(when, earliest) < 0)) continue;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+static void
+on_history_checked(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+  g_autoptr(ArtemisSpotOutbox) self = user_data;
+  g_autoptr(GError) error = NULL;
+  g_autoptr(GPtrArray) history = pota_client_get_spot_history_finish(ARTEMIS_POTA_CLIENT(source), res, &error);
+
+  if (g_cancellable_is_cancelled(self->cancellable)) return;
+
+  if (!history) {
+    // Posting blind could duplicate the spot; try again later. Whatever the lookup
+    // failed with says nothing about the spot, so this is never final.
+    outbox_failed(self, error, FALSE, FALSE);
+  } else if (history_has_spot(history, self->sending_spot)) {
+    g_debug("Spot outbox row %" G_GINT64_FORMAT " was already posted", (gint64)self->sending_id);
+    outbox_sent(self, NULL);
+  } else {
+    outbox_post(self);
+  }
+}
+
+static void
+outbox_send(ArtemisSpotOutbox *self, SpotOutboxRow *row)
+{
+  self->sending_id = row->id;
+  self->sending_spot = g_object_ref(row->spot);
+
+  row->state = SPOT_OUTBOX_SENDING;
+  row->attempts++;
+  outbox_store(row);
+  g_signal_emit(self, signals[SIGNAL_CHANGED], 0);
+
+  if (row->unconfirmed) {
+    pota_client_get_spot_history_async(self->client,
+                                       artemis_spot_get_callsign(row->spot),
+                                       artemis_spot_get_park_ref(row->spot),
+                                       self->cancellable, on_history_checked, g_object_ref(self));
+  } else {
+    outbox_post(self);
+  }
+}
+
+// Start the oldest due row, or arm the timer for the next one
+static void
+outbox_schedule(ArtemisSpotOutbox *self)
+{
+  g_clear_handle_id(&self->wake_id, g_source_remove);
+  if (self->sending_id || !self->network_available || !self->rows) return;
+
+  gint64 now = now_unix();
+  gint64 earliest = G_MAXINT64;
+  for (guint i = 0; i < self->rows->len; i++) {
+    SpotOutboxRow *row = g_ptr_array_index(self->rows, i);
+    if (row->state != SPOT_OUTBOX_QUEUED) continue;
+    if (row->next_attempt <= now) {
+      outbox_send(self, row);
+      return;
+    }
+    earliest = MIN(earliest, row->next_attempt);
+  }
+
+  if (earliest != G_MAXINT64) {
+    self->wake_id = g_timeout_add_seconds((guint)(earliest - now), on_wake, self);
+  }
+}
+
+static void
+on_network_changed(GNetworkMonitor *monitor, gboolean available, gpointer user_data)
+{
+  ArtemisSpotOutbox *self = user_data;
+  gboolean was_available = self->network_available;
+  self->network_available = available;
+
+  if (available && !was_available && self->rows) {
+    // Failures while offline say nothing about the server; try everything again now
+    for (guint i = 0; i < self->rows->len; i++) {
+      SpotOutboxRow *row = g_ptr_array_index(self->rows, i);
+      if (row->state == SPOT_OUTBOX_QUEUED && row->next_attempt > 0) {
+        row->next_attempt = 0;
+        outbox_store(row);
+      }
+    }
+  }
+
+  if (available != was_available) {
+    g_signal_emit(self, signals[SIGNAL_CHANGED], 0);
+    outbox_schedule(self);
+  }
+}
+
+static void
+artemis_spot_outbox_dispose(GObject *object)
+{
+  ArtemisSpotOutbox *self = ARTEMIS_SPOT_OUTBOX(object);
+
+  g_cancellable_cancel(self->cancellable);
+  g_clear_handle_id(&self->wake_id, g_source_remove);
+  g_clear_signal_handler(&self->network_handler, self->monitor);
+  g_clear_object(&self->monitor);
+  g_clear_object(&self->client);
+  g_clear_object(&self->sending_spot);
+  g_clear_pointer(&self->rows, g_ptr_array_unref);
+
+  G_OBJECT_CLASS(artemis_spot_outbox_parent_class)->dispose(object);
+}
+
+static void
+artemis_spot_outbox_finalize(GObject *object)
+{
+  ArtemisSpotOutbox *self = ARTEMIS_SPOT_OUTBOX(object);
+  g_clear_object(&self->cancellable);
+  G_OBJECT_CLASS(artemis_spot_outbox_parent_class)->finalize(object);
+}
+
+static void
+artemis_spot_outbox_class_init(ArtemisSpotOutboxClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+  object_class->dispose = artemis_spot_outbox_dispose;
+  object_class->finalize = artemis_spot_outbox_finalize;
+
+  signals[SIGNAL_CHANGED] = g_signal_new(
+    "changed",
+    G_TYPE_FROM_CLASS(klass),
+    G_SIGNAL_RUN_LAST,
+    0, NULL, NULL, NULL,
+    G_TYPE_NONE, 0
+  );
+
+  signals[SIGNAL_POSTED] = g_signal_new(
+    "posted",
+    G_TYPE_FROM_CLASS(klass),
+    G_SIGNAL_RUN_LAST,
+    0, NULL, NULL, NULL,
+    G_TYPE_NONE, 2, ARTEMIS_TYPE_SPOT, G_TYPE_PTR_ARRAY
+  );
+
+  signals[SIGNAL_FAILED] = g_signal_new(
+    "failed",
+    G_TYPE_FROM_CLASS(klass),
+    G_SIGNAL_RUN_LAST,
+    0, NULL, NULL, NULL,
+    G_TYPE_NONE, 1, ARTEMIS_TYPE_SPOT
+  );
+}
+
+static void
+artemis_spot_outbox_init(ArtemisSpotOutbox *self)
+{
+  self->cancellable = g_cancellable_new();
+}
+
+ArtemisSpotOutbox *
+artemis_spot_outbox_new(PotaClient *client)
+{
+  g_return_val_if_fail(ARTEMIS_IS_POTA_CLIENT(client), NULL);
+
+  ArtemisSpotOutbox *self = g_object_new(ARTEMIS_TYPE_SPOT_OUTBOX, NULL);
+  self->client = g_object_ref(client);
+  self->monitor = g_object_ref(g_network_monitor_get_default());
+  self->network_available = g_network_monitor_get_network_available(self->monitor);
+  self->network_handler = g_signal_connect(self->monitor, "network-changed",
+                                           G_CALLBACK(on_network_changed), self);
+
+  g_autoptr(GError) error = NULL;
+  if (!spot_db_outbox_prune_sent(spot_db_get_instance(), now_unix() - SENT_KEEP_SECS, &error)) {
+    g_warning("Failed to prune spot outbox: %s", error->message);
+  }
+  outbox_reload(self);
+
+  // A row still marked sending was interrupted by shutdown and may have gone out
+  for (guint i = 0; self->rows && i < self->rows->len; i++) {
+    SpotOutboxRow *row = g_ptr_array_index(self->rows, i);
+    if (row->state == SPOT_OUTBOX_SENDING) {
+      row->state = SPOT_OUTBOX_QUEUED;
+      row->unconfirmed = TRUE;
+      row->next_attempt = 0;
+      outbox_store(row);
+    }
+  }
+
+  outbox_schedule(self);
+  return self;
+}
+
+gboolean
+artemis_spot_outbox_enqueue(ArtemisSpotOutbox *self, ArtemisSpot *spot, GError **error)
+{
+  g_return_val_if_fail(ARTEMIS_IS_SPOT_OUTBOX(self), FALSE);
+  g_return_val_if_fail(ARTEMIS_IS_SPOT(spot), FALSE);
+
+  gboolean duplicate = FALSE;
+  if (!spot_db_outbox_add(spot_db_get_instance(), spot, NULL, &duplicate, error)) return FALSE;
+  if (duplicate) g_debug("Spot of %s is already waiting to be posted", artemis_spot_get_callsign(spot));
+
+  outbox_reload(self);
+  outbox_schedule(self);
+  return TRUE;
+}
+
+GPtrArray*
+artemis_spot_outbox_get_rows(ArtemisSpotOutbox *self)
+{
+  g_return_val_if_fail(ARTEMIS_IS_SPOT_OUTBOX(self), NULL);
+  return self->rows;
+}
+
+guint
+artemis_spot_outbox_get_n_waiting(ArtemisSpotOutbox *self)
+{
+  g_return_val_if_fail(ARTEMIS_IS_SPOT_OUTBOX(self), 0);
+
+  guint n = 0;
+  for (guint i = 0; self->rows && i < self->rows->len; i++) {
+    SpotOutboxRow *row = g_ptr_array_index(self->rows, i);
+    if (row->state != SPOT_OUTBOX_SENT) n++;
+  }
+  return n;
+}
+
+gboolean
+artemis_spot_outbox_get_network_available(ArtemisSpotOutbox *self)
+{
+  g_return_val_if_fail(ARTEMIS_IS_SPOT_OUTBOX(self), FALSE);
+  return self->network_available;
+}
+
+void
+artemis_spot_outbox_retry(ArtemisSpotOutbox *self, sqlite3_int64 id)
+{
+  g_return_if_fail(ARTEMIS_IS_SPOT_OUTBOX(self));
+
+  SpotOutboxRow *row = outbox_find(self, id);
+  if (!row || id == self->sending_id || row->state == SPOT_OUTBOX_SENT) return;
+
+  row->state = SPOT_OUTBOX_QUEUED;
+  row->next_attempt = 0;
+
+  g_autoptr(GError) error = NULL;
+  if (!spot_db_outbox_update(spot_db_get_instance(), row, &error)) {
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_EXISTS)) {
+      // The same spot was queued again since this row failed; that one carries on
+      g_debug("Spot outbox row %" G_GINT64_FORMAT " is waiting under another row; dropping it", (gint64)id);
+      g_clear_error(&error);
+      if (!spot_db_outbox_remove(spot_db_get_instance(), id, &error)) {
+        g_warning("Failed to remove spot outbox row %" G_GINT64_FORMAT ": %s", (gint64)id, error->message);
+      }
+    } else {
+      g_warning("Failed to update spot outbox row %" G_GINT64_FORMAT ": %s", (gint64)id, error->message);
+    }
+  }
+  outbox_reload(self);
+  outbox_schedule(self);
+}
+
+void
+artemis_spot_outbox_discard(ArtemisSpotOutbox *self, sqlite3_int64 id)
+{
+  g_return_if_fail(ARTEMIS_IS_SPOT_OUTBOX(self));
+  if (id == self->sending_id) return;
+
+  g_autoptr(GError) error = NULL;
+  if (!spot_db_outbox_remove(spot_db_get_instance(), id, &error)) {
+    g_warning("Failed to remove spot outbox row %" G_GINT64_FORMAT ": %s", (gint64)id, error->message);
+  }
+  outbox_reload(self);
+  outbox_schedule(self);
+}
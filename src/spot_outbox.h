@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "database.h"
+#include "pota_client.h"
+#include "spot.h"
+
+G_BEGIN_DECLS
+
+/* Posts spots from the spot_outbox table. A spot is stored before any request is
+ * made, then sent in the background, one at a time, while the network is up.
+ * Failures back off exponentially; 4xx rejections stop retrying. When an attempt
+ * may have reached the server before failing, the activation's spot history is
+ * checked before posting again so the spot does not appear twice.
+ *
+ * "changed" is emitted whenever a row's state changes; "posted" (ArtemisSpot *queued,
+ * GPtrArray *server_spots) when one goes out. server_spots is the server's spot list
+ * and is NULL when the spot was found already posted. "failed" (ArtemisSpot *queued)
+ * when the server refuses one for good. */
+#define ARTEMIS_TYPE_SPOT_OUTBOX (artemis_spot_outbox_get_type())
+G_DECLARE_FINAL_TYPE(ArtemisSpotOutbox, artemis_spot_outbox, ARTEMIS, SPOT_OUTBOX, GObject)
+
+ArtemisSpotOutbox *artemis_spot_outbox_new(PotaClient *client);
+
+// Store the spot and send it when possible. FALSE only if it could not be stored.
+gboolean
+artemis_spot_outbox_enqueue(ArtemisSpotOutbox *self, ArtemisSpot *spot, GError **error);
+
+// Current rows, oldest first (SpotOutboxRow*, borrowed until the next "changed")
+GPtrArray*
+artemis_spot_outbox_get_rows(ArtemisSpotOutbox *self);
+// Rows not yet sent
+guint
+artemis_spot_outbox_get_n_waiting(ArtemisSpotOutbox *self);
+gboolean
+artemis_spot_outbox_get_network_available(ArtemisSpotOutbox *self);
+
+// Send a failed or waiting row now
+void
+artemis_spot_outbox_retry(ArtemisSpotOutbox *self, sqlite3_int64 id);
+// Drop a row that is not being sent
+void
+artemis_spot_outbox_discard(ArtemisSpotOutbox *self, sqlite3_int64 id);
+
+G_END_DECLS
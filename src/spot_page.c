@@ -11,7 +11,11 @@
 #include "gtk/gtkshortcut.h"
 #include "spot.h"
 #include "logbook.h"
-#include "logbook_qrz.h"
+#include "logbook_queue.h"
+#include "database.h"
+
+#define PARK_SUGGESTION_MIN_CHARS 2
+#define PARK_SUGGESTION_LIMIT     8
 
 typedef struct {
   GtkBuilder  *builder;
@@ -27,21 +31,109 @@ spot_page_ctx_free(SpotPageContext *ctx)
     g_free(ctx);
 }
 
+typedef struct {
+  AdwEntryRow *row;
+  GtkWidget   *popover;
+  GtkListBox  *list;
+  gboolean     applying; // text is being set from a suggestion
+} ParkAutocomplete;
+
 static void
-qso_logged_callback(GObject *source_object, GAsyncResult *res, gpointer user_data)
+park_autocomplete_free(ParkAutocomplete *ac)
 {
-  LogbookProvider *provider = LOGBOOK_PROVIDER(source_object);
-  g_autoptr(GError) error = NULL;
-  
-  gboolean success = logbook_provider_log_qso_finish(provider, res, &error);
-  
-  if (success) {
-    g_debug("QSO logged successfully to %s", logbook_provider_get_name(provider));
-  } else {
-    g_warning("Failed to log QSO to %s: %s", 
-              logbook_provider_get_name(provider), 
-              error ? error->message : "Unknown error");
+  if (!ac) return;
+  g_free(ac);
+}
+
+// The popover has to leave the row during its dispose; by finalize GTK has
+// already warned about a child still attached
+static void
+on_park_ref_row_destroy(GtkWidget *row, gpointer user_data)
+{
+  ParkAutocomplete *ac = user_data;
+  g_clear_pointer(&ac->popover, gtk_widget_unparent);
+}
+
+static void
+on_park_suggestion_activated(GtkListBox *list, GtkListBoxRow *row, gpointer user_data)
+{
+  ParkAutocomplete *ac = user_data;
+  const char *reference = g_object_get_data(G_OBJECT(row), "park-reference");
+  if (!reference) return;
+
+  ac->applying = TRUE;
+  gtk_editable_set_text(GTK_EDITABLE(ac->row), reference);
+  gtk_editable_set_position(GTK_EDITABLE(ac->row), -1);
+  ac->applying = FALSE;
+
+  gtk_popover_popdown(GTK_POPOVER(ac->popover));
+}
+
+static void
+on_park_ref_changed(GtkEditable *editable, gpointer user_data)
+{
+  ParkAutocomplete *ac = user_data;
+  if (ac->applying) return;
+
+  const char *text = gtk_editable_get_text(editable);
+  gtk_list_box_remove_all(ac->list);
+
+  if (!text || strlen(text) < PARK_SUGGESTION_MIN_CHARS) {
+    gtk_popover_popdown(GTK_POPOVER(ac->popover));
+    return;
   }
+
+  g_autoptr(GPtrArray) parks = spot_db_search_parks(spot_db_get_instance(), text, PARK_SUGGESTION_LIMIT, NULL);
+  if (!parks || parks->len == 0) {
+    gtk_popover_popdown(GTK_POPOVER(ac->popover));
+    return;
+  }
+
+  for (guint i = 0; i < parks->len; i++) {
+    ParkCatalogRow *park = g_ptr_array_index(parks, i);
+    GtkWidget *row = adw_action_row_new();
+    adw_preferences_row_set_title(ADW_PREFERENCES_ROW(row), park->reference);
+    adw_preferences_row_set_use_markup(ADW_PREFERENCES_ROW(row), FALSE);
+    g_autofree gchar *subtitle = g_strdup_printf("%s%s%s", park->name ? park->name : "",
+                                                 park->location ? " · " : "",
+                                                 park->location ? park->location : "");
+    adw_action_row_set_subtitle(ADW_ACTION_ROW(row), subtitle);
+    gtk_list_box_row_set_activatable(GTK_LIST_BOX_ROW(row), TRUE);
+    g_object_set_data_full(G_OBJECT(row), "park-reference", g_strdup(park->reference), g_free);
+    gtk_list_box_append(ac->list, row);
+  }
+
+  gtk_popover_popup(GTK_POPOVER(ac->popover));
+}
+
+/* Suggest parks from the offline catalog while typing a reference, name or location */
+static void
+park_autocomplete_attach(AdwEntryRow *park_ref_row)
+{
+  ParkAutocomplete *ac = g_new0(ParkAutocomplete, 1);
+  ac->row = park_ref_row;
+
+  ac->list = GTK_LIST_BOX(gtk_list_box_new());
+  gtk_list_box_set_selection_mode(ac->list, GTK_SELECTION_NONE);
+  gtk_widget_add_css_class(GTK_WIDGET(ac->list), "boxed-list");
+
+  GtkWidget *scroller = gtk_scrolled_window_new();
+  gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroller), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+  gtk_scrolled_window_set_propagate_natural_height(GTK_SCROLLED_WINDOW(scroller), TRUE);
+  gtk_scrolled_window_set_max_content_height(GTK_SCROLLED_WINDOW(scroller), 320);
+  gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scroller), GTK_WIDGET(ac->list));
+
+  ac->popover = gtk_popover_new();
+  gtk_popover_set_child(GTK_POPOVER(ac->popover), scroller);
+  gtk_popover_set_autohide(GTK_POPOVER(ac->popover), FALSE); // keep typing in the row
+  gtk_popover_set_has_arrow(GTK_POPOVER(ac->popover), FALSE);
+  gtk_popover_set_position(GTK_POPOVER(ac->popover), GTK_POS_BOTTOM);
+  gtk_widget_set_parent(ac->popover, GTK_WIDGET(park_ref_row));
+
+  g_signal_connect(ac->list, "row-activated", G_CALLBACK(on_park_suggestion_activated), ac);
+  g_signal_connect(park_ref_row, "changed", G_CALLBACK(on_park_ref_changed), ac);
+  g_signal_connect(park_ref_row, "destroy", G_CALLBACK(on_park_ref_row_destroy), ac);
+  g_object_set_data_full(G_OBJECT(park_ref_row), "park-autocomplete", ac, (GDestroyNotify)park_autocomplete_free);
 }
 
 static void
@@ -121,18 +213,11 @@ on_spot_page_submit(GtkButton *button, gpointer user_data)
   gboolean logging_enabled = g_settings_get_boolean(settings, "enable-logging");
   
   if (logging_enabled) {
-    // Create QRZ logbook provider
-    g_autoptr(LogbookQrz) qrz_provider = logbook_qrz_new();
-    LogbookProvider *provider = LOGBOOK_PROVIDER(qrz_provider);
-    
-    if (logbook_provider_is_configured(provider)) {
-      // Create QSO data from spot
-      g_autoptr(LogbookQso) qso = logbook_qso_from_spot(spot, rst_sent, rst_received);
-      
-      // Log the QSO
-      logbook_provider_log_qso_async(provider, qso, NULL, qso_logged_callback, NULL);
-    } else {
-      g_debug("QRZ logbook not configured - skipping logging");
+    // Stored first and uploaded in the background, so nothing is lost while offline
+    g_autoptr(LogbookQso) qso = logbook_qso_from_spot(spot, rst_sent, rst_received);
+    g_autoptr(GError) error = NULL;
+    if (!logbook_queue_enqueue(artemis_app_get_logbook_queue(app), qso, &error)) {
+      g_warning("Failed to queue QSO for logging: %s", error->message);
     }
   }
 
@@ -142,7 +227,7 @@ on_spot_page_submit(GtkButton *button, gpointer user_data)
 }
 
 void
-show_add_spot_page(GtkWidget *parent)
+show_add_spot_page(GtkWidget *parent, gint frequency_khz)
 {
   GSettings *settings = artemis_app_get_settings();
   GtkBuilder *b = gtk_builder_new_from_resource("/com/k0vcz/artemis/data/ui/add_spot_page.ui");
@@ -150,6 +235,7 @@ show_add_spot_page(GtkWidget *parent)
   GtkWidget  *dlg   = GTK_WIDGET(gtk_builder_get_object (b, "spot_page"));
 
   AdwEntryRow *spotter_callsign_row     = ADW_ENTRY_ROW(gtk_builder_get_object(b, "spotter_callsign"));
+  AdwEntryRow *park_ref_row             = ADW_ENTRY_ROW(gtk_builder_get_object(b, "park_ref"));
   AdwEntryRow *spotter_comments_row     = ADW_ENTRY_ROW(gtk_builder_get_object(b, "spotter_comments"));
 
   GtkButton *submit_button              = GTK_BUTTON(gtk_builder_get_object(b, "submit_button"));
@@ -161,6 +247,14 @@ show_add_spot_page(GtkWidget *parent)
   gtk_editable_set_text(GTK_EDITABLE(spotter_callsign_row), spotter_callsign);
   gtk_editable_set_text(GTK_EDITABLE(spotter_comments_row), default_msg);
 
+  if (frequency_khz > 0) {
+    AdwEntryRow *frequency_row = ADW_ENTRY_ROW(gtk_builder_get_object(b, "frequency"));
+    g_autofree gchar *frequency_str = g_strdup_printf("%d", frequency_khz);
+    gtk_editable_set_text(GTK_EDITABLE(frequency_row), frequency_str);
+  }
+
+  park_autocomplete_attach(park_ref_row);
+
   SpotPageContext *ctx = g_new0(SpotPageContext, 1);
   ctx->builder = g_object_ref(b);
 
@@ -6,5 +6,6 @@
 void show_spot_page_with_spot(GtkWidget *parent, 
                               ArtemisSpot *spot); 
 
+/* frequency_khz pre-fills the frequency row when > 0 */
 void
-show_add_spot_page(GtkWidget *parent);
\ No newline at end of file
+show_add_spot_page(GtkWidget *parent, gint frequency_khz);
\ No newline at end of file
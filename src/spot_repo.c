@@ -8,11 +8,15 @@
 #include "pota_user_cache.h"
 #include "spot.h"
 #include "database.h"
+#include "spot_snapshot.h"
 
 enum {
   SIGNAL_BUSY_CHANGED,
   SIGNAL_REFRESHED,
+  SIGNAL_APPLIED,
+  SIGNAL_UNCHANGED,
   SIGNAL_ERROR,
+  SIGNAL_STALE_CHANGED,
   N_SIGNALS
 };
 static guint signals[N_SIGNALS];
@@ -27,8 +31,38 @@ struct _ArtemisSpotRepo {
   ArtemisPotaUserCache *pota_user_cache;
 
   gboolean busy;
+  gint     refresh_hint_secs; // server's max-age / Retry-After from the last fetch, -1 = none
+  guint    ttl_secs;          // user-cache TTL from the last update_spots()
+  guint    generation;        // bumped whenever the store is replaced
+
+  gboolean archiving;       // snapshot write in flight on a worker thread
+  gint64   last_prune_us;   // monotonic time of the last archive prune
+
+  gboolean   stale;               // the store holds the on-disk snapshot, not a fetch
+  GDateTime *stale_fetched_utc;   // when that snapshot was fetched
+  gboolean   snapshotting;        // spot_snapshot_save() running on a worker thread
+  GPtrArray *snapshot_pending;    // newest list that arrived while it was
+
+  GPtrArray *pending;             // PendingSpot*, shown until the store is next replaced
 };
 
+// A spot the user submitted, and the server's spot it stands in for (may be NULL)
+typedef struct {
+  ArtemisSpot *shown;
+  ArtemisSpot *replaced;
+} PendingSpot;
+
+static void
+pending_spot_free(PendingSpot *pending)
+{
+  g_object_unref(pending->shown);
+  g_clear_object(&pending->replaced);
+  g_free(pending);
+}
+
+#define ARCHIVE_PRUNE_INTERVAL_US (G_USEC_PER_SEC * 3600)
+#define ARCHIVE_VACUUM_PAGES      256
+
 G_DEFINE_FINAL_TYPE(ArtemisSpotRepo, artemis_spot_repo, G_TYPE_OBJECT)
 
 static void repo_set_busy(ArtemisSpotRepo *self, gboolean busy) 
@@ -45,6 +79,9 @@ static void artemis_spot_repo_dispose(GObject *obj)
   g_clear_object(&self->ham_store);
   g_clear_object(&self->client);
   g_clear_object(&self->pota_user_cache);
+  g_clear_pointer(&self->stale_fetched_utc, g_date_time_unref);
+  g_clear_pointer(&self->snapshot_pending, g_ptr_array_unref);
+  g_clear_pointer(&self->pending, g_ptr_array_unref);
 
   G_OBJECT_CLASS(artemis_spot_repo_parent_class)->dispose(obj);
 }
@@ -70,6 +107,24 @@ static void artemis_spot_repo_class_init(ArtemisSpotRepoClass *klass)
     G_TYPE_NONE, 1, G_TYPE_UINT
   );
 
+  // The list was replaced by one the server returned outside a fetch (spot POST)
+  signals[SIGNAL_APPLIED] = g_signal_new(
+    "applied",
+    G_TYPE_FROM_CLASS(klass),
+    G_SIGNAL_RUN_LAST,
+    0, NULL, NULL, g_cclosure_marshal_VOID__UINT,
+    G_TYPE_NONE, 1, G_TYPE_UINT
+  );
+
+  // A refresh finished but the server had nothing new; the model was not touched
+  signals[SIGNAL_UNCHANGED] = g_signal_new(
+    "unchanged",
+    G_TYPE_FROM_CLASS(klass),
+    G_SIGNAL_RUN_LAST,
+    0, NULL, NULL, NULL,
+    G_TYPE_NONE, 0
+  );
+
   signals[SIGNAL_ERROR] = g_signal_new(
     "error",
     G_TYPE_FROM_CLASS(klass),
@@ -77,26 +132,44 @@ static void artemis_spot_repo_class_init(ArtemisSpotRepoClass *klass)
     0, NULL, NULL, g_cclosure_marshal_VOID__BOXED,
     G_TYPE_NONE, 1, G_TYPE_ERROR
   );
+
+  // The store switched between the startup snapshot and live data
+  signals[SIGNAL_STALE_CHANGED] = g_signal_new(
+    "stale-changed",
+    G_TYPE_FROM_CLASS(klass),
+    G_SIGNAL_RUN_LAST,
+    0, NULL, NULL, g_cclosure_marshal_VOID__BOOLEAN,
+    G_TYPE_NONE, 1, G_TYPE_BOOLEAN
+  );
+}
+
+static void repo_set_stale(ArtemisSpotRepo *self, gboolean stale)
+{
+  if (self->stale == stale) return;
+  self->stale = stale;
+  if (!stale) g_clear_pointer(&self->stale_fetched_utc, g_date_time_unref);
+  g_signal_emit(self, signals[SIGNAL_STALE_CHANGED], 0, stale);
 }
 
 static void artemis_spot_repo_init(ArtemisSpotRepo *self) 
 {
   self->spot_store = g_list_store_new(ARTEMIS_TYPE_SPOT);
   self->client = pota_client_new();
-  self->pota_user_cache = artemis_pota_user_cache_new(self->client);
+  self->refresh_hint_secs = -1;
+  self->ttl_secs = 3600;
+  self->pending = g_ptr_array_new_with_free_func((GDestroyNotify)pending_spot_free);
+  // Share the cards' cache so the prefetch below actually saves them a lookup
+  self->pota_user_cache = artemis_pota_user_cache_init_instance(self->client);
 }
 
 typedef struct {
   ArtemisSpotRepo *repo;
-  guint ttl_seconds;
-  guint n_spots_added;
-  GHashTable *unique_callsigns; // tracks unique callsigns to avoid duplicate requests
+  guint generation;             // store generation when the fetch started
 } SpotUpdateData;
 
 static void
 spot_update_data_free(SpotUpdateData *data) {
   if (data) {
-    if (data->unique_callsigns) g_hash_table_unref(data->unique_callsigns);
     g_object_unref(data->repo);
     g_free(data);
   }
@@ -120,90 +193,238 @@ on_user_data_fetched(GObject *source, GAsyncResult *result, gpointer user_data)
   }
 }
 
+typedef struct {
+  GPtrArray *spots;          // ArtemisSpot*
+  GDateTime *fetched_utc;
+  guint      retention_days;
+  gboolean   prune;
+} ArchiveData;
+
+static void
+archive_data_free(ArchiveData *data) {
+  g_ptr_array_unref(data->spots);
+  g_date_time_unref(data->fetched_utc);
+  g_free(data);
+}
+
+static void
+archive_thread_func(GTask *task, gpointer source_object, gpointer task_data, GCancellable *cancellable)
+{
+  ArchiveData *data = task_data;
+  SpotDb *db = spot_db_get_instance();
+  GError *error = NULL;
+  guint n_changes = 0;
+
+  if (!spot_db_archive_snapshot(db, data->spots, data->fetched_utc, &n_changes, &error)) {
+    g_task_return_error(task, error);
+    return;
+  }
+  g_debug("Archived %u spots (%u changes)", data->spots->len, n_changes);
+
+  if (data->prune) {
+    g_autoptr(GDateTime) cutoff = g_date_time_add_days(data->fetched_utc, -(gint)data->retention_days);
+    if (!spot_db_archive_prune(db, cutoff, ARCHIVE_VACUUM_PAGES, &error)) {
+      g_task_return_error(task, error);
+      return;
+    }
+  }
+
+  g_task_return_boolean(task, TRUE);
+}
+
+static void
+on_archive_done(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  ArtemisSpotRepo *self = ARTEMIS_SPOT_REPO(source);
+  g_autoptr(GError) error = NULL;
+
+  self->archiving = FALSE;
+  if (!g_task_propagate_boolean(G_TASK(result), &error)) {
+    g_warning("Failed to archive spots: %s", error->message);
+  }
+}
+
+/* Store the snapshot off the main thread. A refresh that lands while the previous
+ * write is still running is skipped; the next one diffs against the last stored set. */
+static void
+repo_archive_spots(ArtemisSpotRepo *self, GPtrArray *spots)
+{
+  GSettings *settings = g_settings_new("com.k0vcz.artemis");
+  guint retention_days = (guint)g_settings_get_int(settings, "archive-retention-days");
+  g_object_unref(settings);
+
+  if (retention_days == 0 || self->archiving) return;
+
+  gint64 now = g_get_monotonic_time();
+  ArchiveData *data = g_new0(ArchiveData, 1);
+  data->spots = g_ptr_array_ref(spots);
+  data->fetched_utc = g_date_time_new_now_utc();
+  data->retention_days = retention_days;
+  data->prune = self->last_prune_us == 0 || now - self->last_prune_us >= ARCHIVE_PRUNE_INTERVAL_US;
+  if (data->prune) self->last_prune_us = now;
+
+  self->archiving = TRUE;
+  g_autoptr(GTask) task = g_task_new(self, NULL, on_archive_done, NULL);
+  g_task_set_source_tag(task, repo_archive_spots);
+  g_task_set_task_data(task, data, (GDestroyNotify)archive_data_free);
+  g_task_run_in_thread(task, archive_thread_func);
+}
+
+static void
+snapshot_thread_func(GTask *task, gpointer source_object, gpointer task_data, GCancellable *cancellable)
+{
+  GPtrArray *spots = task_data;
+  g_autofree gchar *path = spot_snapshot_default_path();
+  g_autoptr(GDateTime) now = g_date_time_new_now_utc();
+  GError *error = NULL;
+
+  if (!spot_snapshot_save(path, spots, now, &error)) {
+    g_task_return_error(task, error);
+    return;
+  }
+  g_task_return_boolean(task, TRUE);
+}
+
+static void repo_save_snapshot(ArtemisSpotRepo *self, GPtrArray *spots);
+
+static void
+on_snapshot_saved(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+  ArtemisSpotRepo *self = ARTEMIS_SPOT_REPO(source);
+  g_autoptr(GError) error = NULL;
+
+  self->snapshotting = FALSE;
+  if (!g_task_propagate_boolean(G_TASK(result), &error)) {
+    g_warning("Failed to save spot snapshot: %s", error->message);
+  }
+
+  g_autoptr(GPtrArray) pending = g_steal_pointer(&self->snapshot_pending);
+  if (pending) repo_save_snapshot(self, pending);
+}
+
+/* Keep the latest list on disk for the next launch. Unlike the archive, the
+ * newest list must win, so one that lands mid-write is saved right after. */
+static void
+repo_save_snapshot(ArtemisSpotRepo *self, GPtrArray *spots)
+{
+  if (self->snapshotting) {
+    g_clear_pointer(&self->snapshot_pending, g_ptr_array_unref);
+    self->snapshot_pending = g_ptr_array_ref(spots);
+    return;
+  }
+
+  self->snapshotting = TRUE;
+  g_autoptr(GTask) task = g_task_new(self, NULL, on_snapshot_saved, NULL);
+  g_task_set_source_tag(task, repo_save_snapshot);
+  g_task_set_task_data(task, g_ptr_array_ref(spots), (GDestroyNotify)g_ptr_array_unref);
+  g_task_run_in_thread(task, snapshot_thread_func);
+}
+
+/* Replace the store with a fresh server list and do the per-spot bookkeeping.
+ * Shared by the periodic fetch and the list that comes back from a spot POST. */
+static guint
+repo_apply_spots(ArtemisSpotRepo *self, GPtrArray *spots)
+{
+  GSettings *settings = g_settings_new("com.k0vcz.artemis");
+  g_autofree gchar *user_callsign = g_settings_get_string(settings, "callsign");
+  g_object_unref(settings);
+
+  // tracks unique callsigns to avoid duplicate requests
+  g_autoptr(GHashTable) unique_callsigns = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+  guint n_added = 0;
+  for (guint i = 0; i < spots->len; ++i) {
+    ArtemisSpot *spot = g_ptr_array_index(spots, i);
+
+    // Check if this spot was posted by the user from an external program
+    const char *spotter = artemis_spot_get_spotter(spot);
+    if (spotter && *spotter && user_callsign && g_strcmp0(spotter, user_callsign) == 0) {
+      // This is a spot posted by the user from an external program
+      // Add it to the database as a hunted QSO
+      const char *callsign = artemis_spot_get_callsign(spot);
+      const char *park_ref = artemis_spot_get_park_ref(spot);
+
+      if (callsign && park_ref) {
+        g_debug("Auto-marking externally spotted park as hunted: %s @ %s", callsign, park_ref);
+        sqlite3_int64 qso_id = 0;
+        GError *db_err = NULL;
+        if (!spot_db_add_qso_from_spot(spot_db_get_instance(), spot, &qso_id, &db_err)) {
+          g_warning("Failed to add externally spotted QSO to database: %s", 
+                   db_err ? db_err->message : "Unknown error");
+          g_clear_error(&db_err);
+        }
+      }
+    }
+
+    // Fetch activator data for unique callsigns
+    const char *callsign = artemis_spot_get_callsign(spot);
+    if (callsign && *callsign && !g_hash_table_contains(unique_callsigns, callsign)) {
+      g_hash_table_add(unique_callsigns, g_strdup(callsign));
+      artemis_pota_user_cache_get_async(self->pota_user_cache, callsign, self->ttl_secs,
+                                        POTA_PRIORITY_PREFETCH, NULL, on_user_data_fetched, NULL);
+    }
+
+    // Also fetch spotter/hunter data for unique callsigns
+    if (spotter && *spotter && !g_hash_table_contains(unique_callsigns, spotter)) {
+      g_hash_table_add(unique_callsigns, g_strdup(spotter));
+      artemis_pota_user_cache_get_async(self->pota_user_cache, spotter, self->ttl_secs,
+                                        POTA_PRIORITY_PREFETCH, NULL, on_user_data_fetched, NULL);
+    }
+
+    n_added++;
+  }
+
+  // One items-changed for the whole list instead of one per spot
+  self->generation++;
+  g_ptr_array_set_size(self->pending, 0);
+  g_list_store_splice(self->spot_store, 0, g_list_model_get_n_items(G_LIST_MODEL(self->spot_store)),
+                      spots->pdata, spots->len);
+
+  repo_set_stale(self, FALSE);
+  repo_archive_spots(self, spots);
+  repo_save_snapshot(self, spots);
+  return n_added;
+}
+
 static void on_update_spots(GObject *src, GAsyncResult *result, gpointer user_data)
 {
   PotaClient *client = ARTEMIS_POTA_CLIENT(src);
   SpotUpdateData *data = (SpotUpdateData *)user_data;
   ArtemisSpotRepo *self = data->repo;
 
-  g_list_store_remove_all(self->spot_store);
-
   GError *err = NULL;
-  JsonNode *root = pota_client_get_spots_finish(client, result, &err);
+  g_autoptr(GPtrArray) spots = pota_client_get_spots_finish(client, result, &err);
+  self->refresh_hint_secs = pota_client_get_spots_refresh_hint(client, result);
+
+  // Nothing changed: skip parsing, archiving and the UI rebuild entirely.
+  // Likewise when a spot POST replaced the list while this fetch was out;
+  // its answer may predate the new spot.
+  if (g_error_matches(err, POTA_CLIENT_ERROR, POTA_CLIENT_ERROR_NOT_MODIFIED) ||
+      (!err && data->generation != self->generation))
+  {
+    // A dropped list was never shown, so the same list must not come back as a 304
+    if (!err) pota_client_reset_spots_validators(client);
+    g_clear_error(&err);
+    repo_set_busy(self, FALSE);
+    g_signal_emit(self, signals[SIGNAL_UNCHANGED], 0);
+    spot_update_data_free(data);
+    return;
+  }
 
   if (err)
   {
-    g_list_store_remove_all(self->spot_store); // remove all on error
+    // A startup snapshot stays up, already marked stale, until a fetch succeeds
+    if (!self->stale) g_list_store_remove_all(self->spot_store); // remove all on error
+    // The list is gone, so the next fetch must not be answered with a 304
+    pota_client_reset_spots_validators(client);
     g_signal_emit(self, signals[SIGNAL_ERROR], 0, err);
+    g_error_free(err);
     repo_set_busy(self, FALSE);
     spot_update_data_free(data);
     return;
   }
 
-  guint n_added = 0;
-  if (JSON_NODE_HOLDS_ARRAY(root)) {
-    JsonArray *arr = json_node_get_array(root);
-    // clear + repopulate
-    guint n = g_list_model_get_n_items(G_LIST_MODEL(self->spot_store));
-    for (gint i = (gint)n - 1; i >= 0; --i) g_list_store_remove(self->spot_store, i);
-
-    guint len = json_array_get_length(arr);
-    for (guint i = 0; i < len; ++i) {
-      JsonObject *o = json_array_get_object_element(arr, i);
-      if (!o) continue;
-      ArtemisSpot *spot = artemis_spot_new_from_json(o);
-      g_list_store_append(self->spot_store, spot);
-      
-      // Check if this spot was posted by the user from an external program
-      const char *spotter = artemis_spot_get_spotter(spot);
-      if (spotter && *spotter) {
-        GSettings *settings = g_settings_new("com.k0vcz.artemis");
-        g_autofree gchar *user_callsign = g_settings_get_string(settings, "callsign");
-        
-        if (user_callsign && g_strcmp0(spotter, user_callsign) == 0) {
-          // This is a spot posted by the user from an external program
-          // Add it to the database as a hunted QSO
-          const char *callsign = artemis_spot_get_callsign(spot);
-          const char *park_ref = artemis_spot_get_park_ref(spot);
-          
-          if (callsign && park_ref) {
-            g_debug("Auto-marking externally spotted park as hunted: %s @ %s", callsign, park_ref);
-            sqlite3_int64 qso_id = 0;
-            GError *db_err = NULL;
-            if (!spot_db_add_qso_from_spot(spot_db_get_instance(), spot, &qso_id, &db_err)) {
-              g_warning("Failed to add externally spotted QSO to database: %s", 
-                       db_err ? db_err->message : "Unknown error");
-              g_clear_error(&db_err);
-            }
-          }
-        }
-        
-        g_object_unref(settings);
-      }
-      
-      // Fetch activator data for unique callsigns
-      const char *callsign = artemis_spot_get_callsign(spot);
-      if (callsign && *callsign && !g_hash_table_contains(data->unique_callsigns, callsign)) {
-        g_hash_table_add(data->unique_callsigns, g_strdup(callsign));
-        artemis_pota_user_cache_get_async(self->pota_user_cache, callsign, data->ttl_seconds,
-                                          NULL, on_user_data_fetched, NULL);
-      }
-      
-      // Also fetch spotter/hunter data for unique callsigns
-      if (spotter && *spotter && !g_hash_table_contains(data->unique_callsigns, spotter)) {
-        g_hash_table_add(data->unique_callsigns, g_strdup(spotter));
-        artemis_pota_user_cache_get_async(self->pota_user_cache, spotter, data->ttl_seconds,
-                                          NULL, on_user_data_fetched, NULL);
-      }
-      
-      g_object_unref(spot);
-      n_added++;
-    }
-  }
-
-  if (root) json_node_unref(root);
-  
-  data->n_spots_added = n_added;
+  guint n_added = repo_apply_spots(self, spots);
   repo_set_busy(self, FALSE);
   g_signal_emit(self, signals[SIGNAL_REFRESHED], 0, n_added);
   spot_update_data_free(data);
@@ -229,16 +450,161 @@ GListModel *artemis_spot_repo_get_model(ArtemisSpotRepo *self)
 void artemis_spot_repo_update_spots(ArtemisSpotRepo *self, guint ttl_secs) 
 {
   g_return_if_fail(ARTEMIS_IS_SPOT_REPO(self));
+
+  // One fetch at a time; the caller hears about the running one through "refreshed"/"error"
+  if (self->busy) return;
   repo_set_busy(self, TRUE);
 
+  self->ttl_secs = ttl_secs > 0 ? ttl_secs : 3600; // Default 1 hour TTL
+
   SpotUpdateData *data = g_new0(SpotUpdateData, 1);
   data->repo = g_object_ref(self);
-  data->ttl_seconds = ttl_secs > 0 ? ttl_secs : 3600; // Default 1 hour TTL
-  data->unique_callsigns = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  data->generation = self->generation;
 
   pota_client_get_spots_async(self->client, NULL, on_update_spots, data);
 }
 
+void artemis_spot_repo_apply_spots(ArtemisSpotRepo *self, GPtrArray *spots)
+{
+  g_return_if_fail(ARTEMIS_IS_SPOT_REPO(self));
+  g_return_if_fail(spots != NULL);
+
+  // Not a fetch; a running one still completes through "unchanged"
+  guint n_added = repo_apply_spots(self, spots);
+  g_signal_emit(self, signals[SIGNAL_APPLIED], 0, n_added);
+}
+
+void artemis_spot_repo_add_pending(ArtemisSpotRepo *self, ArtemisSpot *spot)
+{
+  g_return_if_fail(ARTEMIS_IS_SPOT_REPO(self));
+  g_return_if_fail(ARTEMIS_IS_SPOT(spot));
+
+  const char *callsign = artemis_spot_get_callsign(spot);
+  const char *park_ref = artemis_spot_get_park_ref(spot);
+
+  // The server keeps one spot per activation, so the new one takes the old one's place
+  GListModel *model = G_LIST_MODEL(self->spot_store);
+  guint n = g_list_model_get_n_items(model);
+  guint pos = 0;
+  g_autoptr(ArtemisSpot) current = NULL;
+  for (; pos < n; pos++) {
+    g_autoptr(ArtemisSpot) item = g_list_model_get_item(model, pos);
+    if (g_ascii_strcasecmp(artemis_spot_get_callsign(item), callsign) == 0 &&
+        g_ascii_strcasecmp(artemis_spot_get_park_ref(item), park_ref) == 0) {
+      current = g_steal_pointer(&item);
+      break;
+    }
+  }
+
+  // Keep what the submit form does not know from the spot being replaced
+  g_autoptr(GDateTime) now = g_date_time_new_now_utc();
+  g_autoptr(ArtemisSpot) pending = artemis_spot_new(
+    callsign,
+    park_ref,
+    artemis_spot_get_park_name(spot) ? artemis_spot_get_park_name(spot)
+                                     : current ? artemis_spot_get_park_name(current) : NULL,
+    artemis_spot_get_location_desc(spot) ? artemis_spot_get_location_desc(spot)
+                                         : current ? artemis_spot_get_location_desc(current) : NULL,
+    current ? artemis_spot_get_activator_comment(current) : NULL,
+    artemis_spot_get_frequency_hz(spot),
+    artemis_spot_get_mode(spot),
+    now,
+    artemis_spot_get_spotter(spot),
+    artemis_spot_get_spotter_comment(spot),
+    current ? artemis_spot_get_spot_count(current) + 1 : 1);
+
+  // Submitted again before the server caught up: keep the server's original
+  PendingSpot *entry = NULL;
+  for (guint i = 0; current && i < self->pending->len; i++) {
+    PendingSpot *candidate = g_ptr_array_index(self->pending, i);
+    if (candidate->shown == current) entry = candidate;
+  }
+  if (entry) {
+    g_object_unref(entry->shown);
+  } else {
+    entry = g_new0(PendingSpot, 1);
+    entry->replaced = current ? g_object_ref(current) : NULL;
+    g_ptr_array_add(self->pending, entry);
+  }
+  entry->shown = g_object_ref(pending);
+
+  // A fetch that started before the POST may not include the new spot yet. The
+  // next one must return the full list, even if the server's is unchanged, or
+  // the pending spot would never be replaced.
+  self->generation++;
+  pota_client_reset_spots_validators(self->client);
+  gpointer items[] = { pending };
+  g_list_store_splice(self->spot_store, current ? pos : 0, current ? 1 : 0, items, 1);
+}
+
+void artemis_spot_repo_remove_pending(ArtemisSpotRepo *self, ArtemisSpot *spot)
+{
+  g_return_if_fail(ARTEMIS_IS_SPOT_REPO(self));
+  g_return_if_fail(ARTEMIS_IS_SPOT(spot));
+
+  for (guint i = 0; i < self->pending->len; i++) {
+    PendingSpot *entry = g_ptr_array_index(self->pending, i);
+    if (g_ascii_strcasecmp(artemis_spot_get_callsign(entry->shown), artemis_spot_get_callsign(spot)) != 0 ||
+        g_ascii_strcasecmp(artemis_spot_get_park_ref(entry->shown), artemis_spot_get_park_ref(spot)) != 0) {
+      continue;
+    }
+
+    // Put back the spot it stood in for, if any
+    guint pos = 0;
+    if (g_list_store_find(self->spot_store, entry->shown, &pos)) {
+      gpointer items[] = { entry->replaced };
+      g_list_store_splice(self->spot_store, pos, 1, items, entry->replaced ? 1 : 0);
+    }
+    g_ptr_array_remove_index_fast(self->pending, i);
+    return;
+  }
+}
+
+gboolean artemis_spot_repo_load_snapshot(ArtemisSpotRepo *self)
+{
+  g_return_val_if_fail(ARTEMIS_IS_SPOT_REPO(self), FALSE);
+
+  g_autofree gchar *path = spot_snapshot_default_path();
+  g_autoptr(GDateTime) fetched_utc = NULL;
+  g_autoptr(GError) error = NULL;
+  g_autoptr(GPtrArray) spots = spot_snapshot_load(path, &fetched_utc, &error);
+  if (!spots) {
+    if (!g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+      g_debug("No spot snapshot loaded: %s", error->message);
+    }
+    return FALSE;
+  }
+
+  // No user-cache prefetch or archiving here; the first fetch does both
+  self->generation++;
+  g_ptr_array_set_size(self->pending, 0);
+  g_list_store_splice(self->spot_store, 0, g_list_model_get_n_items(G_LIST_MODEL(self->spot_store)),
+                      spots->pdata, spots->len);
+
+  // The server's validators may be newer than the file; a 304 must not leave the snapshot up
+  pota_client_reset_spots_validators(self->client);
+
+  self->stale_fetched_utc = g_steal_pointer(&fetched_utc);
+  repo_set_stale(self, TRUE);
+  g_debug("Loaded %u spots from snapshot", spots->len);
+  return TRUE;
+}
+
+gboolean artemis_spot_repo_get_stale(ArtemisSpotRepo *self, GDateTime **out_fetched_utc)
+{
+  g_return_val_if_fail(ARTEMIS_IS_SPOT_REPO(self), FALSE);
+  if (out_fetched_utc) {
+    *out_fetched_utc = self->stale_fetched_utc ? g_date_time_ref(self->stale_fetched_utc) : NULL;
+  }
+  return self->stale;
+}
+
+gint artemis_spot_repo_get_refresh_hint(ArtemisSpotRepo *self)
+{
+  g_return_val_if_fail(ARTEMIS_IS_SPOT_REPO(self), -1);
+  return self->refresh_hint_secs;
+}
+
 PotaClient *artemis_spot_repo_get_pota_client(ArtemisSpotRepo *self)
 {
   return self->client;
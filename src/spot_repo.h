@@ -16,9 +16,42 @@ GListModel *artemis_spot_repo_get_model(ArtemisSpotRepo *self);
 gboolean
 artemis_spot_repo_get_busy(ArtemisSpotRepo *self);
 
+// Seconds the server asked to wait before the next fetch, -1 if none.
+// Updated before "refreshed" or "error" is emitted.
+gint
+artemis_spot_repo_get_refresh_hint(ArtemisSpotRepo *self);
+
 PotaClient *artemis_spot_repo_get_pota_client(ArtemisSpotRepo *self);
 ArtemisPotaUserCache *artemis_spot_repo_get_pota_user_cache(ArtemisSpotRepo *self);
 void
 artemis_spot_repo_update_spots(ArtemisSpotRepo *self, guint ttl_secs);
 
+// Replace the list with one the server returned elsewhere, e.g. from a spot POST,
+// exactly as a fetch would, but emits "applied" rather than "refreshed". The answer
+// of a fetch already running is dropped, which completes it with "unchanged".
+void
+artemis_spot_repo_apply_spots(ArtemisSpotRepo *self, GPtrArray *spots);
+
+// Show a spot the user just submitted until the server's list catches up.
+// Replaces the activation's current spot if there is one. The answer of a fetch
+// already running is dropped, since it may predate the spot.
+void
+artemis_spot_repo_add_pending(ArtemisSpotRepo *self, ArtemisSpot *spot);
+
+// Take back the pending spot for spot's activation, e.g. when the server refused
+// it, restoring the spot it replaced. Does nothing once a refresh has replaced it.
+void
+artemis_spot_repo_remove_pending(ArtemisSpotRepo *self, ArtemisSpot *spot);
+
+// Fill the store from the snapshot the last run left on disk, if there is one, and
+// mark it stale until a fetch replaces it. Emits "stale-changed". Returns FALSE if
+// there was nothing usable to load.
+gboolean
+artemis_spot_repo_load_snapshot(ArtemisSpotRepo *self);
+
+// TRUE while the store holds the snapshot rather than live data. *out_fetched_utc
+// (if given) gets a new reference to the time the snapshot was fetched.
+gboolean
+artemis_spot_repo_get_stale(ArtemisSpotRepo *self, GDateTime **out_fetched_utc);
+
 G_END_DECLS
@@ -0,0 +1,215 @@
+#include "spot_snapshot.h"
+
+#include <gio/gio.h>
+#include <string.h>
+
+#include "spot.h"
+
+/* Layout, all integers little-endian:
+ *
+ *   header   magic "ASNP", u32 version, u32 n_spots, u32 record_size,
+ *            i64 fetched (unix), u32 strings_len, u32 reserved      (32 bytes)
+ *   records  n_spots x { i64 spot_id, i64 spot_time (unix, or NO_TIME),
+ *            i32 frequency, i32 spot_count, u32 strings[N_STRINGS] } (56 bytes)
+ *   strings  strings_len bytes of NUL-terminated strings; a record field is an
+ *            offset into it or NO_STRING. Repeated values are stored once.
+ */
+#define SNAPSHOT_MAGIC        "ASNP"
+#define SNAPSHOT_VERSION      1
+#define SNAPSHOT_HEADER_SIZE  32
+#define SNAPSHOT_RECORD_SIZE  56
+
+#define NO_STRING  G_MAXUINT32
+#define NO_TIME    G_MININT64
+
+enum {
+  STR_CALLSIGN,
+  STR_PARK_REF,
+  STR_PARK_NAME,
+  STR_LOCATION_DESC,
+  STR_ACTIVATOR_COMMENT,
+  STR_MODE,
+  STR_SPOTTER,
+  STR_SPOTTER_COMMENT,
+  N_STRINGS
+};
+
+G_STATIC_ASSERT(SNAPSHOT_RECORD_SIZE == 8 + 8 + 4 + 4 + 4 * N_STRINGS);
+
+gchar*
+spot_snapshot_default_path(void)
+{
+  return g_build_filename(g_get_user_data_dir(), "artemis", "spots.snapshot", NULL);
+}
+
+/* ----------------- writing ----------------- */
+
+static void
+put_u32(GByteArray *out, guint32 value)
+{
+  guint32 le = GUINT32_TO_LE(value);
+  g_byte_array_append(out, (const guint8 *)&le, sizeof le);
+}
+
+static void
+put_i64(GByteArray *out, gint64 value)
+{
+  guint64 le = GUINT64_TO_LE((guint64)value);
+  g_byte_array_append(out, (const guint8 *)&le, sizeof le);
+}
+
+// Offset of value in the string table, adding it the first time it is seen
+static guint32
+intern_string(GString *strings, GHashTable *offsets, const char *value)
+{
+  if (!value) return NO_STRING;
+
+  gpointer found = NULL;
+  if (g_hash_table_lookup_extended(offsets, value, NULL, &found)) return GPOINTER_TO_UINT(found);
+
+  guint32 offset = (guint32)strings->len;
+  g_string_append_len(strings, value, strlen(value) + 1);
+  g_hash_table_insert(offsets, (gpointer)value, GUINT_TO_POINTER(offset));
+  return offset;
+}
+
+gboolean
+spot_snapshot_save(const gchar *path, GPtrArray *spots, GDateTime *fetched_utc, GError **error)
+{
+  g_return_val_if_fail(path != NULL && spots != NULL && fetched_utc != NULL, FALSE);
+
+  // Keys are borrowed from the spots, which outlive the table
+  g_autoptr(GHashTable) offsets = g_hash_table_new(g_str_hash, g_str_equal);
+  g_autoptr(GString) strings = g_string_sized_new(spots->len * 64);
+  g_autoptr(GByteArray) out = g_byte_array_sized_new(SNAPSHOT_HEADER_SIZE + spots->len * SNAPSHOT_RECORD_SIZE);
+
+  // Header; strings_len is patched in once the table is built
+  g_byte_array_append(out, (const guint8 *)SNAPSHOT_MAGIC, 4);
+  put_u32(out, SNAPSHOT_VERSION);
+  put_u32(out, spots->len);
+  put_u32(out, SNAPSHOT_RECORD_SIZE);
+  put_i64(out, g_date_time_to_unix(fetched_utc));
+  put_u32(out, 0);
+  put_u32(out, 0);
+
+  for (guint i = 0; i < spots->len; i++) {
+    ArtemisSpot *spot = g_ptr_array_index(spots, i);
+    GDateTime *spot_time = artemis_spot_get_spot_time(spot);
+    const char *fields[N_STRINGS] = {
+      [STR_CALLSIGN]          = artemis_spot_get_callsign(spot),
+      [STR_PARK_REF]          = artemis_spot_get_park_ref(spot),
+      [STR_PARK_NAME]         = artemis_spot_get_park_name(spot),
+      [STR_LOCATION_DESC]     = artemis_spot_get_location_desc(spot),
+      [STR_ACTIVATOR_COMMENT] = artemis_spot_get_activator_comment(spot),
+      [STR_MODE]              = artemis_spot_get_mode(spot),
+      [STR_SPOTTER]           = artemis_spot_get_spotter(spot),
+      [STR_SPOTTER_COMMENT]   = artemis_spot_get_spotter_comment(spot),
+    };
+
+    put_i64(out, artemis_spot_get_spot_id(spot));
+    put_i64(out, spot_time ? g_date_time_to_unix(spot_time) : NO_TIME);
+    put_u32(out, (guint32)artemis_spot_get_frequency_hz(spot));
+    put_u32(out, (guint32)artemis_spot_get_spot_count(spot));
+    for (guint f = 0; f < N_STRINGS; f++) {
+      put_u32(out, intern_string(strings, offsets, fields[f]));
+    }
+  }
+
+  guint32 strings_len = GUINT32_TO_LE((guint32)strings->len);
+  memcpy(out->data + 24, &strings_len, sizeof strings_len);
+  g_byte_array_append(out, (const guint8 *)strings->str, (guint)strings->len);
+
+  g_autofree gchar *dir = g_path_get_dirname(path);
+  g_mkdir_with_parents(dir, 0700);
+
+  // Written to a temporary file and renamed, so a reader never sees half a snapshot
+  return g_file_set_contents(path, (const gchar *)out->data, out->len, error);
+}
+
+/* ----------------- reading ----------------- */
+
+static guint32
+get_u32(const guint8 *p)
+{
+  guint32 le;
+  memcpy(&le, p, sizeof le);
+  return GUINT32_FROM_LE(le);
+}
+
+static gint64
+get_i64(const guint8 *p)
+{
+  guint64 le;
+  memcpy(&le, p, sizeof le);
+  return (gint64)GUINT64_FROM_LE(le);
+}
+
+GPtrArray*
+spot_snapshot_load(const gchar *path, GDateTime **out_fetched_utc, GError **error)
+{
+  g_return_val_if_fail(path != NULL, NULL);
+
+  g_autoptr(GMappedFile) mapped = g_mapped_file_new(path, FALSE, error);
+  if (!mapped) return NULL;
+
+  const guint8 *data = (const guint8 *)g_mapped_file_get_contents(mapped);
+  gsize len = g_mapped_file_get_length(mapped);
+
+  if (len < SNAPSHOT_HEADER_SIZE || memcmp(data, SNAPSHOT_MAGIC, 4) != 0 ||
+      get_u32(data + 4) != SNAPSHOT_VERSION || get_u32(data + 12) != SNAPSHOT_RECORD_SIZE) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Not a spot snapshot: %s", path);
+    return NULL;
+  }
+
+  guint32 n_spots = get_u32(data + 8);
+  gint64 fetched = get_i64(data + 16);
+  guint32 strings_len = get_u32(data + 24);
+  const guint8 *records = data + SNAPSHOT_HEADER_SIZE;
+  const gchar *strings = (const gchar *)records + (gsize)n_spots * SNAPSHOT_RECORD_SIZE;
+
+  // Every string must end inside the table, so its last byte has to be a NUL
+  if ((guint64)SNAPSHOT_HEADER_SIZE + (guint64)n_spots * SNAPSHOT_RECORD_SIZE + strings_len != len ||
+      (strings_len > 0 && strings[strings_len - 1] != '\0')) {
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Truncated spot snapshot: %s", path);
+    return NULL;
+  }
+
+  GPtrArray *spots = g_ptr_array_new_full(n_spots, g_object_unref);
+  for (guint32 i = 0; i < n_spots; i++) {
+    const guint8 *rec = records + (gsize)i * SNAPSHOT_RECORD_SIZE;
+    const char *fields[N_STRINGS];
+
+    for (guint f = 0; f < N_STRINGS; f++) {
+      guint32 offset = get_u32(rec + 24 + f * 4);
+      if (offset == NO_STRING) {
+        fields[f] = NULL;
+      } else if (offset < strings_len) {
+        fields[f] = strings + offset;
+      } else {
+        g_ptr_array_unref(spots);
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Corrupt spot snapshot: %s", path);
+        return NULL;
+      }
+    }
+
+    gint64 spot_time = get_i64(rec + 8);
+    g_autoptr(GDateTime) dt = spot_time != NO_TIME ? g_date_time_new_from_unix_utc(spot_time) : NULL;
+
+    ArtemisSpot *spot = artemis_spot_new(fields[STR_CALLSIGN],
+                                         fields[STR_PARK_REF],
+                                         fields[STR_PARK_NAME],
+                                         fields[STR_LOCATION_DESC],
+                                         fields[STR_ACTIVATOR_COMMENT],
+                                         (gint32)get_u32(rec + 16),
+                                         fields[STR_MODE],
+                                         dt,
+                                         fields[STR_SPOTTER],
+                                         fields[STR_SPOTTER_COMMENT],
+                                         (gint32)get_u32(rec + 20));
+    artemis_spot_set_spot_id(spot, get_i64(rec));
+    g_ptr_array_add(spots, spot);
+  }
+
+  if (out_fetched_utc) *out_fetched_utc = g_date_time_new_from_unix_utc(fetched);
+  return spots;
+}
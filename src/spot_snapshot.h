@@ -0,0 +1,26 @@
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* The last spot list the server sent, kept on disk so the next launch can show
+ * it before the first fetch returns. The file is a fixed header, one fixed-size
+ * record per spot, and a table of NUL-terminated strings the records point into;
+ * it is read straight out of a GMappedFile. Any damage makes the load fail and
+ * the app starts empty as before. */
+
+// <user data dir>/artemis/spots.snapshot
+gchar*
+spot_snapshot_default_path(void);
+
+// Write spots (ArtemisSpot*) atomically. Safe to call from a worker thread.
+gboolean
+spot_snapshot_save(const gchar *path, GPtrArray *spots, GDateTime *fetched_utc, GError **error);
+
+// Read a snapshot back as a GPtrArray of ArtemisSpot*. *out_fetched_utc gets the
+// time the list was fetched.
+GPtrArray*
+spot_snapshot_load(const gchar *path, GDateTime **out_fetched_utc, GError **error);
+
+G_END_DECLS
@@ -0,0 +1,98 @@
+#include "stats_dialog.h"
+#include "adwaita.h"
+#include "glib.h"
+
+#include "artemis.h"
+#include "database.h"
+
+#define STATS_MAX_ROWS 25
+#define STATS_RECENT_DAYS 14
+
+static GtkWidget *
+stats_row_new(const char *title, const char *subtitle)
+{
+  GtkWidget *row = adw_action_row_new();
+  adw_preferences_row_set_use_markup(ADW_PREFERENCES_ROW(row), FALSE);
+  adw_preferences_row_set_title(ADW_PREFERENCES_ROW(row), title);
+  adw_action_row_set_subtitle(ADW_ACTION_ROW(row), subtitle);
+  return row;
+}
+
+/* One row per key: "12 parks · 30 QSOs" */
+static void
+fill_stats_group(SpotDb *db, AdwPreferencesGroup *group, const char *dimension, guint max_rows)
+{
+  GError *error = NULL;
+  g_autoptr(GPtrArray) rows = spot_db_get_stats(db, dimension, &error);
+  if (!rows) {
+    g_warning("Failed to load %s statistics: %s", dimension, error->message);
+    g_clear_error(&error);
+    gtk_widget_set_visible(GTK_WIDGET(group), FALSE);
+    return;
+  }
+
+  for (guint i = 0; i < rows->len && i < max_rows; i++) {
+    StatRow *stat = g_ptr_array_index(rows, i);
+    guint park_count = (guint)stat->park_count;
+    guint qso_count = (guint)stat->qso_count;
+    g_autofree gchar *parks = g_strdup_printf(ngettext("%u park", "%u parks", park_count), park_count);
+    g_autofree gchar *qsos = g_strdup_printf(ngettext("%u QSO", "%u QSOs", qso_count), qso_count);
+    g_autofree gchar *subtitle = g_strdup_printf("%s · %s", parks, qsos);
+    adw_preferences_group_add(group, stats_row_new(stat->key, subtitle));
+  }
+
+  if (rows->len == 0) {
+    gtk_widget_set_visible(GTK_WIDGET(group), FALSE);
+  }
+}
+
+static void
+set_property_subtitle(GtkBuilder *b, const char *row_id, const char *text)
+{
+  adw_action_row_set_subtitle(ADW_ACTION_ROW(gtk_builder_get_object(b, row_id)), text);
+}
+
+static void
+fill_summary(SpotDb *db, GtkBuilder *b)
+{
+  gint64 parks = 0, qsos = 0;
+  g_autoptr(GPtrArray) totals = spot_db_get_stats(db, SPOT_DB_STAT_TOTAL, NULL);
+  if (totals && totals->len > 0) {
+    StatRow *all = g_ptr_array_index(totals, 0);
+    parks = all->park_count;
+    qsos = all->qso_count;
+  }
+
+  guint current = 0, longest = 0;
+  g_autoptr(GDateTime) now = g_date_time_new_now_utc();
+  spot_db_get_streaks(db, now, &current, &longest, NULL);
+
+  g_autofree gchar *parks_str = g_strdup_printf("%" G_GINT64_FORMAT, parks);
+  g_autofree gchar *qsos_str = g_strdup_printf("%" G_GINT64_FORMAT, qsos);
+  g_autofree gchar *current_str = g_strdup_printf(ngettext("%u day", "%u days", current), current);
+  g_autofree gchar *longest_str = g_strdup_printf(ngettext("%u day", "%u days", longest), longest);
+
+  set_property_subtitle(b, "row_total_parks", parks_str);
+  set_property_subtitle(b, "row_total_qsos", qsos_str);
+  set_property_subtitle(b, "row_current_streak", current_str);
+  set_property_subtitle(b, "row_longest_streak", longest_str);
+}
+
+void
+show_stats_dialog(GtkWidget *parent)
+{
+  g_autoptr(GtkBuilder) b = gtk_builder_new_from_resource("/com/k0vcz/artemis/data/ui/stats_dialog.ui");
+  GtkWidget *dlg = GTK_WIDGET(gtk_builder_get_object(b, "stats_dialog"));
+
+  SpotDb *db = spot_db_get_instance();
+  if (db) {
+    fill_summary(db, b);
+    fill_stats_group(db, ADW_PREFERENCES_GROUP(gtk_builder_get_object(b, "band_group")), SPOT_DB_STAT_BAND, STATS_MAX_ROWS);
+    fill_stats_group(db, ADW_PREFERENCES_GROUP(gtk_builder_get_object(b, "mode_group")), SPOT_DB_STAT_MODE, STATS_MAX_ROWS);
+    fill_stats_group(db, ADW_PREFERENCES_GROUP(gtk_builder_get_object(b, "location_group")), SPOT_DB_STAT_LOCATION, STATS_MAX_ROWS);
+    fill_stats_group(db, ADW_PREFERENCES_GROUP(gtk_builder_get_object(b, "entity_group")), SPOT_DB_STAT_ENTITY, STATS_MAX_ROWS);
+    fill_stats_group(db, ADW_PREFERENCES_GROUP(gtk_builder_get_object(b, "day_group")), SPOT_DB_STAT_DAY, STATS_RECENT_DAYS);
+  }
+
+  adw_dialog_present(ADW_DIALOG(dlg), parent);
+}
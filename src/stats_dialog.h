@@ -0,0 +1,9 @@
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+void show_stats_dialog(GtkWidget *parent);
+
+G_END_DECLS